@@ -0,0 +1,110 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes/drts/data_flow/Graph.hpp>
+
+#include "util/SetBasedGraph.hpp"
+
+using namespace HPM;
+
+//!
+//! \brief Add the task graph of a DG-like time stepping: a surface and a volume loop on each partition, for a number of steps.
+//!
+//! Partition `p` of each loop reads the partitions `p-1`, `p` and `p+1` (slab layout) of one field and writes partition `p` of the other field.
+//! Dependencies are identified by the field and the partition.
+//!
+//! \param graph the graph
+//! \param num_partitions the number of partitions
+//! \param num_steps the number of steps
+//!
+template <typename GraphT>
+static void AddTaskGraph(GraphT& graph, const std::size_t num_partitions, const std::size_t num_steps)
+{
+    for (std::size_t step = 0; step < num_steps; ++step)
+    {
+        for (std::size_t loop = 0; loop < 2; ++loop)
+        {
+            const std::size_t read_field = loop;
+            const std::size_t write_field = 1 - loop;
+
+            for (std::size_t partition = 0; partition < num_partitions; ++partition)
+            {
+                const auto vertex = graph.AddVertex();
+
+                for (std::size_t neighbor = (partition > 0 ? partition - 1 : 0); neighbor < std::min(partition + 2, num_partitions); ++neighbor)
+                {
+                    graph.AddDependency(vertex, read_field * num_partitions + neighbor, AccessMode::Read);
+                }
+
+                graph.AddDependency(vertex, write_field * num_partitions + partition, (loop == 0 ? AccessMode::Write : AccessMode::ReadWrite));
+            }
+        }
+    }
+}
+
+//!
+//! \brief Time the construction of a task graph: adding the vertices and dependencies, and finalizing the graph.
+//!
+//! The arguments are the number of partitions and the number of steps.
+//!
+//! \tparam GraphT the graph type
+//!
+template <typename GraphT>
+static void GraphConstruction(benchmark::State& state)
+{
+    const std::size_t num_partitions = state.range(0);
+    const std::size_t num_steps = state.range(1);
+    std::size_t num_edges = 0;
+
+    for (auto _ : state)
+    {
+        GraphT graph;
+
+        AddTaskGraph(graph, num_partitions, num_steps);
+        graph.Finalize();
+        num_edges = graph.GetEdges().size();
+
+        benchmark::DoNotOptimize(num_edges);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2 * num_partitions * num_steps);
+    state.counters["edges"] = num_edges;
+}
+
+//!
+//! \brief Time the transitive reduction of a task graph.
+//!
+static void TransitiveReduction(benchmark::State& state)
+{
+    const std::size_t num_partitions = state.range(0);
+    const std::size_t num_steps = state.range(1);
+    std::size_t num_edges = 0;
+    std::size_t num_reduced_edges = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        drts::data_flow::Graph<std::size_t> graph;
+        AddTaskGraph(graph, num_partitions, num_steps);
+        graph.Finalize();
+        num_edges = graph.GetEdges().size();
+        state.ResumeTiming();
+
+        num_reduced_edges = num_edges - graph.ReduceTransitively();
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_edges);
+    state.counters["edges"] = num_edges;
+    state.counters["reduced_edges"] = num_reduced_edges;
+}
+
+BENCHMARK_TEMPLATE(GraphConstruction, SetBasedGraph<std::size_t>)->ArgsProduct({{64, 1024}, {10, 100}})->ArgNames({"partitions", "steps"})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(GraphConstruction, drts::data_flow::Graph<std::size_t>)->ArgsProduct({{64, 1024}, {10, 100}})->ArgNames({"partitions", "steps"})->Unit(benchmark::kMillisecond);
+BENCHMARK(TransitiveReduction)->ArgsProduct({{64, 1024}, {10, 100}})->ArgNames({"partitions", "steps"})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+using HPM::internal::LocalView;
+
+constexpr auto Dofs = dof::MakeDofs<0, 0, 0, 20, 0>();
+
+//!
+//! \brief Time the creation of local views for all cells: cell dofs of two buffers.
+//!
+static void LocalViewOfCells(benchmark::State& state)
+{
+    const auto& mesh = GetBoxMesh(state.range(0)).mesh;
+    using MeshT = std::decay_t<decltype(mesh)>;
+
+    drts::Runtime hpm{GetBuffer{}};
+    auto input = hpm.GetBuffer<double>(mesh, Dofs);
+    auto output = hpm.GetBuffer<double>(mesh, Dofs);
+    const auto access_definitions = std::tuple(Read(Cell(input)), Write(Cell(output)));
+    const auto cells = mesh.GetEntityRange<MeshT::CellDimension>();
+    const auto& entities = cells.GetEntities();
+
+    for (auto _ : state)
+    {
+        auto it = entities.begin();
+
+        for (std::size_t i = 0; i < entities.GetRangeSize(); ++i, ++it)
+        {
+            auto&& local_view = LocalView::Create(access_definitions, it.GetHandle());
+
+            benchmark::DoNotOptimize(local_view);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+}
+
+//!
+//! \brief Time the creation of local views for all faces of all cells: dofs of the containing and the neighboring cells.
+//!
+//! This is the access pattern of the MIDG2 surface kernel.
+//!
+static void LocalViewOfFaces(benchmark::State& state)
+{
+    const auto& mesh = GetBoxMesh(state.range(0)).mesh;
+    using MeshT = std::decay_t<decltype(mesh)>;
+    constexpr std::size_t NumFacesPerCell = MeshT::CellDimension + 1;
+
+    drts::Runtime hpm{GetBuffer{}};
+    auto input = hpm.GetBuffer<double>(mesh, Dofs);
+    auto output = hpm.GetBuffer<double>(mesh, Dofs);
+    const auto access_definitions = std::tuple(Read(ContainingMeshElement(input)), Read(NeighboringMeshElementOrSelf(input)), Write(ContainingMeshElement(output)));
+    const auto cells = mesh.GetEntityRange<MeshT::CellDimension>();
+    const auto& entities = cells.GetEntities();
+
+    for (auto _ : state)
+    {
+        auto it = entities.begin();
+
+        for (std::size_t i = 0; i < entities.GetRangeSize(); ++i, ++it)
+        {
+            const auto& faces = it.GetHandle().template GetEntities<MeshT::CellDimension - 1>();
+            auto&& local_views = LocalView::CreateMultiple(access_definitions, faces, std::make_index_sequence<NumFacesPerCell>{});
+
+            benchmark::DoNotOptimize(local_views);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities() * NumFacesPerCell);
+}
+
+BENCHMARK(LocalViewOfCells)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(LocalViewOfFaces)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,99 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cstddef>
+#include <tuple>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+
+constexpr std::size_t NumDofsPerCell = 20;
+
+//!
+//! \brief Time a `ForEachEntity` loop over all cells that scales the cell dofs of a buffer.
+//!
+//! The loop body is cheap, so the measurement is dominated by the loop and local view overhead.
+//!
+//! \tparam Loops the loop implementations (see `BoxMesh.hpp`)
+//!
+template <typename Loops>
+static void ForEachEntityLoop(benchmark::State& state)
+{
+    const auto& mesh = GetBoxMesh(state.range(0)).mesh;
+    using MeshT = std::decay_t<decltype(mesh)>;
+    constexpr auto Dofs = dof::MakeDofs<0, 0, 0, NumDofsPerCell, 0>();
+
+    drts::Runtime hpm{GetBuffer{}};
+    auto input = hpm.GetBuffer<double>(mesh, Dofs);
+    auto output = hpm.GetBuffer<double>(mesh, Dofs);
+    const auto cells = mesh.GetEntityRange<MeshT::CellDimension>();
+    SequentialDispatcher dispatcher;
+
+    auto loop = ForEachEntity(
+        cells, std::tuple(Read(Cell(input)), Write(Cell(output))),
+        [](const auto&, const auto&, auto& lvs) {
+            const auto& input = std::get<0>(lvs);
+            auto& output = std::get<1>(lvs);
+
+            ForEach(NumDofsPerCell, [&](const std::size_t n) { output[n] = 2.0 * input[n]; });
+        },
+        typename Loops::template ForEachEntity<MeshT::CellDimension>{});
+
+    for (auto _ : state)
+    {
+        dispatcher.Execute(loop);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+    state.SetBytesProcessed(state.iterations() * mesh.GetNumEntities() * NumDofsPerCell * 2 * sizeof(double));
+}
+
+//!
+//! \brief Time a `ForEachIncidence` loop over all faces of all cells that reads the dofs of the neighboring cell.
+//!
+//! \tparam Loops the loop implementations (see `BoxMesh.hpp`)
+//!
+template <typename Loops>
+static void ForEachIncidenceLoop(benchmark::State& state)
+{
+    const auto& mesh = GetBoxMesh(state.range(0)).mesh;
+    using MeshT = std::decay_t<decltype(mesh)>;
+    constexpr auto Dofs = dof::MakeDofs<0, 0, 0, NumDofsPerCell, 0>();
+
+    drts::Runtime hpm{GetBuffer{}};
+    auto input = hpm.GetBuffer<double>(mesh, Dofs);
+    auto output = hpm.GetBuffer<double>(mesh, Dofs);
+    const auto cells = mesh.GetEntityRange<MeshT::CellDimension>();
+    SequentialDispatcher dispatcher;
+
+    auto loop = ForEachIncidence<MeshT::CellDimension - 1>(
+        cells, std::tuple(Read(NeighboringMeshElementOrSelf(input)), ReadWrite(ContainingMeshElement(output))),
+        [](const auto&, const auto&, const auto&, auto& lvs) {
+            const auto& input = std::get<0>(lvs);
+            auto& output = std::get<1>(lvs);
+
+            ForEach(NumDofsPerCell, [&](const std::size_t n) { output[n] += input[n]; });
+        },
+        typename Loops::template ForEachIncidence<MeshT::CellDimension, MeshT::CellDimension - 1>{});
+
+    for (auto _ : state)
+    {
+        dispatcher.Execute(loop);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities() * (MeshT::CellDimension + 1));
+}
+
+BENCHMARK_TEMPLATE(ForEachEntityLoop, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ForEachEntityLoop, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ForEachIncidenceLoop, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ForEachIncidenceLoop, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,191 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "RKCoeff.hpp"
+#include "data3dN03.hpp"
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+
+using RealT = dataType::Real;
+using Vec3D = dataType::Vec<double, 3>;
+using Mat3D = dataType::Matrix<double, 3, 3>;
+
+//!
+//! \brief The MIDG2 kernels (see `examples/MIDG2_DSL`).
+//!
+enum class Kernel
+{
+    Surface,
+    Volume,
+    RungeKutta,
+    All
+};
+
+//!
+//! \brief Time one Runge-Kutta stage of the MIDG2 Maxwell solver (or one of its kernels) on a tetrahedral box mesh.
+//!
+//! The kernels are the same as in `examples/MIDG2_DSL/mainUnfusedKernels.cpp` (polynomial order 3).
+//!
+//! \tparam K the kernel(s) to be executed
+//! \tparam Loops the loop implementations (see `BoxMesh.hpp`)
+//!
+template <Kernel K, typename Loops>
+static void MIDG2(benchmark::State& state)
+{
+    const auto& mesh = GetBoxMesh(state.range(0)).mesh;
+    using MeshT = std::decay_t<decltype(mesh)>;
+    using DG = DgNodes<RealT, Vec3D, 3>;
+    constexpr std::size_t CellDimension = MeshT::CellDimension;
+    constexpr auto Dofs = dof::MakeDofs<0, 0, 0, DG::numVolNodes, 0>();
+    constexpr RealT time_step = 1.0E-4;
+
+    drts::Runtime hpm{GetBuffer{}};
+    const HPM::DG::DgNodesMap<DG, MeshT> dg_node_map(mesh);
+    const auto all_cells = mesh.GetEntityRange<CellDimension>();
+    SequentialDispatcher dispatcher;
+
+    auto fieldH = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+    auto fieldE = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+    auto resH = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+    auto resE = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+    auto rhsH = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+    auto rhsE = hpm.GetBuffer<Vec3D>(mesh, Dofs);
+
+    // Initial conditions.
+    dispatcher.Execute(ForEachEntity(all_cells, std::tuple(Write(Cell(fieldE))), [&](const auto& cell, auto&&, auto& lvs) {
+        auto& fieldE = std::get<0>(lvs);
+
+        ForEach(DG::numVolNodes, [&](const std::size_t n) {
+            const auto& coordinates = DG::LocalToGlobal(DG::referenceCoords[n], cell.GetTopology().GetNodes());
+
+            fieldE[n].y = std::sin(M_PI * coordinates.x) * std::sin(M_PI * coordinates.z);
+        });
+    }));
+
+    auto surface_kernel = ForEachIncidence<CellDimension - 1>(
+        all_cells,
+        std::tuple(Read(ContainingMeshElement(fieldH)), Read(ContainingMeshElement(fieldE)), Read(NeighboringMeshElementOrSelf(fieldH)), Read(NeighboringMeshElementOrSelf(fieldE)),
+                   Write(ContainingMeshElement(rhsH)), Write(ContainingMeshElement(rhsE))),
+        [&](const auto& element, const auto& face, const auto&, auto& lvs) {
+            const std::size_t face_index = face.GetTopology().GetLocalIndex();
+            const RealT face_normal_scaling_factor = 2.0 / element.GetGeometry().GetAbsJacobianDeterminant();
+            const Vec3D& face_normal = face.GetGeometry().GetNormal() * face_normal_scaling_factor;
+            const RealT edge = face_normal.Norm() * 0.5;
+            const Vec3D& face_unit_normal = face.GetGeometry().GetUnitNormal();
+            const auto& local_map = dg_node_map.Get(element, face);
+
+            ForEach(DG::NumSurfaceNodes, [&](const std::size_t m) {
+                const auto& fieldH = std::get<0>(lvs);
+                const auto& fieldE = std::get<1>(lvs);
+                auto& neighboring_fieldH = std::get<2>(lvs);
+                auto& neighboring_fieldE = std::get<3>(lvs);
+
+                const Vec3D& dH = edge * HPM::DG::Delta(fieldH, neighboring_fieldH, m, local_map);
+                const Vec3D& dE = edge * HPM::DG::DirectionalDelta(fieldE, neighboring_fieldE, face, m, local_map);
+                const Vec3D& flux_H = (dH - (dH * face_unit_normal) * face_unit_normal - CrossProduct(face_unit_normal, dE));
+                const Vec3D& flux_E = (dE - (dE * face_unit_normal) * face_unit_normal + CrossProduct(face_unit_normal, dH));
+
+                auto& rhsH = std::get<4>(lvs);
+                auto& rhsE = std::get<5>(lvs);
+
+                ForEach(DG::numVolNodes, [&](const std::size_t n) {
+                    rhsH[n] += DG::LIFT[face_index][m][n] * flux_H;
+                    rhsE[n] += DG::LIFT[face_index][m][n] * flux_E;
+                });
+            });
+        },
+        typename Loops::template ForEachIncidence<CellDimension, CellDimension - 1>{});
+
+    auto volume_kernel = ForEachEntity(
+        all_cells, std::tuple(Read(Cell(fieldH)), Read(Cell(fieldE)), Cell(rhsH), Cell(rhsE)),
+        [&](const auto& element, const auto&, auto& lvs) {
+            const Mat3D& D = element.GetGeometry().GetInverseJacobian() * 2.0;
+
+            ForEach(DG::numVolNodes, [&](const std::size_t n) {
+                Mat3D derivative_E, derivative_H;
+
+                const auto& fieldH = std::get<0>(lvs);
+                const auto& fieldE = std::get<1>(lvs);
+
+                ForEach(DG::numVolNodes, [&](const std::size_t m) {
+                    derivative_H += DyadicProduct(DG::derivative[n][m], fieldH[m]);
+                    derivative_E += DyadicProduct(DG::derivative[n][m], fieldE[m]);
+                });
+
+                auto& rhsH = std::get<2>(lvs);
+                auto& rhsE = std::get<3>(lvs);
+
+                rhsH[n] += -Curl(D, derivative_E);
+                rhsE[n] += Curl(D, derivative_H);
+            });
+        },
+        typename Loops::template ForEachEntity<CellDimension>{});
+
+    auto runge_kutta_kernel = ForEachEntity(
+        all_cells, std::tuple(Write(Cell(fieldH)), Write(Cell(fieldE)), Cell(rhsH), Cell(rhsE), Cell(resH), Cell(resE)),
+        [&](const auto&, const auto& iter, auto& lvs) {
+            const auto& rk_stage = RungeKuttaCoeff<RealT>::rk4[iter % 5];
+
+            auto& fieldH = std::get<0>(lvs);
+            auto& fieldE = std::get<1>(lvs);
+            auto& rhsH = std::get<2>(lvs);
+            auto& rhsE = std::get<3>(lvs);
+            auto& resH = std::get<4>(lvs);
+            auto& resE = std::get<5>(lvs);
+
+            ForEach(DG::numVolNodes, [&](const std::size_t n) {
+                resH[n] = rk_stage[0] * resH[n] + time_step * rhsH[n];
+                resE[n] = rk_stage[0] * resE[n] + time_step * rhsE[n];
+                fieldH[n] += rk_stage[1] * resH[n];
+                fieldE[n] += rk_stage[1] * resE[n];
+                assign_to_entries(rhsH[n], 0.0);
+                assign_to_entries(rhsE[n], 0.0);
+            });
+        },
+        typename Loops::template ForEachEntity<CellDimension>{});
+
+    for (auto _ : state)
+    {
+        if constexpr (K == Kernel::Surface)
+        {
+            dispatcher.Execute(surface_kernel);
+        }
+        else if constexpr (K == Kernel::Volume)
+        {
+            dispatcher.Execute(volume_kernel);
+        }
+        else if constexpr (K == Kernel::RungeKutta)
+        {
+            dispatcher.Execute(runge_kutta_kernel);
+        }
+        else
+        {
+            dispatcher.Execute(surface_kernel, volume_kernel, runge_kutta_kernel);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+    state.counters["cells"] = mesh.GetNumEntities();
+}
+
+BENCHMARK_TEMPLATE(MIDG2, Kernel::Surface, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::Surface, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::Volume, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::Volume, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::RungeKutta, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::RungeKutta, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::All, DefaultLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MIDG2, Kernel::All, OpenMPLoops)->Apply(BoxMeshSizes)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,137 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+
+template <typename GeometryCachePolicy>
+using MeshWithPolicy = mesh::Mesh<CoordinateT, entity::Simplex, 3, GeometryCachePolicy>;
+
+//!
+//! \brief Time the setup of the geometry information (normals, orientations and the geometry cache) of a tetrahedral box mesh.
+//!
+template <typename GeometryCachePolicy>
+static void GeometrySetup(benchmark::State& state)
+{
+    using MeshT = MeshWithPolicy<GeometryCachePolicy>;
+
+    const std::size_t extent = state.range(0);
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+    MeshT mesh{box_mesh.nodes, box_mesh.simplices};
+
+    for (auto _ : state)
+    {
+        MeshT::CellT::Geometry::SetupGeometry(mesh);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+    state.counters["cells"] = mesh.GetNumEntities();
+    state.counters["cache_bytes"] = mesh.GetGeometryCacheSize();
+}
+
+//!
+//! \brief Time the construction of a tetrahedral box mesh, including its topology and geometry setup.
+//!
+//! Without geometry cache, the construction time is dominated by the topology setup.
+//!
+template <typename GeometryCachePolicy>
+static void MeshConstruction(benchmark::State& state)
+{
+    using MeshT = MeshWithPolicy<GeometryCachePolicy>;
+
+    const std::size_t extent = state.range(0);
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+
+    for (auto _ : state)
+    {
+        MeshT mesh{box_mesh.nodes, box_mesh.simplices};
+        benchmark::DoNotOptimize(mesh);
+    }
+
+    state.SetItemsProcessed(state.iterations() * box_mesh.simplices.size());
+    state.counters["cells"] = box_mesh.simplices.size();
+}
+
+//!
+//! \brief Time the refresh of the geometry information after the nodes have been moved.
+//!
+template <typename GeometryCachePolicy>
+static void UpdateNodes(benchmark::State& state)
+{
+    using MeshT = MeshWithPolicy<GeometryCachePolicy>;
+
+    const std::size_t extent = state.range(0);
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+    MeshT mesh{box_mesh.nodes, box_mesh.simplices};
+    std::vector<CoordinateT> nodes = box_mesh.nodes;
+    double scale = 1.0;
+
+    for (auto _ : state)
+    {
+        scale *= -1.0;
+
+        for (auto& node : nodes)
+        {
+            node[0] *= scale;
+        }
+
+        mesh.UpdateNodes(nodes);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+    state.counters["cells"] = mesh.GetNumEntities();
+}
+
+//!
+//! \brief Time the refresh of the geometry information after a few nodes (1 percent) have been moved.
+//!
+template <typename GeometryCachePolicy>
+static void UpdateSomeNodes(benchmark::State& state)
+{
+    using MeshT = MeshWithPolicy<GeometryCachePolicy>;
+
+    const std::size_t extent = state.range(0);
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+    MeshT mesh{box_mesh.nodes, box_mesh.simplices};
+    std::vector<CoordinateT> nodes = box_mesh.nodes;
+    double scale = 1.0;
+
+    for (auto _ : state)
+    {
+        scale *= -1.0;
+
+        for (std::size_t i = 0; i < nodes.size(); i += 100)
+        {
+            nodes[i][0] *= scale;
+        }
+
+        mesh.UpdateNodes(nodes);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.GetNumEntities());
+    state.counters["cells"] = mesh.GetNumEntities();
+}
+
+BENCHMARK_TEMPLATE(GeometrySetup, mesh::CacheAllGeometry)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(GeometrySetup, mesh::CacheAllGeometryAsFloat)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(GeometrySetup, mesh::ComputeGeometryOnTheFly)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(UpdateNodes, mesh::CacheAllGeometry)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(UpdateSomeNodes, mesh::CacheAllGeometry)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MeshConstruction, mesh::CacheAllGeometry)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(MeshConstruction, mesh::ComputeGeometryOnTheFly)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
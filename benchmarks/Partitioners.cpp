@@ -0,0 +1,136 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/drts/data_flow/DataDependencyMaps.hpp>
+#include <HighPerMeshes/dsl/meshes/PartitionedMesh.hpp>
+#include <HighPerMeshes/third_party/metis/Partitioner.hpp>
+
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+
+using PartitionedMesh = mesh::PartitionedMesh<BoxMesh::CoordinateT, entity::Simplex>;
+
+//!
+//! \brief Time the two-level partitioning (and reordering) of the nodes and cells of a tetrahedral box mesh.
+//!
+//! The second benchmark argument is the number of L2 partitions (one L1 partition).
+//!
+//! \tparam PartitionerT the partitioner type
+//!
+template <typename PartitionerT>
+static void CreatePartitions(benchmark::State& state)
+{
+    const BoxMesh& box_mesh = GetBoxMesh(state.range(0));
+    const std::pair<std::size_t, std::size_t> num_partitions{1, state.range(1)};
+    PartitionerT partitioner;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto nodes = box_mesh.nodes;
+        auto simplices = box_mesh.simplices;
+        state.ResumeTiming();
+
+        auto&& partitions = partitioner.template CreatePartitions<3>(std::move(nodes), std::move(simplices), num_partitions);
+
+        benchmark::DoNotOptimize(partitions);
+    }
+
+    state.SetItemsProcessed(state.iterations() * box_mesh.simplices.size());
+}
+
+//!
+//! \brief Time the construction of a partitioned mesh: partitioning, topology and geometry setup, and the partition bookkeeping.
+//!
+//! With a geometric partitioner, the time is dominated by the mesh setup rather than by the partitioning itself.
+//!
+//! \tparam PartitionerT the partitioner type
+//!
+template <typename PartitionerT>
+static void PartitionedMeshConstruction(benchmark::State& state)
+{
+    const BoxMesh& box_mesh = GetBoxMesh(state.range(0));
+    const std::pair<std::size_t, std::size_t> num_partitions{1, state.range(1)};
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto nodes = box_mesh.nodes;
+        auto simplices = box_mesh.simplices;
+        state.ResumeTiming();
+
+        PartitionedMesh mesh{std::move(nodes), std::move(simplices), num_partitions, 0, PartitionerT{}};
+
+        benchmark::DoNotOptimize(mesh.GetNumL2Partitions());
+    }
+
+    state.SetItemsProcessed(state.iterations() * box_mesh.simplices.size());
+}
+
+//!
+//! \brief Time the computation of the data dependency map of the face neighbors of a partitioned mesh.
+//!
+static void DataDependencyMapConstruction(benchmark::State& state)
+{
+    const BoxMesh& box_mesh = GetBoxMesh(state.range(0));
+    const std::pair<std::size_t, std::size_t> num_partitions{1, state.range(1)};
+    const PartitionedMesh mesh{std::vector(box_mesh.nodes), std::vector(box_mesh.simplices), num_partitions, 0, mesh::RcbPartitioner{}};
+
+    for (auto _ : state)
+    {
+        const drts::data_flow::DataDependencyMap<3> map{mesh, AccessPatterns::NeighboringMeshElementOrSelfPattern, internal::ForEachIncidence<3, 2>{}};
+
+        benchmark::DoNotOptimize(map.GetNumL2Partitions());
+    }
+
+    state.SetItemsProcessed(state.iterations() * box_mesh.simplices.size());
+}
+
+//!
+//! \brief Time the loading of the data dependency map of the face neighbors of a partitioned mesh from a file.
+//!
+static void DataDependencyMapLoad(benchmark::State& state)
+{
+    const BoxMesh& box_mesh = GetBoxMesh(state.range(0));
+    const std::pair<std::size_t, std::size_t> num_partitions{1, state.range(1)};
+    const PartitionedMesh mesh{std::vector(box_mesh.nodes), std::vector(box_mesh.simplices), num_partitions, 0, mesh::RcbPartitioner{}};
+
+    drts::data_flow::DataDependencyMap<3>{mesh, AccessPatterns::NeighboringMeshElementOrSelfPattern, internal::ForEachIncidence<3, 2>{}}.Save("benchmark.ddm", mesh);
+
+    for (auto _ : state)
+    {
+        const auto& map = drts::data_flow::DataDependencyMap<3>::Load("benchmark.ddm", mesh, AccessPatterns::NeighboringMeshElementOrSelfPattern, internal::ForEachIncidence<3, 2>{});
+
+        benchmark::DoNotOptimize(map.GetNumL2Partitions());
+    }
+
+    std::remove("benchmark.ddm");
+    state.SetItemsProcessed(state.iterations() * box_mesh.simplices.size());
+}
+
+//!
+//! \brief Register the mesh sizes and numbers of L2 partitions.
+//!
+static void PartitionSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgsProduct({{8, 16, 32}, {4, 16}})->ArgNames({"extent", "L2"});
+}
+
+BENCHMARK_TEMPLATE(CreatePartitions, mesh::SimplePartitioner)->ArgsProduct({{8, 16, 32}, {1}})->ArgNames({"extent", "L2"})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(CreatePartitions, mesh::MetisPartitioner)->Apply(PartitionSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(CreatePartitions, mesh::RcbPartitioner)->Apply(PartitionSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(PartitionedMeshConstruction, mesh::MetisPartitioner)->Args({8, 4})->Args({16, 4})->ArgNames({"extent", "L2"})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(PartitionedMeshConstruction, mesh::RcbPartitioner)->Args({16, 16})->Args({32, 16})->Args({32, 64})->ArgNames({"extent", "L2"})->Unit(benchmark::kMillisecond);
+BENCHMARK(DataDependencyMapConstruction)->Args({16, 16})->Args({32, 64})->ArgNames({"extent", "L2"})->Unit(benchmark::kMillisecond);
+BENCHMARK(DataDependencyMapLoad)->Args({16, 16})->Args({32, 64})->ArgNames({"extent", "L2"})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,125 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "util/BoxMesh.hpp"
+
+using namespace HPM;
+
+using CoordinateT = BoxMesh::CoordinateT;
+using CellNodeIndicesT = std::array<std::size_t, 4>;
+
+//!
+//! \brief Write a tetrahedral box mesh to a 'GAMBIT neutral' file (only the sections the reader needs).
+//!
+//! \param extent the number of nodes per dimension
+//! \return the name of the file
+//!
+static auto WriteGambitFile(const std::size_t extent) -> std::string
+{
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+    const std::string filename = (std::filesystem::temp_directory_path() / ("hpm_benchmark_box_" + std::to_string(extent) + ".neu")).string();
+    std::ofstream file(filename);
+
+    file << "        CONTROL INFO 2.0.0\n** GAMBIT NEUTRAL FILE\n"
+         << "     NUMNP     NELEM     NGRPS    NBSETS     NDFCD     NDFVL\n"
+         << box_mesh.nodes.size() << " " << box_mesh.simplices.size() << " 1 0 3 3\nENDOFSECTION\n"
+         << "   NODAL COORDINATES 2.0.0\n";
+    file.precision(17);
+
+    for (std::size_t i = 0; i < box_mesh.nodes.size(); ++i)
+    {
+        file << (i + 1) << " " << box_mesh.nodes[i].x << " " << box_mesh.nodes[i].y << " " << box_mesh.nodes[i].z << "\n";
+    }
+
+    file << "ENDOFSECTION\n      ELEMENTS/CELLS 2.0.0\n";
+
+    for (std::size_t i = 0; i < box_mesh.simplices.size(); ++i)
+    {
+        const auto& simplex = box_mesh.simplices[i];
+
+        file << (i + 1) << " 6 4 " << (simplex[0] + 1) << " " << (simplex[1] + 1) << " " << (simplex[2] + 1) << " " << (simplex[3] + 1) << "\n";
+    }
+
+    file << "ENDOFSECTION\n";
+
+    return filename;
+}
+
+//!
+//! \brief Write a tetrahedral box mesh to an Amira mesh file (only the sections the reader needs).
+//!
+//! \param extent the number of nodes per dimension
+//! \return the name of the file
+//!
+static auto WriteAmiraFile(const std::size_t extent) -> std::string
+{
+    const BoxMesh& box_mesh = GetBoxMesh(extent);
+    const std::string filename = (std::filesystem::temp_directory_path() / ("hpm_benchmark_box_" + std::to_string(extent) + ".am")).string();
+    std::ofstream file(filename);
+
+    file << "# AmiraMesh 3D ASCII 2.0\n\n"
+         << "nNodes " << box_mesh.nodes.size() << "\n"
+         << "nTetrahedra " << box_mesh.simplices.size() << "\n\n"
+         << "@1\n";
+    file.precision(17);
+
+    for (const auto& node : box_mesh.nodes)
+    {
+        file << node.x << " " << node.y << " " << node.z << "\n";
+    }
+
+    file << "\n@3\n";
+
+    for (const auto& simplex : box_mesh.simplices)
+    {
+        file << (simplex[0] + 1) << " " << (simplex[1] + 1) << " " << (simplex[2] + 1) << " " << (simplex[3] + 1) << "\n";
+    }
+
+    return filename;
+}
+
+//!
+//! \brief Time reading the nodes and cells of a tetrahedral box mesh from a file.
+//!
+//! \tparam ReaderT the mesh file reader
+//! \param state the benchmark state
+//! \param filename the name of the mesh file
+//!
+template <template <typename, typename> class ReaderT>
+static void ReadMeshFile(benchmark::State& state, const std::string& filename)
+{
+    std::size_t num_cells = 0;
+
+    for (auto _ : state)
+    {
+        auto&& fields = ReaderT<CoordinateT, CellNodeIndicesT>().ReadNodesAndElements(filename);
+
+        num_cells = std::get<1>(fields).size();
+        benchmark::DoNotOptimize(fields);
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_cells);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(filename));
+    state.counters["cells"] = num_cells;
+
+    std::filesystem::remove(filename);
+}
+
+static void GambitReader(benchmark::State& state) { ReadMeshFile<auxiliary::GambitMeshFileReader>(state, WriteGambitFile(state.range(0))); }
+
+static void AmiraReader(benchmark::State& state) { ReadMeshFile<auxiliary::AmiraMeshFileReader>(state, WriteAmiraFile(state.range(0))); }
+
+BENCHMARK(GambitReader)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(AmiraReader)->Apply(BoxMeshSizes)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,108 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef BENCHMARKS_UTIL_BOXMESH_HPP
+#define BENCHMARKS_UTIL_BOXMESH_HPP
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <HighPerMeshes.hpp>
+
+//!
+//! \brief Register the mesh sizes used by the benchmarks.
+//!
+//! The argument of a benchmark is the number of nodes per dimension of a tetrahedral box mesh (6 tetrahedra per unit cube):
+//! 8, 16 and 32 nodes result in about 2k, 20k and 179k cells.
+//!
+//! \param benchmark the benchmark to be configured
+//!
+inline auto BoxMeshSizes(benchmark::internal::Benchmark* benchmark) -> void
+{
+    for (const std::int64_t extent : {8, 16, 32})
+    {
+        benchmark->Arg(extent);
+    }
+
+    benchmark->ArgName("extent");
+}
+
+//!
+//! \brief A tetrahedral box mesh with unit spacing, created by the `BoxMeshGenerator` (conforming).
+//!
+//! Nodes and cells are kept, so benchmarks can create their own meshes (or files) from them.
+//!
+struct BoxMesh
+{
+    using CoordinateT = ::HPM::dataType::Vec<double, 3>;
+    using MeshT = ::HPM::mesh::Mesh<CoordinateT, ::HPM::entity::Simplex>;
+
+    //!
+    //! \brief Constructor.
+    //!
+    //! \param extent the number of nodes per dimension
+    //!
+    BoxMesh(const std::size_t extent)
+        : generator({extent - 1, extent - 1, extent - 1}), nodes(generator.CreateNodes()), simplices(generator.CreateCells()), mesh{nodes, simplices}
+    {
+    }
+
+    const ::HPM::mesh::BoxMeshGenerator<CoordinateT> generator;
+    const std::vector<CoordinateT> nodes;
+    const std::vector<std::array<std::size_t, 4>> simplices;
+    const MeshT mesh;
+};
+
+//!
+//! \brief Get a tetrahedral box mesh.
+//!
+//! Meshes are created on first use and shared among all benchmarks, so the mesh setup is not part of the measurements.
+//!
+//! \param extent the number of nodes per dimension
+//! \return a reference to the box mesh holding the nodes, the cells and the mesh
+//!
+inline auto GetBoxMesh(const std::size_t extent) -> const BoxMesh&
+{
+    static std::map<std::size_t, std::unique_ptr<const BoxMesh>> box_meshes;
+    auto& box_mesh = box_meshes[extent];
+
+    if (!box_mesh)
+    {
+        box_mesh = std::make_unique<const BoxMesh>(extent);
+    }
+
+    return *box_mesh;
+}
+
+//!
+//! \brief Loop implementations of the DSL: the sequential default ones.
+//!
+struct DefaultLoops
+{
+    template <std::size_t Dimension>
+    using ForEachEntity = ::HPM::internal::ForEachEntity<Dimension>;
+
+    template <std::size_t Dimension, std::size_t SubDimension>
+    using ForEachIncidence = ::HPM::internal::ForEachIncidence<Dimension, SubDimension>;
+};
+
+//!
+//! \brief Loop implementations of the DSL: the OpenMP ones.
+//!
+struct OpenMPLoops
+{
+    template <std::size_t Dimension>
+    using ForEachEntity = ::HPM::internal::OpenMP_ForEachEntity<Dimension>;
+
+    template <std::size_t Dimension, std::size_t SubDimension>
+    using ForEachIncidence = ::HPM::internal::OpenMP_ForEachIncidence<Dimension, SubDimension>;
+};
+
+#endif
@@ -0,0 +1,207 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+//!
+//! Critical-path and parallelism analysis of a data flow schedule.
+//!
+//! Usage: graphAnalysis <tasks file | -> [--workers N] [--steps N] [--reduce] [--dot FILE] [--json FILE]
+//!
+//! The tasks file describes one step of the schedule in execution order, one statement per line:
+//!
+//!     task [duration]         adds a task (vertex), with a duration in seconds (default: 1)
+//!     read <dependency>       the last task reads the dependency
+//!     write <dependency>      the last task writes the dependency
+//!     readwrite <dependency>  the last task reads and writes the dependency
+//!
+//! Dependencies are arbitrary names (e.g., "fieldH:3" for partition 3 of the buffer fieldH), and lines starting with '#' are ignored.
+//! The analysis (critical path, parallelism per level, idle time of a list schedule) is written to the standard output,
+//! the graph with the highlighted critical path as DOT, and the analysis as JSON.
+//!
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <HighPerMeshes/drts/data_flow/GraphAnalysis.hpp>
+
+using namespace HPM;
+using namespace HPM::drts::data_flow;
+
+//!
+//! \brief Read the tasks and their accesses into a graph.
+//!
+//! \param stream the input stream
+//! \param graph the graph (not finalized)
+//! \return the duration of each task, indexed by the vertex
+//!
+static auto ReadTasks(std::istream& stream, Graph<std::string>& graph) -> std::vector<double>
+{
+    std::vector<double> durations(1, 0.0);
+    std::string line;
+    std::size_t line_number = 0;
+
+    while (std::getline(stream, line))
+    {
+        std::istringstream tokens(line);
+        std::string keyword;
+        std::string dependency;
+
+        ++line_number;
+
+        if (!(tokens >> keyword) || keyword[0] == '#')
+        {
+            continue;
+        }
+
+        if (keyword == "task")
+        {
+            double duration = 1.0;
+            std::string rest;
+
+            // The duration is optional, but if given, it must be a non-negative number (and nothing else).
+            if ((!(tokens >> std::ws).eof() && !(tokens >> duration)) || duration < 0.0 || (tokens >> rest))
+            {
+                throw std::runtime_error("error: line " + std::to_string(line_number) + ": expected a non-negative duration after the task");
+            }
+
+            durations.resize(graph.AddVertex() + 1, 0.0);
+            durations.back() = duration;
+
+            continue;
+        }
+
+        if (durations.size() == 1 || !(tokens >> dependency))
+        {
+            throw std::runtime_error("error: line " + std::to_string(line_number) + ": expected a task before the access, and a dependency");
+        }
+
+        if (keyword == "read")
+        {
+            graph.AddDependency(durations.size() - 1, dependency, AccessMode::Read);
+        }
+        else if (keyword == "write")
+        {
+            graph.AddDependency(durations.size() - 1, dependency, AccessMode::Write);
+        }
+        else if (keyword == "readwrite")
+        {
+            graph.AddDependency(durations.size() - 1, dependency, AccessMode::ReadWrite);
+        }
+        else
+        {
+            throw std::runtime_error("error: line " + std::to_string(line_number) + ": unknown statement: " + keyword);
+        }
+    }
+
+    return durations;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <tasks file | -> [--workers N] [--steps N] [--reduce] [--dot FILE] [--json FILE]" << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const std::string input = argv[1];
+        std::size_t num_workers = 1;
+        std::size_t num_steps = 1;
+        bool reduce = false;
+        std::string dot_file;
+        std::string json_file;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            const std::string option = argv[i];
+
+            if (option == "--reduce")
+            {
+                reduce = true;
+            }
+            else if (i + 1 < argc && option == "--workers")
+            {
+                num_workers = std::stoul(argv[++i]);
+            }
+            else if (i + 1 < argc && option == "--steps")
+            {
+                num_steps = std::stoul(argv[++i]);
+            }
+            else if (i + 1 < argc && option == "--dot")
+            {
+                dot_file = argv[++i];
+            }
+            else if (i + 1 < argc && option == "--json")
+            {
+                json_file = argv[++i];
+            }
+            else
+            {
+                throw std::runtime_error("error: unknown option: " + option);
+            }
+        }
+
+        Graph<std::string> graph;
+        std::vector<double> durations;
+
+        if (input == "-")
+        {
+            durations = ReadTasks(std::cin, graph);
+        }
+        else
+        {
+            std::ifstream file(input);
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not open file: " + input);
+            }
+
+            durations = ReadTasks(file, graph);
+        }
+
+        graph.Finalize();
+
+        std::cout << "tasks: " << graph.GetVertices().size() << ", edges: " << graph.GetEdges().size() << std::endl;
+
+        if (reduce)
+        {
+            std::cout << "removed edges (transitive reduction): " << graph.ReduceTransitively() << std::endl;
+        }
+
+        const auto& analysis = AnalyzeSchedule(graph, durations, num_workers, num_steps);
+
+        analysis.WriteText(std::cout);
+
+        if (!dot_file.empty())
+        {
+            std::ofstream file(dot_file);
+
+            analysis.WriteDot(file, graph);
+        }
+
+        if (!json_file.empty())
+        {
+            std::ofstream file(json_file);
+
+            analysis.WriteJson(file);
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -89,8 +89,6 @@ int main(int, char**)
     auto maint2 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> setup_duration = maint2 - maint1;
     std::cout << "Setup time in seconds: " << setup_duration.count() << std::endl;
-    double aggregate_time1 = 0.0, aggregate_time2 = 0.0, aggregate_time3 = 0.0;
-
     /** \brief outer time step loop, Runge-Kutta loop, maxwell's kernels (surface and volume) and Runge-Kutta kernel  */
 
     /** \brief determine time step size (polynomial order-based and algorithmic-specific) */
@@ -110,9 +108,11 @@ int main(int, char**)
     timeStep = finalTime / floor(finalTime * (order + 1) * (order + 1)/(.5 * timeStep) );
     std::cout << "time step: " << timeStep << std::endl;
 
-    {
-        auto t1 = std::chrono::high_resolution_clock::now();
+    /** \brief the kernels of the time step loop are timed by the dispatcher: per step, per thread and per partition */
+    HPM::SequentialDispatcher<HPM::RooflineTimer> timed_body;
+    const std::size_t num_steps = static_cast<std::size_t>(((finalTime - startTime) / timeStep) * 5);
 
+    {
         /** \brief Maxwell's surface kernel */
         auto surfaceKernelLoop = HPM::ForEachIncidence<2>(
             AllCells,
@@ -156,10 +156,6 @@ int main(int, char**)
                 });
             });
 
-        auto t2 = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> duration = t2 - t1;
-        aggregate_time1 += duration.count();
-        t1 = std::chrono::high_resolution_clock::now();
 
         /** \brief Maxwell's volume kernel */
         auto volumeKernelLoop = HPM::ForEachEntity(
@@ -191,10 +187,6 @@ int main(int, char**)
                 });
             });
 
-        t2 = std::chrono::high_resolution_clock::now();
-        duration = t2 - t1;
-        aggregate_time2 += duration.count();
-        t1 = std::chrono::high_resolution_clock::now();
 
         /** \brief Runge-Kutta integrtion kernel */
         auto rungeKuttaLoop =
@@ -227,21 +219,33 @@ int main(int, char**)
                     });
                 });
 
-        body.Execute( HPM::iterator::Range<size_t> { static_cast<std::size_t>(((finalTime - startTime) / timeStep) * 5) },
-                        surfaceKernelLoop, volumeKernelLoop, rungeKuttaLoop);
-
-        t2 = std::chrono::high_resolution_clock::now();
-        duration = t2 - t1;
-        aggregate_time3 += duration.count();
+        timed_body.Execute(HPM::iterator::Range<size_t>{num_steps}, surfaceKernelLoop, volumeKernelLoop, rungeKuttaLoop);
     }
+
+    auto& timer = timed_body.GetInstrumentation();
+
+    timer.SetLoopName(0, 0, "surface kernel");
+    timer.SetLoopName(0, 1, "volume kernel");
+    timer.SetLoopName(0, 2, "runge-kutta kernel");
+
+    const double aggregate_time1 = std::chrono::duration<double>(timer.GetWallTime(0, 0)).count();
+    const double aggregate_time2 = std::chrono::duration<double>(timer.GetWallTime(0, 1)).count();
+    const double aggregate_time3 = std::chrono::duration<double>(timer.GetWallTime(0, 2)).count();
+
     std::cout << "Aggregate execution time for Surface kernel       = " << aggregate_time1 * 1000 << " ms" << std::endl;
     std::cout << "Aggregate execution time for Volume kernel        = " << aggregate_time2 * 1000 << " ms" << std::endl;
     std::cout << "Aggregate execution time for RK kernel            = " << aggregate_time3 * 1000 << " ms" << std::endl;
     std::cout << "Aggregate all kernel execution time               = " << (aggregate_time1 + aggregate_time2 + aggregate_time3) * 1000 << " ms" << std::endl;
-    std::cout << "Individual Execution time of Surface kernel       = " << (aggregate_time1 * 1000) / (finalTime / timeStep * 5) << " ms" << std::endl;
-    std::cout << "Individual Execution time of Volume kernel        = " << (aggregate_time2 * 1000) / (finalTime / timeStep * 5) << " ms" << std::endl;
-    std::cout << "Individual Execution time of RK kernel            = " << (aggregate_time3 * 1000) / (finalTime / timeStep * 5) << " ms" << std::endl;
-    std::cout << "Individual all kernel execution time              = " << ((aggregate_time1 + aggregate_time2 + aggregate_time3) * 1000) / (finalTime / timeStep * 5) << " ms" << std::endl;
+    std::cout << "Individual Execution time of Surface kernel       = " << (aggregate_time1 * 1000) / num_steps << " ms" << std::endl;
+    std::cout << "Individual Execution time of Volume kernel        = " << (aggregate_time2 * 1000) / num_steps << " ms" << std::endl;
+    std::cout << "Individual Execution time of RK kernel            = " << (aggregate_time3 * 1000) / num_steps << " ms" << std::endl;
+    std::cout << "Individual all kernel execution time              = " << ((aggregate_time1 + aggregate_time2 + aggregate_time3) * 1000) / num_steps << " ms" << std::endl;
+
+    /** \brief achieved bandwidth of the kernels relative to the STREAM bandwidth */
+    timer.WriteRooflineReport(std::cout, HPM::MeasureStreamBandwidth());
+
+    /** \brief per-thread timeline of the kernels (chrome://tracing or https://ui.perfetto.dev) */
+    timer.WriteChromeTrace("midg2_trace.json");
     
     /** \brief find maximum & minimum values for Ey*/
     double maxErrorEy = 0;
@@ -6,8 +6,9 @@ int main() {
 
     using namespace HPM;
 
-    std::mutex mutex;
-    std::ofstream fstream { "output.txt" };
+    // One file per buffer: the entity indices of cells and nodes overlap.
+    AsyncBinaryWriter cell_writer { "cells.bin" };
+    AsyncBinaryWriter node_writer { "nodes.bin" };
 
     drts::Runtime hpm{
         GetBuffer{}
@@ -34,7 +35,7 @@ int main() {
 
             bufferAccess[dof] = 1;
         }),
-        WriteLoop(mutex, fstream, cells, cell_buffer)
+        WriteLoop(cell_writer, cells, cell_buffer)
     );
 
     constexpr auto node_dofs= dof::MakeDofs<1, 0, 0, 0, 0>();
@@ -53,7 +54,10 @@ int main() {
 
             bufferAccess[dof] = 1;
         }),
-        WriteLoop(mutex, fstream, nodes, node_buffer)
+        WriteLoop(node_writer, nodes, node_buffer)
     );
 
+    cell_writer.Flush();
+    node_writer.Flush();
+
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <HighPerMeshes/drts/DataFlow.hpp>
 #include <HighPerMeshes/drts/GetBuffer.hpp>
 #include <HighPerMeshes/drts/GetDistributedBuffer.hpp>
+#include <HighPerMeshes/drts/HaloExchangePlan.hpp>
 #include <HighPerMeshes/drts/Runtime.hpp>
 
 #endif
\ No newline at end of file
@@ -6,12 +6,21 @@
 #ifndef COMMON_ITERATOR_HPP
 #define COMMON_ITERATOR_HPP
 
+#include <array>
 #include <cassert>
 #include <iterator>
 #include <set>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+namespace HPM::entity
+{
+    // Forward declaration.
+    template <typename>
+    class EntityHandle;
+}
+
 namespace HPM::iterator
 {
     //!
@@ -210,6 +219,8 @@ namespace HPM::iterator
             public:
             // Template arguments.
             using EntityT = EntityT_;
+            // Deduced types and constants.
+            using HandleT = ::HPM::entity::EntityHandle<EntityT>;
 
             //!
             //! \brief Constructor.
@@ -297,6 +308,35 @@ namespace HPM::iterator
             //!
             inline auto operator[](int index) const -> EntityT { return {mesh, value + index, value + index, containing_mesh_entity_index}; }
 
+            //!
+            //! \brief Get a handle to an entity.
+            //!
+            //! This function does the same as the array subscript operator, but it creates an index-only handle instead of the entity.
+            //!
+            //! \param offset shift to be applied to the internal state
+            //! \return a handle to the entity according to the iterator state shifted by `offset`
+            //!
+            inline auto GetHandle(const std::size_t offset = 0) const -> HandleT { return {mesh, value + offset, value + offset, containing_mesh_entity_index}; }
+
+            //!
+            //! \brief Get handles to the next `N` entities.
+            //!
+            //! \tparam N the number of handles
+            //! \return an array of handles to the entities according to the iterator state shifted by `0..N-1`
+            //!
+            template <std::size_t N>
+            inline auto GetHandles() const -> std::array<HandleT, N>
+            {
+                std::array<HandleT, N> handles;
+
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    handles[i] = GetHandle(i);
+                }
+
+                return handles;
+            }
+
             protected:
             const MeshT& mesh;
             std::size_t value;
@@ -326,21 +366,21 @@ namespace HPM::iterator
             // Template arguments.
             using EntityT = EntityT_;
             // Deduced types and constants.
+            using HandleT = typename Base::HandleT;
             static constexpr bool IsCell = (EntityT::Dimension == MeshT::CellDimension);
 
             //!
             //! \brief Constructor.
             //!
             //! Creates a forward iterator with its initial state set to `value` and with an index field for the entity indexing.
-            //! This constructor does not take ownership of the index set.
-            //! It is used in all cases where a reference to a non-temporary field is provided.
+            //! This constructor does not take ownership of the index field: it must outlive the iterator.
             //!
             //! \param mesh the associated mesh
             //! \param value the initial state of the iterator: used for the increment operation
-            //! \param index_set a container holding the indices of the entities
+            //! \param index_set a pointer to the contiguous index field holding the indices of the entities
             //! \param containing_mesh_entity_index the index of the containing mesh entity
             //!
-            IndexedEntityIterator(const MeshT& mesh, const std::size_t value, const std::vector<std::size_t>& index_set, const std::size_t containing_mesh_entity_index = MeshT::InvalidIndex)
+            IndexedEntityIterator(const MeshT& mesh, const std::size_t value, const std::size_t* index_set, const std::size_t containing_mesh_entity_index = MeshT::InvalidIndex)
                 : Base(mesh, value, containing_mesh_entity_index), index_set(index_set)
             {
             }
@@ -414,14 +454,128 @@ namespace HPM::iterator
                 }
             }
 
+            //!
+            //! \brief Get a handle to an entity.
+            //!
+            //! This function does the same as the array subscript operator, but it creates an index-only handle instead of the entity.
+            //!
+            //! \param offset shift to be applied to the internal state
+            //! \return a handle to the entity according to the iterator state shifted by `offset` and the index field entry
+            //!
+            inline auto GetHandle(const std::size_t offset = 0) const -> HandleT
+            {
+                if constexpr (IsCell || AssignIndex)
+                {
+                    return {mesh, index_set[value + offset], index_set[value + offset], containing_mesh_entity_index};
+                }
+                else
+                {
+                    return {mesh, value + offset, index_set[value + offset], containing_mesh_entity_index};
+                }
+            }
+
+            //!
+            //! \brief Get handles to the next `N` entities.
+            //!
+            //! \tparam N the number of handles
+            //! \return an array of handles to the entities according to the iterator state shifted by `0..N-1`
+            //!
+            template <std::size_t N>
+            inline auto GetHandles() const -> std::array<HandleT, N>
+            {
+                std::array<HandleT, N> handles;
+
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    handles[i] = GetHandle(i);
+                }
+
+                return handles;
+            }
+
             protected:
             using Base::containing_mesh_entity_index;
             using Base::mesh;
             using Base::value;
-            const std::vector<std::size_t>& index_set;
+            const std::size_t* index_set;
         };
     } // namespace internal
 
+    //!
+    //! \brief A non-owning view of a contiguous index field.
+    //!
+    //! The index field is not copied: it must outlive the view.
+    //! Use it for index fields that are stored in the mesh or in any other persistent data structure.
+    //!
+    class IndexSpan
+    {
+        public:
+        IndexSpan() = default;
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param data a pointer to the first element of the index field
+        //! \param size the number of elements in the index field
+        //!
+        IndexSpan(const std::size_t* data, const std::size_t size) : ptr(data), extent(size) {}
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param indices a container holding the indices
+        //!
+        IndexSpan(const std::vector<std::size_t>& indices) : IndexSpan(indices.data(), indices.size()) {}
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! \tparam N the extent of the index array
+        //! \param indices an array holding the indices
+        //!
+        template <std::size_t N>
+        IndexSpan(const std::array<std::size_t, N>& indices) : IndexSpan(indices.data(), N)
+        {
+        }
+
+        //!
+        //! \brief Get a pointer to the first element of the index field.
+        //!
+        //! \return a pointer to the first element of the index field
+        //!
+        inline auto data() const -> const std::size_t* { return ptr; }
+
+        //!
+        //! \brief Get the number of elements in the index field.
+        //!
+        //! \return the number of elements in the index field
+        //!
+        inline auto size() const { return extent; }
+
+        //!
+        //! \brief Test for an empty index field.
+        //!
+        //! \return `true` if the index field has no elements
+        //!
+        inline auto empty() const { return (extent == 0); }
+
+        //!
+        //! \brief Array subscript operator.
+        //!
+        //! \param index the position of the element
+        //! \return the element at the specified position
+        //!
+        inline auto operator[](const std::size_t index) const { return ptr[index]; }
+
+        inline auto begin() const { return ptr; }
+
+        inline auto end() const { return ptr + extent; }
+
+        private:
+        const std::size_t* ptr = nullptr;
+        std::size_t extent = 0;
+    };
+
     //!
     //! \brief A forward iterator range over mesh entities.
     //!
@@ -484,12 +638,17 @@ namespace HPM::iterator
     //! \brief A forward iterator range over mesh entities.
     //!
     //! An index field for the entity creation is used.
+    //! The storage of the index field is determined by `IndexSetT`:
+    //!     - `IndexSpan` (default): a non-owning view, e.g., into the mesh's own index lists (no copy, no allocation)
+    //!     - `std::array<std::size_t, N>`: an inline fixed-size array, e.g., for the sub-entities of an entity (no allocation)
+    //!     - `std::vector<std::size_t>`: an owning container for index sets that are computed on the fly
     //!
     //! \tparam EntityT the type of the entity
     //! \tparam MeshT the mesh type
     //! \tparam AssignIndex a parameter to control the local entity-index assignment
+    //! \tparam IndexSetT the type of the index field
     //!
-    template <typename EntityT_, typename MeshT, bool AssignIndex = false>
+    template <typename EntityT_, typename MeshT, bool AssignIndex = false, typename IndexSetT = IndexSpan>
     class IndexedEntityRange
     {
         public:
@@ -506,25 +665,10 @@ namespace HPM::iterator
         //! The size of the index field specifies the end index of the iterator range.
         //!
         //! \param mesh the associated mesh
-        //! \param index_set a container holding the indices of the entities
-        //! \param containing_mesh_entity_index the index of the containing mesh entity
-        //!
-        IndexedEntityRange(const MeshT& mesh, const std::vector<std::size_t>& index_set, const std::size_t containing_mesh_entity_index = MeshT::InvalidIndex)
-            : mesh { mesh }, index_set { index_set }, containing_mesh_entity_index { containing_mesh_entity_index }
-        {
-        }
-        //!
-        //! \brief Constructor.
-        //!
-        //! Creates a forward iterator range over entities with local index between zero and the size of the index field, and (global) index according to the index field.
-        //! The start index of the range is zero in all cases.
-        //! The size of the index field specifies the end index of the iterator range.
-        //!
-        //! \param mesh the associated mesh
-        //! \param index_set a temporary container holding the indices of the entities
+        //! \param index_set the index field (or a view of it) holding the indices of the entities
         //! \param containing_mesh_entity_index the index of the containing mesh entity
         //!
-        IndexedEntityRange(const MeshT& mesh, std::vector<std::size_t>&& index_set, const std::size_t containing_mesh_entity_index = MeshT::InvalidIndex)
+        IndexedEntityRange(const MeshT& mesh, IndexSetT index_set, const std::size_t containing_mesh_entity_index = MeshT::InvalidIndex)
             : mesh { mesh }, index_set { std::move(index_set) }, containing_mesh_entity_index { containing_mesh_entity_index }
         {
         }
@@ -534,14 +678,14 @@ namespace HPM::iterator
         //!
         //! \return an iterator pointing to the begin of the range
         //!
-        inline auto begin() const -> IteratorT { return { mesh, 0, index_set, containing_mesh_entity_index }; }
+        inline auto begin() const -> IteratorT { return { mesh, 0, index_set.data(), containing_mesh_entity_index }; }
 
         //!
         //! \brief Get an iterator pointing to the end of the range.
         //!
         //! \return an iterator pointing to the end of the range
         //!
-        inline auto end() const -> IteratorT{ return { mesh, GetRangeSize(), index_set, containing_mesh_entity_index }; }
+        inline auto end() const -> IteratorT{ return { mesh, GetRangeSize(), index_set.data(), containing_mesh_entity_index }; }
 
         //!
         //! \brief Get the extent of this range.
@@ -553,7 +697,7 @@ namespace HPM::iterator
         private:
 
         const MeshT& mesh;
-        const std::vector<std::size_t> index_set;
+        const IndexSetT index_set;
         const std::size_t containing_mesh_entity_index;
     };
 } // namespace HPM::iterator
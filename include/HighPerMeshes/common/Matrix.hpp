@@ -7,7 +7,6 @@
 #define COMMON_MATRIX_HPP
 
 #include <cstdint>
-#include <iostream>
 
 #include <HighPerMeshes/auxiliary/Math.hpp>
 #include <HighPerMeshes/common/Vec.hpp>
@@ -325,8 +324,12 @@ inline auto operator OP(const T& x)->Matrix&
         //!
         //! \brief Inverse matrix calculation.
         //!
-        //! The inversion of the matrix \f$A\f$ is calculated either by the adjoint matrix
-        //! (\f$A^{-1} = adj(A)/det(A)\f$) or by the Gauss-Jordan Elimination.
+        //! The inversion of the matrix \f$A\f$ is calculated by the adjoint matrix (\f$A^{-1} = adj(A)/det(A)\f$).
+        //! The Gauss-Jordan Elimination is not implemented.
+        //!
+        //! This function does not check for singular matrices (it is used in setup loops and kernels):
+        //! if the determinant is zero, the result contains non-finite values.
+        //! Callers that need to handle singular matrices must check the determinant beforehand.
         //!
         //! \return the inverse of the Matrix
         //!
@@ -335,43 +338,33 @@ inline auto operator OP(const T& x)->Matrix&
         {
             static_assert(M == N, "error: M and N differ");
             static_assert(M > 0 && M < 4, "error: M (or N) must be any of 1..3.");
+            static_assert(Scheme == MatrixInversionScheme::Adjoint, "error: only the adjoint inversion scheme is implemented");
 
-            if constexpr (Scheme == MatrixInversionScheme::Adjoint)
-            {
-                const T det = Determinant();
+            const T inv_det = 1 / Determinant();
 
-                // \todo { cout should be some kind of error - Stefan G. 6.11.2019 }
-                if (det == 0.0)
-                {
-                    std::cout << "error in Matrix::Invert() : Determinant is zero -> inverse does not exist" << std::endl << std::flush;
-                }
-
-                const T inv_det = 1 / det;
-
-                if constexpr (M == 2)
-                {
-                    return {(*this)[1][1] * inv_det, -(*this)[0][1] * inv_det, -(*this)[1][0] * inv_det, (*this)[0][0] * inv_det};
-                }
-                else if constexpr (M == 3)
-                {
-                    // Sarrus' rule
-                    const T a = (*this)[0][0];
-                    const T b = (*this)[0][1];
-                    const T c = (*this)[0][2];
-                    const T d = (*this)[1][0];
-                    const T e = (*this)[1][1];
-                    const T f = (*this)[1][2];
-                    const T g = (*this)[2][0];
-                    const T h = (*this)[2][1];
-                    const T i = (*this)[2][2];
-
-                    return {(e * i - f * h) * inv_det, (c * h - b * i) * inv_det, (b * f - c * e) * inv_det, (f * g - d * i) * inv_det, (a * i - c * g) * inv_det,
-                            (c * d - a * f) * inv_det, (d * h - e * g) * inv_det, (b * g - a * h) * inv_det, (a * e - b * d) * inv_det};
-                }
+            if constexpr (M == 1)
+            {
+                return {inv_det};
+            }
+            else if constexpr (M == 2)
+            {
+                return {(*this)[1][1] * inv_det, -(*this)[0][1] * inv_det, -(*this)[1][0] * inv_det, (*this)[0][0] * inv_det};
             }
             else
             {
-                std::cerr << "error in Matrix::Invert() : use Adjoint" << std::endl << std::flush;
+                // Sarrus' rule
+                const T a = (*this)[0][0];
+                const T b = (*this)[0][1];
+                const T c = (*this)[0][2];
+                const T d = (*this)[1][0];
+                const T e = (*this)[1][1];
+                const T f = (*this)[1][2];
+                const T g = (*this)[2][0];
+                const T h = (*this)[2][1];
+                const T i = (*this)[2][2];
+
+                return {(e * i - f * h) * inv_det, (c * h - b * i) * inv_det, (b * f - c * e) * inv_det, (f * g - d * i) * inv_det, (a * i - c * g) * inv_det,
+                        (c * d - a * f) * inv_det, (d * h - e * g) * inv_det, (b * g - a * h) * inv_det, (a * e - b * d) * inv_det};
             }
         }
 
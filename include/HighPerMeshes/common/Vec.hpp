@@ -230,18 +230,15 @@ namespace HPM::dataType
 
         constexpr Vec() : Base() {}
 
-        constexpr Vec(const Vec& other) : Base(other.data) {}
+        // Defaulted copy operations: vectors are trivially copyable and can be copied as raw bytes (e.g., snapshots and halo exchange).
+        constexpr Vec(const Vec& other) = default;
 
         template <typename... Args, typename std::enable_if_t<(sizeof...(Args) == N), int> = 0>
         constexpr Vec(Args&&... args) : Base(std::forward<Args>(args)...)
         {
         }
 
-        inline auto operator=(const Vec& other) -> Vec& 
-        {                    
-            this->data = other.data;
-            return *this;
-        }
+        inline auto operator=(const Vec& other) -> Vec& = default;
 
         inline auto Norm() const
         {
@@ -7,6 +7,7 @@
 #define DRTS_DATAFLOW_COLLECTIVE_HEADER
 
 #include <HighPerMeshes/drts/data_flow/Graph.hpp>
+#include <HighPerMeshes/drts/data_flow/GraphAnalysis.hpp>
 #include <HighPerMeshes/drts/data_flow/DataDependencyMaps.hpp>
 
 #endif
\ No newline at end of file
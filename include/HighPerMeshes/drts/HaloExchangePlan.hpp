@@ -0,0 +1,440 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DRTS_HALOEXCHANGEPLAN_HPP
+#define DRTS_HALOEXCHANGEPLAN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/auxiliary/ConstexprFor.hpp>
+#include <HighPerMeshes/common/Iterator.hpp>
+#include <HighPerMeshes/drts/data_flow/DataDependencyMaps.hpp>
+#include <HighPerMeshes/dsl/data_access/AccessMode.hpp>
+#include <HighPerMeshes/dsl/entities/EntityHandle.hpp>
+
+namespace HPM::drts
+{
+    namespace internal
+    {
+        //!
+        //! \brief Check if a buffer allocates entries lazily (`DistributedBuffer::At`).
+        //!
+        template <typename BufferT, typename = void>
+        struct HasLazyAllocation : std::false_type
+        {
+        };
+
+        template <typename BufferT>
+        struct HasLazyAllocation<BufferT, std::void_t<decltype(std::declval<BufferT&>().At(std::size_t{}))>> : std::true_type
+        {
+        };
+
+        //!
+        //! \brief Get the position of a dof within the data of a buffer.
+        //!
+        //! Buffers that allocate lazily get an entry for the dof if they do not have one yet (e.g., a ghost dof of a `DistributedBuffer`).
+        //!
+        //! \param buffer the buffer
+        //! \param dof the (global) index of the dof
+        //! \return the position of the dof within `buffer.GetData()`
+        //!
+        template <typename BufferT>
+        auto GetDataPosition(BufferT& buffer, const std::size_t dof) -> std::size_t
+        {
+            if constexpr (HasLazyAllocation<BufferT>::value)
+            {
+                return &buffer.At(dof) - buffer.GetData();
+            }
+            else
+            {
+                return dof;
+            }
+        }
+    } // namespace internal
+
+    //!
+    //! \brief Persistent halo exchange plan for a group of buffers: one message per neighboring process.
+    //!
+    //! The plan is computed once from the access definitions of a group of mesh loops and the `DataDependencyMap` of each access pattern.
+    //! Processes are identified by their level-1 (L1) partition.
+    //! For each neighboring process, the plan holds the positions of the dofs to send and to receive for each buffer, sorted by the (global) dof index:
+    //! the send list of one process and the receive list of the neighbor match.
+    //! The halos of all buffers are packed into one message per neighbor (one aligned segment per buffer), so that an exchange
+    //! sends one message per neighbor instead of one message per buffer and neighbor.
+    //!
+    //! The plan does not depend on a communication library: `Exchange` hands the packed messages to a transport callable,
+    //! or use `Pack`, `GetSendMessage`, `GetReceiveMessage` and `Unpack` with non-blocking communication.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! HaloExchangePlan plan{std::tie(fieldH, fieldE), surfaceKernelLoop, volumeKernelLoop};
+    //! for (std::size_t step = 0; step < num_steps; ++step)
+    //! {
+    //!     plan.Exchange([](std::size_t rank, const char* send, std::size_t send_bytes, char* receive, std::size_t receive_bytes) {
+    //!         MPI_Sendrecv(send, send_bytes, MPI_BYTE, rank, 0, receive, receive_bytes, MPI_BYTE, rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    //!     });
+    //!     dispatcher.Execute(iterator::Range{step, step + 1}, surfaceKernelLoop, volumeKernelLoop);
+    //! }
+    //! \endcode
+    //!
+    //! \tparam BufferT the types of the buffers
+    //!
+    template <typename... BufferT>
+    class HaloExchangePlan
+    {
+        static_assert(sizeof...(BufferT) > 0, "error: a halo exchange plan needs at least one buffer");
+        static_assert((std::is_trivially_copyable_v<typename BufferT::ValueT> && ...), "error: buffer entries are sent as raw bytes");
+
+        using MeshT = typename std::tuple_element_t<0, std::tuple<BufferT...>>::MeshT;
+
+        static constexpr std::size_t NumBuffers = sizeof...(BufferT);
+        static constexpr std::size_t CellDimension = MeshT::CellDimension;
+        //! Alignment of the buffer segments within a message.
+        static constexpr std::size_t SegmentAlignment = alignof(std::max_align_t);
+
+        public:
+        //!
+        //! \brief Compute the plan for a group of buffers and mesh loops.
+        //!
+        //! All read accesses of the mesh loops to the buffers are considered: the accessed dofs owned by another process are received,
+        //! and the dofs owned by this process that the mesh loops of other processes access are sent.
+        //! Accesses to other buffers and to global dofs are ignored.
+        //! The halo is derived from all entities of each partition: filters of the entity ranges are not taken into account.
+        //!
+        //! \tparam MeshLoops the types of the mesh loops
+        //! \param buffers the buffers, e.g., `std::tie(fieldH, fieldE)`: they must outlive the plan
+        //! \param mesh_loops the mesh loops
+        //!
+        template <typename... MeshLoops>
+        HaloExchangePlan(std::tuple<BufferT&...> buffers, const MeshLoops&... mesh_loops) : buffers(buffers)
+        {
+            const MeshT& mesh = std::get<0>(buffers).GetMesh();
+            const std::size_t num_ranks = mesh.GetNumL1Partitions();
+            // The dofs to send to and to receive from each process, for each buffer: index = rank * NumBuffers + buffer.
+            std::vector<std::vector<std::size_t>> send_dofs(num_ranks * NumBuffers);
+            std::vector<std::vector<std::size_t>> receive_dofs(num_ranks * NumBuffers);
+
+            (AddHalo(mesh, mesh_loops, send_dofs, receive_dofs), ...);
+
+            for (std::size_t rank = 0; rank < num_ranks; ++rank)
+            {
+                bool is_neighbor = false;
+
+                for (std::size_t buffer = 0; buffer < NumBuffers; ++buffer)
+                {
+                    ::HPM::drts::data_flow::uniquify(send_dofs[rank * NumBuffers + buffer]);
+                    ::HPM::drts::data_flow::uniquify(receive_dofs[rank * NumBuffers + buffer]);
+                    is_neighbor = is_neighbor || !send_dofs[rank * NumBuffers + buffer].empty() || !receive_dofs[rank * NumBuffers + buffer].empty();
+                }
+
+                if (is_neighbor)
+                {
+                    neighbors.push_back(rank);
+                }
+            }
+
+            SetupMessages(send_dofs, send_offsets, send_positions, send_segment_offsets, send_messages);
+            SetupMessages(receive_dofs, receive_offsets, receive_positions, receive_segment_offsets, receive_messages);
+        }
+
+        //!
+        //! \return the number of neighboring processes: the number of messages sent (and received) per exchange
+        //!
+        auto GetNumNeighbors() const -> std::size_t { return neighbors.size(); }
+
+        //!
+        //! \return the ranks (L1 partitions) of the neighboring processes in ascending order
+        //!
+        auto GetNeighbors() const -> const std::vector<std::size_t>& { return neighbors; }
+
+        //!
+        //! \brief Get the positions of the entries of a buffer that are sent to a neighbor.
+        //!
+        //! \param neighbor the index of the neighbor (not its rank)
+        //! \param buffer the position of the buffer in the plan
+        //! \return the positions within the data of the buffer
+        //!
+        auto GetSendPositions(const std::size_t neighbor, const std::size_t buffer) const -> ::HPM::iterator::IndexSpan
+        {
+            const std::size_t segment = neighbor * NumBuffers + buffer;
+
+            return {send_positions.data() + send_offsets[segment], send_offsets[segment + 1] - send_offsets[segment]};
+        }
+
+        //!
+        //! \brief Get the positions of the entries of a buffer that are received from a neighbor.
+        //!
+        //! \param neighbor the index of the neighbor (not its rank)
+        //! \param buffer the position of the buffer in the plan
+        //! \return the positions within the data of the buffer
+        //!
+        auto GetReceivePositions(const std::size_t neighbor, const std::size_t buffer) const -> ::HPM::iterator::IndexSpan
+        {
+            const std::size_t segment = neighbor * NumBuffers + buffer;
+
+            return {receive_positions.data() + receive_offsets[segment], receive_offsets[segment + 1] - receive_offsets[segment]};
+        }
+
+        //!
+        //! \param neighbor the index of the neighbor
+        //! \return the packed message to the neighbor (valid after `Pack`)
+        //!
+        auto GetSendMessage(const std::size_t neighbor) const -> const char* { return send_messages.data() + send_segment_offsets[neighbor * NumBuffers]; }
+
+        //!
+        //! \param neighbor the index of the neighbor
+        //! \return the size of the message to the neighbor in bytes
+        //!
+        auto GetSendMessageSize(const std::size_t neighbor) const -> std::size_t { return send_segment_offsets[(neighbor + 1) * NumBuffers] - send_segment_offsets[neighbor * NumBuffers]; }
+
+        //!
+        //! \param neighbor the index of the neighbor
+        //! \return the storage for the message from the neighbor (read by `Unpack`)
+        //!
+        auto GetReceiveMessage(const std::size_t neighbor) -> char* { return receive_messages.data() + receive_segment_offsets[neighbor * NumBuffers]; }
+
+        //!
+        //! \param neighbor the index of the neighbor
+        //! \return the size of the message from the neighbor in bytes
+        //!
+        auto GetReceiveMessageSize(const std::size_t neighbor) const -> std::size_t
+        {
+            return receive_segment_offsets[(neighbor + 1) * NumBuffers] - receive_segment_offsets[neighbor * NumBuffers];
+        }
+
+        //!
+        //! \brief Gather the halo entries of all buffers into the send messages (OpenMP parallel over the neighbors).
+        //!
+        auto Pack() -> void
+        {
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t neighbor = 0; neighbor < neighbors.size(); ++neighbor)
+            {
+                ::HPM::auxiliary::ConstexprFor<0, NumBuffers>([this, neighbor](const auto Buffer) {
+                    using ValueT = typename std::tuple_element_t<Buffer, std::tuple<BufferT...>>::ValueT;
+
+                    const std::size_t segment = neighbor * NumBuffers + Buffer;
+                    const std::size_t* positions = send_positions.data() + send_offsets[segment];
+                    const std::size_t num_values = send_offsets[segment + 1] - send_offsets[segment];
+                    const ValueT* source = std::get<Buffer>(buffers).GetData();
+                    ValueT* destination = reinterpret_cast<ValueT*>(send_messages.data() + send_segment_offsets[segment]);
+
+#pragma omp simd
+                    for (std::size_t i = 0; i < num_values; ++i)
+                    {
+                        destination[i] = source[positions[i]];
+                    }
+                });
+            }
+        }
+
+        //!
+        //! \brief Scatter the received messages into the halo entries of all buffers (OpenMP parallel over the neighbors).
+        //!
+        auto Unpack() -> void
+        {
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t neighbor = 0; neighbor < neighbors.size(); ++neighbor)
+            {
+                ::HPM::auxiliary::ConstexprFor<0, NumBuffers>([this, neighbor](const auto Buffer) {
+                    using ValueT = typename std::tuple_element_t<Buffer, std::tuple<BufferT...>>::ValueT;
+
+                    const std::size_t segment = neighbor * NumBuffers + Buffer;
+                    const std::size_t* positions = receive_positions.data() + receive_offsets[segment];
+                    const std::size_t num_values = receive_offsets[segment + 1] - receive_offsets[segment];
+                    const ValueT* source = reinterpret_cast<const ValueT*>(receive_messages.data() + receive_segment_offsets[segment]);
+                    ValueT* destination = std::get<Buffer>(buffers).GetData();
+
+#pragma omp simd
+                    for (std::size_t i = 0; i < num_values; ++i)
+                    {
+                        destination[positions[i]] = source[i];
+                    }
+                });
+            }
+        }
+
+        //!
+        //! \brief Exchange the halos of all buffers: pack, transfer one message per neighbor, and unpack.
+        //!
+        //! \tparam TransportT the type of the transport callable
+        //! \param transport a callable `(rank, send, send_bytes, receive, receive_bytes)` that sends a message to the process `rank`
+        //!        and receives the message of this process: it must complete both transfers before returning
+        //!
+        template <typename TransportT>
+        auto Exchange(TransportT&& transport) -> void
+        {
+            Pack();
+
+            for (std::size_t neighbor = 0; neighbor < neighbors.size(); ++neighbor)
+            {
+                transport(neighbors[neighbor], GetSendMessage(neighbor), GetSendMessageSize(neighbor), GetReceiveMessage(neighbor), GetReceiveMessageSize(neighbor));
+            }
+
+            Unpack();
+        }
+
+        private:
+        //!
+        //! \brief Get the position of a buffer within this plan.
+        //!
+        //! \return the position, or `NumBuffers` if the buffer is not part of the plan
+        //!
+        auto GetBufferIndex(const void* buffer) const -> std::size_t
+        {
+            const std::array<const void*, NumBuffers> addresses = std::apply([](const auto&... buffer) { return std::array<const void*, NumBuffers>{&buffer...}; }, buffers);
+
+            return std::find(addresses.begin(), addresses.end(), buffer) - addresses.begin();
+        }
+
+        //!
+        //! \brief Add the dofs to send and to receive for all read accesses of a mesh loop.
+        //!
+        template <typename MeshLoop>
+        auto AddHalo(const MeshT& mesh, const MeshLoop& mesh_loop, std::vector<std::vector<std::size_t>>& send_dofs, std::vector<std::vector<std::size_t>>& receive_dofs) -> void
+        {
+            std::apply([&](const auto&... access) { (AddHalo(mesh, mesh_loop, access, send_dofs, receive_dofs), ...); }, mesh_loop.access_definitions);
+        }
+
+        //!
+        //! \brief Add the dofs to send and to receive for one access definition of a mesh loop.
+        //!
+        //! The accessed entities are determined by a `DataDependencyMap` of the access pattern: for each L2 partition, the entities accessed in all L2 partitions.
+        //!
+        template <typename MeshLoop, typename AccessDefinition>
+        auto AddHalo(const MeshT& mesh, const MeshLoop& mesh_loop, const AccessDefinition& access, std::vector<std::vector<std::size_t>>& send_dofs,
+                     std::vector<std::vector<std::size_t>>& receive_dofs) -> void
+        {
+            constexpr std::size_t RequestedDimension = AccessDefinition::RequestedDimension;
+            constexpr AccessMode Mode = AccessDefinition::Mode.value;
+
+            if constexpr (RequestedDimension <= CellDimension && (Mode == AccessMode::Read || Mode == AccessMode::ReadWrite))
+            {
+                const std::size_t buffer = GetBufferIndex(access.buffer);
+
+                if (buffer == NumBuffers)
+                {
+                    return;
+                }
+
+                // The mesh only knows the lower-dimensional entities of the L2 partitions of this process: the send lists could not be determined.
+                if (MeshLoop::LoopT::Dimension != CellDimension)
+                {
+                    throw std::runtime_error("error: halo exchange plans support mesh loops over cells (or their sub-entities) only");
+                }
+
+                const std::size_t my_rank = mesh.GetMyL1Partition();
+                const ::HPM::drts::data_flow::DataDependencyMap<CellDimension> map(mesh, access.pattern, mesh_loop.loop);
+
+                for (std::size_t accessor_L2 = 0; accessor_L2 < map.GetNumL2Partitions(); ++accessor_L2)
+                {
+                    const std::size_t accessor_rank = mesh.L2PToL1P(accessor_L2);
+
+                    auto add_dofs = [&](const std::size_t entity_index) {
+                        const std::size_t owner_rank = mesh.L2PToL1P(mesh.template EntityToL2P<RequestedDimension>(entity_index));
+
+                        if (accessor_rank == my_rank && owner_rank != my_rank)
+                        {
+                            auto& dofs = receive_dofs[owner_rank * NumBuffers + buffer];
+                            const auto& indices = access.buffer->template GetDofIndices<RequestedDimension>(entity_index);
+
+                            dofs.insert(dofs.end(), indices.begin(), indices.end());
+                        }
+                        else if (accessor_rank != my_rank && owner_rank == my_rank)
+                        {
+                            auto& dofs = send_dofs[accessor_rank * NumBuffers + buffer];
+                            const auto& indices = access.buffer->template GetDofIndices<RequestedDimension>(entity_index);
+
+                            dofs.insert(dofs.end(), indices.begin(), indices.end());
+                        }
+                    };
+
+                    for (const std::size_t accessed_L2 : map.L2PHasAccessToL2P(accessor_L2))
+                    {
+                        const auto& accessed_entities = map.L2PHasAccessToL2PByEntity(accessor_L2, accessed_L2);
+
+                        ::HPM::auxiliary::ConstexprFor<0, CellDimension + 1>([&](const auto Codimension) {
+                            constexpr std::size_t Dimension = CellDimension - Codimension;
+
+                            if constexpr (RequestedDimension <= Dimension)
+                            {
+                                using EntityHandleT = ::HPM::entity::EntityHandle<typename MeshT::template EntityT<Dimension>>;
+
+                                // Handles read the sub-entity indices from the mesh tables: no entity is created.
+                                for (const std::size_t index : accessed_entities[Codimension])
+                                {
+                                    for (const std::size_t entity_index : EntityHandleT{mesh, index}.template GetIndicesOfEntitiesWithDimension<RequestedDimension>())
+                                    {
+                                        add_dofs(entity_index);
+                                    }
+                                }
+                            }
+                        });
+                    }
+                }
+            }
+        }
+
+        //!
+        //! \brief Set up the positions (CSR) and the message layout for one direction (send or receive).
+        //!
+        //! \param dofs the sorted dofs for each rank and buffer
+        //! \param offsets the offsets of the segments (neighbor, buffer) within `positions` (output)
+        //! \param positions the positions of the dofs within the data of the buffers (output)
+        //! \param segment_offsets the offsets of the segments within the messages in bytes (output)
+        //! \param messages the storage of the messages of all neighbors (output)
+        //!
+        auto SetupMessages(const std::vector<std::vector<std::size_t>>& dofs, std::vector<std::size_t>& offsets, std::vector<std::size_t>& positions, std::vector<std::size_t>& segment_offsets,
+                           std::vector<char>& messages) -> void
+        {
+            const std::size_t num_segments = neighbors.size() * NumBuffers;
+
+            offsets.assign(num_segments + 1, 0);
+            segment_offsets.assign(num_segments + 1, 0);
+
+            for (std::size_t neighbor = 0; neighbor < neighbors.size(); ++neighbor)
+            {
+                ::HPM::auxiliary::ConstexprFor<0, NumBuffers>([&](const auto Buffer) {
+                    using ValueT = typename std::tuple_element_t<Buffer, std::tuple<BufferT...>>::ValueT;
+
+                    const std::size_t segment = neighbor * NumBuffers + Buffer;
+                    const auto& segment_dofs = dofs[neighbors[neighbor] * NumBuffers + Buffer];
+                    const std::size_t bytes = segment_dofs.size() * sizeof(ValueT);
+
+                    for (const std::size_t dof : segment_dofs)
+                    {
+                        positions.push_back(internal::GetDataPosition(std::get<Buffer>(buffers), dof));
+                    }
+
+                    offsets[segment + 1] = positions.size();
+                    segment_offsets[segment + 1] = segment_offsets[segment] + (bytes + SegmentAlignment - 1) / SegmentAlignment * SegmentAlignment;
+                });
+            }
+
+            messages.assign(segment_offsets.back(), 0);
+        }
+
+        std::tuple<BufferT&...> buffers;
+        std::vector<std::size_t> neighbors;
+        std::vector<std::size_t> send_offsets;
+        std::vector<std::size_t> send_positions;
+        std::vector<std::size_t> send_segment_offsets;
+        std::vector<char> send_messages;
+        std::vector<std::size_t> receive_offsets;
+        std::vector<std::size_t> receive_positions;
+        std::vector<std::size_t> receive_segment_offsets;
+        std::vector<char> receive_messages;
+    };
+} // namespace HPM::drts
+
+#endif
@@ -23,11 +23,70 @@
 #ifndef DRTS_DATAFLOW_DATADEPENDENCYMAPS_HPP
 #define DRTS_DATAFLOW_DATADEPENDENCYMAPS_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <map>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
 
+#include <HighPerMeshes/auxiliary/ConstexprFor.hpp>
+#include <HighPerMeshes/common/Iterator.hpp>
 #include <HighPerMeshes/dsl/loop_types/loop_implementations/DefaultLoopImplementations.hpp>
 #include <HighPerMeshes/dsl/meshes/PartitionedMesh.hpp>
+#include <HighPerMeshes/dsl/meshes/PartitioningReport.hpp>
+
+namespace HPM::internal
+{
+    //!
+    //! \brief Data dependency map file header.
+    //!
+    //! A data dependency map file consists of this header followed by the raw CSR arrays of the map.
+    //! The number of entities of each dimension and a hash of the cell partitioning identify the mesh the map has been computed for,
+    //! the access key identifies the access pattern and the loop implementation.
+    //!
+    struct DataDependencyMapHeader
+    {
+        char magic[8];
+        std::uint64_t version;
+        std::uint64_t index_size;
+        std::uint64_t dimension;
+        std::uint64_t num_entities[4];
+        std::uint64_t num_L2_partitions;
+        std::uint64_t partition_hash;
+        std::uint64_t access_key;
+        std::uint64_t num_accesses;
+        std::uint64_t num_entity_indices;
+    };
+
+    constexpr char DataDependencyMapMagic[8] = {'H', 'P', 'M', 'D', 'D', 'M', 'A', 'P'};
+    constexpr std::uint64_t DataDependencyMapVersion = 2;
+
+    //!
+    //! \brief 64-bit FNV-1a hash of a byte sequence.
+    //!
+    //! \param data a pointer to the first byte
+    //! \param size the number of bytes
+    //! \param hash the hash of the preceding bytes, if the hash is computed in several parts
+    //! \return the hash
+    //!
+    inline auto Fnv1aHash(const void* data, const std::size_t size, std::uint64_t hash = 14695981039346656037ULL) -> std::uint64_t
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+
+        return hash;
+    }
+} // namespace HPM::internal
 
 namespace HPM::drts::data_flow
 {
@@ -41,12 +100,37 @@ namespace HPM::drts::data_flow
     //!
     //! \brief This class specifies the dependencies between two local (L2) partitions given an access pattern and a loop implementation.
     //!
+    //! The dependencies are stored in compressed sparse row (CSR) format: for each accessor L2 partition the sorted list of accessed L2 partitions,
+    //! and for each pair of partitions and each codimension the sorted list of accessed entities.
+    //! The map is computed in parallel (OpenMP), one L2 partition at a time.
+    //! As all lists are sorted, maps for different access patterns are merged without sorting again.
+    //!
+    //! The map can be saved to and loaded from a file, e.g., next to the snapshots of a simulation: see `Save`, `Load` and `LoadOrCreate`.
+    //! A file is accepted only for the mesh partitioning, the access pattern and the loop implementation it has been computed for.
+    //!
     //! \tparam Dimension The dimension of the mesh this data dependency map is calculated for
     //!
     template <std::size_t Dimension>
     class DataDependencyMap
     {
+        static constexpr std::size_t NumCodimensions = Dimension + 1;
+
+        //!
+        //! \brief The dependencies of a single accessor L2 partition, with offsets relative to the partition.
+        //!
+        struct Accesses
+        {
+            std::vector<std::size_t> accessed_L2;
+            std::vector<std::size_t> entity_offsets;
+            std::vector<std::size_t> entities;
+        };
+
         public:
+        //!
+        //! \brief Create an empty map: no L2 partition has access to any other L2 partition.
+        //!
+        DataDependencyMap() : access_offsets(1, 0), entity_offsets(1, 0) {}
+
         //!
         //! \param pattern An access pattern
         //! \param loop A loop implementation
@@ -55,97 +139,583 @@ namespace HPM::drts::data_flow
         //! \see DefaultLoopImplementations.hpp
         //!
         template <typename MeshT, typename Pattern, typename LoopT>
-        DataDependencyMap(const MeshT& mesh, const Pattern pattern, const LoopT loop)
+        DataDependencyMap(const MeshT& mesh, const Pattern pattern, const LoopT loop) : access_key(GetAccessKey<Pattern, LoopT>())
         {
-            auto detectL2Accesses = [&](const auto& entity, std::size_t L2) {
-                const auto& considered_element = pattern(entity);
-                using ConsideredElementT = std::decay_t<decltype(considered_element)>;
-                constexpr std::size_t RequiredCodimension = ConsideredElementT::CellDimension - ConsideredElementT::Dimension;
-                const std::size_t other_L2 = mesh.EntityToL2P(considered_element);
-                const std::size_t other_index = considered_element.GetTopology().GetIndex();
+            std::vector<std::size_t> L2_partitions;
 
-                has_access[L2].emplace_back(other_L2);
-                has_access_by_entity[{L2, other_L2}][RequiredCodimension].emplace_back(other_index);
-            };
-            
             const std::size_t num_l1_partitions = mesh.GetNumL1Partitions();
             for (std::size_t i_L1 = 0; i_L1 < num_l1_partitions; ++i_L1)
             {
                 for (auto L2 : mesh.L1PToL2P(i_L1))
                 {
-                    const auto& elements = mesh.template L2PToEntity<LoopT::Dimension>(L2);
-                    loop(elements, [&](const auto& entity) { detectL2Accesses(entity, L2); });
+                    L2_partitions.push_back(L2);
                 }
             }
 
-            for (auto& [_, vector] : has_access)
-            {
-                uniquify(vector);
-            }
+            const std::size_t num_L2_partitions = (L2_partitions.empty() ? 0 : *std::max_element(L2_partitions.begin(), L2_partitions.end()) + 1);
+            std::vector<Accesses> accesses(num_L2_partitions);
 
-            for (auto& [_, array] : has_access_by_entity)
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t i = 0; i < L2_partitions.size(); ++i)
             {
-                for (std::size_t dim = 0; dim < array.size(); ++dim)
-                {
-                    uniquify(array[dim]);
-                }
+                const std::size_t L2 = L2_partitions[i];
+                // Accessed entities grouped by the accessed L2 partition and the codimension: key = accessed L2 partition * NumCodimensions + codimension.
+                std::vector<std::size_t> keys;
+                std::vector<std::vector<std::size_t>> accessed_entities;
+                std::size_t bucket = 0;
+
+                auto detectL2Accesses = [&](const auto& entity) {
+                    const auto& considered_element = pattern(entity);
+                    using ConsideredElementT = std::decay_t<decltype(considered_element)>;
+                    constexpr std::size_t RequiredCodimension = ConsideredElementT::CellDimension - ConsideredElementT::Dimension;
+                    const std::size_t other_L2 = mesh.EntityToL2P(considered_element);
+                    const std::size_t other_index = considered_element.GetTopology().GetIndex();
+                    const std::size_t key = other_L2 * NumCodimensions + RequiredCodimension;
+
+                    // Consecutive entities mostly access the same partition: there are only few keys per partition.
+                    if (keys.empty() || keys[bucket] != key)
+                    {
+                        bucket = std::find(keys.begin(), keys.end(), key) - keys.begin();
+
+                        if (bucket == keys.size())
+                        {
+                            keys.push_back(key);
+                            accessed_entities.emplace_back();
+                        }
+                    }
+
+                    accessed_entities[bucket].push_back(other_index);
+                };
+
+                const auto& elements = mesh.template L2PToEntity<LoopT::Dimension>(L2);
+                loop(elements, detectL2Accesses);
+
+                accesses[L2] = GetAccesses(keys, accessed_entities);
             }
 
+            Assemble(accesses);
         }
 
         //!
         //! \return All L2 partitions that `accessor_L2` has access to
         //!
-        const auto& L2PHasAccessToL2P(const std::size_t accessor_L2) const
+        auto L2PHasAccessToL2P(const std::size_t accessor_L2) const -> ::HPM::iterator::IndexSpan
         {
-            auto iter = has_access.find(accessor_L2);
+            if (accessor_L2 >= GetNumL2Partitions())
+            {
+                return {};
+            }
 
-            return iter != has_access.end() ? iter->second : empty_access;
+            return {accessed.data() + access_offsets[accessor_L2], access_offsets[accessor_L2 + 1] - access_offsets[accessor_L2]};
         }
 
         //!
         //! \return An array of indices that determines all entities that the L2 partition `accessor_L2` can access in partition `accessed_L2`.
         //!         The index given to the arrays operator[] determines the codimension of the entity and the value of the underlying sets specify the global index of the underlying entity.
         //!
-        const auto& L2PHasAccessToL2PByEntity(const std::size_t accessor_L2, const std::size_t accessed_L2) const
+        auto L2PHasAccessToL2PByEntity(const std::size_t accessor_L2, const std::size_t accessed_L2) const -> std::array<::HPM::iterator::IndexSpan, NumCodimensions>
         {
-            auto iter = has_access_by_entity.find({accessor_L2, accessed_L2});
-            return iter != has_access_by_entity.end() ? iter->second : empty_access_by_entity;
+            std::array<::HPM::iterator::IndexSpan, NumCodimensions> entity_access;
+            const auto& accessed_L2_partitions = L2PHasAccessToL2P(accessor_L2);
+            const auto it = std::lower_bound(accessed_L2_partitions.begin(), accessed_L2_partitions.end(), accessed_L2);
+
+            if (it != accessed_L2_partitions.end() && *it == accessed_L2)
+            {
+                const std::size_t access = access_offsets[accessor_L2] + (it - accessed_L2_partitions.begin());
+
+                for (std::size_t codimension = 0; codimension < NumCodimensions; ++codimension)
+                {
+                    const std::size_t begin = entity_offsets[access * NumCodimensions + codimension];
+
+                    entity_access[codimension] = {entities.data() + begin, entity_offsets[access * NumCodimensions + codimension + 1] - begin};
+                }
+            }
+
+            return entity_access;
         }
 
+        //!
+        //! \return the number of L2 partitions covered by this map: accessor partitions have indices smaller than this number
+        //!
+        auto GetNumL2Partitions() const -> std::size_t { return access_offsets.size() - 1; }
+
         //! Adds all indices for all relationships in other to this.
-        void operator+=(const DataDependencyMap<Dimension>&& other)
+        //! Both maps are sorted: the lists of L2 partitions and entities are merged in linear time.
+        //! The access key of the merged map combines the access keys of both maps.
+        void operator+=(const DataDependencyMap<Dimension>& other)
         {
-            auto move_insert = [](auto&& dst, auto&& src) { 
-                dst.insert(dst.end(), make_move_iterator(src.begin()), make_move_iterator(src.end())); 
-            };
+            if (access_key == 0 || other.access_key == 0 || access_key == other.access_key)
+            {
+                access_key = (access_key == 0 ? other.access_key : access_key);
+            }
+            else
+            {
+                access_key = ::HPM::internal::Fnv1aHash(&other.access_key, sizeof(other.access_key), access_key);
+            }
+
+            const std::size_t num_L2_partitions = std::max(GetNumL2Partitions(), other.GetNumL2Partitions());
+            std::vector<Accesses> accesses(num_L2_partitions);
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t L2 = 0; L2 < num_L2_partitions; ++L2)
+            {
+                const auto& lhs = L2PHasAccessToL2P(L2);
+                const auto& rhs = other.L2PHasAccessToL2P(L2);
+                auto& merged = accesses[L2];
+
+                std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(merged.accessed_L2));
+                merged.entity_offsets.push_back(0);
 
-            for (auto& [key, value] : other.has_access)
+                for (const std::size_t accessed_L2 : merged.accessed_L2)
+                {
+                    const auto& lhs_entities = L2PHasAccessToL2PByEntity(L2, accessed_L2);
+                    const auto& rhs_entities = other.L2PHasAccessToL2PByEntity(L2, accessed_L2);
+
+                    for (std::size_t codimension = 0; codimension < NumCodimensions; ++codimension)
+                    {
+                        std::set_union(lhs_entities[codimension].begin(), lhs_entities[codimension].end(), rhs_entities[codimension].begin(), rhs_entities[codimension].end(),
+                                       std::back_inserter(merged.entities));
+                        merged.entity_offsets.push_back(merged.entities.size());
+                    }
+                }
+            }
+
+            Assemble(accesses);
+        }
+
+        //!
+        //! \return `true` if both maps contain the same dependencies (the access keys are not compared)
+        //!
+        auto operator==(const DataDependencyMap<Dimension>& other) const
+        {
+            return access_offsets == other.access_offsets && accessed == other.accessed && entity_offsets == other.entity_offsets && entities == other.entities;
+        }
+
+        auto operator!=(const DataDependencyMap<Dimension>& other) const { return !(*this == other); }
+
+        //!
+        //! \brief Write this map to a file.
+        //!
+        //! The file records the number of entities of each dimension of the mesh, a hash of its cell partitioning, and the access key of this map,
+        //! which are checked when loading the map.
+        //!
+        //! \param filename the file to write to
+        //! \param mesh the mesh this map has been computed for
+        //!
+        template <typename MeshT>
+        auto Save(const std::string& filename, const MeshT& mesh) const -> void
+        {
+            std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not open file: " + filename);
+            }
+
+            const auto& header = GetHeader(mesh, access_key, GetNumL2Partitions(), accessed.size(), entities.size());
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(access_offsets.data()), access_offsets.size() * sizeof(std::size_t));
+            file.write(reinterpret_cast<const char*>(accessed.data()), accessed.size() * sizeof(std::size_t));
+            file.write(reinterpret_cast<const char*>(entity_offsets.data()), entity_offsets.size() * sizeof(std::size_t));
+            file.write(reinterpret_cast<const char*>(entities.data()), entities.size() * sizeof(std::size_t));
+            file.close();
+
+            if (!file)
             {
-                auto& this_access = has_access[key]; 
-                move_insert(this_access, value);
-                uniquify(this_access);
+                throw std::runtime_error("error: could not write file: " + filename);
             }
+        }
+
+        //!
+        //! \brief Load a map from a file written by `Save`.
+        //!
+        //! \param filename the file to read from
+        //! \param mesh the mesh the map has been computed for: the number of entities of each dimension and the cell partitioning must match
+        //! \param pattern the access pattern the map has been computed for
+        //! \param loop the loop implementation the map has been computed for
+        //! \return the map
+        //!
+        template <typename MeshT, typename Pattern, typename LoopT>
+        static auto Load(const std::string& filename, const MeshT& mesh, const Pattern, const LoopT) -> DataDependencyMap
+        {
+            std::ifstream file(filename, std::ios::in | std::ios::binary);
 
-            for (auto& [key, value] : other.has_access_by_entity)
+            if (!file)
             {
-                for (std::size_t dim = 0; dim < value.size(); ++dim)
+                throw std::runtime_error("error: could not open file: " + filename);
+            }
+
+            DataDependencyMap map;
+
+            if (!map.Read(file, mesh, GetAccessKey<Pattern, LoopT>()))
+            {
+                throw std::runtime_error("error: not a data dependency map of this mesh, access pattern and loop: " + filename);
+            }
+
+            return map;
+        }
+
+        //!
+        //! \brief Load a map from a file, or compute it and write it to the file if the file does not exist
+        //! or belongs to a different mesh partitioning, access pattern or loop implementation.
+        //!
+        //! Usage:
+        //! \code{.cpp}
+        //! const auto& map = DataDependencyMap<3>::LoadOrCreate("neighbors.ddm", mesh, AccessPatterns::NeighboringMeshElementOrSelfPattern, internal::ForEachIncidence<3, 2>{});
+        //! \endcode
+        //!
+        //! \param filename the file
+        //! \param mesh the mesh
+        //! \param pattern An access pattern
+        //! \param loop A loop implementation
+        //! \return the map
+        //!
+        template <typename MeshT, typename Pattern, typename LoopT>
+        static auto LoadOrCreate(const std::string& filename, const MeshT& mesh, const Pattern pattern, const LoopT loop) -> DataDependencyMap
+        {
+            {
+                std::ifstream file(filename, std::ios::in | std::ios::binary);
+                DataDependencyMap map;
+
+                if (file && map.Read(file, mesh, GetAccessKey<Pattern, LoopT>()))
                 {
-                    auto& this_access = has_access_by_entity[key][dim]; 
-                    move_insert(this_access, value[dim]);
-                    uniquify(this_access);
+                    return map;
                 }
             }
-  
+
+            DataDependencyMap map(mesh, pattern, loop);
+
+            map.Save(filename, mesh);
+
+            return map;
         }
 
         private:
-        const std::vector<std::size_t> empty_access;
-        std::map<std::size_t, std::vector<std::size_t>> has_access;
+        //!
+        //! \brief Convert the accessed entities of an accessor L2 partition, grouped by the accessed L2 partition and the codimension, into CSR format.
+        //!
+        static auto GetAccesses(const std::vector<std::size_t>& keys, std::vector<std::vector<std::size_t>>& accessed_entities) -> Accesses
+        {
+            Accesses accesses;
+            std::vector<std::size_t> order(keys.size());
+
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&keys](const std::size_t lhs, const std::size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+            for (const std::size_t bucket : order)
+            {
+                if (accesses.accessed_L2.empty() || accesses.accessed_L2.back() != keys[bucket] / NumCodimensions)
+                {
+                    accesses.accessed_L2.push_back(keys[bucket] / NumCodimensions);
+                }
+
+                uniquify(accessed_entities[bucket]);
+            }
+
+            accesses.entity_offsets.assign(accesses.accessed_L2.size() * NumCodimensions + 1, 0);
+
+            for (std::size_t bucket = 0; bucket < keys.size(); ++bucket)
+            {
+                const std::size_t access = std::lower_bound(accesses.accessed_L2.begin(), accesses.accessed_L2.end(), keys[bucket] / NumCodimensions) - accesses.accessed_L2.begin();
+
+                accesses.entity_offsets[access * NumCodimensions + keys[bucket] % NumCodimensions + 1] = accessed_entities[bucket].size();
+            }
+
+            std::partial_sum(accesses.entity_offsets.begin(), accesses.entity_offsets.end(), accesses.entity_offsets.begin());
+            accesses.entities.reserve(accesses.entity_offsets.back());
+
+            for (const std::size_t bucket : order)
+            {
+                accesses.entities.insert(accesses.entities.end(), accessed_entities[bucket].begin(), accessed_entities[bucket].end());
+            }
+
+            return accesses;
+        }
+
+        //!
+        //! \brief Concatenate the dependencies of all accessor L2 partitions into the CSR arrays of this map.
+        //!
+        auto Assemble(const std::vector<Accesses>& accesses) -> void
+        {
+            const std::size_t num_L2_partitions = accesses.size();
+            std::vector<std::size_t> entity_begin(num_L2_partitions + 1, 0);
+
+            access_offsets.assign(num_L2_partitions + 1, 0);
+
+            for (std::size_t L2 = 0; L2 < num_L2_partitions; ++L2)
+            {
+                access_offsets[L2 + 1] = access_offsets[L2] + accesses[L2].accessed_L2.size();
+                entity_begin[L2 + 1] = entity_begin[L2] + accesses[L2].entities.size();
+            }
+
+            accessed.resize(access_offsets.back());
+            entity_offsets.resize(access_offsets.back() * NumCodimensions + 1);
+            entities.resize(entity_begin.back());
+            entity_offsets.back() = entities.size();
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t L2 = 0; L2 < num_L2_partitions; ++L2)
+            {
+                const auto& partition_accesses = accesses[L2];
+
+                std::copy(partition_accesses.accessed_L2.begin(), partition_accesses.accessed_L2.end(), accessed.begin() + access_offsets[L2]);
+                std::copy(partition_accesses.entities.begin(), partition_accesses.entities.end(), entities.begin() + entity_begin[L2]);
+
+                // The last (relative) offset of this partition is the first offset of the next one.
+                for (std::size_t i = 0; i + 1 < partition_accesses.entity_offsets.size(); ++i)
+                {
+                    entity_offsets[access_offsets[L2] * NumCodimensions + i] = entity_begin[L2] + partition_accesses.entity_offsets[i];
+                }
+            }
+        }
+
+        //!
+        //! \brief Get a key for an access pattern and a loop implementation: a hash of their (mangled) type names.
+        //!
+        //! Access patterns are stateless lambdas or function objects, so the types determine the map.
+        //! The key is the same for all executables built with the same compiler.
+        //!
+        template <typename Pattern, typename LoopT>
+        static auto GetAccessKey() -> std::uint64_t
+        {
+            const char* name = typeid(std::tuple<Pattern, LoopT>).name();
+
+            return ::HPM::internal::Fnv1aHash(name, std::strlen(name));
+        }
+
+        //!
+        //! \brief Get a hash of the cell partitioning of a mesh: the L2 partition of each cell, the cell offsets of the L2 partitions,
+        //! and the node indices of each cell.
+        //!
+        //! The partitioners sort the cells by their L2 partition: partitionings with the same partition sizes differ in the cell nodes only.
+        //!
+        template <typename MeshT>
+        static auto GetPartitionHash(const MeshT& mesh) -> std::uint64_t
+        {
+            const auto& cell_to_L2P = mesh.GetCellToL2P();
+            const auto& L2P_to_cell_offset = mesh.GetL2PToCellOffsets();
+            std::uint64_t hash = ::HPM::internal::Fnv1aHash(cell_to_L2P.data(), cell_to_L2P.size() * sizeof(std::size_t));
+
+            hash = ::HPM::internal::Fnv1aHash(L2P_to_cell_offset.data(), L2P_to_cell_offset.size() * sizeof(std::size_t), hash);
+
+            // The node indices of all cells, one after another.
+            for (const auto& cell : mesh.GetEntities())
+            {
+                const auto& node_indices = cell.GetTopology().template GetIndicesOfEntitiesWithDimension<0>();
+
+                hash = ::HPM::internal::Fnv1aHash(node_indices.data(), node_indices.size() * sizeof(node_indices[0]), hash);
+            }
+
+            return hash;
+        }
+
+        template <typename MeshT>
+        static auto GetHeader(const MeshT& mesh, const std::uint64_t access_key, const std::size_t num_L2_partitions, const std::size_t num_accesses, const std::size_t num_entity_indices)
+            -> ::HPM::internal::DataDependencyMapHeader
+        {
+            static_assert(Dimension <= 3, "error: data dependency map files support meshes with cell dimension up to 3");
+
+            ::HPM::internal::DataDependencyMapHeader header{
+                {}, ::HPM::internal::DataDependencyMapVersion, sizeof(std::size_t), Dimension, {}, num_L2_partitions, GetPartitionHash(mesh), access_key, num_accesses, num_entity_indices};
+
+            std::memcpy(header.magic, ::HPM::internal::DataDependencyMapMagic, sizeof(::HPM::internal::DataDependencyMapMagic));
+            ::HPM::auxiliary::ConstexprFor<0, Dimension + 1>([&](const auto D) { header.num_entities[D] = mesh.template GetNumEntities<D>(); });
+
+            return header;
+        }
+
+        //!
+        //! \brief Read the map from a stream, if the stream contains a map of the given mesh and access key.
+        //!
+        //! \return `true` if the map has been read, `false` otherwise (the map is left empty)
+        //!
+        template <typename MeshT>
+        auto Read(std::istream& stream, const MeshT& mesh, const std::uint64_t expected_access_key) -> bool
+        {
+            ::HPM::internal::DataDependencyMapHeader header;
+
+            stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+            if (!stream)
+            {
+                return false;
+            }
+
+            const auto& expected_header = GetHeader(mesh, expected_access_key, header.num_L2_partitions, header.num_accesses, header.num_entity_indices);
+
+            if (std::memcmp(&header, &expected_header, sizeof(header)) != 0)
+            {
+                return false;
+            }
+
+            auto read = [&stream](std::vector<std::size_t>& values, const std::size_t size) {
+                values.resize(size);
+                stream.read(reinterpret_cast<char*>(values.data()), size * sizeof(std::size_t));
+            };
+
+            read(access_offsets, header.num_L2_partitions + 1);
+            read(accessed, header.num_accesses);
+            read(entity_offsets, header.num_accesses * NumCodimensions + 1);
+            read(entities, header.num_entity_indices);
+
+            if (!stream || access_offsets.back() != accessed.size() || entity_offsets.back() != entities.size())
+            {
+                *this = DataDependencyMap{};
+
+                return false;
+            }
+
+            access_key = header.access_key;
+
+            return true;
+        }
 
-        const std::array<std::vector<std::size_t>, Dimension + 1> empty_access_by_entity;
-        std::map<std::pair<std::size_t, std::size_t>, std::array<std::vector<std::size_t>, Dimension + 1>> has_access_by_entity;
+        std::vector<std::size_t> access_offsets;
+        std::vector<std::size_t> accessed;
+        std::vector<std::size_t> entity_offsets;
+        std::vector<std::size_t> entities;
+        // Identifies the access pattern(s) and loop implementation(s): 0 for an empty map.
+        std::uint64_t access_key = 0;
     };
+
+    //!
+    //! \brief Analyze the size and the communication volume of all level-1 (L1) and level-2 (L2) partitions.
+    //!
+    //! Ghost entities are determined with a `DataDependencyMap` for an access pattern and a loop implementation:
+    //! these are the entities owned by other partitions that a loop with this access pattern reads.
+    //! The halo size of each buffer is estimated from the number of ghost entities and the dofs of the buffer.
+    //! Loops over entities with a dimension lower than the cell dimension are analyzed for the L1 partition of this process only.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! const auto& report = AnalyzePartitioning(mesh, AccessPatterns::NeighboringMeshElementOrSelfPattern, internal::ForEachIncidence<3, 2>{}, fieldH, fieldE);
+    //! report.WriteText(std::cout);
+    //! \endcode
+    //!
+    //! \tparam MeshT the type of the partitioned mesh
+    //! \tparam Pattern the type of the access pattern
+    //! \tparam LoopT the type of the loop implementation
+    //! \tparam BufferT the types of the buffers
+    //! \param mesh the partitioned mesh
+    //! \param pattern the access pattern, see `AccessPatterns.hpp`
+    //! \param loop the loop implementation, see `DefaultLoopImplementations.hpp`
+    //! \param buffers the buffers whose halo sizes are estimated
+    //! \return the partitioning report
+    //!
+    template <typename MeshT, typename Pattern, typename LoopT, typename... BufferT>
+    auto AnalyzePartitioning(const MeshT& mesh, const Pattern& pattern, const LoopT& loop, const BufferT&... buffers) -> ::HPM::mesh::PartitioningReport
+    {
+        using ::HPM::mesh::PartitionStatistics;
+        constexpr std::size_t CellDimension = MeshT::CellDimension;
+        // Entity indices, indexed by the codimension (as in the `DataDependencyMap`).
+        using GhostEntities = std::array<std::vector<std::size_t>, CellDimension + 1>;
+
+        const DataDependencyMap<CellDimension> map(mesh, pattern, loop);
+        const auto& L2P_to_cell_offset = mesh.GetL2PToCellOffsets();
+        const auto& L2P_to_node_offset = mesh.GetL2PToNodeOffsets();
+        const std::size_t num_L1_partitions = mesh.GetNumL1Partitions();
+        const std::size_t num_L2_partitions = mesh.GetNumL2Partitions();
+        ::HPM::mesh::PartitioningReport report{num_L1_partitions, num_L2_partitions / num_L1_partitions, std::vector<PartitionStatistics>(num_L1_partitions), std::vector<PartitionStatistics>(num_L2_partitions)};
+
+        auto set_ghost_entities = [&buffers...](PartitionStatistics& statistics, const GhostEntities& ghost_entities) {
+            statistics.num_ghost_entities.assign(CellDimension + 1, 0);
+
+            for (std::size_t codimension = 0; codimension <= CellDimension; ++codimension)
+            {
+                statistics.num_ghost_entities[CellDimension - codimension] = ghost_entities[codimension].size();
+            }
+
+            statistics.halo_bytes = {[&statistics](const auto& buffer) {
+                std::size_t bytes = 0;
+
+                for (std::size_t dimension = 0; dimension <= CellDimension; ++dimension)
+                {
+                    bytes += statistics.num_ghost_entities[dimension] * buffer.GetDofs().At(dimension) * sizeof(typename BufferT::ValueT);
+                }
+
+                return bytes;
+            }(buffers)...};
+        };
+
+        auto make_unique = [](std::vector<std::size_t>& indices) {
+            std::sort(indices.begin(), indices.end());
+            indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        };
+
+        auto set_imbalance = [](std::vector<PartitionStatistics>& partitions) {
+            const double average_num_cells = static_cast<double>(std::accumulate(partitions.begin(), partitions.end(), std::size_t{0}, [](const std::size_t sum, const auto& partition) { return sum + partition.num_cells; })) / partitions.size();
+
+            for (auto& partition : partitions)
+            {
+                partition.imbalance = (average_num_cells > 0.0 ? partition.num_cells / average_num_cells : 0.0);
+            }
+        };
+
+        for (std::size_t i_L1 = 0; i_L1 < num_L1_partitions; ++i_L1)
+        {
+            auto& L1_statistics = report.L1_partitions[i_L1];
+            GhostEntities L1_ghost_entities;
+            std::vector<std::size_t> L1_neighbors;
+
+            for (const std::size_t i_L2 : mesh.L1PToL2P(i_L1))
+            {
+                auto& statistics = report.L2_partitions[i_L2];
+                GhostEntities ghost_entities;
+
+                statistics.num_cells = L2P_to_cell_offset[i_L2 + 1] - L2P_to_cell_offset[i_L2];
+                statistics.num_nodes = L2P_to_node_offset[i_L2 + 1] - L2P_to_node_offset[i_L2];
+
+                for (const std::size_t other_L2 : map.L2PHasAccessToL2P(i_L2))
+                {
+                    if (other_L2 == i_L2)
+                    {
+                        continue;
+                    }
+
+                    const auto& accessed_entities = map.L2PHasAccessToL2PByEntity(i_L2, other_L2);
+                    const bool other_L1 = (mesh.L2PToL1P(other_L2) != i_L1);
+
+                    ++statistics.num_neighbors;
+
+                    if (other_L1)
+                    {
+                        L1_neighbors.push_back(mesh.L2PToL1P(other_L2));
+                    }
+
+                    for (std::size_t codimension = 0; codimension <= CellDimension; ++codimension)
+                    {
+                        // Each entity is owned by exactly one partition: no duplicates among the L2 partitions.
+                        ghost_entities[codimension].insert(ghost_entities[codimension].end(), accessed_entities[codimension].begin(), accessed_entities[codimension].end());
+
+                        if (other_L1)
+                        {
+                            L1_ghost_entities[codimension].insert(L1_ghost_entities[codimension].end(), accessed_entities[codimension].begin(), accessed_entities[codimension].end());
+                        }
+                    }
+                }
+
+                set_ghost_entities(statistics, ghost_entities);
+                L1_statistics.num_cells += statistics.num_cells;
+                L1_statistics.num_nodes += statistics.num_nodes;
+            }
+
+            // Different L2 partitions of this L1 partition can access the same entities.
+            for (auto& entities : L1_ghost_entities)
+            {
+                make_unique(entities);
+            }
+
+            make_unique(L1_neighbors);
+            L1_statistics.num_neighbors = L1_neighbors.size();
+            set_ghost_entities(L1_statistics, L1_ghost_entities);
+        }
+
+        set_imbalance(report.L1_partitions);
+        set_imbalance(report.L2_partitions);
+
+        return report;
+    }
 } // namespace HPM::drts::data_flow
 
-#endif
\ No newline at end of file
+#endif
@@ -6,54 +6,52 @@
 #ifndef DRTS_DATAFLOW_GRAPH
 #define DRTS_DATAFLOW_GRAPH
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <map>
-#include <set>
+#include <numeric>
+#include <utility>
 #include <vector>
 
+#include <HighPerMeshes/common/Iterator.hpp>
 #include <HighPerMeshes/dsl/data_access/AccessMode.hpp>
 
 namespace HPM::drts::data_flow
 {
     //!
-    //! \tparam Dependency must be able to uniquely identify a given dependency
+    //! \brief A data flow graph: vertices (e.g., mesh loops on partitions) connected by edges from the producers to the consumers of dependencies.
+    //!
+    //! Accesses are collected in flat arrays, and `Finalize` builds the edges for all dependencies in parallel.
+    //! Vertices are numbered consecutively in the order they are added: this is the execution order within a step.
+    //! An edge whose producer is not lower than its consumer connects a vertex with a vertex of the next step (a loop-carried dependency).
+    //! After finalization, the predecessors and successors of each vertex are available in CSR format.
+    //!
+    //! \tparam Dependency must be able to uniquely identify a given dependency (less-than comparable and default constructible)
     //!
     template <typename Dependency>
     class Graph
     {
-        //!  Internal structure to store reads and writes for a given dependency
-        struct ReadsAndWrites
+        //! A read or write access of a vertex to a dependency, identified by its index.
+        struct Access
         {
-            std::set<std::size_t> reads;
-            std::set<std::size_t> writes;
-
-            //! Adds an access mode to a given vertex
-            void Add(std::size_t vertex, AccessMode mode)
-            {
-                if (mode == AccessMode::Read || mode == AccessMode::ReadWrite)
-                {
-                    reads.insert(vertex);
-                }
-
-                if (mode == AccessMode::Write || mode == AccessMode::ReadWrite)
-                {
-                    writes.insert(vertex);
-                }
-            }
+            std::size_t dependency;
+            std::size_t vertex;
         };
 
-        void AddVertex(const std::size_t id) { vertices.insert(id); }
+        void AddVertex(const std::size_t id) { vertices.push_back(id); }
 
         public:
         //! The Edge class consists of a producer and consumer node, identified by an integer and a dependency.
         struct Edge
         {
+            Edge() = default;
+
             Edge(const std::size_t producer, const Dependency edge, const std::size_t consumer) : producer(producer), edge(edge), consumer(consumer) {}
 
-            const std::size_t producer;
-            const Dependency edge;
-            const std::size_t consumer;
+            std::size_t producer;
+            Dependency edge;
+            std::size_t consumer;
         };
 
         //!
@@ -81,11 +79,19 @@ namespace HPM::drts::data_flow
         {
             assert(!finalized);
 
-            auto& accesses = dependency_to_accesses.emplace(dependency, ReadsAndWrites{}).first->second;
-
             if (mode != AccessMode::Accumulate)
             {
-                accesses.Add(vertex, mode);
+                const std::size_t index = dependency_to_index.emplace(dependency, dependency_to_index.size()).first->second;
+
+                if (mode == AccessMode::Read || mode == AccessMode::ReadWrite)
+                {
+                    reads.push_back({index, vertex});
+                }
+
+                if (mode == AccessMode::Write || mode == AccessMode::ReadWrite)
+                {
+                    writes.push_back({index, vertex});
+                }
             }
             else
             {
@@ -106,43 +112,206 @@ namespace HPM::drts::data_flow
         //! is reached we start from the end of the collection.
         //! If there are unmet read or write accesses we add another node to the front or back of the execution order
         //!
+        //! The reads and writes are sorted by their dependency (counting sort), and the edges of the dependencies are created in parallel.
+        //! Edges are ordered by their dependency and, for each dependency, by their consumer.
+        //!
         void Finalize()
         {
             assert(!finalized);
 
-            // If there are unmet read or write accesses we add another node to the front or back of the execution order
-            for (const auto& [edge, reads_and_writes] : dependency_to_accesses)
+            const std::size_t num_dependencies = dependency_to_index.size();
+            std::vector<std::size_t> read_offsets;
+            std::vector<std::size_t> write_offsets;
+            const std::vector<std::size_t>& readers = SortByDependency(reads, num_dependencies, read_offsets);
+            const std::vector<std::size_t>& writers = SortByDependency(writes, num_dependencies, write_offsets);
+
+            // The dependencies in ascending order, and their number of edges: one per (unique) reader.
+            std::vector<std::pair<Dependency, std::size_t>> dependencies(num_dependencies);
+            std::vector<std::size_t> edge_offsets(num_dependencies + 1, 0);
+            bool unmet_reads = false;
+            bool unmet_writes = false;
+
             {
-                if (reads_and_writes.reads.empty())
+                std::size_t rank = 0;
+
+                for (const auto& [dependency, index] : dependency_to_index)
                 {
-                    AddVertex(current_id);
-                    AddDependency(current_id, edge, AccessMode::Read);
+                    dependencies[rank] = {dependency, index};
+                    // If there are unmet read accesses we add another node to the back of the execution order.
+                    edge_offsets[rank + 1] = std::max(read_offsets[index + 1] - read_offsets[index], std::size_t{1});
+                    unmet_reads = unmet_reads || (read_offsets[index + 1] == read_offsets[index]);
+                    unmet_writes = unmet_writes || (write_offsets[index + 1] == write_offsets[index]);
+                    ++rank;
                 }
-                if (reads_and_writes.writes.empty())
+            }
+
+            // If there are unmet write accesses we add another node to the front of the execution order.
+            if (unmet_writes)
+            {
+                vertices.insert(vertices.begin(), initial_id);
+            }
+
+            if (unmet_reads)
+            {
+                AddVertex(current_id);
+            }
+
+            std::partial_sum(edge_offsets.begin(), edge_offsets.end(), edge_offsets.begin());
+            edges.resize(edge_offsets.back());
+
+            // Go forward through all readers of a dependency. For such a reader go backward through the writers of the dependency
+            // until a writer is found that comes before the reader: if there is none, start from the end.
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t rank = 0; rank < num_dependencies; ++rank)
+            {
+                const Dependency& dependency = dependencies[rank].first;
+                const std::size_t index = dependencies[rank].second;
+                const std::size_t* writers_begin = writers.data() + write_offsets[index];
+                const std::size_t* writers_end = writers.data() + write_offsets[index + 1];
+                Edge* edge = edges.data() + edge_offsets[rank];
+
+                auto add_edge = [&](const std::size_t reader) {
+                    std::size_t write_before = initial_id;
+
+                    if (writers_begin != writers_end)
+                    {
+                        const std::size_t* lower_bound = std::lower_bound(writers_begin, writers_end, reader);
+
+                        write_before = (lower_bound != writers_begin) ? *(lower_bound - 1) : *(writers_end - 1);
+                    }
+
+                    *edge++ = Edge{write_before, dependency, reader};
+                };
+
+                if (read_offsets[index + 1] == read_offsets[index])
+                {
+                    add_edge(current_id);
+                }
+
+                for (std::size_t i = read_offsets[index]; i < read_offsets[index + 1]; ++i)
                 {
-                    AddVertex(initial_id);
-                    AddDependency(initial_id, edge, AccessMode::Write);
+                    add_edge(readers[i]);
                 }
             }
 
-            // Go forward through all initial edges. For such an edge go backward through the initial edges
-            // until another initial edge e2 is found such that e.dependency == e2.dependency.
-            for (const auto& [dependency, accesses] : dependency_to_accesses)
+            SetupAdjacency();
+
+            finalized = true;
+        }
+
+        //!
+        //! \brief Remove all edges that are implied by other edges (transitive reduction).
+        //!
+        //! An edge is removed if there is another path from its producer to its consumer, possibly through the next step:
+        //! the order of the vertices is the same in each step, so it is sufficient to consider the paths within two consecutive steps.
+        //! Of multiple edges connecting the same producer and consumer (different dependencies), the first one is kept.
+        //! An executor that waits for the predecessors of each vertex then has fewer dependencies to track, with the same execution order.
+        //!
+        //! \return the number of removed edges
+        //!
+        auto ReduceTransitively() -> std::size_t
+        {
+            assert(finalized);
+
+            const std::size_t num_ids = successor_offsets.size() - 1;
+            const std::size_t num_edges = edges.size();
+            std::vector<std::size_t> redundant_successors(successors.size(), 0);
+
+            // Position of a vertex in the two-step unrolled graph: (step, vertex) -> step * num_ids + vertex.
+            // Forward edges (producer < consumer) connect vertices of the same step, all other edges connect a vertex with a vertex of the next step.
+#pragma omp parallel
             {
-                for (const auto& reader : accesses.reads)
+                std::vector<std::size_t> reached(2 * num_ids, 0);
+                std::vector<std::size_t> stack;
+                std::size_t stamp = 0;
+
+#pragma omp for schedule(dynamic, 64)
+                for (std::size_t producer = 0; producer < num_ids; ++producer)
                 {
+                    const std::size_t begin = successor_offsets[producer];
+                    const std::size_t end = successor_offsets[producer + 1];
+
+                    if (end - begin < 2)
+                    {
+                        // Any other path would start with the only edge.
+                        continue;
+                    }
 
-                    auto lower_bound = accesses.writes.lower_bound(reader);
-                    // Note that lower_bound finds the element one larger than lower_bound, therefore we have to decrement it by one.
-                    auto write_before = (lower_bound != accesses.writes.begin()) ? *(--lower_bound) : *(--accesses.writes.end());
+                    // Direct successors in ascending order of their position: forward edges first.
+                    std::vector<std::pair<std::size_t, std::size_t>> targets;
 
-                    edges.emplace_back(write_before, dependency, reader);
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        targets.emplace_back(GetUnrolledPosition(producer, successors[i], num_ids), i);
+                    }
+
+                    std::sort(targets.begin(), targets.end());
+
+                    const std::size_t max_position = targets.back().first;
+
+                    ++stamp;
+
+                    for (const auto& [position, i] : targets)
+                    {
+                        if (reached[position] == stamp)
+                        {
+                            redundant_successors[i] = 1;
+
+                            continue;
+                        }
+
+                        // Depth-first search: all vertices reachable from this successor, up to the position of the last successor.
+                        stack.assign(1, position);
+
+                        while (!stack.empty())
+                        {
+                            const std::size_t current = stack.back();
+                            const std::size_t step = current / num_ids;
+                            const std::size_t vertex = current % num_ids;
+
+                            stack.pop_back();
+
+                            for (std::size_t j = successor_offsets[vertex]; j < successor_offsets[vertex + 1]; ++j)
+                            {
+                                const std::size_t next = (successors[j] > vertex ? step : step + 1) * num_ids + successors[j];
+
+                                if (next <= max_position && reached[next] != stamp)
+                                {
+                                    reached[next] = stamp;
+                                    stack.push_back(next);
+                                }
+                            }
+                        }
+                    }
                 }
             }
 
-            finalized = true;
+            // Keep the first edge for each non-redundant pair of producer and consumer.
+            std::vector<Edge> reduced_edges;
+
+            for (const auto& edge : edges)
+            {
+                const std::size_t* successors_begin = successors.data() + successor_offsets[edge.producer];
+                const std::size_t* successors_end = successors.data() + successor_offsets[edge.producer + 1];
+                const std::size_t i = std::lower_bound(successors_begin, successors_end, edge.consumer) - successors.data();
+
+                if (redundant_successors[i] == 0)
+                {
+                    // Mark this pair as done.
+                    redundant_successors[i] = 1;
+                    reduced_edges.push_back(edge);
+                }
+            }
+
+            edges.swap(reduced_edges);
+            SetupAdjacency();
+
+            return num_edges - edges.size();
         }
 
+        //!
+        //! \return all vertices in ascending order
+        //!
         const auto& GetVertices() const
         {
             assert(finalized);
@@ -157,14 +326,169 @@ namespace HPM::drts::data_flow
             return edges;
         }
 
+        //!
+        //! \brief Get the producers of all dependencies of a vertex.
+        //!
+        //! \param vertex the vertex
+        //! \return the (unique) producers in ascending order
+        //!
+        auto GetPredecessors(const std::size_t vertex) const -> ::HPM::iterator::IndexSpan
+        {
+            assert(finalized);
+
+            return {predecessors.data() + predecessor_offsets[vertex], predecessor_offsets[vertex + 1] - predecessor_offsets[vertex]};
+        }
+
+        //!
+        //! \brief Get the consumers of all dependencies a vertex produces.
+        //!
+        //! \param vertex the vertex
+        //! \return the (unique) consumers in ascending order
+        //!
+        auto GetSuccessors(const std::size_t vertex) const -> ::HPM::iterator::IndexSpan
+        {
+            assert(finalized);
+
+            return {successors.data() + successor_offsets[vertex], successor_offsets[vertex + 1] - successor_offsets[vertex]};
+        }
+
     private:
+        //!
+        //! \brief Sort the accesses by their dependency (counting sort), and sort and uniquify the vertices of each dependency.
+        //!
+        //! \param accesses the accesses
+        //! \param num_dependencies the number of dependencies
+        //! \param offsets the offsets (prefix sums) of the dependencies within the sorted vertices (output)
+        //! \return the vertices, sorted by dependency and in ascending order for each dependency
+        //!
+        static auto SortByDependency(const std::vector<Access>& accesses, const std::size_t num_dependencies, std::vector<std::size_t>& offsets) -> std::vector<std::size_t>
+        {
+            std::vector<std::size_t> vertices(accesses.size());
+
+            offsets.assign(num_dependencies + 1, 0);
+
+            for (const auto& access : accesses)
+            {
+                ++offsets[access.dependency + 1];
+            }
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            {
+                std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+
+                for (const auto& access : accesses)
+                {
+                    vertices[position[access.dependency]++] = access.vertex;
+                }
+            }
+
+            // Sort and uniquify the vertices of each dependency.
+            std::vector<std::size_t> num_unique(num_dependencies);
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t dependency = 0; dependency < num_dependencies; ++dependency)
+            {
+                const auto begin = vertices.begin() + offsets[dependency];
+                const auto end = vertices.begin() + offsets[dependency + 1];
+
+                std::sort(begin, end);
+                num_unique[dependency] = std::distance(begin, std::unique(begin, end));
+            }
+
+            // Compact the unique vertices.
+            std::size_t size = 0;
+
+            for (std::size_t dependency = 0; dependency < num_dependencies; ++dependency)
+            {
+                const std::size_t begin = offsets[dependency];
+
+                std::copy(vertices.begin() + begin, vertices.begin() + begin + num_unique[dependency], vertices.begin() + size);
+                offsets[dependency] = size;
+                size += num_unique[dependency];
+            }
+
+            offsets[num_dependencies] = size;
+            vertices.resize(size);
+
+            return vertices;
+        }
+
+        //!
+        //! \brief Set up the predecessors and successors of each vertex from the edges (CSR).
+        //!
+        auto SetupAdjacency() -> void
+        {
+            const std::size_t num_ids = (vertices.empty() ? 0 : vertices.back() + 1);
+
+            auto setup = [this, num_ids](auto get_vertex, auto get_neighbor, std::vector<std::size_t>& offsets, std::vector<std::size_t>& neighbors) {
+                offsets.assign(num_ids + 1, 0);
+                neighbors.resize(edges.size());
+
+                for (const auto& edge : edges)
+                {
+                    ++offsets[get_vertex(edge) + 1];
+                }
+
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+
+                for (const auto& edge : edges)
+                {
+                    neighbors[position[get_vertex(edge)]++] = get_neighbor(edge);
+                }
+
+                // Sort and uniquify the neighbors of each vertex (in place), then compact.
+                std::vector<std::size_t> num_unique(num_ids);
+
+#pragma omp parallel for schedule(dynamic, 256)
+                for (std::size_t vertex = 0; vertex < num_ids; ++vertex)
+                {
+                    const auto begin = neighbors.begin() + offsets[vertex];
+                    const auto end = neighbors.begin() + offsets[vertex + 1];
+
+                    std::sort(begin, end);
+                    num_unique[vertex] = std::distance(begin, std::unique(begin, end));
+                }
+
+                std::size_t size = 0;
+
+                for (std::size_t vertex = 0; vertex < num_ids; ++vertex)
+                {
+                    const std::size_t begin = offsets[vertex];
+
+                    std::copy(neighbors.begin() + begin, neighbors.begin() + begin + num_unique[vertex], neighbors.begin() + size);
+                    offsets[vertex] = size;
+                    size += num_unique[vertex];
+                }
+
+                offsets[num_ids] = size;
+                neighbors.resize(size);
+            };
+
+            setup([](const Edge& edge) { return edge.consumer; }, [](const Edge& edge) { return edge.producer; }, predecessor_offsets, predecessors);
+            setup([](const Edge& edge) { return edge.producer; }, [](const Edge& edge) { return edge.consumer; }, successor_offsets, successors);
+        }
+
+        //!
+        //! \brief Get the position of the consumer of an edge in the two-step unrolled graph, relative to the producer in the first step.
+        //!
+        static auto GetUnrolledPosition(const std::size_t producer, const std::size_t consumer, const std::size_t num_ids) -> std::size_t { return (consumer > producer ? consumer : num_ids + consumer); }
+
         bool finalized;
         std::size_t initial_id;
         std::size_t current_id;
-        std::set<std::size_t> vertices;
+        std::vector<std::size_t> vertices;
         std::vector<Edge> edges;
-        std::map<Dependency, ReadsAndWrites> dependency_to_accesses;
+        std::map<Dependency, std::size_t> dependency_to_index;
+        std::vector<Access> reads;
+        std::vector<Access> writes;
+        std::vector<std::size_t> predecessor_offsets;
+        std::vector<std::size_t> predecessors;
+        std::vector<std::size_t> successor_offsets;
+        std::vector<std::size_t> successors;
     };
 } // namespace HPM::drts::data_flow
 
-#endif
\ No newline at end of file
+#endif
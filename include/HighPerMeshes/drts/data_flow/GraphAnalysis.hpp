@@ -0,0 +1,425 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DRTS_DATAFLOW_GRAPHANALYSIS_HPP
+#define DRTS_DATAFLOW_GRAPHANALYSIS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/drts/data_flow/Graph.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
+
+namespace HPM::drts::data_flow
+{
+    //!
+    //! \brief Critical path, parallelism and idle time of a data flow graph (see `AnalyzeSchedule`).
+    //!
+    //! Tasks are identified by their step and their vertex.
+    //! Durations are given in seconds, or in units of one task if no durations are given.
+    //!
+    struct ScheduleAnalysis
+    {
+        std::size_t num_steps = 0;
+        std::size_t num_workers = 0;
+        std::vector<double> durations;                                  //!< the duration of each task, indexed by the vertex
+        std::vector<std::pair<std::size_t, std::size_t>> critical_path; //!< the tasks (step, vertex) on the critical path, in execution order
+        std::vector<std::size_t> parallelism;                           //!< the number of tasks of each level: tasks of the same level are independent of each other
+        double total_work = 0.0;                                        //!< the sum of the durations of all tasks
+        double critical_path_length = 0.0;                              //!< the execution time with an unlimited number of workers
+        double makespan = 0.0;                                          //!< the execution time of a list schedule with `num_workers` workers
+        double idle_time = 0.0;                                         //!< the time the workers are idle in the list schedule, summed up over all workers
+
+        //!
+        //! \return the average number of tasks that can run concurrently: the total work divided by the length of the critical path
+        //!
+        auto GetAverageParallelism() const -> double { return (critical_path_length > 0.0 ? total_work / critical_path_length : 0.0); }
+
+        //!
+        //! \return the fraction of the worker time spent on tasks in the list schedule
+        //!
+        auto GetEfficiency() const -> double { return (makespan > 0.0 ? total_work / (num_workers * makespan) : 1.0); }
+
+        //!
+        //! \brief Test if a vertex is on the critical path (in any step).
+        //!
+        //! \param vertex the vertex
+        //! \return `true` if the vertex is on the critical path
+        //!
+        auto IsCritical(const std::size_t vertex) const -> bool
+        {
+            return std::any_of(critical_path.begin(), critical_path.end(), [vertex](const auto& task) { return task.second == vertex; });
+        }
+
+        //!
+        //! \brief Write the analysis as text.
+        //!
+        //! \param stream the output stream
+        //!
+        auto WriteText(std::ostream& stream) const -> void
+        {
+            const auto flags = stream.flags();
+            const auto precision = stream.precision();
+
+            stream << "steps: " << num_steps << ", workers: " << num_workers << std::endl;
+            stream << std::setprecision(6) << "total work: " << total_work << ", critical path: " << critical_path_length << ", average parallelism: " << GetAverageParallelism() << std::endl;
+            stream << "makespan: " << makespan << ", idle time: " << idle_time << ", efficiency: " << GetEfficiency() << std::endl;
+            stream << "critical path (step:vertex):";
+
+            for (const auto& [step, vertex] : critical_path)
+            {
+                stream << " " << step << ":" << vertex;
+            }
+
+            stream << std::endl << "parallelism per level:";
+
+            for (const std::size_t num_tasks : parallelism)
+            {
+                stream << " " << num_tasks;
+            }
+
+            stream << std::endl;
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        //!
+        //! \brief Write the analysis as a JSON object.
+        //!
+        //! \param stream the output stream
+        //!
+        auto WriteJson(std::ostream& stream) const -> void
+        {
+            stream << "{\"num_steps\":" << num_steps << ",\"num_workers\":" << num_workers << ",\"total_work\":" << total_work << ",\"critical_path_length\":" << critical_path_length
+                   << ",\"average_parallelism\":" << GetAverageParallelism() << ",\"makespan\":" << makespan << ",\"idle_time\":" << idle_time << ",\"efficiency\":" << GetEfficiency()
+                   << ",\"critical_path\":[";
+
+            for (std::size_t i = 0; i < critical_path.size(); ++i)
+            {
+                stream << (i == 0 ? "" : ",") << "{\"step\":" << critical_path[i].first << ",\"vertex\":" << critical_path[i].second << "}";
+            }
+
+            stream << "],\"parallelism\":[";
+
+            for (std::size_t level = 0; level < parallelism.size(); ++level)
+            {
+                stream << (level == 0 ? "" : ",") << parallelism[level];
+            }
+
+            stream << "]}" << std::endl;
+        }
+
+        //!
+        //! \brief Write a data flow graph in the DOT format (Graphviz) with the critical path highlighted.
+        //!
+        //! Vertices are labeled with their id and duration.
+        //! Edges into the next step (loop-carried dependencies) are dashed.
+        //!
+        //! \tparam Dependency the dependency type of the graph
+        //! \param stream the output stream
+        //! \param graph the graph that has been analyzed
+        //!
+        template <typename Dependency>
+        auto WriteDot(std::ostream& stream, const Graph<Dependency>& graph) const -> void
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> critical_edges;
+
+            for (std::size_t i = 1; i < critical_path.size(); ++i)
+            {
+                critical_edges.emplace_back(critical_path[i - 1].second, critical_path[i].second);
+            }
+
+            std::sort(critical_edges.begin(), critical_edges.end());
+
+            stream << "digraph data_flow {" << std::endl;
+            stream << "  node [shape=box];" << std::endl;
+
+            for (const std::size_t vertex : graph.GetVertices())
+            {
+                stream << "  " << vertex << " [label=\"" << vertex << "\\n" << (vertex < durations.size() ? durations[vertex] : 0.0) << "\"" << (IsCritical(vertex) ? ", color=red, penwidth=2" : "") << "];"
+                       << std::endl;
+            }
+
+            for (const std::size_t producer : graph.GetVertices())
+            {
+                for (const std::size_t consumer : graph.GetSuccessors(producer))
+                {
+                    const bool critical = std::binary_search(critical_edges.begin(), critical_edges.end(), std::make_pair(producer, consumer));
+                    const bool next_step = (consumer <= producer);
+
+                    stream << "  " << producer << " -> " << consumer;
+
+                    if (critical || next_step)
+                    {
+                        stream << " [" << (critical ? "color=red, penwidth=2" : "") << (critical && next_step ? ", " : "") << (next_step ? "style=dashed" : "") << "]";
+                    }
+
+                    stream << ";" << std::endl;
+                }
+            }
+
+            stream << "}" << std::endl;
+        }
+    };
+
+    //!
+    //! \brief Get the durations of the tasks of a data flow graph from the events recorded by a `LoopTimer`.
+    //!
+    //! The duration of a task in one step is the time between the first begin and the last end of its events (all threads).
+    //! The durations are averaged over all steps recorded for a task.
+    //!
+    //! \tparam GetVertex the type of the callable
+    //! \param events the recorded events, see `LoopTimer::GetEvents`
+    //! \param num_vertices the number of vertex ids of the graph
+    //! \param get_vertex a callable that maps an event to its vertex: events mapped to ids not lower than `num_vertices` are ignored
+    //! \return the duration of each task in seconds, indexed by the vertex
+    //!
+    template <typename GetVertex>
+    auto GetTaskDurations(const std::vector<LoopEvent>& events, const std::size_t num_vertices, GetVertex&& get_vertex) -> std::vector<double>
+    {
+        std::map<std::pair<std::size_t, std::size_t>, std::pair<std::int64_t, std::int64_t>> intervals;
+
+        for (const auto& event : events)
+        {
+            const std::size_t vertex = get_vertex(event);
+
+            if (vertex < num_vertices)
+            {
+                auto [it, inserted] = intervals.try_emplace({vertex, event.step}, event.begin, event.end);
+
+                if (!inserted)
+                {
+                    it->second.first = std::min(it->second.first, event.begin);
+                    it->second.second = std::max(it->second.second, event.end);
+                }
+            }
+        }
+
+        std::vector<double> durations(num_vertices, 0.0);
+        std::vector<std::size_t> num_steps(num_vertices, 0);
+
+        for (const auto& [task, interval] : intervals)
+        {
+            durations[task.first] += (interval.second - interval.first) * 1.0E-9;
+            ++num_steps[task.first];
+        }
+
+        for (std::size_t vertex = 0; vertex < num_vertices; ++vertex)
+        {
+            durations[vertex] /= std::max(num_steps[vertex], std::size_t{1});
+        }
+
+        return durations;
+    }
+
+    //!
+    //! \brief Analyze the execution of a finalized data flow graph over a number of steps.
+    //!
+    //! The graph is unrolled over the steps: edges whose consumer is not greater than the producer connect a task with a task of the next step.
+    //! The critical path is the longest path through the unrolled graph, weighted by the task durations.
+    //! The level of a task is the number of tasks on the longest chain of dependencies before it.
+    //! The makespan and the idle time are those of a list schedule that starts ready tasks with the longest remaining path first.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! graph.Finalize();
+    //! const auto& durations = GetTaskDurations(timer.GetEvents(), num_vertices, [](const LoopEvent& event) { return 1 + event.partition * 2 + event.loop; });
+    //! const auto& analysis = AnalyzeSchedule(graph, durations, omp_get_max_threads(), 10);
+    //! analysis.WriteText(std::cout);
+    //! \endcode
+    //!
+    //! \tparam Dependency the dependency type of the graph
+    //! \param graph the finalized graph
+    //! \param durations the duration of each task, indexed by the vertex (missing entries are 0): if empty, each task takes one unit of time
+    //! \param num_workers the number of workers of the list schedule
+    //! \param num_steps the number of steps
+    //! \return the analysis
+    //!
+    template <typename Dependency>
+    auto AnalyzeSchedule(const Graph<Dependency>& graph, const std::vector<double>& durations = {}, const std::size_t num_workers = 1, const std::size_t num_steps = 1) -> ScheduleAnalysis
+    {
+        if (num_workers == 0 || num_steps == 0)
+        {
+            throw std::runtime_error("error: the number of workers and the number of steps must be positive");
+        }
+
+        const auto& vertices = graph.GetVertices();
+        const std::size_t num_ids = (vertices.empty() ? 0 : vertices.back() + 1);
+        const std::size_t num_positions = num_steps * num_ids;
+        constexpr std::size_t None = std::numeric_limits<std::size_t>::max();
+        ScheduleAnalysis analysis;
+
+        analysis.num_steps = num_steps;
+        analysis.num_workers = num_workers;
+        analysis.durations.assign(num_ids, 0.0);
+
+        for (const std::size_t vertex : vertices)
+        {
+            analysis.durations[vertex] = (durations.empty() ? 1.0 : (vertex < durations.size() ? durations[vertex] : 0.0));
+        }
+
+        // Tasks of the unrolled graph: position = step * num_ids + vertex.
+        // Ordering the tasks by step and vertex is a topological order: edges within a step go to greater vertices.
+        std::vector<std::size_t> tasks;
+
+        for (std::size_t step = 0; step < num_steps; ++step)
+        {
+            for (const std::size_t vertex : vertices)
+            {
+                tasks.push_back(step * num_ids + vertex);
+            }
+        }
+
+        auto for_each_predecessor = [&graph, num_ids](const std::size_t position, auto&& func) {
+            const std::size_t step = position / num_ids;
+            const std::size_t vertex = position % num_ids;
+
+            for (const std::size_t producer : graph.GetPredecessors(vertex))
+            {
+                if (producer < vertex)
+                {
+                    func(step * num_ids + producer);
+                }
+                else if (step > 0)
+                {
+                    func((step - 1) * num_ids + producer);
+                }
+            }
+        };
+
+        auto for_each_successor = [&graph, num_ids, num_steps](const std::size_t position, auto&& func) {
+            const std::size_t step = position / num_ids;
+            const std::size_t vertex = position % num_ids;
+
+            for (const std::size_t consumer : graph.GetSuccessors(vertex))
+            {
+                if (consumer > vertex)
+                {
+                    func(step * num_ids + consumer);
+                }
+                else if (step + 1 < num_steps)
+                {
+                    func((step + 1) * num_ids + consumer);
+                }
+            }
+        };
+
+        auto duration = [&analysis, num_ids](const std::size_t position) { return analysis.durations[position % num_ids]; };
+
+        // Earliest finish time and level (forward), and the longest remaining path (backward).
+        std::vector<double> finish(num_positions, 0.0);
+        std::vector<double> remaining(num_positions, 0.0);
+        std::vector<std::size_t> critical_predecessor(num_positions, None);
+        std::vector<std::size_t> level(num_positions, 0);
+        std::vector<std::size_t> num_predecessors(num_positions, 0);
+
+        for (const std::size_t position : tasks)
+        {
+            double start = 0.0;
+
+            for_each_predecessor(position, [&](const std::size_t predecessor) {
+                if (critical_predecessor[position] == None || finish[predecessor] > start)
+                {
+                    start = finish[predecessor];
+                    critical_predecessor[position] = predecessor;
+                }
+
+                level[position] = std::max(level[position], level[predecessor] + 1);
+                ++num_predecessors[position];
+            });
+
+            finish[position] = start + duration(position);
+            analysis.total_work += duration(position);
+
+            if (level[position] >= analysis.parallelism.size())
+            {
+                analysis.parallelism.resize(level[position] + 1, 0);
+            }
+
+            ++analysis.parallelism[level[position]];
+        }
+
+        for (auto it = tasks.rbegin(); it != tasks.rend(); ++it)
+        {
+            double longest_successor = 0.0;
+
+            for_each_successor(*it, [&](const std::size_t successor) { longest_successor = std::max(longest_successor, remaining[successor]); });
+
+            remaining[*it] = duration(*it) + longest_successor;
+        }
+
+        // The critical path ends in the task that finishes last.
+        if (!tasks.empty())
+        {
+            std::size_t position = *std::max_element(tasks.begin(), tasks.end(), [&finish](const std::size_t lhs, const std::size_t rhs) { return finish[lhs] < finish[rhs]; });
+
+            analysis.critical_path_length = finish[position];
+
+            for (; position != None; position = critical_predecessor[position])
+            {
+                analysis.critical_path.emplace_back(position / num_ids, position % num_ids);
+            }
+
+            std::reverse(analysis.critical_path.begin(), analysis.critical_path.end());
+        }
+
+        // List schedule: whenever a worker is free, start the ready task with the longest remaining path (ties: execution order).
+        {
+            auto lower_priority = [&remaining](const std::size_t lhs, const std::size_t rhs) { return (remaining[lhs] < remaining[rhs]) || (remaining[lhs] == remaining[rhs] && lhs > rhs); };
+            std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(lower_priority)> ready(lower_priority);
+            std::priority_queue<std::pair<double, std::size_t>, std::vector<std::pair<double, std::size_t>>, std::greater<>> running;
+            std::size_t num_free_workers = num_workers;
+            double time = 0.0;
+
+            for (const std::size_t position : tasks)
+            {
+                if (num_predecessors[position] == 0)
+                {
+                    ready.push(position);
+                }
+            }
+
+            while (!ready.empty() || !running.empty())
+            {
+                while (num_free_workers > 0 && !ready.empty())
+                {
+                    running.emplace(time + duration(ready.top()), ready.top());
+                    ready.pop();
+                    --num_free_workers;
+                }
+
+                time = running.top().first;
+
+                while (!running.empty() && running.top().first == time)
+                {
+                    for_each_successor(running.top().second, [&](const std::size_t successor) {
+                        if (--num_predecessors[successor] == 0)
+                        {
+                            ready.push(successor);
+                        }
+                    });
+
+                    running.pop();
+                    ++num_free_workers;
+                }
+            }
+
+            analysis.makespan = time;
+            analysis.idle_time = num_workers * time - analysis.total_work;
+        }
+
+        return analysis;
+    }
+} // namespace HPM::drts::data_flow
+
+#endif
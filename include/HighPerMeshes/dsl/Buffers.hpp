@@ -10,5 +10,7 @@
 #include <HighPerMeshes/dsl/buffers/BufferBase.hpp>
 #include <HighPerMeshes/dsl/buffers/DistributedBuffer.hpp>
 #include <HighPerMeshes/dsl/buffers/LocalBuffer.hpp>
+#include <HighPerMeshes/dsl/buffers/Snapshot.hpp>
+#include <HighPerMeshes/dsl/buffers/VtuWriter.hpp>
 
 #endif
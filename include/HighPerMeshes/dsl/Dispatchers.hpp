@@ -6,7 +6,12 @@
 #ifndef DSL_DISPATCHER_COLLECTIVE_HEADER
 #define DSL_DISPATCHER_COLLECTIVE_HEADER
 
+#include <HighPerMeshes/dsl/dispatchers/CostProfiler.hpp>
 #include <HighPerMeshes/dsl/dispatchers/Dispatcher.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
+#include <HighPerMeshes/dsl/dispatchers/OpenMPDispatcher.hpp>
+#include <HighPerMeshes/dsl/dispatchers/PerfCounters.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Roofline.hpp>
 #include <HighPerMeshes/dsl/dispatchers/SequentialDispatcher.hpp>
 
 #endif
\ No newline at end of file
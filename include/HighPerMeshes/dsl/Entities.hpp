@@ -6,6 +6,7 @@
 #ifndef DSL_ENTITIES_COLLECTIVE_HEADER
 #define DSL_ENTITIES_COLLECTIVE_HEADER
 
+#include <HighPerMeshes/dsl/entities/EntityHandle.hpp>
 #include <HighPerMeshes/dsl/entities/Geometry.hpp>
 #include <HighPerMeshes/dsl/entities/Simplex.hpp>
 #include <HighPerMeshes/dsl/entities/Topology.hpp>
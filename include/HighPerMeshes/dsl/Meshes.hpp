@@ -6,6 +6,9 @@
 #ifndef DSL_MESHES_COLLECTIVE_HEADERS
 #define DSL_MESHES_COLLECTIVE_HEADERS
 
+#include <HighPerMeshes/dsl/meshes/BoxMeshGenerator.hpp>
+#include <HighPerMeshes/dsl/meshes/GeometricPartitioner.hpp>
+#include <HighPerMeshes/dsl/meshes/GeometryCachePolicy.hpp>
 #include <HighPerMeshes/dsl/meshes/Mesh.hpp>
 #include <HighPerMeshes/dsl/meshes/PartitionedMesh.hpp>
 #include <HighPerMeshes/dsl/meshes/Partitioner.hpp>
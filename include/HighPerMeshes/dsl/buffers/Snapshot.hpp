@@ -0,0 +1,312 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_BUFFERS_SNAPSHOT_HPP
+#define DSL_BUFFERS_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <HighPerMeshes/auxiliary/ConstexprFor.hpp>
+
+namespace HPM
+{
+    namespace internal
+    {
+        //!
+        //! \brief Snapshot file header.
+        //!
+        //! A snapshot file consists of this header followed by a `SnapshotBufferHeader` and the raw data for each buffer.
+        //!
+        struct SnapshotHeader
+        {
+            char magic[8];
+            std::uint64_t version;
+            std::uint64_t step;
+            std::uint64_t num_buffers;
+        };
+
+        //!
+        //! \brief Description of a buffer within a snapshot file: entry type, mesh and dofs.
+        //!
+        struct SnapshotBufferHeader
+        {
+            std::uint64_t value_size;
+            std::uint64_t num_values;
+            std::uint64_t cell_dimension;
+            std::uint64_t num_entities[4];
+            std::uint64_t dofs[5];
+
+            auto operator==(const SnapshotBufferHeader& other) const { return std::memcmp(this, &other, sizeof(SnapshotBufferHeader)) == 0; }
+        };
+
+        constexpr char SnapshotMagic[8] = {'H', 'P', 'M', 'S', 'N', 'A', 'P', '\0'};
+        constexpr std::uint64_t SnapshotVersion = 1;
+
+        template <typename BufferT>
+        auto GetSnapshotBufferHeader(const BufferT& buffer) -> SnapshotBufferHeader
+        {
+            using MeshT = typename BufferT::MeshT;
+            using ValueT = typename BufferT::ValueT;
+
+            static_assert(MeshT::CellDimension <= 3, "error: snapshots support meshes with cell dimension up to 3");
+            static_assert(std::is_trivially_copyable_v<ValueT>, "error: buffer entries are written as raw data");
+
+            SnapshotBufferHeader header{sizeof(ValueT), buffer.GetSize(), MeshT::CellDimension, {}, {}};
+
+            ::HPM::auxiliary::ConstexprFor<0, MeshT::CellDimension + 1>([&](const auto Dimension) { header.num_entities[Dimension] = buffer.GetMesh().template GetNumEntities<Dimension>(); });
+            ::HPM::auxiliary::ConstexprFor<0, MeshT::CellDimension + 2>([&](const auto Dimension) { header.dofs[Dimension] = buffer.GetDofs().template At<Dimension>(); });
+
+            return header;
+        }
+
+        //!
+        //! \brief Parallel (OpenMP) memcpy in chunks of 1 MiB.
+        //!
+        inline auto ParallelCopy(char* destination, const char* source, const std::size_t size) -> void
+        {
+            constexpr std::size_t ChunkSize = (1UL << 20);
+            const std::size_t num_chunks = (size + ChunkSize - 1) / ChunkSize;
+
+#pragma omp parallel for schedule(static)
+            for (std::size_t chunk = 0; chunk < num_chunks; ++chunk)
+            {
+                const std::size_t begin = chunk * ChunkSize;
+
+                std::memcpy(destination + begin, source + begin, std::min(ChunkSize, size - begin));
+            }
+        }
+    } // namespace internal
+
+    //!
+    //! \brief Timing summary of all snapshots written by a `SnapshotWriter`.
+    //!
+    //! The copy time and the wait time block the caller, the write time is spent in the background.
+    //!
+    struct SnapshotReport
+    {
+        std::size_t num_snapshots;
+        std::size_t bytes;
+        double copy_time;
+        double write_time;
+        double wait_time;
+
+        //! \return the write time that overlapped with the computation
+        auto GetHiddenTime() const { return std::max(write_time - wait_time, 0.0); }
+
+        //! \return the fraction of the write time that overlapped with the computation
+        auto GetHiddenFraction() const { return (write_time > 0.0 ? GetHiddenTime() / write_time : 1.0); }
+    };
+
+    //!
+    //! \brief Asynchronous snapshot (checkpoint) writer.
+    //!
+    //! `Write()` copies the buffers into a staging area in parallel and returns: the file is written in the background,
+    //! while the caller continues with the next time steps.
+    //! There is a single staging area: a `Write()` waits for the previous snapshot to be written.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! SnapshotWriter snapshots;
+    //! for (std::size_t step = 0; step < num_steps; step += checkpoint_interval)
+    //! {
+    //!     dispatcher.Execute(iterator::Range{step, step + checkpoint_interval}, loops...);
+    //!     snapshots.Write("checkpoint_" + std::to_string(step) + ".hpm", step + checkpoint_interval, fieldH, fieldE);
+    //! }
+    //! snapshots.Wait();
+    //! ...
+    //! const std::size_t step = LoadSnapshot("checkpoint_0100.hpm", fieldH, fieldE);
+    //! \endcode
+    //!
+    class SnapshotWriter
+    {
+        using ClockT = std::chrono::high_resolution_clock;
+
+        public:
+        SnapshotWriter() = default;
+
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+        ~SnapshotWriter()
+        {
+            try
+            {
+                Wait();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        //!
+        //! \brief Write a snapshot of a set of buffers in the background.
+        //!
+        //! \param filename the file to write to
+        //! \param step the time step the snapshot belongs to
+        //! \param buffers the buffers: they can be modified as soon as this function returns
+        //!
+        template <typename... BufferT>
+        auto Write(const std::string& filename, const std::size_t step, const BufferT&... buffers) -> void
+        {
+            Wait();
+
+            const auto begin = ClockT::now();
+            internal::SnapshotHeader header{{}, internal::SnapshotVersion, step, sizeof...(BufferT)};
+            std::size_t size = sizeof(header);
+
+            ((size += sizeof(internal::SnapshotBufferHeader) + buffers.GetSize() * sizeof(typename BufferT::ValueT)), ...);
+
+            // Resize only: the staging area is overwritten entirely.
+            if (staging.size() < size)
+            {
+                staging.resize(size);
+            }
+
+            std::size_t position = 0;
+            auto append = [this, &position](const void* data, const std::size_t bytes, const bool parallel) {
+                if (parallel)
+                {
+                    internal::ParallelCopy(staging.data() + position, static_cast<const char*>(data), bytes);
+                }
+                else
+                {
+                    std::memcpy(staging.data() + position, data, bytes);
+                }
+
+                position += bytes;
+            };
+
+            std::memcpy(header.magic, internal::SnapshotMagic, sizeof(internal::SnapshotMagic));
+            append(&header, sizeof(header), false);
+
+            (
+                [&](const auto& buffer) {
+                    const auto& buffer_header = internal::GetSnapshotBufferHeader(buffer);
+
+                    append(&buffer_header, sizeof(buffer_header), false);
+                    append(buffer.GetData(), buffer_header.num_values * buffer_header.value_size, true);
+                }(buffers),
+                ...);
+
+            report.copy_time += std::chrono::duration<double>(ClockT::now() - begin).count();
+            report.bytes += size;
+            ++report.num_snapshots;
+
+            pending_write = std::async(std::launch::async, [this, filename, size]() {
+                const auto begin = ClockT::now();
+                std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+                if (!file)
+                {
+                    throw std::runtime_error("error: could not open file: " + filename);
+                }
+
+                file.write(staging.data(), size);
+                file.close();
+
+                if (!file)
+                {
+                    throw std::runtime_error("error: could not write file: " + filename);
+                }
+
+                return std::chrono::duration<double>(ClockT::now() - begin).count();
+            });
+        }
+
+        //!
+        //! \brief Wait for the current snapshot to be written.
+        //!
+        //! Errors of the background write are rethrown here.
+        //!
+        auto Wait() -> void
+        {
+            if (pending_write.valid())
+            {
+                const auto begin = ClockT::now();
+
+                pending_write.wait();
+                report.wait_time += std::chrono::duration<double>(ClockT::now() - begin).count();
+                report.write_time += pending_write.get();
+            }
+        }
+
+        //!
+        //! \return the timing summary of all completed snapshots
+        //!
+        auto GetReport() const -> const SnapshotReport& { return report; }
+
+        private:
+        std::vector<char> staging;
+        std::future<double> pending_write;
+        SnapshotReport report{};
+    };
+
+    //!
+    //! \brief Load a snapshot into a set of buffers (restart).
+    //!
+    //! The buffers must match the buffers the snapshot has been written from: entry type, mesh and dofs.
+    //!
+    //! \param filename the snapshot file
+    //! \param buffers the buffers to load the data into
+    //! \return the time step of the snapshot
+    //!
+    template <typename... BufferT>
+    auto LoadSnapshot(const std::string& filename, BufferT&... buffers) -> std::size_t
+    {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+        if (!file)
+        {
+            throw std::runtime_error("error: could not open file: " + filename);
+        }
+
+        internal::SnapshotHeader header;
+
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        if (!file || std::memcmp(header.magic, internal::SnapshotMagic, sizeof(internal::SnapshotMagic)) != 0 || header.version != internal::SnapshotVersion)
+        {
+            throw std::runtime_error("error: not a snapshot file: " + filename);
+        }
+
+        if (header.num_buffers != sizeof...(BufferT))
+        {
+            throw std::runtime_error("error: the snapshot contains " + std::to_string(header.num_buffers) + " buffers");
+        }
+
+        (
+            [&](auto& buffer) {
+                internal::SnapshotBufferHeader buffer_header;
+
+                file.read(reinterpret_cast<char*>(&buffer_header), sizeof(buffer_header));
+
+                if (!file || !(buffer_header == internal::GetSnapshotBufferHeader(buffer)))
+                {
+                    throw std::runtime_error("error: the snapshot does not match the buffer (entry type, mesh or dofs)");
+                }
+
+                file.read(reinterpret_cast<char*>(buffer.GetData()), buffer_header.num_values * buffer_header.value_size);
+
+                if (!file)
+                {
+                    throw std::runtime_error("error: truncated snapshot file: " + filename);
+                }
+            }(buffers),
+            ...);
+
+        return header.step;
+    }
+} // namespace HPM
+
+#endif
@@ -0,0 +1,657 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_BUFFERS_VTUWRITER_HPP
+#define DSL_BUFFERS_VTUWRITER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(HPM_ENABLE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include <HighPerMeshes/common/Vec.hpp>
+#include <HighPerMeshes/dsl/data_access/Dof.hpp>
+
+namespace HPM
+{
+    namespace internal
+    {
+        //!
+        //! \brief Scalar type and number of components of a buffer entry.
+        //!
+        //! \tparam T the buffer entry type: an arithmetic type or a `Vec` of those
+        //!
+        template <typename T>
+        struct VtkValue
+        {
+            static_assert(std::is_arithmetic_v<T>, "error: only arithmetic types and Vec types can be written");
+
+            using ScalarT = T;
+
+            static constexpr std::size_t NumComponents = 1;
+
+            static auto Get(const T& value, const std::size_t) -> ScalarT { return value; }
+        };
+
+        template <typename T, std::size_t Dimension>
+        struct VtkValue<::HPM::dataType::Vec<T, Dimension>>
+        {
+            static_assert(std::is_arithmetic_v<T>, "error: only arithmetic types and Vec types can be written");
+
+            using ScalarT = T;
+
+            static constexpr std::size_t NumComponents = Dimension;
+
+            static auto Get(const ::HPM::dataType::Vec<T, Dimension>& value, const std::size_t component) -> ScalarT { return value[component]; }
+        };
+
+        //!
+        //! \return the VTK type name of an arithmetic type
+        //!
+        template <typename T>
+        auto GetVtkTypeName() -> std::string
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                static_assert(sizeof(T) == 4 || sizeof(T) == 8, "error: unsupported floating point type");
+
+                return (sizeof(T) == 4 ? "Float32" : "Float64");
+            }
+            else
+            {
+                return std::string(std::is_signed_v<T> ? "Int" : "UInt") + std::to_string(8 * sizeof(T));
+            }
+        }
+
+        //!
+        //! \brief Test for a mesh with L2 partitions.
+        //!
+        template <typename MeshT, typename = void>
+        struct HasL2Partitions : std::false_type
+        {
+        };
+
+        template <typename MeshT>
+        struct HasL2Partitions<MeshT, std::void_t<decltype(std::declval<const MeshT&>().GetNumL2Partitions())>> : std::true_type
+        {
+        };
+    } // namespace internal
+
+    //!
+    //! \brief Writer for VTK unstructured grid files (`.vtu`) with appended raw binary data.
+    //!
+    //! The cells of each L2 partition of a `PartitionedMesh` are written as a separate piece (file), a plain `Mesh` is written as a single piece.
+    //! Pieces are written in parallel (OpenMP), and a `.pvtu` file references all of them.
+    //! Each piece contains the nodes of its cells only: nodes at the partition boundaries are written by all pieces sharing them.
+    //!
+    //! Fields are gathered from the buffer storage into binary arrays, which are optionally compressed with zlib
+    //! (requires `HPM_ENABLE_ZLIB` and linking against zlib).
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! VtuWriter writer{mesh};
+    //! writer.AddCellData("rho", rho).AddPointData("phi", phi).AddPointData("E", fieldE, [](const auto& cell, const auto* dofs, std::size_t node) { ... });
+    //! writer.Write("output/step_0100");
+    //! \endcode
+    //!
+    //! \tparam MeshT the mesh type
+    //!
+    template <typename MeshT>
+    class VtuWriter
+    {
+        static constexpr std::size_t CellDimension = MeshT::CellDimension;
+        static constexpr std::size_t BlockSize = (1UL << 20);
+
+        //!
+        //! \brief The cells and nodes of a piece.
+        //!
+        struct Piece
+        {
+            std::vector<std::size_t> cells;
+            // Sorted (global) indices.
+            std::vector<std::size_t> nodes;
+        };
+
+        //!
+        //! \brief A field gathered from a buffer: either one value per cell or per node of a piece.
+        //!
+        struct Field
+        {
+            std::string name;
+            std::string type;
+            std::size_t num_components;
+            bool at_points;
+            std::function<void(const Piece&, std::vector<char>&)> gather;
+        };
+
+        public:
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param mesh the mesh
+        //! \param compress compress the appended data with zlib
+        //!
+        VtuWriter(const MeshT& mesh, const bool compress = false) : mesh(mesh), compress(compress)
+        {
+#if !defined(HPM_ENABLE_ZLIB)
+            if (compress)
+            {
+                throw std::runtime_error("error: zlib compression is not enabled (define HPM_ENABLE_ZLIB)");
+            }
+#endif
+        }
+
+        //!
+        //! \brief Write the cell dofs of a buffer as cell data.
+        //!
+        //! All dofs of a cell are written as components of one tuple.
+        //!
+        //! \param name the name of the field
+        //! \param buffer a buffer with cell dofs
+        //! \return a reference to this writer
+        //!
+        template <typename BufferT>
+        auto AddCellData(const std::string& name, const BufferT& buffer) -> VtuWriter&
+        {
+            using ValueT = internal::VtkValue<typename BufferT::ValueT>;
+
+            const std::size_t num_dofs = buffer.GetDofs().template At<CellDimension>();
+
+            if (num_dofs == 0)
+            {
+                throw std::runtime_error("error: the buffer has no cell dofs");
+            }
+
+            fields.push_back({name, internal::GetVtkTypeName<typename ValueT::ScalarT>(), num_dofs * ValueT::NumComponents, false, [&buffer, num_dofs](const Piece& piece, std::vector<char>& data) {
+                                  GatherDofs<CellDimension>(buffer, piece.cells, num_dofs, data);
+                              }});
+
+            return *this;
+        }
+
+        //!
+        //! \brief Write the node dofs of a buffer as point data.
+        //!
+        //! All dofs of a node are written as components of one tuple.
+        //!
+        //! \param name the name of the field
+        //! \param buffer a buffer with node dofs
+        //! \return a reference to this writer
+        //!
+        template <typename BufferT>
+        auto AddPointData(const std::string& name, const BufferT& buffer) -> VtuWriter&
+        {
+            using ValueT = internal::VtkValue<typename BufferT::ValueT>;
+
+            const std::size_t num_dofs = buffer.GetDofs().template At<0>();
+
+            if (num_dofs == 0)
+            {
+                throw std::runtime_error("error: the buffer has no node dofs");
+            }
+
+            fields.push_back({name, internal::GetVtkTypeName<typename ValueT::ScalarT>(), num_dofs * ValueT::NumComponents, true, [&buffer, num_dofs](const Piece& piece, std::vector<char>& data) {
+                                  GatherDofs<0>(buffer, piece.nodes, num_dofs, data);
+                              }});
+
+            return *this;
+        }
+
+        //!
+        //! \brief Evaluate the cell dofs of a buffer at the nodes and write the result as point data.
+        //!
+        //! The value at a node is the average of the values evaluated by all cells that contain the node.
+        //! Hence, it is the same in all pieces.
+        //! Each of these cells is created once per piece and evaluated at those of its nodes that belong to the piece.
+        //!
+        //! \param name the name of the field
+        //! \param buffer a buffer with cell dofs
+        //! \param evaluate a callable `(cell, dofs, i) -> BufferT::ValueT` that evaluates the field of a cell at its i-th node,
+        //!        `dofs` is a pointer to the cell dofs within the buffer
+        //! \return a reference to this writer
+        //!
+        template <typename BufferT, typename EvaluateT>
+        auto AddPointData(const std::string& name, const BufferT& buffer, EvaluateT evaluate) -> VtuWriter&
+        {
+            using ValueT = internal::VtkValue<typename BufferT::ValueT>;
+            using ScalarT = typename ValueT::ScalarT;
+
+            if (buffer.GetDofs().template At<CellDimension>() == 0)
+            {
+                throw std::runtime_error("error: the buffer has no cell dofs");
+            }
+
+            fields.push_back({name, internal::GetVtkTypeName<ScalarT>(), ValueT::NumComponents, true, [&mesh = mesh, &buffer, evaluate](const Piece& piece, std::vector<char>& data) {
+                                  std::vector<std::array<double, ValueT::NumComponents>> sums(piece.nodes.size());
+                                  std::vector<std::size_t> num_cells(piece.nodes.size());
+                                  std::vector<std::size_t> cells;
+                                  std::size_t i = 0;
+
+                                  // Collect all cells that contain a node of the piece, including those of other pieces.
+                                  for (const auto& node : mesh.template GetEntities<0>(piece.nodes))
+                                  {
+                                      const auto& cell_indices = node.GetTopology().GetIndicesOfAllContainingCells();
+
+                                      num_cells[i++] = cell_indices.size();
+                                      cells.insert(cells.end(), cell_indices.begin(), cell_indices.end());
+                                  }
+
+                                  std::sort(cells.begin(), cells.end());
+                                  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+                                  // Each cell is created and evaluated once: its geometry is read from the geometry cache of the mesh (if enabled).
+                                  for (const auto& cell : mesh.GetEntities(cells))
+                                  {
+                                      const auto& node_indices = cell.GetTopology().GetNodeIndices();
+                                      const auto offset = ::HPM::dof::GetOffset<CellDimension>(mesh, buffer.GetDofs(), cell.GetTopology().GetIndex());
+
+                                      for (std::size_t local_node = 0; local_node < node_indices.size(); ++local_node)
+                                      {
+                                          const auto it = std::lower_bound(piece.nodes.begin(), piece.nodes.end(), node_indices[local_node]);
+
+                                          if (it == piece.nodes.end() || *it != node_indices[local_node])
+                                          {
+                                              continue;
+                                          }
+
+                                          const auto& value = evaluate(cell, &buffer[offset], local_node);
+                                          auto& sum = sums[it - piece.nodes.begin()];
+
+                                          for (std::size_t component = 0; component < ValueT::NumComponents; ++component)
+                                          {
+                                              sum[component] += ValueT::Get(value, component);
+                                          }
+                                      }
+                                  }
+
+                                  data.resize(piece.nodes.size() * ValueT::NumComponents * sizeof(ScalarT));
+
+                                  std::size_t position = 0;
+
+                                  for (std::size_t node = 0; node < piece.nodes.size(); ++node)
+                                  {
+                                      for (std::size_t component = 0; component < ValueT::NumComponents; ++component)
+                                      {
+                                          const auto average = static_cast<ScalarT>(sums[node][component] / std::max(num_cells[node], std::size_t{1}));
+
+                                          std::memcpy(&data[position], &average, sizeof(ScalarT));
+                                          position += sizeof(ScalarT);
+                                      }
+                                  }
+                              }});
+
+            return *this;
+        }
+
+        //!
+        //! \brief Write all pieces and the `.pvtu` file.
+        //!
+        //! The pieces are written to `<basename>_<piece>.vtu`, the index to `<basename>.pvtu`.
+        //!
+        //! \param basename the path of the output files without extension
+        //! \return the number of pieces
+        //!
+        auto Write(const std::string& basename) const -> std::size_t
+        {
+            const std::size_t num_pieces = GetNumPieces();
+            std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t piece = 0; piece < num_pieces; ++piece)
+            {
+                try
+                {
+                    WritePiece(GetPieceName(basename, piece), CreatePiece(piece));
+                }
+                catch (...)
+                {
+#pragma omp critical
+                    exception = std::current_exception();
+                }
+            }
+
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+
+            WriteIndex(basename, num_pieces);
+
+            return num_pieces;
+        }
+
+        private:
+        template <std::size_t Dimension, typename BufferT>
+        static auto GatherDofs(const BufferT& buffer, const std::vector<std::size_t>& indices, const std::size_t num_dofs, std::vector<char>& data)
+        {
+            using ValueT = internal::VtkValue<typename BufferT::ValueT>;
+            using ScalarT = typename ValueT::ScalarT;
+
+            data.resize(indices.size() * num_dofs * ValueT::NumComponents * sizeof(ScalarT));
+
+            std::size_t position = 0;
+
+            for (const std::size_t index : indices)
+            {
+                const auto offset = ::HPM::dof::GetOffset<Dimension>(buffer.GetMesh(), buffer.GetDofs(), index);
+
+                for (std::size_t dof = 0; dof < num_dofs; ++dof)
+                {
+                    for (std::size_t component = 0; component < ValueT::NumComponents; ++component)
+                    {
+                        const ScalarT value = ValueT::Get(buffer[offset + dof], component);
+
+                        std::memcpy(&data[position], &value, sizeof(ScalarT));
+                        position += sizeof(ScalarT);
+                    }
+                }
+            }
+        }
+
+        auto GetNumPieces() const -> std::size_t
+        {
+            if constexpr (internal::HasL2Partitions<MeshT>::value)
+            {
+                return mesh.GetNumL2Partitions();
+            }
+            else
+            {
+                return 1;
+            }
+        }
+
+        auto CreatePiece(const std::size_t piece_index) const -> Piece
+        {
+            Piece piece;
+
+            if constexpr (internal::HasL2Partitions<MeshT>::value)
+            {
+                for (const auto& cell : mesh.L2PToEntity(piece_index))
+                {
+                    piece.cells.push_back(cell.GetTopology().GetIndex());
+                }
+            }
+            else
+            {
+                piece.cells.resize(mesh.GetNumEntities());
+
+                for (std::size_t i = 0; i < piece.cells.size(); ++i)
+                {
+                    piece.cells[i] = i;
+                }
+            }
+
+            for (const auto& cell : mesh.GetEntities(piece.cells))
+            {
+                const auto& node_indices = cell.GetTopology().GetNodeIndices();
+
+                piece.nodes.insert(piece.nodes.end(), node_indices.begin(), node_indices.end());
+            }
+
+            std::sort(piece.nodes.begin(), piece.nodes.end());
+            piece.nodes.erase(std::unique(piece.nodes.begin(), piece.nodes.end()), piece.nodes.end());
+
+            return piece;
+        }
+
+        static auto GetPieceName(const std::string& basename, const std::size_t piece) -> std::string { return basename + "_" + std::to_string(piece) + ".vtu"; }
+
+        static auto GetByteOrder() -> std::string
+        {
+            const std::uint16_t probe = 1;
+            unsigned char first_byte;
+
+            std::memcpy(&first_byte, &probe, 1);
+
+            return (first_byte == 1 ? "LittleEndian" : "BigEndian");
+        }
+
+        auto GetHeader(const std::string& type) const -> std::string
+        {
+            return "<?xml version=\"1.0\"?>\n<VTKFile type=\"" + type + "\" version=\"1.0\" byte_order=\"" + GetByteOrder() + "\" header_type=\"UInt64\"" +
+                   (compress ? " compressor=\"vtkZLibDataCompressor\"" : "") + ">\n";
+        }
+
+        //!
+        //! \brief Append the (optionally compressed) encoding of an array to the appended data section.
+        //!
+        //! Uncompressed arrays are preceded by their size.
+        //! Compressed arrays are split into blocks: they are preceded by the number of blocks, the block size, the size of the last block,
+        //! and the compressed size of each block.
+        //!
+        auto Encode(const std::vector<char>& data, std::vector<char>& appended_data) const -> void
+        {
+            auto append = [&appended_data](const void* values, const std::size_t size) {
+                const std::size_t position = appended_data.size();
+
+                appended_data.resize(position + size);
+                std::memcpy(appended_data.data() + position, values, size);
+            };
+
+            if (!compress)
+            {
+                const std::uint64_t size = data.size();
+
+                append(&size, sizeof(size));
+                append(data.data(), data.size());
+
+                return;
+            }
+
+#if defined(HPM_ENABLE_ZLIB)
+            const std::size_t num_blocks = (data.size() + BlockSize - 1) / BlockSize;
+            std::vector<std::uint64_t> header{num_blocks, BlockSize, (data.size() % BlockSize == 0 && num_blocks > 0 ? BlockSize : data.size() % BlockSize)};
+            std::vector<char> compressed_data;
+
+            for (std::size_t block = 0; block < num_blocks; ++block)
+            {
+                const std::size_t size = std::min(BlockSize, data.size() - block * BlockSize);
+                uLongf compressed_size = compressBound(size);
+                const std::size_t position = compressed_data.size();
+
+                compressed_data.resize(position + compressed_size);
+
+                if (compress2(reinterpret_cast<Bytef*>(compressed_data.data() + position), &compressed_size, reinterpret_cast<const Bytef*>(data.data() + block * BlockSize), size, Z_DEFAULT_COMPRESSION) != Z_OK)
+                {
+                    throw std::runtime_error("error: zlib compression failed");
+                }
+
+                compressed_data.resize(position + compressed_size);
+                header.push_back(compressed_size);
+            }
+
+            append(header.data(), header.size() * sizeof(std::uint64_t));
+            append(compressed_data.data(), compressed_data.size());
+#endif
+        }
+
+        auto WritePiece(const std::string& filename, const Piece& piece) const -> void
+        {
+            using ScalarT = typename MeshT::ScalarT;
+
+            constexpr std::size_t NumNodesPerCell = CellDimension + 1;
+            // VTK_LINE, VTK_TRIANGLE, VTK_TETRA
+            constexpr std::uint8_t CellType = (CellDimension == 1 ? 3 : (CellDimension == 2 ? 5 : 10));
+
+            std::ostringstream xml;
+            std::vector<char> appended_data;
+            std::vector<char> data;
+
+            auto add_array = [&](const std::string& type, const std::string& name, const std::size_t num_components) {
+                xml << "        <DataArray type=\"" << type << "\"" << (name.empty() ? "" : " Name=\"" + name + "\"") << " NumberOfComponents=\"" << num_components
+                    << "\" format=\"appended\" offset=\"" << appended_data.size() << "\"/>\n";
+                Encode(data, appended_data);
+            };
+
+            xml << GetHeader("UnstructuredGrid") << "  <UnstructuredGrid>\n"
+                << "    <Piece NumberOfPoints=\"" << piece.nodes.size() << "\" NumberOfCells=\"" << piece.cells.size() << "\">\n";
+
+            // Point data and cell data.
+            for (const bool at_points : {true, false})
+            {
+                xml << (at_points ? "      <PointData>\n" : "      <CellData>\n");
+
+                for (const auto& field : fields)
+                {
+                    if (field.at_points == at_points)
+                    {
+                        field.gather(piece, data);
+                        add_array(field.type, field.name, field.num_components);
+                    }
+                }
+
+                xml << (at_points ? "      </PointData>\n" : "      </CellData>\n");
+            }
+
+            // Points: VTK requires 3 coordinates.
+            data.assign(piece.nodes.size() * 3 * sizeof(ScalarT), 0);
+
+            std::size_t i = 0;
+
+            for (const auto& node : mesh.template GetEntities<0>(piece.nodes))
+            {
+                const auto coordinates = node.GetTopology().GetNodes()[0];
+
+                for (std::size_t dimension = 0; dimension < MeshT::WorldDimension; ++dimension)
+                {
+                    const ScalarT value = coordinates[dimension];
+
+                    std::memcpy(&data[(3 * i + dimension) * sizeof(ScalarT)], &value, sizeof(ScalarT));
+                }
+
+                ++i;
+            }
+
+            xml << "      <Points>\n";
+            add_array(internal::GetVtkTypeName<ScalarT>(), "", 3);
+            xml << "      </Points>\n";
+
+            // Cells: connectivity with piece-local node indices, offsets, types.
+            xml << "      <Cells>\n";
+
+            data.resize(piece.cells.size() * NumNodesPerCell * sizeof(std::int64_t));
+
+            std::size_t position = 0;
+
+            for (const auto& cell : mesh.GetEntities(piece.cells))
+            {
+                for (const std::size_t node_index : cell.GetTopology().GetNodeIndices())
+                {
+                    const std::int64_t local_index = std::lower_bound(piece.nodes.begin(), piece.nodes.end(), node_index) - piece.nodes.begin();
+
+                    std::memcpy(&data[position], &local_index, sizeof(local_index));
+                    position += sizeof(local_index);
+                }
+            }
+
+            add_array("Int64", "connectivity", 1);
+
+            data.resize(piece.cells.size() * sizeof(std::int64_t));
+
+            for (std::size_t i = 0; i < piece.cells.size(); ++i)
+            {
+                const std::int64_t offset = (i + 1) * NumNodesPerCell;
+
+                std::memcpy(&data[i * sizeof(offset)], &offset, sizeof(offset));
+            }
+
+            add_array("Int64", "offsets", 1);
+
+            data.assign(piece.cells.size(), static_cast<char>(CellType));
+            add_array("UInt8", "types", 1);
+
+            xml << "      </Cells>\n"
+                << "    </Piece>\n"
+                << "  </UnstructuredGrid>\n"
+                << "  <AppendedData encoding=\"raw\">\n_";
+
+            std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not open file: " + filename);
+            }
+
+            const std::string header = xml.str();
+
+            file.write(header.data(), header.size());
+            file.write(appended_data.data(), appended_data.size());
+            file << "\n  </AppendedData>\n</VTKFile>\n";
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not write file: " + filename);
+            }
+        }
+
+        auto WriteIndex(const std::string& basename, const std::size_t num_pieces) const -> void
+        {
+            using ScalarT = typename MeshT::ScalarT;
+
+            std::ofstream file(basename + ".pvtu");
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not open file: " + basename + ".pvtu");
+            }
+
+            // Pieces are referenced relative to the index file.
+            const std::size_t separator = basename.find_last_of('/');
+            const std::string local_basename = (separator == std::string::npos ? basename : basename.substr(separator + 1));
+
+            file << GetHeader("PUnstructuredGrid") << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+
+            for (const bool at_points : {true, false})
+            {
+                file << (at_points ? "    <PPointData>\n" : "    <PCellData>\n");
+
+                for (const auto& field : fields)
+                {
+                    if (field.at_points == at_points)
+                    {
+                        file << "      <PDataArray type=\"" << field.type << "\" Name=\"" << field.name << "\" NumberOfComponents=\"" << field.num_components << "\"/>\n";
+                    }
+                }
+
+                file << (at_points ? "    </PPointData>\n" : "    </PCellData>\n");
+            }
+
+            file << "    <PPoints>\n"
+                 << "      <PDataArray type=\"" << internal::GetVtkTypeName<ScalarT>() << "\" NumberOfComponents=\"3\"/>\n"
+                 << "    </PPoints>\n";
+
+            for (std::size_t piece = 0; piece < num_pieces; ++piece)
+            {
+                file << "    <Piece Source=\"" << GetPieceName(local_basename, piece) << "\"/>\n";
+            }
+
+            file << "  </PUnstructuredGrid>\n</VTKFile>\n";
+
+            if (!file)
+            {
+                throw std::runtime_error("error: could not write file: " + basename + ".pvtu");
+            }
+        }
+
+        const MeshT& mesh;
+        const bool compress;
+        std::vector<Field> fields;
+    };
+} // namespace HPM
+
+#endif
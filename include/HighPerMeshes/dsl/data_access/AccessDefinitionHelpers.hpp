@@ -81,19 +81,19 @@ namespace HPM
     //! DataAccess
     //!
     //! \{
-    auto Read = [](auto&& access_definition) {
+    inline auto Read = [](auto&& access_definition) {
         static_assert(IsAccessDefinition<std::decay_t<decltype(access_definition)>>);
         return AccessDefinition{std::move(access_definition.buffer), std::move(access_definition.pattern), access_definition.RequestedDimension, ReadConstant};
     };
-    auto Write = [](auto&& access_definition) {
+    inline auto Write = [](auto&& access_definition) {
         static_assert(IsAccessDefinition<std::decay_t<decltype(access_definition)>>);
         return AccessDefinition{std::move(access_definition.buffer), std::move(access_definition.pattern), access_definition.RequestedDimension, WriteConstant};
     };
-    auto Accumulate = [](auto&& access_definition) {
+    inline auto Accumulate = [](auto&& access_definition) {
         static_assert(IsAccessDefinition<std::decay_t<decltype(access_definition)>>);
         return AccessDefinition{std::move(access_definition.buffer), std::move(access_definition.pattern), access_definition.RequestedDimension, AccumulateConstant};
     };
-    auto ReadWrite = [](auto&& access_definition) {
+    inline auto ReadWrite = [](auto&& access_definition) {
         static_assert(IsAccessDefinition<std::decay_t<decltype(access_definition)>>);
         return AccessDefinition{std::move(access_definition.buffer), std::move(access_definition.pattern), access_definition.RequestedDimension, ReadWriteConstant};
     };
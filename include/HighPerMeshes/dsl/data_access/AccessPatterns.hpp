@@ -15,11 +15,11 @@ namespace HPM::AccessPatterns
     //! By providing them to access definitions in a loop the run time system is able to provide the correct local views to the kernels.
     //!
     //! \{
-    auto SimplePattern = [](auto&& entity) { return entity; };
+    inline auto SimplePattern = [](auto&& entity) { return entity; };
 
-    auto NeighboringMeshElementOrSelfPattern = [](auto&& entity) { return entity.GetTopology().GetNeighboringCell(); };
+    inline auto NeighboringMeshElementOrSelfPattern = [](auto&& entity) { return entity.GetTopology().GetNeighboringCell(); };
 
-    auto ContainingMeshElementPattern = [](auto&& entity) { return entity.GetTopology().GetContainingCell(); };
+    inline auto ContainingMeshElementPattern = [](auto&& entity) { return entity.GetTopology().GetContainingCell(); };
     //! \}
 } // namespace HPM::AccessPatterns
 
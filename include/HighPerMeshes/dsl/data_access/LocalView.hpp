@@ -152,11 +152,25 @@ namespace HPM::internal
             return Create(access_definitions, entity, std::make_index_sequence<std::tuple_size_v<AccessDefinitions>>{});
         }
 
-        template <typename AccessDefinitions, typename EntityIterator, std::size_t ...I>
-        static auto CreateMultiple(const AccessDefinitions& access_definitions, const EntityIterator& it, std::index_sequence<I...>)
-            -> std::array<decltype(Create(access_definitions, it[0])), sizeof...(I)>
+        //!
+        //! \brief Create local views for multiple entities at once.
+        //!
+        //! The entities are taken from anything that provides an array subscript operator, e.g., an entity iterator or an array of entity handles.
+        //! Using entity handles avoids the creation of the full entities (and of the entities returned by the access patterns).
+        //!
+        //! \tparam AccessDefinitions the `AccessDefinitionDefinition` type for a collection of fields
+        //! \tparam EntitiesT the type of the entity collection
+        //! \tparam I a variadic list of indices into the entity collection
+        //! \param access_definitions the `AccessDefinitionDefinition` for a collection of fields
+        //! \param entities the considered entities
+        //! \param unnamed used for template parameter deduction
+        //! \return an array of local views, one for each of the considered entities
+        //!
+        template <typename AccessDefinitions, typename EntitiesT, std::size_t ...I>
+        static auto CreateMultiple(const AccessDefinitions& access_definitions, const EntitiesT& entities, std::index_sequence<I...>)
+            -> std::array<decltype(Create(access_definitions, entities[0])), sizeof...(I)>
         {
-            return {Create(access_definitions, it[I])...};
+            return {Create(access_definitions, entities[I])...};
         }
     };
 } // namespace HPM::internal
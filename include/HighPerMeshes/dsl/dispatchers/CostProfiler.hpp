@@ -0,0 +1,324 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_DISPATCHERS_COSTPROFILER_HPP
+#define DSL_DISPATCHERS_COSTPROFILER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/auxiliary/Atomic.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
+
+namespace HPM
+{
+    //!
+    //! \brief The granularity of the execution costs measured by a `CostProfiler`.
+    //!
+    enum class CostGranularity
+    {
+        Partition, //!< the time spent on each (L2) partition: low overhead
+        Cell       //!< the time spent on each invocation of the loop bodies, assigned to the (containing) cell
+    };
+
+    namespace internal
+    {
+        //!
+        //! \brief Get the index of a cell, or the index of the containing cell of any other entity.
+        //!
+        template <typename EntityT>
+        auto GetIndexOfCell(const EntityT& entity) -> std::size_t
+        {
+            const auto& topology = entity.GetTopology();
+
+            if constexpr (EntityT::Dimension == EntityT::CellDimension)
+            {
+                return topology.GetIndex();
+            }
+            else
+            {
+                return topology.GetIndexOfContainingCell();
+            }
+        }
+    } // namespace internal
+
+    //!
+    //! \brief Dispatcher instrumentation that measures the execution cost of each partition or cell over the first steps.
+    //!
+    //! The costs are meant as element weights for a (re-)partitioning of the mesh (see `Partitioner::SetElementWeights`):
+    //! cells with different kernels (boundary cells, PML regions, material-specific kernels) are balanced by their measured costs.
+    //! Costs are CPU times in seconds, summed up over all threads, mesh loops and profiled steps.
+    //! A step is profiled until `num_profiled_steps` (distinct) steps have been seen; all further steps are executed without measurement.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! SequentialDispatcher<CostProfiler<CostGranularity::Cell>> profiling_dispatcher;
+    //! profiling_dispatcher.GetInstrumentation().SetNumProfiledSteps(5);
+    //! profiling_dispatcher.Execute(iterator::Range{5}, surface_kernel, volume_kernel);
+    //! const auto& weights = profiling_dispatcher.GetInstrumentation().GetCellWeights(mesh);
+    //! const auto& balanced_mesh = mesh.Repartition({1, 8}, 0, MetisPartitioner{}.SetElementWeights(weights));
+    //! \endcode
+    //!
+    //! \tparam Granularity the granularity of the measurement
+    //! \tparam ClockT the clock used for the measurement (a `std::chrono` clock type)
+    //!
+    template <CostGranularity Granularity = CostGranularity::Partition, typename ClockT = std::chrono::steady_clock>
+    class CostProfiler
+    {
+        public:
+        static constexpr bool Enabled = true;
+        static constexpr bool MeasuresEntities = (Granularity == CostGranularity::Cell);
+
+        //!
+        //! \brief Measurement scope of a mesh loop (for one step and one partition).
+        //!
+        class Scope
+        {
+            friend class CostProfiler;
+
+            Scope(CostProfiler* profiler, const std::size_t partition) : profiler(profiler), partition(partition) {}
+
+            public:
+            //!
+            //! \brief Execute a callable and add its execution time to the cost of the partition.
+            //!
+            //! \tparam FuncT the type of the callable
+            //! \param func the callable
+            //!
+            template <typename FuncT>
+            auto Measure(FuncT&& func) const -> void
+            {
+                if (!profiler)
+                {
+                    std::forward<FuncT>(func)();
+
+                    return;
+                }
+
+                const auto begin = ClockT::now();
+
+                std::forward<FuncT>(func)();
+
+                ::HPM::atomic::AtomicAdd(profiler->partition_costs[partition], std::chrono::duration<double>(ClockT::now() - begin).count());
+            }
+
+            //!
+            //! \brief Execute a callable for an entity and add its execution time to the cost of the (containing) cell.
+            //!
+            //! This function is called by the dispatcher for each invocation of the loop bodies if `MeasuresEntities` is set.
+            //!
+            //! \tparam EntityT the type of the entity
+            //! \tparam FuncT the type of the callable
+            //! \param entity the entity the loop body is invoked for
+            //! \param func the callable
+            //!
+            template <typename EntityT, typename FuncT>
+            auto MeasureEntity(const EntityT& entity, FuncT&& func) const -> void
+            {
+                if (!profiler)
+                {
+                    std::forward<FuncT>(func)();
+
+                    return;
+                }
+
+                const auto begin = ClockT::now();
+
+                std::forward<FuncT>(func)();
+
+                ::HPM::atomic::AtomicAdd(profiler->cell_costs[internal::GetIndexOfCell(entity)], std::chrono::duration<double>(ClockT::now() - begin).count());
+            }
+
+            private:
+            CostProfiler* const profiler;
+            const std::size_t partition;
+        };
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param num_profiled_steps the number of steps to be profiled
+        //!
+        explicit CostProfiler(const std::size_t num_profiled_steps = 10) : num_profiled_steps(num_profiled_steps) {}
+
+        //!
+        //! \brief Set the number of steps to be profiled.
+        //!
+        //! \param num_steps the number of steps to be profiled
+        //!
+        auto SetNumProfiledSteps(const std::size_t num_steps) -> void { num_profiled_steps = num_steps; }
+
+        //!
+        //! \brief Start a new `Execute` call: called by the dispatcher.
+        //!
+        //! The cost containers are sized according to the mesh loops (number of partitions and cells).
+        //!
+        //! \tparam MeshLoops the types of the mesh loops
+        //! \param mesh_loops the mesh loops
+        //!
+        template <typename... MeshLoops>
+        auto BeginExecution(const MeshLoops&... mesh_loops) -> void
+        {
+            ++num_executions;
+
+            (
+                [this](const auto& mesh_loop) {
+                    const auto& entity_range = mesh_loop.entity_range;
+
+                    if (partition_costs.size() < entity_range.GetNumPartitions())
+                    {
+                        partition_costs.resize(entity_range.GetNumPartitions(), 0.0);
+                    }
+
+                    if constexpr (MeasuresEntities)
+                    {
+                        if (cell_costs.size() < entity_range.GetMesh().GetNumEntities())
+                        {
+                            cell_costs.resize(entity_range.GetMesh().GetNumEntities(), 0.0);
+                        }
+                    }
+                }(mesh_loops),
+                ...);
+        }
+
+        //!
+        //! \brief Get the measurement scope for a mesh loop of the current `Execute` call: called by the dispatcher.
+        //!
+        //! \param step the current step
+        //! \param partition the partition of the entity range
+        //! \return the measurement scope: it does not measure anything if all steps have been profiled already
+        //!
+        auto GetScope(const std::size_t, const std::size_t step, const std::size_t partition) -> Scope
+        {
+            // Parallel dispatchers request the scopes of different partitions concurrently.
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (num_steps == 0 || current_step != std::make_pair(num_executions, step))
+            {
+                current_step = {num_executions, step};
+                ++num_steps;
+            }
+
+            return {(num_steps <= num_profiled_steps ? this : nullptr), partition};
+        }
+
+        //!
+        //! \brief Get the number of steps that have been profiled.
+        //!
+        //! \return the number of profiled steps
+        //!
+        auto GetNumProfiledSteps() const -> std::size_t { return std::min(num_steps, num_profiled_steps); }
+
+        //!
+        //! \brief Test whether all steps have been profiled.
+        //!
+        //! \return `true` if the profiling is complete
+        //!
+        auto IsComplete() const -> bool { return num_steps >= num_profiled_steps; }
+
+        //!
+        //! \brief Get the cost of each (L2) partition.
+        //!
+        //! \return the CPU time (in seconds) spent on each partition
+        //!
+        auto GetPartitionCosts() const -> const std::vector<double>& { return partition_costs; }
+
+        //!
+        //! \brief Get the cost of each cell (`CostGranularity::Cell` only).
+        //!
+        //! \return the CPU time (in seconds) spent on each cell, indexed by the cell index
+        //!
+        auto GetCellCosts() const -> const std::vector<double>&
+        {
+            static_assert(MeasuresEntities, "error: cell costs are measured with CostGranularity::Cell only");
+
+            return cell_costs;
+        }
+
+        //!
+        //! \brief Get a weight for each cell of a partitioned mesh, derived from the measured costs.
+        //!
+        //! With `CostGranularity::Partition`, the cost of each partition is distributed evenly among its cells.
+        //! Cells without any measurement (e.g., those of other processes) get the average weight of the measured cells.
+        //!
+        //! \tparam MeshT the type of the (partitioned) mesh
+        //! \param mesh the mesh that has been executed on
+        //! \return the weight of each cell, indexed by the cell index
+        //!
+        template <typename MeshT>
+        auto GetCellWeights(const MeshT& mesh) const -> std::vector<double>
+        {
+            const std::size_t num_cells = mesh.GetNumEntities();
+            std::vector<double> weights(num_cells, 0.0);
+
+            if constexpr (MeasuresEntities)
+            {
+                std::copy_n(cell_costs.begin(), std::min(num_cells, cell_costs.size()), weights.begin());
+            }
+            else
+            {
+                std::vector<std::size_t> num_cells_in_partition(partition_costs.size(), 0);
+
+                for (std::size_t cell_index = 0; cell_index < num_cells; ++cell_index)
+                {
+                    const std::size_t partition = mesh.CellToL2P(cell_index);
+
+                    if (partition < partition_costs.size())
+                    {
+                        ++num_cells_in_partition[partition];
+                    }
+                }
+
+                for (std::size_t cell_index = 0; cell_index < num_cells; ++cell_index)
+                {
+                    const std::size_t partition = mesh.CellToL2P(cell_index);
+
+                    if (partition < partition_costs.size())
+                    {
+                        weights[cell_index] = partition_costs[partition] / num_cells_in_partition[partition];
+                    }
+                }
+            }
+
+            const std::size_t num_measured_cells = std::count_if(weights.begin(), weights.end(), [](const double weight) { return weight > 0.0; });
+
+            if (num_measured_cells > 0 && num_measured_cells < num_cells)
+            {
+                const double average_weight = std::accumulate(weights.begin(), weights.end(), 0.0) / num_measured_cells;
+
+                std::replace(weights.begin(), weights.end(), 0.0, average_weight);
+            }
+
+            return weights;
+        }
+
+        //!
+        //! \brief Remove all measurements and restart the profiling.
+        //!
+        auto Reset() -> void
+        {
+            std::fill(partition_costs.begin(), partition_costs.end(), 0.0);
+            std::fill(cell_costs.begin(), cell_costs.end(), 0.0);
+            num_steps = 0;
+        }
+
+        private:
+        std::size_t num_profiled_steps;
+        std::size_t num_executions = 0;
+        std::size_t num_steps = 0;
+        std::pair<std::size_t, std::size_t> current_step{};
+        std::vector<double> partition_costs;
+        std::vector<double> cell_costs;
+        std::mutex mutex;
+    };
+} // namespace HPM
+
+#endif
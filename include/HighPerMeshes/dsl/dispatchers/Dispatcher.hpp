@@ -6,9 +6,11 @@
 #ifndef DSL_DISPATCHERS_DISPATCHER_HPP
 #define DSL_DISPATCHERS_DISPATCHER_HPP
 
+#include <type_traits>
 #include <utility>
 
 #include <HighPerMeshes/common/Iterator.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
 
 namespace HPM
 {
@@ -17,9 +19,12 @@ namespace HPM
     //! \tparam
     //! DispatchTo defines a sub-class that Executes all specified mesh_loops somehow by implementing the `dispatch` method
     //!
+    //! \tparam
+    //! InstrumentationT records the execution of the mesh loops (see `Instrumentation.hpp`): nothing is recorded by default
+    //!
     //! \note
     //! CRTP
-    template <typename DispatchTo>
+    template <typename DispatchTo, typename InstrumentationT = NoInstrumentation>
     class Dispatcher
     {
       public:
@@ -61,8 +66,62 @@ namespace HPM
         template <typename... MeshLoops, typename IntegerT>
         auto Execute(iterator::Range<IntegerT> range, MeshLoops&&... mesh_loops)
         {
+            instrumentation.BeginExecution(mesh_loops...);
+
             static_cast<DispatchTo*>(this)->Dispatch(range, std::forward<MeshLoops>(mesh_loops)...);
         }
+
+        //! \brief Get the instrumentation of this dispatcher.
+        //!
+        //! \return a reference to the instrumentation
+        auto GetInstrumentation() -> InstrumentationT& { return instrumentation; }
+
+        //! \brief Get the instrumentation of this dispatcher.
+        //!
+        //! \return a const reference to the instrumentation
+        auto GetInstrumentation() const -> const InstrumentationT& { return instrumentation; }
+
+      protected:
+        //! \brief Executes a mesh loop for one partition of its entity range and one step.
+        //!
+        //! Loop implementations that accept a measurement scope as additional argument record the time of each thread themselves.
+        //! Otherwise, the loop is measured as a whole.
+        //! Instrumentations that measure entities (`MeasuresEntities`) additionally measure each invocation of the loop body.
+        //!
+        //! \param mesh_loop the mesh loop
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param partition the partition of the entity range
+        //! \param step the current step
+        template <typename MeshLoop, typename StepT>
+        auto ExecuteLoop(MeshLoop& mesh_loop, const std::size_t loop, const std::size_t partition, const StepT& step)
+        {
+            using EntitiesT = decltype(mesh_loop.entity_range.GetEntities(partition));
+
+            const auto& scope = instrumentation.GetScope(loop, step, partition);
+            auto loop_body = [&mesh_loop, &step, &scope](auto&& entity, auto& local_vectors) {
+                if constexpr (internal::MeasuresEntities<InstrumentationT>::value)
+                {
+                    scope.MeasureEntity(entity, [&]() { mesh_loop.loop_body(entity, step, local_vectors); });
+                }
+                else
+                {
+                    static_cast<void>(scope);
+
+                    mesh_loop.loop_body(entity, step, local_vectors);
+                }
+            };
+
+            if constexpr (std::is_invocable_v<decltype(mesh_loop.loop), EntitiesT, decltype(mesh_loop.access_definitions)&, decltype(loop_body), decltype(scope)>)
+            {
+                mesh_loop.loop(mesh_loop.entity_range.GetEntities(partition), mesh_loop.access_definitions, loop_body, scope);
+            }
+            else
+            {
+                scope.Measure([&]() { mesh_loop.loop(mesh_loop.entity_range.GetEntities(partition), mesh_loop.access_definitions, loop_body); });
+            }
+        }
+
+        InstrumentationT instrumentation;
     };
 } // namespace HPM
 
@@ -0,0 +1,426 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_DISPATCHERS_INSTRUMENTATION_HPP
+#define DSL_DISPATCHERS_INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace HPM
+{
+    //!
+    //! \brief A time interval recorded for a mesh loop: one step, one partition and one thread.
+    //!
+    //! Times are given in nanoseconds since the creation of the recording instrumentation.
+    //!
+    struct LoopEvent
+    {
+        std::size_t execution; //!< index of the `Execute` call of the dispatcher
+        std::size_t loop;      //!< position of the mesh loop within the `Execute` call
+        std::size_t step;      //!< the step passed to the loop body
+        std::size_t partition; //!< the (L2) partition of the entity range
+        std::size_t thread;    //!< the OpenMP thread (0 for sequential loops)
+        std::int64_t begin;
+        std::int64_t end;
+    };
+
+    namespace internal
+    {
+        //!
+        //! \brief Get the index of the calling thread.
+        //!
+        //! \return the OpenMP thread number, or 0 without OpenMP
+        //!
+        inline auto GetThreadIndex() -> std::size_t
+        {
+#if defined(_OPENMP)
+            return omp_get_thread_num();
+#else
+            return 0;
+#endif
+        }
+
+        //!
+        //! \brief Check if an instrumentation measures each invocation of the loop bodies (`InstrumentationT::MeasuresEntities`).
+        //!
+        template <typename InstrumentationT, typename = void>
+        struct MeasuresEntities : std::false_type
+        {
+        };
+
+        template <typename InstrumentationT>
+        struct MeasuresEntities<InstrumentationT, std::enable_if_t<InstrumentationT::MeasuresEntities>> : std::true_type
+        {
+        };
+    } // namespace internal
+
+    //!
+    //! \brief Dispatcher instrumentation that records nothing.
+    //!
+    //! This is the default instrumentation of the dispatchers.
+    //! All member functions are empty and inlined: the instrumentation is compiled out.
+    //!
+    class NoInstrumentation
+    {
+        public:
+        static constexpr bool Enabled = false;
+
+        //!
+        //! \brief Measurement scope of a mesh loop (for one step and one partition).
+        //!
+        struct Scope
+        {
+            //!
+            //! \brief Execute a callable.
+            //!
+            //! \tparam FuncT the type of the callable
+            //! \param func the callable
+            //!
+            template <typename FuncT>
+            inline auto Measure(FuncT&& func) const -> void
+            {
+                std::forward<FuncT>(func)();
+            }
+        };
+
+        template <typename... MeshLoops>
+        inline auto BeginExecution(const MeshLoops&...) -> void
+        {
+        }
+
+        inline auto GetScope(const std::size_t, const std::size_t, const std::size_t) -> Scope { return {}; }
+    };
+
+    //!
+    //! \brief Dispatcher instrumentation that records the wall time of the mesh loops.
+    //!
+    //! For each `Execute` call of the dispatcher, each mesh loop, step and partition, the loop implementation measures the time
+    //! each thread spends on its share of the entities (loop implementations without thread support are measured as a whole).
+    //! The recorded events can be queried, or written as a Chrome trace (`chrome://tracing`, https://ui.perfetto.dev).
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! SequentialDispatcher<LoopTimer> dispatcher;
+    //! dispatcher.Execute(iterator::Range{100}, surface_kernel, volume_kernel);
+    //! auto& timer = dispatcher.GetInstrumentation();
+    //! timer.SetLoopName(0, 0, "surface");
+    //! timer.SetLoopName(0, 1, "volume");
+    //! std::cout << timer.GetWallTime(0, 0).count() << " ns" << std::endl;
+    //! timer.WriteChromeTrace("trace.json");
+    //! \endcode
+    //!
+    class LoopTimer
+    {
+        using ClockT = std::chrono::steady_clock;
+
+        public:
+        static constexpr bool Enabled = true;
+
+        //!
+        //! \brief Measurement scope of a mesh loop (for one step and one partition).
+        //!
+        //! The scope is shared by all threads of the loop implementation: each thread measures its own share.
+        //!
+        class Scope
+        {
+            friend class LoopTimer;
+
+            Scope(LoopTimer& timer, const std::size_t execution, const std::size_t loop, const std::size_t step, const std::size_t partition)
+                : timer(timer), execution(execution), loop(loop), step(step), partition(partition)
+            {
+            }
+
+            public:
+            //!
+            //! \brief Execute a callable and record its wall time for the calling thread.
+            //!
+            //! \tparam FuncT the type of the callable
+            //! \param func the callable
+            //!
+            template <typename FuncT>
+            auto Measure(FuncT&& func) const -> void
+            {
+                const std::int64_t begin = timer.Now();
+
+                std::forward<FuncT>(func)();
+
+                timer.Record({execution, loop, step, partition, internal::GetThreadIndex(), begin, timer.Now()});
+            }
+
+            private:
+            LoopTimer& timer;
+            const std::size_t execution;
+            const std::size_t loop;
+            const std::size_t step;
+            const std::size_t partition;
+        };
+
+        LoopTimer() : start(ClockT::now()) {}
+
+        //!
+        //! \brief Start a new `Execute` call: called by the dispatcher.
+        //!
+        //! \tparam MeshLoops the types of the mesh loops
+        //!
+        template <typename... MeshLoops>
+        auto BeginExecution(const MeshLoops&...) -> void
+        {
+            ++num_executions;
+        }
+
+        //!
+        //! \brief Get the measurement scope for a mesh loop of the current `Execute` call: called by the dispatcher.
+        //!
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param step the current step
+        //! \param partition the partition of the entity range
+        //! \return the measurement scope
+        //!
+        auto GetScope(const std::size_t loop, const std::size_t step, const std::size_t partition) -> Scope { return {*this, num_executions - 1, loop, step, partition}; }
+
+        //!
+        //! \brief Get the number of `Execute` calls recorded.
+        //!
+        //! \return the number of `Execute` calls
+        //!
+        auto GetNumExecutions() const -> std::size_t { return num_executions; }
+
+        //!
+        //! \brief Assign a name to a mesh loop (used for the trace output).
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param name the name of the mesh loop
+        //!
+        auto SetLoopName(const std::size_t execution, const std::size_t loop, std::string name) -> void { loop_names[{execution, loop}] = std::move(name); }
+
+        //!
+        //! \brief Get the name of a mesh loop.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \return the name assigned with `SetLoopName`, or a generic name
+        //!
+        auto GetLoopName(const std::size_t execution, const std::size_t loop) const -> std::string
+        {
+            const auto it = loop_names.find({execution, loop});
+
+            return (it != loop_names.end() ? it->second : "execution " + std::to_string(execution) + " / loop " + std::to_string(loop));
+        }
+
+        //!
+        //! \brief Get all recorded events.
+        //!
+        //! \return the events sorted by their begin
+        //!
+        auto GetEvents() const -> std::vector<LoopEvent>
+        {
+            std::vector<LoopEvent> sorted_events;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                sorted_events = events;
+            }
+
+            std::stable_sort(sorted_events.begin(), sorted_events.end(), [](const auto& a, const auto& b) { return a.begin < b.begin; });
+
+            return sorted_events;
+        }
+
+        //!
+        //! \brief Get the wall time of a mesh loop.
+        //!
+        //! For each step, the wall time is the time between the first begin and the last end among all partitions and threads.
+        //! The wall times of all steps are summed up.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \return the wall time of the mesh loop
+        //!
+        auto GetWallTime(const std::size_t execution, const std::size_t loop) const -> std::chrono::nanoseconds
+        {
+            std::map<std::size_t, std::pair<std::int64_t, std::int64_t>> step_intervals;
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (const auto& event : events)
+            {
+                if (event.execution == execution && event.loop == loop)
+                {
+                    auto [it, inserted] = step_intervals.try_emplace(event.step, event.begin, event.end);
+
+                    if (!inserted)
+                    {
+                        it->second.first = std::min(it->second.first, event.begin);
+                        it->second.second = std::max(it->second.second, event.end);
+                    }
+                }
+            }
+
+            std::int64_t wall_time = 0;
+
+            for (const auto& interval : step_intervals)
+            {
+                wall_time += interval.second.second - interval.second.first;
+            }
+
+            return std::chrono::nanoseconds{wall_time};
+        }
+
+        //!
+        //! \brief Get the number of steps a mesh loop has been executed for.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \return the number of distinct steps recorded for the mesh loop
+        //!
+        auto GetNumSteps(const std::size_t execution, const std::size_t loop) const -> std::size_t
+        {
+            std::vector<std::size_t> steps;
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (const auto& event : events)
+            {
+                if (event.execution == execution && event.loop == loop)
+                {
+                    steps.push_back(event.step);
+                }
+            }
+
+            std::sort(steps.begin(), steps.end());
+
+            return std::distance(steps.begin(), std::unique(steps.begin(), steps.end()));
+        }
+
+        //!
+        //! \brief Remove all recorded events and names.
+        //!
+        auto Clear() -> void
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            events.clear();
+            loop_names.clear();
+            num_executions = 0;
+        }
+
+        //!
+        //! \brief Write the recorded events as a Chrome trace (JSON).
+        //!
+        //! Partitions are mapped to processes and threads to threads of the trace.
+        //!
+        //! \param filename the name of the output file
+        //!
+        auto WriteChromeTrace(const std::string& filename) const -> void
+        {
+            std::ofstream file(filename);
+
+            if (!file)
+            {
+                throw std::runtime_error("error: cannot open file " + filename);
+            }
+
+            // Timestamps in microseconds, with nanosecond resolution.
+            file << std::fixed;
+            file.precision(3);
+
+            const auto& sorted_events = GetEvents();
+            std::vector<std::size_t> partitions;
+
+            for (const auto& event : sorted_events)
+            {
+                partitions.push_back(event.partition);
+            }
+
+            std::sort(partitions.begin(), partitions.end());
+            partitions.erase(std::unique(partitions.begin(), partitions.end()), partitions.end());
+
+            file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            bool first = true;
+
+            for (const std::size_t partition : partitions)
+            {
+                file << (first ? "" : ",") << "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << partition << ",\"args\":{\"name\":\"partition " << partition << "\"}}";
+                first = false;
+            }
+
+            for (const auto& event : sorted_events)
+            {
+                file << (first ? "" : ",") << "\n{\"name\":\"" << EscapeJson(GetLoopName(event.execution, event.loop)) << "\",\"cat\":\"mesh_loop\",\"ph\":\"X\""
+                     << ",\"pid\":" << event.partition << ",\"tid\":" << event.thread << ",\"ts\":" << (event.begin / 1000.0) << ",\"dur\":" << ((event.end - event.begin) / 1000.0)
+                     << ",\"args\":{\"execution\":" << event.execution << ",\"loop\":" << event.loop << ",\"step\":" << event.step << "}}";
+                first = false;
+            }
+
+            file << "\n]}\n";
+        }
+
+        private:
+        //!
+        //! \brief Get the current time.
+        //!
+        //! \return the nanoseconds since the creation of this instance
+        //!
+        auto Now() const -> std::int64_t { return std::chrono::duration_cast<std::chrono::nanoseconds>(ClockT::now() - start).count(); }
+
+        //!
+        //! \brief Add an event (thread-safe).
+        //!
+        //! \param event the event
+        //!
+        auto Record(const LoopEvent& event) -> void
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            events.push_back(event);
+        }
+
+        //!
+        //! \brief Escape a string for the use in a JSON string.
+        //!
+        //! \param input the input string
+        //! \return the escaped string
+        //!
+        static auto EscapeJson(const std::string& input) -> std::string
+        {
+            std::string output;
+
+            for (const char c : input)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    output += '\\';
+                }
+
+                output += (static_cast<unsigned char>(c) < 0x20 ? ' ' : c);
+            }
+
+            return output;
+        }
+
+        const ClockT::time_point start;
+        std::size_t num_executions = 0;
+        std::map<std::pair<std::size_t, std::size_t>, std::string> loop_names;
+        std::vector<LoopEvent> events;
+        mutable std::mutex mutex;
+    };
+} // namespace HPM
+
+#endif
@@ -0,0 +1,581 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_DISPATCHERS_OPENMPDISPATCHER_HPP
+#define DSL_DISPATCHERS_OPENMPDISPATCHER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <HighPerMeshes/auxiliary/Atomic.hpp>
+#include <HighPerMeshes/common/Iterator.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Dispatcher.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Roofline.hpp>
+
+namespace HPM
+{
+    namespace internal
+    {
+        //!
+        //! \brief Get the NUMA node of the cpu the calling thread is running on.
+        //!
+        //! \return the NUMA node, or -1 if it cannot be determined
+        //!
+        inline auto GetNumaNode() -> int
+        {
+#if defined(__linux__) && defined(SYS_getcpu)
+            unsigned int cpu = 0;
+            unsigned int node = 0;
+
+            if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+            {
+                return node;
+            }
+#endif
+            return -1;
+        }
+
+        //!
+        //! \brief Move memory pages to a NUMA node (`move_pages(2)`, without a libnuma dependency).
+        //!
+        //! \param pages the (page-aligned) addresses of the pages
+        //! \param node the target NUMA node
+        //! \return the number of pages that reside on the target node afterwards
+        //!
+        inline auto MovePages(std::vector<void*>& pages, const int node) -> std::size_t
+        {
+#if defined(__linux__) && defined(SYS_move_pages)
+            // MPOL_MF_MOVE from <numaif.h>: move pages that are mapped by this process only.
+            constexpr int MoveOwnPages = (1 << 1);
+            std::vector<int> nodes(pages.size(), node);
+            std::vector<int> status(pages.size(), -1);
+
+            if (pages.empty() || syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(), MoveOwnPages) != 0)
+            {
+                return 0;
+            }
+
+            return std::count(status.begin(), status.end(), node);
+#else
+            static_cast<void>(pages);
+            static_cast<void>(node);
+
+            return 0;
+#endif
+        }
+
+        //!
+        //! \brief Get the (page-aligned) addresses of all pages holding dofs that a mesh loop accesses within one partition.
+        //!
+        //! Global dofs are shared by all partitions and are not considered.
+        //!
+        //! \tparam MeshLoop the type of the mesh loop
+        //! \param mesh_loop the mesh loop
+        //! \param partition the partition of the entity range
+        //! \param page_size the page size in bytes
+        //! \param pages the container the page addresses are appended to (not unique)
+        //!
+        template <typename MeshLoop>
+        auto GetAccessedPages(const MeshLoop& mesh_loop, const std::size_t partition, const std::uintptr_t page_size, std::vector<void*>& pages) -> void
+        {
+            using MeshT = typename MeshLoop::MeshT;
+
+            auto add_page = [page_size, &pages](const void* address) { pages.push_back(reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(address) & ~(page_size - 1))); };
+
+            std::apply(
+                [&](const auto&... access) {
+                    (
+                        [&](const auto& access) {
+                            using AccessDefinition = std::decay_t<decltype(access)>;
+
+                            constexpr std::size_t RequestedDimension = AccessDefinition::RequestedDimension;
+
+                            if constexpr (RequestedDimension <= MeshT::CellDimension)
+                            {
+                                if (access.buffer->GetDofs().At(RequestedDimension) == 0)
+                                {
+                                    return;
+                                }
+
+                                const auto* data = access.buffer->GetData();
+
+                                ForEachVisitedEntity(mesh_loop, partition, [&](const auto& entity) {
+                                    for (const auto index : access.pattern(entity).GetTopology().template GetIndicesOfEntitiesWithDimension<RequestedDimension>())
+                                    {
+                                        const auto& dof_indices = access.buffer->template GetDofIndices<RequestedDimension>(index);
+
+                                        add_page(data + dof_indices.front());
+                                        add_page(data + dof_indices.back());
+                                    }
+                                });
+                            }
+                        }(access),
+                        ...);
+                },
+                mesh_loop.access_definitions);
+        }
+    } // namespace internal
+
+    //!
+    //! \brief Provides a class to execute MeshLoops in parallel with OpenMP: the (L2) partitions are distributed among the threads, with dynamic load balancing.
+    //!
+    //! The partitions of the entity ranges are over-decomposed work units: each partition is owned by one thread, which executes
+    //! all mesh loops on it.
+    //! Initially, each thread owns a contiguous block of partitions.
+    //! The dispatcher measures the execution time of each partition and, every `rebalancing_interval` steps, moves partitions from
+    //! the most loaded to the least loaded threads until the load of each thread is within `tolerance` of the average load.
+    //! Moves to threads on the same NUMA node are preferred, and only as few partitions as needed are moved (data locality).
+    //! The ownership persists across `Execute` calls.
+    //!
+    //! The partitions can be grouped into domains, e.g., the NUMA-level partitions of a `PartitionedMesh` with the hierarchy
+    //! `{nodes, NUMA domains, blocks}` (see `SetPartitionDomains`): the threads are split into one contiguous group per domain,
+    //! each group owns the partitions of its domain initially, and moves within the same group are preferred over moves to threads on the same NUMA node.
+    //! With `OMP_PROC_BIND=close` and one group per NUMA domain, only the cut between the domains causes cross-socket traffic.
+    //!
+    //! When a partition moves to a thread on a different NUMA node, the new owner migrates the memory pages holding the dofs the mesh loops
+    //! access within this partition to its node (`move_pages(2)`, Linux only), so that the first-touch placement follows the ownership.
+    //! For a meaningful placement, the threads should be pinned, e.g., with `OMP_PROC_BIND=close` or `OMP_PROC_BIND=spread`.
+    //!
+    //! Semantics are the same as for the `SequentialDispatcher` as long as the loop bodies of different partitions do not write to
+    //! the same dofs: the mesh loops of a step are executed one after another (with a barrier in between).
+    //! Loop implementations are executed by the owning thread: nested OpenMP loop implementations run with a single thread.
+    //! The instrumentation (`GetScope`) is called concurrently by all threads.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! // Rebalance every 10 steps.
+    //! OpenMPDispatcher dispatcher{10};
+    //! dispatcher.Execute(iterator::Range{100}, surface_kernel, volume_kernel);
+    //! \endcode
+    //!
+    //! \tparam InstrumentationT records the execution of the mesh loops, e.g., `LoopTimer` (default: nothing is recorded)
+    //! \tparam ClockT the clock the execution times of the partitions are measured with (a `std::chrono` clock type)
+    //! \see
+    //! Dispatcher
+    //! \note
+    //! CRTP
+    //!
+    template <typename InstrumentationT = NoInstrumentation, typename ClockT = std::chrono::steady_clock>
+    class OpenMPDispatcher : public Dispatcher<OpenMPDispatcher<InstrumentationT, ClockT>, InstrumentationT>
+    {
+      public:
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param rebalancing_interval the number of steps between two rebalancings (0: the partitions are never moved)
+        //! \param tolerance the tolerated relative load imbalance of the threads
+        //!
+        explicit OpenMPDispatcher(const std::size_t rebalancing_interval = 0, const double tolerance = 0.05) : rebalancing_interval(rebalancing_interval), tolerance(tolerance) {}
+
+        //!
+        //! \brief Set the number of steps between two rebalancings.
+        //!
+        //! \param interval the number of steps (0: the partitions are never moved)
+        //!
+        auto SetRebalancingInterval(const std::size_t interval) -> void { rebalancing_interval = interval; }
+
+        //!
+        //! \brief Enable or disable the migration of memory pages to the NUMA node of the new owner of a partition.
+        //!
+        //! \param enable `true` to migrate the pages (default)
+        //!
+        auto SetPageMigration(const bool enable) -> void { page_migration = enable; }
+
+        //!
+        //! \brief Group the partitions into domains.
+        //!
+        //! Usage:
+        //! \code{.cpp}
+        //! // The NUMA-level partitions of a mesh with the hierarchy {nodes, NUMA domains, blocks}.
+        //! dispatcher.SetPartitionDomains(mesh.GetL2PToLxP(1));
+        //! \endcode
+        //!
+        //! \param domains the domain of each partition (contiguous indices starting at 0), or none to disable the grouping
+        //!
+        auto SetPartitionDomains(std::vector<std::size_t> domains) -> void
+        {
+            partition_to_domain = std::move(domains);
+            num_domains = (partition_to_domain.empty() ? 0 : *std::max_element(partition_to_domain.begin(), partition_to_domain.end()) + 1);
+
+            // Reset the ownership.
+            partition_to_thread.clear();
+        }
+
+        //!
+        //! \brief Implementation of the dispatch function
+        //! \see HPM::Dispatcher
+        //!
+        template <typename... MeshLoops, typename IntegerT>
+        auto Dispatch(iterator::Range<IntegerT> range, MeshLoops&&... mesh_loops)
+        {
+            const std::size_t num_partitions = std::max({std::size_t{0}, mesh_loops.entity_range.GetNumPartitions()...});
+
+            Resize(num_partitions, GetMaxNumThreads());
+
+#pragma omp parallel num_threads(num_threads)
+            {
+                const std::size_t thread = internal::GetThreadIndex();
+
+                // The team can be smaller than requested, e.g., within an active parallel region.
+#pragma omp single
+                {
+                    Resize(num_partitions, GetNumThreads());
+                }
+
+                thread_to_node[thread] = internal::GetNumaNode();
+
+                for (auto step : range)
+                {
+                    std::size_t loop = 0;
+
+                    (
+                        [this, thread, &loop](auto& mesh_loop, const auto& step) {
+                            const auto& entity_range = mesh_loop.entity_range;
+
+                            for (const std::size_t partition : partitions_of_thread[thread])
+                            {
+                                // Partitions that are not assigned to this process are empty.
+                                if (partition < entity_range.GetNumPartitions() && !entity_range.GetIndices(partition).empty())
+                                {
+                                    const auto begin = ClockT::now();
+
+                                    this->ExecuteLoop(mesh_loop, loop, partition, step);
+
+                                    // Each partition is written by its owner only.
+                                    partition_times[partition] += std::chrono::duration<double>(ClockT::now() - begin).count();
+                                }
+                            }
+
+                            ++loop;
+
+#pragma omp barrier
+                        }(mesh_loops, step),
+                        ...);
+
+#pragma omp single
+                    {
+                        ++num_steps;
+                        rebalanced = (rebalancing_interval > 0 && (num_steps % rebalancing_interval) == 0 && Rebalance());
+                    }
+
+                    if (rebalanced)
+                    {
+                        if (page_migration && thread_to_node[thread] != -1)
+                        {
+                            MigratePages(thread, mesh_loops...);
+                        }
+
+#pragma omp barrier
+                    }
+                }
+            }
+        }
+
+        //!
+        //! \brief Get the owning thread of each partition.
+        //!
+        //! \return the thread index for each partition
+        //!
+        auto GetOwners() const -> const std::vector<std::size_t>& { return partition_to_thread; }
+
+        //!
+        //! \brief Get the execution time of each partition per step, as measured for the last rebalancing.
+        //!
+        //! \return the time in seconds for each partition (all mesh loops)
+        //!
+        auto GetPartitionTimes() const -> const std::vector<double>& { return partition_costs; }
+
+        //!
+        //! \brief Get the number of rebalancings that moved at least one partition.
+        //!
+        //! \return the number of rebalancings
+        //!
+        auto GetNumRebalancings() const -> std::size_t { return num_rebalancings; }
+
+        //!
+        //! \brief Get the total number of partitions moved between threads.
+        //!
+        //! \return the number of moves
+        //!
+        auto GetNumMovedPartitions() const -> std::size_t { return num_moved_partitions; }
+
+        //!
+        //! \brief Get the total number of memory pages migrated to the NUMA node of the new owner of a partition.
+        //!
+        //! \return the number of pages
+        //!
+        auto GetNumMigratedPages() const -> std::size_t { return num_migrated_pages; }
+
+      private:
+        static auto GetMaxNumThreads() -> std::size_t
+        {
+#if defined(_OPENMP)
+            return omp_get_max_threads();
+#else
+            return 1;
+#endif
+        }
+
+        static auto GetNumThreads() -> std::size_t
+        {
+#if defined(_OPENMP)
+            return omp_get_num_threads();
+#else
+            return 1;
+#endif
+        }
+
+        //!
+        //! \brief Set up the ownership of the partitions: contiguous blocks of partitions per thread (within each domain and its group of threads).
+        //!
+        //! The ownership is kept as long as the number of partitions and threads does not change.
+        //!
+        auto Resize(const std::size_t num_partitions, const std::size_t max_num_threads) -> void
+        {
+            if (num_partitions == partition_to_thread.size() && max_num_threads == num_threads)
+            {
+                return;
+            }
+
+            num_threads = max_num_threads;
+            partition_to_thread.resize(num_partitions);
+            partition_times.assign(num_partitions, 0.0);
+            partition_costs.assign(num_partitions, 0.0);
+            thread_to_node.assign(num_threads, -1);
+            thread_to_domain.assign(num_threads, 0);
+            moved_to_thread.assign(num_threads, {});
+            num_steps = 0;
+
+            if (partition_to_domain.size() != num_partitions)
+            {
+                for (std::size_t partition = 0; partition < num_partitions; ++partition)
+                {
+                    partition_to_thread[partition] = (partition * num_threads) / num_partitions;
+                }
+            }
+            else
+            {
+                std::vector<std::size_t> num_partitions_in_domain(num_domains, 0);
+                std::vector<std::size_t> position(num_domains, 0);
+
+                for (const std::size_t domain : partition_to_domain)
+                {
+                    ++num_partitions_in_domain[domain];
+                }
+
+                // Group of threads of a domain: [domain * T / D, (domain + 1) * T / D), at least one thread.
+                auto get_first_thread = [this](const std::size_t domain) { return std::min((domain * num_threads) / num_domains, num_threads - 1); };
+                auto get_num_threads = [this, &get_first_thread](const std::size_t domain) { return std::max(std::min(((domain + 1) * num_threads) / num_domains, num_threads) - get_first_thread(domain), std::size_t{1}); };
+
+                for (std::size_t domain = 0; domain < num_domains; ++domain)
+                {
+                    for (std::size_t thread = get_first_thread(domain); thread < get_first_thread(domain) + get_num_threads(domain); ++thread)
+                    {
+                        thread_to_domain[thread] = domain;
+                    }
+                }
+
+                for (std::size_t partition = 0; partition < num_partitions; ++partition)
+                {
+                    const std::size_t domain = partition_to_domain[partition];
+
+                    partition_to_thread[partition] = get_first_thread(domain) + (position[domain]++ * get_num_threads(domain)) / num_partitions_in_domain[domain];
+                }
+            }
+
+            UpdatePartitionsOfThreads();
+        }
+
+        auto UpdatePartitionsOfThreads() -> void
+        {
+            partitions_of_thread.assign(num_threads, {});
+
+            for (std::size_t partition = 0; partition < partition_to_thread.size(); ++partition)
+            {
+                partitions_of_thread[partition_to_thread[partition]].push_back(partition);
+            }
+        }
+
+        //!
+        //! \brief Move partitions from the most loaded to the least loaded threads (called by a single thread).
+        //!
+        //! Each move takes the partition whose time is closest to half the load difference of the two threads, and strictly reduces the
+        //! larger load. The least loaded thread of the group (or on the NUMA node) of the most loaded thread is chosen if its load is below average.
+        //!
+        //! \return `true` if any partition has been moved
+        //!
+        auto Rebalance() -> bool
+        {
+            const std::size_t num_partitions = partition_to_thread.size();
+            const std::vector<std::size_t> previous_owners = partition_to_thread;
+            std::vector<double> loads(num_threads, 0.0);
+
+            for (std::size_t partition = 0; partition < num_partitions; ++partition)
+            {
+                partition_costs[partition] = partition_times[partition] / rebalancing_interval;
+                partition_times[partition] = 0.0;
+                loads[partition_to_thread[partition]] += partition_costs[partition];
+            }
+
+            const double average_load = std::accumulate(loads.begin(), loads.end(), 0.0) / num_threads;
+
+            for (std::size_t move = 0; move < num_partitions; ++move)
+            {
+                const std::size_t source = std::distance(loads.begin(), std::max_element(loads.begin(), loads.end()));
+
+                if (loads[source] <= (1.0 + tolerance) * average_load)
+                {
+                    break;
+                }
+
+                std::size_t target = std::distance(loads.begin(), std::min_element(loads.begin(), loads.end()));
+
+                for (std::size_t thread = 0; thread < num_threads; ++thread)
+                {
+                    if (IsClose(thread, source) && loads[thread] < average_load && (!IsClose(target, source) || loads[thread] < loads[target]))
+                    {
+                        target = thread;
+                    }
+                }
+
+                const double difference = loads[source] - loads[target];
+                std::size_t best_partition = num_partitions;
+                double best_distance = std::numeric_limits<double>::max();
+
+                for (std::size_t partition = 0; partition < num_partitions; ++partition)
+                {
+                    const double cost = partition_costs[partition];
+
+                    if (partition_to_thread[partition] == source && cost > 0.0 && cost < difference && std::abs(cost - 0.5 * difference) < best_distance)
+                    {
+                        best_partition = partition;
+                        best_distance = std::abs(cost - 0.5 * difference);
+                    }
+                }
+
+                if (best_partition == num_partitions)
+                {
+                    break;
+                }
+
+                partition_to_thread[best_partition] = target;
+                loads[source] -= partition_costs[best_partition];
+                loads[target] += partition_costs[best_partition];
+            }
+
+            std::size_t num_moves = 0;
+
+            for (auto& partitions : moved_to_thread)
+            {
+                partitions.clear();
+            }
+
+            for (std::size_t partition = 0; partition < num_partitions; ++partition)
+            {
+                if (partition_to_thread[partition] != previous_owners[partition])
+                {
+                    ++num_moves;
+
+                    if (thread_to_node[partition_to_thread[partition]] != thread_to_node[previous_owners[partition]])
+                    {
+                        moved_to_thread[partition_to_thread[partition]].push_back(partition);
+                    }
+                }
+            }
+
+            if (num_moves == 0)
+            {
+                return false;
+            }
+
+            UpdatePartitionsOfThreads();
+            ++num_rebalancings;
+            num_moved_partitions += num_moves;
+
+            return true;
+        }
+
+        //!
+        //! \brief Test whether two threads belong to the same group of a domain, or run on the same NUMA node if there are no domains.
+        //!
+        auto IsClose(const std::size_t thread, const std::size_t other_thread) const -> bool
+        {
+            if (partition_to_domain.size() == partition_to_thread.size())
+            {
+                return (thread_to_domain[thread] == thread_to_domain[other_thread]);
+            }
+
+            return (thread_to_node[thread] == thread_to_node[other_thread]);
+        }
+
+        //!
+        //! \brief Migrate the dofs of the partitions that moved to a thread to its NUMA node (called by this thread).
+        //!
+        template <typename... MeshLoops>
+        auto MigratePages(const std::size_t thread, const MeshLoops&... mesh_loops) -> void
+        {
+#if defined(__linux__)
+            const std::uintptr_t page_size = sysconf(_SC_PAGESIZE);
+#else
+            const std::uintptr_t page_size = 4096;
+#endif
+            std::vector<void*> pages;
+
+            for (const std::size_t partition : moved_to_thread[thread])
+            {
+                (
+                    [&](const auto& mesh_loop) {
+                        if (partition < mesh_loop.entity_range.GetNumPartitions())
+                        {
+                            internal::GetAccessedPages(mesh_loop, partition, page_size, pages);
+                        }
+                    }(mesh_loops),
+                    ...);
+            }
+
+            std::sort(pages.begin(), pages.end());
+            pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+            ::HPM::atomic::AtomicAdd(num_migrated_pages, internal::MovePages(pages, thread_to_node[thread]));
+        }
+
+        std::size_t rebalancing_interval;
+        double tolerance;
+        bool page_migration = true;
+        std::size_t num_threads = 0;
+        std::size_t num_steps = 0;
+        bool rebalanced = false;
+        std::vector<std::size_t> partition_to_thread;
+        std::vector<std::vector<std::size_t>> partitions_of_thread;
+        std::vector<std::vector<std::size_t>> moved_to_thread;
+        std::vector<int> thread_to_node;
+        std::vector<std::size_t> partition_to_domain;
+        std::vector<std::size_t> thread_to_domain;
+        std::size_t num_domains = 0;
+        std::vector<double> partition_times;
+        std::vector<double> partition_costs;
+        std::size_t num_rebalancings = 0;
+        std::size_t num_moved_partitions = 0;
+        std::size_t num_migrated_pages = 0;
+    };
+} // namespace HPM
+
+#endif
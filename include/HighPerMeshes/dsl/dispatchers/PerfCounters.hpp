@@ -0,0 +1,525 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_DISPATCHERS_PERFCOUNTERS_HPP
+#define DSL_DISPATCHERS_PERFCOUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
+
+namespace HPM
+{
+    //!
+    //! \brief Hardware performance counters that can be collected by the `PerfCounterTimer`.
+    //!
+    enum class PerfCounter : std::size_t
+    {
+        Cycles,
+        Instructions,
+        CacheReferences, //!< last level cache references
+        CacheMisses,     //!< last level cache misses
+        BranchMisses,
+        L1DReadMisses
+    };
+
+    constexpr std::size_t NumPerfCounters = 6;
+
+    //! Counter values, indexed by `PerfCounter`.
+    using PerfCounterValues = std::array<std::uint64_t, NumPerfCounters>;
+
+    //!
+    //! \brief Counter values recorded for a mesh loop: one step, one partition and one thread.
+    //!
+    struct PerfCounterEvent
+    {
+        std::size_t execution; //!< index of the `Execute` call of the dispatcher
+        std::size_t loop;      //!< position of the mesh loop within the `Execute` call
+        std::size_t step;      //!< the step passed to the loop body
+        std::size_t partition; //!< the (L2) partition of the entity range
+        std::size_t thread;    //!< the OpenMP thread (0 for sequential loops)
+        PerfCounterValues values;
+    };
+
+    //!
+    //! \brief Get the name of a hardware performance counter.
+    //!
+    //! \param counter the counter
+    //! \return the name of the counter
+    //!
+    inline auto GetPerfCounterName(const PerfCounter counter) -> std::string
+    {
+        static const std::array<std::string, NumPerfCounters> names{"cycles", "instructions", "LLC references", "LLC misses", "branch misses", "L1D read misses"};
+
+        return names[static_cast<std::size_t>(counter)];
+    }
+
+    namespace internal
+    {
+        //!
+        //! \brief A group of hardware performance counters for the calling thread (Linux `perf_event_open`).
+        //!
+        //! All counters are opened in one group so that they are scheduled together and read with a single system call.
+        //! Counters that cannot be opened (missing permissions, no PMU access in containers or virtual machines, unsupported events)
+        //! are skipped: their values are always 0.
+        //! Only user space is counted, which is allowed for the own process with the default `perf_event_paranoid` setting.
+        //!
+        class PerfEventGroup
+        {
+            public:
+            //!
+            //! \brief Raw values of the group.
+            //!
+            struct Sample
+            {
+                std::uint64_t time_enabled = 0;
+                std::uint64_t time_running = 0;
+                PerfCounterValues values{};
+            };
+
+            PerfEventGroup()
+            {
+                fds.fill(-1);
+                positions.fill(0);
+
+#if defined(__linux__)
+                std::size_t position = 0;
+
+                for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+                {
+                    perf_event_attr attr;
+
+                    std::memset(&attr, 0, sizeof(attr));
+                    attr.size = sizeof(attr);
+                    attr.type = GetType(counter);
+                    attr.config = GetConfig(counter);
+                    attr.disabled = (leader == -1 ? 1 : 0);
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                    // The calling thread on any cpu.
+                    const int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+
+                    if (fd != -1)
+                    {
+                        fds[counter] = fd;
+                        positions[counter] = position++;
+                        leader = (leader == -1 ? fd : leader);
+                    }
+                }
+
+                if (leader != -1)
+                {
+                    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+                }
+#endif
+            }
+
+            PerfEventGroup(const PerfEventGroup&) = delete;
+            PerfEventGroup& operator=(const PerfEventGroup&) = delete;
+
+            ~PerfEventGroup()
+            {
+#if defined(__linux__)
+                for (const int fd : fds)
+                {
+                    if (fd != -1)
+                    {
+                        close(fd);
+                    }
+                }
+#endif
+            }
+
+            //!
+            //! \brief Check if a counter could be opened.
+            //!
+            //! \param counter the counter
+            //! \return true if the counter is available, otherwise false
+            //!
+            auto IsAvailable(const PerfCounter counter) const -> bool { return fds[static_cast<std::size_t>(counter)] != -1; }
+
+            //!
+            //! \brief Read all counters of the group.
+            //!
+            //! \return the raw values (all zero if no counter is available)
+            //!
+            auto Read() const -> Sample
+            {
+                Sample sample;
+
+#if defined(__linux__)
+                // Layout for PERF_FORMAT_GROUP: number of counters, time enabled, time running, values.
+                std::array<std::uint64_t, 3 + NumPerfCounters> buffer{};
+
+                if (leader != -1 && ::read(leader, buffer.data(), sizeof(buffer)) > 0)
+                {
+                    sample.time_enabled = buffer[1];
+                    sample.time_running = buffer[2];
+
+                    for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+                    {
+                        if (fds[counter] != -1)
+                        {
+                            sample.values[counter] = buffer[3 + positions[counter]];
+                        }
+                    }
+                }
+#endif
+                return sample;
+            }
+
+            //!
+            //! \brief Get the counter values between two samples.
+            //!
+            //! If the group was not running all the time (the kernel multiplexes the counters), the values are extrapolated.
+            //!
+            //! \param begin the first sample
+            //! \param end the second sample
+            //! \return the counter values
+            //!
+            static auto GetDifference(const Sample& begin, const Sample& end) -> PerfCounterValues
+            {
+                const std::uint64_t time_enabled = end.time_enabled - begin.time_enabled;
+                const std::uint64_t time_running = end.time_running - begin.time_running;
+                PerfCounterValues values{};
+
+                for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+                {
+                    const std::uint64_t value = end.values[counter] - begin.values[counter];
+
+                    values[counter] = (time_running == 0 || time_running == time_enabled ? value : static_cast<std::uint64_t>(static_cast<double>(value) * time_enabled / time_running));
+                }
+
+                return values;
+            }
+
+            private:
+#if defined(__linux__)
+            static auto GetType(const std::size_t counter) -> std::uint32_t
+            {
+                return (static_cast<PerfCounter>(counter) == PerfCounter::L1DReadMisses ? PERF_TYPE_HW_CACHE : PERF_TYPE_HARDWARE);
+            }
+
+            static auto GetConfig(const std::size_t counter) -> std::uint64_t
+            {
+                switch (static_cast<PerfCounter>(counter))
+                {
+                    case PerfCounter::Cycles:
+                        return PERF_COUNT_HW_CPU_CYCLES;
+                    case PerfCounter::Instructions:
+                        return PERF_COUNT_HW_INSTRUCTIONS;
+                    case PerfCounter::CacheReferences:
+                        return PERF_COUNT_HW_CACHE_REFERENCES;
+                    case PerfCounter::CacheMisses:
+                        return PERF_COUNT_HW_CACHE_MISSES;
+                    case PerfCounter::BranchMisses:
+                        return PERF_COUNT_HW_BRANCH_MISSES;
+                    default:
+                        return PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                }
+            }
+#endif
+
+            int leader = -1;
+            std::array<int, NumPerfCounters> fds;
+            std::array<std::size_t, NumPerfCounters> positions;
+        };
+    } // namespace internal
+
+    //!
+    //! \brief Dispatcher instrumentation that records hardware performance counters in addition to the `LoopTimer` events.
+    //!
+    //! Each thread that executes a mesh loop opens its own counter group (Linux `perf_event_open`, no external library) on first use.
+    //! For each mesh loop, step, partition and thread the counter values are recorded.
+    //! If the counters are not available, e.g., in containers without PMU access, all counter values are 0 and only the times are recorded:
+    //! check with `IsAvailable`.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! SequentialDispatcher<PerfCounterTimer> dispatcher;
+    //! dispatcher.Execute(iterator::Range{100}, surface_kernel, volume_kernel);
+    //! const auto& counters = dispatcher.GetInstrumentation();
+    //! if (counters.IsAvailable(PerfCounter::CacheMisses))
+    //!     std::cout << counters.GetCounts(0, 0)[static_cast<std::size_t>(PerfCounter::CacheMisses)] << std::endl;
+    //! counters.WritePerfCounterReport(std::cout);
+    //! \endcode
+    //!
+    class PerfCounterTimer : public LoopTimer
+    {
+        public:
+        //!
+        //! \brief Measurement scope of a mesh loop (for one step and one partition).
+        //!
+        //! The scope is shared by all threads of the loop implementation: each thread measures its own share.
+        //!
+        class Scope
+        {
+            friend class PerfCounterTimer;
+
+            Scope(PerfCounterTimer& timer, LoopTimer::Scope&& time_scope, const std::size_t execution, const std::size_t loop, const std::size_t step, const std::size_t partition)
+                : timer(timer), time_scope(std::move(time_scope)), execution(execution), loop(loop), step(step), partition(partition)
+            {
+            }
+
+            public:
+            //!
+            //! \brief Execute a callable and record its wall time and the counter values for the calling thread.
+            //!
+            //! \tparam FuncT the type of the callable
+            //! \param func the callable
+            //!
+            template <typename FuncT>
+            auto Measure(FuncT&& func) const -> void
+            {
+                const internal::PerfEventGroup& group = timer.GetThreadGroup();
+                const auto begin = group.Read();
+
+                time_scope.Measure(std::forward<FuncT>(func));
+
+                const auto end = group.Read();
+
+                timer.Record({execution, loop, step, partition, internal::GetThreadIndex(), internal::PerfEventGroup::GetDifference(begin, end)});
+            }
+
+            private:
+            PerfCounterTimer& timer;
+            const LoopTimer::Scope time_scope;
+            const std::size_t execution;
+            const std::size_t loop;
+            const std::size_t step;
+            const std::size_t partition;
+        };
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! Opens the counters for the calling thread to determine which counters are available.
+        //!
+        PerfCounterTimer()
+        {
+            const internal::PerfEventGroup& group = GetThreadGroup();
+
+            for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+            {
+                available[counter] = group.IsAvailable(static_cast<PerfCounter>(counter));
+            }
+        }
+
+        //!
+        //! \brief Get the measurement scope for a mesh loop of the current `Execute` call: called by the dispatcher.
+        //!
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param step the current step
+        //! \param partition the partition of the entity range
+        //! \return the measurement scope
+        //!
+        auto GetScope(const std::size_t loop, const std::size_t step, const std::size_t partition) -> Scope
+        {
+            return {*this, LoopTimer::GetScope(loop, step, partition), GetNumExecutions() - 1, loop, step, partition};
+        }
+
+        //!
+        //! \brief Check if a counter is available.
+        //!
+        //! \param counter the counter
+        //! \return true if the counter could be opened, otherwise false
+        //!
+        auto IsAvailable(const PerfCounter counter) const -> bool { return available[static_cast<std::size_t>(counter)]; }
+
+        //!
+        //! \brief Check if any counter is available.
+        //!
+        //! \return true if at least one counter could be opened, otherwise false
+        //!
+        auto IsAvailable() const -> bool
+        {
+            for (const bool counter_available : available)
+            {
+                if (counter_available)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        //!
+        //! \brief Get all recorded counter events.
+        //!
+        //! \return the counter events in the order they were recorded
+        //!
+        auto GetPerfCounterEvents() const -> std::vector<PerfCounterEvent>
+        {
+            std::lock_guard<std::mutex> lock(counter_mutex);
+
+            return counter_events;
+        }
+
+        //!
+        //! \brief Get the counter values of a mesh loop: summed over all steps, partitions and threads.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \return the counter values
+        //!
+        auto GetCounts(const std::size_t execution, const std::size_t loop) const -> PerfCounterValues
+        {
+            PerfCounterValues counts{};
+            std::lock_guard<std::mutex> lock(counter_mutex);
+
+            for (const auto& event : counter_events)
+            {
+                if (event.execution == execution && event.loop == loop)
+                {
+                    for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+                    {
+                        counts[counter] += event.values[counter];
+                    }
+                }
+            }
+
+            return counts;
+        }
+
+        //!
+        //! \brief Write the counter values of all mesh loops as a table.
+        //!
+        //! Unavailable counters are reported as `n/a`.
+        //!
+        //! \param stream the output stream
+        //!
+        auto WritePerfCounterReport(std::ostream& stream) const -> void
+        {
+            std::set<std::pair<std::size_t, std::size_t>> loops;
+
+            {
+                std::lock_guard<std::mutex> lock(counter_mutex);
+
+                for (const auto& event : counter_events)
+                {
+                    loops.emplace(event.execution, event.loop);
+                }
+            }
+
+            const auto flags = stream.flags();
+            const auto precision = stream.precision();
+
+            stream << std::left << std::setw(32) << "loop" << std::right;
+
+            for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+            {
+                stream << std::setw(18) << GetPerfCounterName(static_cast<PerfCounter>(counter));
+            }
+
+            stream << std::setw(8) << "IPC" << std::endl;
+
+            for (const auto& [execution, loop] : loops)
+            {
+                const auto& counts = GetCounts(execution, loop);
+                const std::uint64_t cycles = counts[static_cast<std::size_t>(PerfCounter::Cycles)];
+                const std::uint64_t instructions = counts[static_cast<std::size_t>(PerfCounter::Instructions)];
+
+                stream << std::left << std::setw(32) << GetLoopName(execution, loop) << std::right;
+
+                for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+                {
+                    if (available[counter])
+                    {
+                        stream << std::setw(18) << counts[counter];
+                    }
+                    else
+                    {
+                        stream << std::setw(18) << "n/a";
+                    }
+                }
+
+                if (cycles > 0 && IsAvailable(PerfCounter::Instructions))
+                {
+                    stream << std::setw(8) << std::fixed << std::setprecision(2) << static_cast<double>(instructions) / cycles << std::endl;
+                }
+                else
+                {
+                    stream << std::setw(8) << "n/a" << std::endl;
+                }
+            }
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        //!
+        //! \brief Remove all recorded events, names and counter values.
+        //!
+        auto Clear() -> void
+        {
+            LoopTimer::Clear();
+
+            std::lock_guard<std::mutex> lock(counter_mutex);
+
+            counter_events.clear();
+        }
+
+        private:
+        //!
+        //! \brief Get the counter group of the calling thread: opened on first use (thread-safe).
+        //!
+        //! \return a reference to the counter group
+        //!
+        auto GetThreadGroup() -> const internal::PerfEventGroup&
+        {
+            std::lock_guard<std::mutex> lock(counter_mutex);
+            auto& group = groups[std::this_thread::get_id()];
+
+            if (!group)
+            {
+                group = std::make_unique<internal::PerfEventGroup>();
+            }
+
+            return *group;
+        }
+
+        //!
+        //! \brief Add a counter event (thread-safe).
+        //!
+        //! \param event the counter event
+        //!
+        auto Record(const PerfCounterEvent& event) -> void
+        {
+            std::lock_guard<std::mutex> lock(counter_mutex);
+
+            counter_events.push_back(event);
+        }
+
+        std::array<bool, NumPerfCounters> available{};
+        std::map<std::thread::id, std::unique_ptr<internal::PerfEventGroup>> groups;
+        std::vector<PerfCounterEvent> counter_events;
+        mutable std::mutex counter_mutex;
+    };
+} // namespace HPM
+
+#endif
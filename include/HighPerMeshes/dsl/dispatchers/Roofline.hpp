@@ -0,0 +1,411 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_DISPATCHERS_ROOFLINE_HPP
+#define DSL_DISPATCHERS_ROOFLINE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/dsl/data_access/AccessMode.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
+
+namespace HPM
+{
+    //!
+    //! \brief The minimum data traffic of one step of a mesh loop.
+    //!
+    //! Each dof that is accessed by the loop is counted once: this is the traffic of a loop whose data does not fit into the caches
+    //! but that never loads a dof twice (compulsory misses only).
+    //!
+    struct DataTraffic
+    {
+        std::size_t bytes_read = 0;     //!< bytes of dofs accessed with `Read`, `ReadWrite` or `Accumulate` mode
+        std::size_t bytes_written = 0;  //!< bytes of dofs accessed with `Write`, `ReadWrite` or `Accumulate` mode
+        std::size_t num_iterations = 0; //!< number of loop body invocations
+
+        //!
+        //! \brief Get the total number of bytes moved.
+        //!
+        //! \return the sum of the bytes read and written
+        //!
+        auto GetBytes() const -> std::size_t { return bytes_read + bytes_written; }
+    };
+
+    //!
+    //! \brief Roofline metrics of a mesh loop for one `Execute` call.
+    //!
+    struct RooflineMetrics
+    {
+        std::chrono::nanoseconds time;  //!< the wall time (see `LoopTimer::GetWallTime`)
+        std::size_t bytes;              //!< the minimum number of bytes moved over all steps
+        double flops;                   //!< the floating point operations over all steps (0 if not annotated)
+        double bandwidth;               //!< the achieved bandwidth in bytes per second
+        double arithmetic_intensity;    //!< flops per byte
+        double fraction_of_peak;        //!< the achieved bandwidth relative to the peak bandwidth
+    };
+
+    namespace internal
+    {
+        //!
+        //! \brief Check if a loop implementation iterates over sub-entities (`ForEachIncidence`).
+        //!
+        template <typename LoopT, typename = void>
+        struct IsIncidenceLoop : std::false_type
+        {
+        };
+
+        template <typename LoopT>
+        struct IsIncidenceLoop<LoopT, std::void_t<decltype(LoopT::SubDimension)>> : std::true_type
+        {
+        };
+
+        //!
+        //! \brief Invoke a callable for each entity the loop body of a mesh loop is invoked for within one partition.
+        //!
+        //! \tparam MeshLoop the type of the mesh loop
+        //! \tparam FuncT the type of the callable
+        //! \param mesh_loop the mesh loop
+        //! \param partition the partition of the entity range
+        //! \param func the callable
+        //!
+        template <typename MeshLoop, typename FuncT>
+        auto ForEachVisitedEntity(const MeshLoop& mesh_loop, const std::size_t partition, FuncT&& func) -> void
+        {
+            using LoopT = typename MeshLoop::LoopT;
+
+            for (const auto& entity : mesh_loop.entity_range.GetEntities(partition))
+            {
+                if constexpr (IsIncidenceLoop<LoopT>::value)
+                {
+                    for (const auto& sub_entity : entity.GetTopology().template GetEntities<LoopT::SubDimension>())
+                    {
+                        func(sub_entity);
+                    }
+                }
+                else
+                {
+                    func(entity);
+                }
+            }
+        }
+
+        //!
+        //! \brief Invoke a callable for each entity the loop body of a mesh loop is invoked for (all partitions).
+        //!
+        //! \tparam MeshLoop the type of the mesh loop
+        //! \tparam FuncT the type of the callable
+        //! \param mesh_loop the mesh loop
+        //! \param func the callable
+        //!
+        template <typename MeshLoop, typename FuncT>
+        auto ForEachVisitedEntity(const MeshLoop& mesh_loop, FuncT&& func) -> void
+        {
+            for (std::size_t partition = 0; partition < mesh_loop.entity_range.GetNumPartitions(); ++partition)
+            {
+                ForEachVisitedEntity(mesh_loop, partition, func);
+            }
+        }
+
+        //!
+        //! \brief Add the data traffic of one access definition of a mesh loop.
+        //!
+        //! \tparam MeshLoop the type of the mesh loop
+        //! \tparam AccessDefinition the type of the access definition
+        //! \param mesh_loop the mesh loop
+        //! \param access the access definition
+        //! \param traffic the data traffic of the mesh loop (the number of iterations must be set)
+        //!
+        template <typename MeshLoop, typename AccessDefinition>
+        auto AddDataTraffic(const MeshLoop& mesh_loop, const AccessDefinition& access, DataTraffic& traffic) -> void
+        {
+            using MeshT = typename MeshLoop::MeshT;
+            using ValueT = typename AccessDefinition::BufferT::ValueT;
+
+            constexpr std::size_t RequestedDimension = AccessDefinition::RequestedDimension;
+            std::size_t num_entities = 0;
+
+            if constexpr (RequestedDimension == MeshT::CellDimension + 1)
+            {
+                // Global dofs.
+                num_entities = (traffic.num_iterations > 0 ? 1 : 0);
+            }
+            else
+            {
+                std::vector<bool> accessed(mesh_loop.entity_range.GetMesh().template GetNumEntities<RequestedDimension>(), false);
+
+                ForEachVisitedEntity(mesh_loop, [&access, &accessed, &num_entities](const auto& entity) {
+                    for (const auto index : access.pattern(entity).GetTopology().template GetIndicesOfEntitiesWithDimension<RequestedDimension>())
+                    {
+                        if (!accessed[index])
+                        {
+                            accessed[index] = true;
+                            ++num_entities;
+                        }
+                    }
+                });
+            }
+
+            const std::size_t bytes = num_entities * access.buffer->GetDofs().At(RequestedDimension) * sizeof(ValueT);
+
+            if constexpr (AccessDefinition::Mode.value != AccessMode::Write)
+            {
+                traffic.bytes_read += bytes;
+            }
+
+            if constexpr (AccessDefinition::Mode.value != AccessMode::Read)
+            {
+                traffic.bytes_written += bytes;
+            }
+        }
+    } // namespace internal
+
+    //!
+    //! \brief Compute the minimum data traffic of one step of a mesh loop from its access definitions.
+    //!
+    //! The dofs accessed are determined by walking the entity range of the mesh loop (all partitions) once.
+    //!
+    //! \tparam MeshLoop the type of the mesh loop
+    //! \param mesh_loop the mesh loop
+    //! \return the data traffic of one step
+    //!
+    template <typename MeshLoop>
+    auto GetDataTraffic(const MeshLoop& mesh_loop) -> DataTraffic
+    {
+        DataTraffic traffic;
+
+        internal::ForEachVisitedEntity(mesh_loop, [&traffic](const auto&) { ++traffic.num_iterations; });
+
+        std::apply([&](const auto&... access) { (internal::AddDataTraffic(mesh_loop, access, traffic), ...); }, mesh_loop.access_definitions);
+
+        return traffic;
+    }
+
+    //!
+    //! \brief Measure the memory bandwidth with the STREAM triad kernel `a[i] = b[i] + s * c[i]`.
+    //!
+    //! The arrays are initialized in parallel (first touch), and the bandwidth is counted the STREAM way: 3 arrays per iteration,
+    //! without write-allocate traffic.
+    //! The arrays should be much larger than the last level cache.
+    //!
+    //! \param num_elements the number of elements per array
+    //! \param num_repetitions the number of repetitions
+    //! \return the best bandwidth in bytes per second
+    //!
+    inline auto MeasureStreamBandwidth(const std::size_t num_elements = (1UL << 23), const std::size_t num_repetitions = 10) -> double
+    {
+        using ClockT = std::chrono::steady_clock;
+
+        const std::int64_t n = num_elements;
+        // Uninitialized memory: the pages are mapped by the threads that use them.
+        std::unique_ptr<double[]> a(new double[n]), b(new double[n]), c(new double[n]);
+        double best_time = std::numeric_limits<double>::max();
+
+#pragma omp parallel for schedule(static)
+        for (std::int64_t i = 0; i < n; ++i)
+        {
+            a[i] = 0.0;
+            b[i] = 1.0;
+            c[i] = 2.0;
+        }
+
+        for (std::size_t repetition = 0; repetition < num_repetitions; ++repetition)
+        {
+            const double scalar = 1.0 / (repetition + 3.0);
+            const auto begin = ClockT::now();
+
+#pragma omp parallel for schedule(static)
+            for (std::int64_t i = 0; i < n; ++i)
+            {
+                a[i] = b[i] + scalar * c[i];
+            }
+
+            best_time = std::min(best_time, std::chrono::duration<double>(ClockT::now() - begin).count());
+        }
+
+        // Keep the compiler from removing the kernel.
+        volatile double sink = a[n / 2];
+        static_cast<void>(sink);
+
+        return 3.0 * sizeof(double) * num_elements / best_time;
+    }
+
+    //!
+    //! \brief Dispatcher instrumentation that relates the measured loop times to the data traffic of the mesh loops.
+    //!
+    //! In addition to the `LoopTimer` events, the minimum data traffic of each mesh loop is computed from its access definitions
+    //! at the begin of an `Execute` call (outside the measured region).
+    //! The traffic is computed once per entity range, loop implementation and access definitions, and cached for subsequent `Execute` calls:
+    //! entity ranges and buffers are identified by their addresses, so `Clear` must be called if a range is destroyed or modified.
+    //! Together with a peak bandwidth, e.g., from `MeasureStreamBandwidth`, this gives the distance of each loop to the memory roof.
+    //! Flops can be annotated per loop body invocation to get the arithmetic intensity.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! SequentialDispatcher<RooflineTimer> dispatcher;
+    //! dispatcher.Execute(iterator::Range{100}, surface_kernel, volume_kernel);
+    //! auto& timer = dispatcher.GetInstrumentation();
+    //! timer.SetFlopsPerIteration(0, 1, 1000.0);
+    //! timer.WriteRooflineReport(std::cout, MeasureStreamBandwidth());
+    //! \endcode
+    //!
+    class RooflineTimer : public LoopTimer
+    {
+        public:
+        //!
+        //! \brief Start a new `Execute` call and compute the data traffic of its mesh loops: called by the dispatcher.
+        //!
+        //! \tparam MeshLoops the types of the mesh loops
+        //! \param mesh_loops the mesh loops
+        //!
+        template <typename... MeshLoops>
+        auto BeginExecution(const MeshLoops&... mesh_loops) -> void
+        {
+            LoopTimer::BeginExecution();
+
+            traffic.push_back({GetCachedDataTraffic(mesh_loops)...});
+        }
+
+        //!
+        //! \brief Get the minimum data traffic of one step of a mesh loop.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \return the data traffic of one step
+        //!
+        auto GetDataTraffic(const std::size_t execution, const std::size_t loop) const -> DataTraffic { return traffic.at(execution).at(loop); }
+
+        //!
+        //! \brief Annotate the floating point operations of one loop body invocation.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param flops the floating point operations per loop body invocation
+        //!
+        auto SetFlopsPerIteration(const std::size_t execution, const std::size_t loop, const double flops) -> void { flops_per_iteration[{execution, loop}] = flops; }
+
+        //!
+        //! \brief Get the roofline metrics of a mesh loop.
+        //!
+        //! \param execution the index of the `Execute` call
+        //! \param loop the position of the mesh loop within the `Execute` call
+        //! \param peak_bandwidth the peak memory bandwidth in bytes per second
+        //! \return the roofline metrics over all steps
+        //!
+        auto GetRoofline(const std::size_t execution, const std::size_t loop, const double peak_bandwidth) const -> RooflineMetrics
+        {
+            const DataTraffic& loop_traffic = GetDataTraffic(execution, loop);
+            const std::size_t num_steps = GetNumSteps(execution, loop);
+            const auto it = flops_per_iteration.find({execution, loop});
+
+            RooflineMetrics metrics;
+
+            metrics.time = GetWallTime(execution, loop);
+            metrics.bytes = num_steps * loop_traffic.GetBytes();
+            metrics.flops = (it != flops_per_iteration.end() ? it->second * loop_traffic.num_iterations * num_steps : 0.0);
+
+            const double seconds = std::chrono::duration<double>(metrics.time).count();
+
+            metrics.bandwidth = (seconds > 0.0 ? metrics.bytes / seconds : 0.0);
+            metrics.arithmetic_intensity = (metrics.bytes > 0 ? metrics.flops / metrics.bytes : 0.0);
+            metrics.fraction_of_peak = (peak_bandwidth > 0.0 ? metrics.bandwidth / peak_bandwidth : 0.0);
+
+            return metrics;
+        }
+
+        //!
+        //! \brief Write the roofline metrics of all mesh loops as a table.
+        //!
+        //! \param stream the output stream
+        //! \param peak_bandwidth the peak memory bandwidth in bytes per second
+        //!
+        auto WriteRooflineReport(std::ostream& stream, const double peak_bandwidth) const -> void
+        {
+            const auto flags = stream.flags();
+            const auto precision = stream.precision();
+
+            stream << "peak bandwidth: " << std::fixed << std::setprecision(2) << peak_bandwidth * 1.0E-9 << " GB/s" << std::endl;
+            stream << std::left << std::setw(32) << "loop" << std::right << std::setw(12) << "time [ms]" << std::setw(12) << "GB" << std::setw(12) << "GB/s" << std::setw(12) << "% peak"
+                   << std::setw(12) << "flop/byte" << std::setw(12) << "GFLOP/s" << std::endl;
+
+            for (std::size_t execution = 0; execution < traffic.size(); ++execution)
+            {
+                for (std::size_t loop = 0; loop < traffic[execution].size(); ++loop)
+                {
+                    const RooflineMetrics& metrics = GetRoofline(execution, loop, peak_bandwidth);
+                    const double seconds = std::chrono::duration<double>(metrics.time).count();
+
+                    stream << std::left << std::setw(32) << GetLoopName(execution, loop) << std::right << std::setw(12) << seconds * 1.0E3 << std::setw(12) << metrics.bytes * 1.0E-9 << std::setw(12)
+                           << metrics.bandwidth * 1.0E-9 << std::setw(12) << metrics.fraction_of_peak * 100.0 << std::setw(12) << metrics.arithmetic_intensity << std::setw(12)
+                           << (seconds > 0.0 ? metrics.flops / seconds * 1.0E-9 : 0.0) << std::endl;
+                }
+            }
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        //!
+        //! \brief Remove all recorded events, names, data traffic and flops annotations.
+        //!
+        auto Clear() -> void
+        {
+            LoopTimer::Clear();
+
+            traffic.clear();
+            traffic_cache.clear();
+            flops_per_iteration.clear();
+        }
+
+        private:
+        //!
+        //! \brief Get the data traffic of a mesh loop from the cache, or compute and cache it.
+        //!
+        //! The loop body does not contribute to the traffic: the cache key consists of the types of the loop implementation and
+        //! the access definitions, the address of the entity range and the addresses of the buffers.
+        //!
+        //! \tparam MeshLoop the type of the mesh loop
+        //! \param mesh_loop the mesh loop
+        //! \return the data traffic of one step
+        //!
+        template <typename MeshLoop>
+        auto GetCachedDataTraffic(const MeshLoop& mesh_loop) -> DataTraffic
+        {
+            using KeyTypeT = std::tuple<typename MeshLoop::LoopT, typename MeshLoop::AccessDefinitions>;
+
+            std::vector<const void*> addresses{&mesh_loop.entity_range};
+
+            std::apply([&addresses](const auto&... access) { (addresses.push_back(access.buffer), ...); }, mesh_loop.access_definitions);
+
+            auto key = std::make_pair(std::type_index(typeid(KeyTypeT)), std::move(addresses));
+            const auto it = traffic_cache.find(key);
+
+            if (it != traffic_cache.end())
+            {
+                return it->second;
+            }
+
+            return traffic_cache.emplace(std::move(key), ::HPM::GetDataTraffic(mesh_loop)).first->second;
+        }
+
+        std::vector<std::vector<DataTraffic>> traffic;
+        std::map<std::pair<std::type_index, std::vector<const void*>>, DataTraffic> traffic_cache;
+        std::map<std::pair<std::size_t, std::size_t>, double> flops_per_iteration;
+    };
+} // namespace HPM
+
+#endif
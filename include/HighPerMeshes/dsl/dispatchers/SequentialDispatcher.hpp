@@ -32,12 +32,16 @@ namespace HPM
     //!     })
     //! );
     //! \endcode
+    //! The mesh loops are executed for all partitions of their entity ranges, one after another.
+    //!
+    //! \tparam InstrumentationT records the execution of the mesh loops, e.g., `LoopTimer` (default: nothing is recorded)
     //! \see
     //! Dispatcher
     //! \note
     //! CRTP
     //!
-    class SequentialDispatcher : public Dispatcher<SequentialDispatcher>
+    template <typename InstrumentationT = NoInstrumentation>
+    class SequentialDispatcher : public Dispatcher<SequentialDispatcher<InstrumentationT>, InstrumentationT>
     {
       public:
         //! Implementation of the dispatch function
@@ -47,10 +51,22 @@ namespace HPM
         {
             for (auto step : range)
             {
-                ([](auto&& mesh_loop, auto step) {
-                    const auto& range = mesh_loop.entity_range;
-                    mesh_loop.loop(range.GetEntities(), mesh_loop.access_definitions, [&mesh_loop, &step](auto&& entity, auto& localVectors) { mesh_loop.loop_body(entity, step, localVectors); });
-                } (std::forward<MeshLoops>(mesh_loops), step),...);
+                std::size_t loop = 0;
+
+                ([this, &loop](auto& mesh_loop, const auto& step) {
+                    const auto& entity_range = mesh_loop.entity_range;
+
+                    for (std::size_t partition = 0; partition < entity_range.GetNumPartitions(); ++partition)
+                    {
+                        // Partitions that are not assigned to this process are empty.
+                        if (!entity_range.GetIndices(partition).empty())
+                        {
+                            this->ExecuteLoop(mesh_loop, loop, partition, step);
+                        }
+                    }
+
+                    ++loop;
+                }(mesh_loops, step), ...);
             }
         }
     };
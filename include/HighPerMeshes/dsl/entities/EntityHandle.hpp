@@ -0,0 +1,244 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_ENTITIES_ENTITYHANDLE_HPP
+#define DSL_ENTITIES_ENTITYHANDLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <HighPerMeshes/dsl/meshes/GeometryCachePolicy.hpp>
+
+namespace HPM::entity
+{
+    //!
+    //! \brief A lightweight, index-only reference to a mesh entity.
+    //!
+    //! Full entities (e.g. `Simplex`) consist of a topology and a geometry sub-object, the latter referring to the former.
+    //! Loop implementations and access patterns, however, only need the mesh and the indices of an entity to set up local views.
+    //! The handle holds exactly this information: a pointer to the mesh, the local index, the (global) index and the index of the containing cell.
+    //! It is trivially copyable and can be passed around by value.
+    //!
+    //! The full entity is created on demand via `Materialize()` only, e.g., right before the kernel is invoked.
+    //! All other queries read the index tables of the mesh directly: no entity is constructed.
+    //!
+    //! For access patterns to work on both handles and entities, the handle provides the index-only subset of the entity topology interface
+    //! through `GetTopology()`, which returns the handle itself.
+    //! Cells returned by the handle's topology queries are handles as well.
+    //!
+    //! \tparam EntityT the type of the full entity
+    //!
+    template <typename EntityT_>
+    class EntityHandle
+    {
+        public:
+        // Template arguments.
+        using EntityT = EntityT_;
+
+        // Deduced types and constants.
+        using MeshT = typename EntityT::MeshT;
+        using CellHandleT = EntityHandle<typename MeshT::CellT>;
+        template <std::size_t SubDimension>
+        using SubEntityT = typename decltype(std::declval<const EntityT&>().GetTopology().template GetEntities<SubDimension>())::EntityT;
+        static constexpr std::size_t Dimension = EntityT::Dimension;
+        static constexpr std::size_t CellDimension = MeshT::CellDimension;
+        static constexpr bool IsCell = (Dimension == CellDimension);
+
+        private:
+        template <std::size_t SubDimension>
+        using SubEntityIndicesT = std::decay_t<decltype(std::declval<const EntityT&>().GetTopology().template GetIndicesOfEntitiesWithDimension<SubDimension>())>;
+
+        public:
+        EntityHandle() = default;
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! If the entity type is a cell, the index of the containing cell is the (global) index of the entity (as with `EntityTopology`).
+        //!
+        //! \param mesh a reference to the mesh
+        //! \param local_index this index is always w.r.t. to an embedding super structure (if there is any)
+        //! \param index a unique index of this entity use for its identification among all entities in the mesh
+        //! \param index_of_containing_cell a unique index of the cell that contains this entity
+        //!
+        EntityHandle(const MeshT& mesh, const std::size_t local_index, const std::size_t index, const std::size_t index_of_containing_cell = MeshT::InvalidIndex)
+            : mesh(&mesh), local_index(local_index), index(index), index_of_containing_cell(IsCell ? index : index_of_containing_cell)
+        {
+        }
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! This constructor is a wrapper. It creates a handle with local index and (global) index being equal.
+        //!
+        //! \param mesh a reference to the mesh
+        //! \param index a unique index of this entity use for its identification among all entities in the mesh
+        //!
+        EntityHandle(const MeshT& mesh, const std::size_t index) : EntityHandle(mesh, index, index) {}
+
+        //!
+        //! \brief Create the full entity this handle refers to.
+        //!
+        //! \return the entity with the same mesh and indices as this handle
+        //!
+        inline auto Materialize() const -> EntityT { return {*mesh, local_index, index, index_of_containing_cell}; }
+
+        //!
+        //! \brief Get the index-only topology interface.
+        //!
+        //! \return a reference to this handle
+        //!
+        inline auto GetTopology() const -> const EntityHandle& { return *this; }
+
+        //!
+        //! \brief Get a mesh reference.
+        //!
+        //! \return a const reference to the mesh
+        //!
+        inline auto GetMesh() const -> const MeshT& { return *mesh; }
+
+        //!
+        //! \brief Get the local index of this entity.
+        //!
+        //! \return the local index of this entity
+        //!
+        inline auto GetLocalIndex() const { return local_index; }
+
+        //!
+        //! \brief Get the (global) index of this entity.
+        //!
+        //! \return the (global) index of this entity
+        //!
+        inline auto GetIndex() const { return index; }
+
+        //!
+        //! \brief Get the index of the cell that contains this entity.
+        //!
+        //! \return the index of the cell that contains this entity
+        //!
+        inline auto GetIndexOfContainingCell() const { return index_of_containing_cell; }
+
+        //!
+        //! \brief Get the index of the neighboring cell relative to this face.
+        //!
+        //! If there is no neighboring cell (e.g. at the boundary), the containing cell is considered the neighboring cell (as with `EntityTopology`).
+        //!
+        //! \return the index of the neighboring cell
+        //!
+        inline auto GetIndexOfNeighboringCell() const -> std::size_t
+        {
+            static_assert((Dimension + 1) == CellDimension, "error: this is not a face entity");
+
+            if constexpr (MeshT::template CachesGeometry<::HPM::mesh::GeometryQuantity::FaceNeighbors>())
+            {
+                return mesh->lookup_face_neighboring_cell_mapping[index_of_containing_cell][local_index];
+            }
+            else
+            {
+                // At most 2 incident cells: the containing cell and optionally a neighboring cell.
+                for (const std::size_t incident_cell_index : mesh->entity_incidence_list[Dimension][index])
+                {
+                    if (incident_cell_index != index_of_containing_cell)
+                    {
+                        return incident_cell_index;
+                    }
+                }
+
+                return index_of_containing_cell;
+            }
+        }
+
+        //!
+        //! \brief Get the (global) indices of all entities with a specified dimension that are contained in this entity.
+        //!
+        //! The indices are read from the tables precomputed during the mesh setup (see `EntityTopology::GetIndicesOfEntitiesWithDimension`).
+        //!
+        //! \tparam SubDimension the dimension of the requested entities
+        //! \return an array containing the (global) indices of the requested entities
+        //!
+        template <std::size_t SubDimension>
+        inline auto GetIndicesOfEntitiesWithDimension() const
+        {
+            static_assert(SubDimension <= Dimension, "error: dimension must be lower or equal to the entity dimension");
+
+            if constexpr (SubDimension == Dimension)
+            {
+                return std::array<std::size_t, 1>{index};
+            }
+            // Cells: all sub-entity indices are stored in the entity_index_list.
+            else if constexpr (IsCell)
+            {
+                return std::get<SubDimension>(mesh->entity_index_list)[index];
+            }
+            // Nodes: the entity's node indices.
+            else if constexpr (SubDimension == 0)
+            {
+                return std::get<Dimension>(mesh->entity_node_index_list)[index];
+            }
+            // Otherwise: the sub-entity index table has a fixed row length.
+            else
+            {
+                constexpr std::size_t NumSubEntities = std::tuple_size_v<SubEntityIndicesT<SubDimension>>;
+                const std::size_t* row = mesh->entity_sub_entity_index_list[Dimension][SubDimension].data() + index * NumSubEntities;
+                std::array<std::size_t, NumSubEntities> indices;
+
+                std::copy(row, row + NumSubEntities, indices.begin());
+
+                return indices;
+            }
+        }
+
+        //!
+        //! \brief Get handles to all entities with a specified dimension that are contained in this entity.
+        //!
+        //! All sub-entities inherit the index of the containing cell from this entity.
+        //!
+        //! \tparam SubDimension the dimension of the requested entities
+        //! \return an array of handles to the requested entities
+        //!
+        template <std::size_t SubDimension>
+        inline auto GetEntities() const
+        {
+            static_assert(SubDimension <= Dimension, "error: dimension must be lower or equal to the entity dimension");
+
+            const auto& indices = GetIndicesOfEntitiesWithDimension<SubDimension>();
+            std::array<EntityHandle<SubEntityT<SubDimension>>, std::tuple_size_v<std::decay_t<decltype(indices)>>> handles;
+
+            for (std::size_t local_index = 0; local_index < handles.size(); ++local_index)
+            {
+                // Local index and (global) index of cells are equal (see `IndexedEntityIterator`).
+                handles[local_index] = {*mesh, (SubDimension == CellDimension ? indices[local_index] : local_index), indices[local_index], index_of_containing_cell};
+            }
+
+            return handles;
+        }
+
+        //!
+        //! \brief Get a handle to the containing cell.
+        //!
+        //! \return a handle to the containing cell
+        //!
+        inline auto GetContainingCell() const -> CellHandleT { return {*mesh, GetIndexOfContainingCell()}; }
+
+        //!
+        //! \brief Get a handle to the neighboring cell of this face.
+        //!
+        //! \return a handle to the neighboring cell
+        //!
+        inline auto GetNeighboringCell() const -> CellHandleT { return {*mesh, GetIndexOfNeighboringCell()}; }
+
+        private:
+        const MeshT* mesh = nullptr;
+        std::size_t local_index = 0;
+        std::size_t index = 0;
+        std::size_t index_of_containing_cell = 0;
+    };
+} // namespace HPM::entity
+
+#endif
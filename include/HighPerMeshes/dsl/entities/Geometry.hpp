@@ -9,6 +9,9 @@
 #include <cmath>
 #include <cstdint>
 #include <tuple>
+#include <vector>
+
+#include <HighPerMeshes/dsl/meshes/GeometryCachePolicy.hpp>
 
 namespace HPM::mesh
 {
@@ -38,6 +41,28 @@ namespace HPM::entity
         using Geometry = typename EntityT::Geometry;
         using Topology = typename EntityT::Topology;
         static constexpr std::size_t WorldDimension = MeshT::WorldDimension;
+        using GeometryQuantity = ::HPM::mesh::GeometryQuantity;
+
+        //!
+        //! \brief Check whether a geometry quantity of this entity can be read from the mesh's geometry cache.
+        //!
+        //! Cell quantities (Jacobians) are cached for cells, face quantities (normals) for faces that have been created by cells.
+        //!
+        //! \tparam Quantity a single geometry quantity
+        //! \return `true` if the quantity is cached for this entity, otherwise `false`
+        //!
+        template <GeometryQuantity Quantity>
+        static constexpr auto IsCached() -> bool
+        {
+            if constexpr (Quantity == GeometryQuantity::AbsJacobianDeterminant || Quantity == GeometryQuantity::InverseJacobian)
+            {
+                return MeshT::template CachesGeometry<Quantity>() && Topology::IsCell;
+            }
+            else
+            {
+                return MeshT::template CachesGeometry<Quantity>() && Topology::IsFace && Topology::CreatedByCell;
+            }
+        }
 
         EntityGeometry() = default;
 
@@ -98,21 +123,21 @@ namespace HPM::entity
         //!
         inline auto GetNormal() const
         {
-#if defined(MESH_VALUE_LOOKUP)
-            static_assert(WorldDimension == 3 && EntityDimension == 2, "error: implementation not available");
+            using ReturnT = decltype(static_cast<const Geometry&>(*this).GetNormalImplementation());
 
             // Case: face of a cell.
-            if constexpr (Topology::IsFace && Topology::CreatedByCell)
+            if constexpr (IsCached<GeometryQuantity::Normal>())
             {
                 const std::size_t cell_index = topology.GetIndexOfContainingCell();
                 const std::size_t face_index = topology.GetLocalIndex();
 
-                return std::get<2>(mesh.lookup_normals)[cell_index][face_index];
+                return ::HPM::mesh::internal::ConvertCachedValue<ReturnT>(mesh.lookup_normals[cell_index][face_index]);
+            }
+            else
+            {
+                // CRTP: call the derived class' implementation.
+                return static_cast<const Geometry&>(*this).GetNormalImplementation();
             }
-#endif
-
-            // CRTP: call the derived class' implementation.
-            return static_cast<const Geometry&>(*this).GetNormalImplementation();
         }
 
         //!
@@ -137,21 +162,21 @@ namespace HPM::entity
         //!
         inline auto GetUnitNormal() const
         {
-#if defined(MESH_VALUE_LOOKUP)
-            static_assert(WorldDimension == 3 && EntityDimension == 2, "error: implementation not available");
+            using ReturnT = decltype(static_cast<const Geometry&>(*this).GetUnitNormalImplementation());
 
             // Case: face of a cell.
-            if constexpr (Topology::IsFace && Topology::CreatedByCell)
+            if constexpr (IsCached<GeometryQuantity::UnitNormal>())
             {
                 const std::size_t cell_index = topology.GetIndexOfContainingCell();
                 const std::size_t face_index = topology.GetLocalIndex();
 
-                return std::get<2>(mesh.lookup_unit_normals)[cell_index][face_index];
+                return ::HPM::mesh::internal::ConvertCachedValue<ReturnT>(mesh.lookup_unit_normals[cell_index][face_index]);
+            }
+            else
+            {
+                // CRTP: call the derived class' implementation.
+                return static_cast<const Geometry&>(*this).GetUnitNormalImplementation();
             }
-#endif
-
-            // CRTP: call the derived class' implementation.
-            return static_cast<const Geometry&>(*this).GetUnitNormalImplementation();
         }
 
         //!
@@ -163,21 +188,21 @@ namespace HPM::entity
         //!
         inline auto GetNormalLength() const
         {
-#if defined(MESH_VALUE_LOOKUP)
-            static_assert(WorldDimension == 3 && EntityDimension == 2, "error: implementation not available");
+            using ReturnT = decltype(static_cast<const Geometry&>(*this).GetNormalLengthImplementation());
 
             // Case: face of a cell.
-            if constexpr (Topology::IsFace && Topology::CreatedByCell)
+            if constexpr (IsCached<GeometryQuantity::NormalLength>())
             {
                 const std::size_t cell_index = topology.GetIndexOfContainingCell();
                 const std::size_t face_index = topology.GetLocalIndex();
 
-                return std::get<2>(mesh.lookup_normal_lengths)[cell_index][face_index];
+                return ::HPM::mesh::internal::ConvertCachedValue<ReturnT>(mesh.lookup_normal_lengths[cell_index][face_index]);
+            }
+            else
+            {
+                // CRTP: call the derived class' implementation.
+                return static_cast<const Geometry&>(*this).GetNormalLengthImplementation();
             }
-#endif
-
-            // CRTP: call the derived class' implementation.
-            return static_cast<const Geometry&>(*this).GetNormalLengthImplementation();
         }
 
         //!
@@ -228,13 +253,15 @@ namespace HPM::entity
         //!
         inline auto GetAbsJacobianDeterminant() const
         {
-#if defined(MESH_VALUE_LOOKUP)
-                            static_assert(EntityDimension == 3 && WorldDimension == 3, "error: implementation not available");
-
-            return mesh.lookup_abs_jacobian_determinant[topology.GetIndex()];
-#else
-            return std::abs(GetJacobian().Determinant());
-#endif
+            if constexpr (IsCached<GeometryQuantity::AbsJacobianDeterminant>())
+            {
+                return static_cast<ScalarT>(mesh.lookup_abs_jacobian_determinant[topology.GetIndex()]);
+            }
+            else
+            {
+                // CRTP: call the derived class' implementation.
+                return static_cast<const Geometry&>(*this).GetAbsJacobianDeterminantImplementation();
+            }
         }
 
         //!
@@ -246,13 +273,16 @@ namespace HPM::entity
         //!
         inline auto GetInverseJacobian() const
         {
-#if defined(MESH_VALUE_LOOKUP)
-            static_assert(EntityDimension == 3 && WorldDimension == 3, "error: implementation not available");
+            using ReturnT = decltype(static_cast<const Geometry&>(*this).GetInverseJacobianImplementation());
 
-            return mesh.lookup_inverse_jacobian[topology.GetIndex()];
-#else
-            return static_cast<const Geometry&>(*this).GetInverseJacobianImplementation();
-#endif
+            if constexpr (IsCached<GeometryQuantity::InverseJacobian>())
+            {
+                return ::HPM::mesh::internal::ConvertCachedValue<ReturnT>(mesh.lookup_inverse_jacobian[topology.GetIndex()]);
+            }
+            else
+            {
+                return static_cast<const Geometry&>(*this).GetInverseJacobianImplementation();
+            }
         }
 
         //!
@@ -265,65 +295,128 @@ namespace HPM::entity
             // Setup data structures in the mesh: normals, for instance.
             Geometry::SetupGeometryImplementation(mesh);
 
-#if defined(MESH_VALUE_LOOKUP)
-            // Pre-calculate some geometry information.
-            if constexpr (WorldDimension == 3 && EntityDimension == 3)
+            // Pre-calculate the geometry information selected by the mesh's geometry cache policy.
+            if constexpr (EntityDimension == MeshT::CellDimension)
             {
-                auto& lookup_abs_jacobian_determinant = mesh.lookup_abs_jacobian_determinant;
-                auto& lookup_inverse_jacobian = mesh.lookup_inverse_jacobian;
-                auto& lookup_normals = std::get<2>(mesh.lookup_normals);
-                auto& lookup_unit_normals = std::get<2>(mesh.lookup_unit_normals);
-                auto& lookup_normal_length = std::get<2>(mesh.lookup_normal_lengths);
                 const std::size_t num_cells = mesh.GetNumEntities();
 
-                if (lookup_abs_jacobian_determinant.empty())
+                if constexpr (MeshT::template CachesGeometry<GeometryQuantity::AbsJacobianDeterminant>())
                 {
-                    lookup_abs_jacobian_determinant.resize(num_cells);
+                    mesh.lookup_abs_jacobian_determinant.resize(num_cells);
                 }
 
-                if (lookup_inverse_jacobian.empty())
+                if constexpr (MeshT::template CachesGeometry<GeometryQuantity::InverseJacobian>())
                 {
-                    lookup_inverse_jacobian.resize(num_cells);
+                    mesh.lookup_inverse_jacobian.resize(num_cells);
                 }
 
-                if (lookup_normals.empty())
+                if constexpr (MeshT::template CachesGeometry<GeometryQuantity::Normal>())
                 {
-                    lookup_normals.resize(num_cells);
+                    mesh.lookup_normals.resize(num_cells);
                 }
 
-                if (lookup_unit_normals.empty())
+                if constexpr (MeshT::template CachesGeometry<GeometryQuantity::UnitNormal>())
                 {
-                    lookup_unit_normals.resize(num_cells);
+                    mesh.lookup_unit_normals.resize(num_cells);
                 }
 
-                if (lookup_normal_length.empty())
+                if constexpr (MeshT::template CachesGeometry<GeometryQuantity::NormalLength>())
                 {
-                    lookup_normal_length.resize(num_cells);
+                    mesh.lookup_normal_lengths.resize(num_cells);
                 }
 
-                auto& normals = mesh.normals[2];
+                SetupCachedGeometry(mesh, nullptr);
+            }
+        }
+
+        //!
+        //! \brief Update the geometry information of some cells after their nodes have been moved.
+        //!
+        //! Only node-dependent data is recomputed: the normals of the faces of these cells, their normal orientations,
+        //! and their cached geometry quantities. The topology of the mesh is not touched.
+        //! The list must contain all cells with at least one moved node.
+        //!
+        //! \param mesh a reference to the mesh
+        //! \param cells the (global) indices of the cells to be updated
+        //!
+        static auto UpdateGeometry(MeshT& mesh, const std::vector<std::size_t>& cells)
+        {
+            static_assert(EntityDimension == MeshT::CellDimension, "error: this entity is not a cell");
+
+            Geometry::SetupGeometryImplementation(mesh, &cells);
+            SetupCachedGeometry(mesh, &cells);
+        }
+
+        private:
+        //!
+        //! \brief Pre-calculate the geometry information selected by the mesh's geometry cache policy.
+        //!
+        //! The lookup tables must have one entry per cell already.
+        //!
+        //! \param mesh a reference to the mesh
+        //! \param cells the (global) indices of the cells to be set up, or `nullptr` for all cells
+        //!
+        static auto SetupCachedGeometry(MeshT& mesh, const std::vector<std::size_t>* cells)
+        {
+            constexpr bool CacheAbsJacobianDeterminant = MeshT::template CachesGeometry<GeometryQuantity::AbsJacobianDeterminant>();
+            constexpr bool CacheInverseJacobian = MeshT::template CachesGeometry<GeometryQuantity::InverseJacobian>();
+            constexpr bool CacheNormal = MeshT::template CachesGeometry<GeometryQuantity::Normal>();
+            constexpr bool CacheUnitNormal = MeshT::template CachesGeometry<GeometryQuantity::UnitNormal>();
+            constexpr bool CacheNormalLength = MeshT::template CachesGeometry<GeometryQuantity::NormalLength>();
+            constexpr bool CacheNormals = (CacheNormal || CacheUnitNormal || CacheNormalLength);
+
+            auto& lookup_abs_jacobian_determinant = mesh.lookup_abs_jacobian_determinant;
+            auto& lookup_inverse_jacobian = mesh.lookup_inverse_jacobian;
+            auto& lookup_normals = mesh.lookup_normals;
+            auto& lookup_unit_normals = mesh.lookup_unit_normals;
+            auto& lookup_normal_length = mesh.lookup_normal_lengths;
+
+            // Jacobians: batched and vectorized computation (CRTP).
+            if constexpr (CacheAbsJacobianDeterminant || CacheInverseJacobian)
+            {
+                Geometry::SetupJacobiansImplementation(mesh, (CacheAbsJacobianDeterminant ? lookup_abs_jacobian_determinant.data() : nullptr),
+                                                       (CacheInverseJacobian ? lookup_inverse_jacobian.data() : nullptr), cells);
+            }
+
+            // Face normals of each cell: oriented w.r.t. the cell.
+            if constexpr (CacheNormals)
+            {
+                const auto& normals = mesh.normals[2];
                 const auto& normal_orientations = std::get<2>(mesh.normal_orientations);
+                const auto& face_index_list = std::get<2>(mesh.entity_index_list);
+                const std::int64_t num_cells = (cells ? cells->size() : mesh.GetNumEntities());
 
-                for (const auto& cell : mesh.GetEntities())
+                #pragma omp parallel for schedule(static)
+                for (std::int64_t i = 0; i < num_cells; ++i)
                 {
-                    const std::size_t cell_index = cell.GetTopology().GetIndex();
+                    const std::size_t cell_index = (cells ? (*cells)[i] : i);
 
-                    lookup_abs_jacobian_determinant[cell_index] = std::abs(cell.GetGeometry().GetJacobianImplementation().Determinant());
-                    lookup_inverse_jacobian[cell_index] = cell.GetGeometry().GetInverseJacobianImplementation();
-
-                    for (const auto& face : cell.GetTopology().GetSubEntities())
+                    for (std::size_t face_index = 0; face_index < face_index_list[cell_index].size(); ++face_index)
                     {
-                        const std::size_t face_index = face.GetTopology().GetLocalIndex();
-                        const CoordinateT& face_normal = normals[face.GetTopology().GetIndex()];
+                        const CoordinateT& face_normal = normals[face_index_list[cell_index][face_index]];
                         const ScalarT orientation = normal_orientations[cell_index][face_index];
 
-                        lookup_normals[cell_index][face_index] = face_normal * orientation;
-                        lookup_unit_normals[cell_index][face_index] = Normalize(face_normal) * orientation;
-                        lookup_normal_length[cell_index][face_index] = face_normal.Norm();
+                        if constexpr (CacheNormal)
+                        {
+                            using CachedCoordinateT = typename std::decay_t<decltype(lookup_normals[cell_index])>::value_type;
+
+                            lookup_normals[cell_index][face_index] = ::HPM::mesh::internal::ConvertCachedValue<CachedCoordinateT>(CoordinateT(face_normal * orientation));
+                        }
+
+                        if constexpr (CacheUnitNormal)
+                        {
+                            using CachedCoordinateT = typename std::decay_t<decltype(lookup_unit_normals[cell_index])>::value_type;
+
+                            lookup_unit_normals[cell_index][face_index] = ::HPM::mesh::internal::ConvertCachedValue<CachedCoordinateT>(CoordinateT(Normalize(face_normal) * orientation));
+                        }
+
+                        if constexpr (CacheNormalLength)
+                        {
+                            lookup_normal_length[cell_index][face_index] = face_normal.Norm();
+                        }
                     }
                 }
             }
-#endif
         }
 
         protected:
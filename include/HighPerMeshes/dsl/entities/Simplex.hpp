@@ -6,8 +6,10 @@
 #ifndef DSL_ENTITIES_SIMPLEX_HPP
 #define DSL_ENTITIES_SIMPLEX_HPP
 
+#include <cmath>
 #include <cstdint>
 #include <algorithm>
+#include <numeric>
 
 #include <HighPerMeshes/dsl/entities/Geometry.hpp>
 #include <HighPerMeshes/dsl/entities/Topology.hpp>
@@ -183,7 +185,7 @@ namespace HPM::entity
             //! Entities of higher dimension can share entities of a lower dimension, and the latter can be constructed all from the cells down to the edges.
             //! Using the subsets of the cell's node indices, all entities of the same dimension have unique IDs. These IDs are the (global) indices.
             //!
-            //! The return type of this function is either a temporary or a reference to an existing array holding the indices.
+            //! The indices are precomputed during the mesh setup (see `SetupTopologyImplementation`), so this function just copies them.
             //!
             //! \tparam Dimension the dimension of the requested entities
             //! \return an array containing the (global) indices of the requested entities
@@ -199,21 +201,13 @@ namespace HPM::entity
                 }
                 else
                 {
-                    // Get this element's node indices and return all entities according to the combinations 'M out of N'.
-                    const auto& node_indices = BaseTopology::GetNodeIndices();
-                    const auto& entity_node_index_list = std::get<Dimension>(BaseTopology::MeshMemberAccess().EntityNodeIndexList());
-                    std::array<std::size_t, GetNumEntitiesImplementation<Dimension>()> entities;
+                    // The sub-entity indices of all entities with dimension 'EntityDimension' are stored contiguously in the mesh (fixed row length).
+                    constexpr std::size_t NumEntities = GetNumEntitiesImplementation<Dimension>();
+                    const auto& sub_entity_index_list = BaseTopology::MeshMemberAccess().EntitySubEntityIndexList()[EntityDimension][Dimension];
+                    const std::size_t* row = sub_entity_index_list.data() + index * NumEntities;
+                    std::array<std::size_t, NumEntities> entities;
 
-                    // Iterate over all sub-entities.
-                    for (std::size_t local_index = 0; local_index < entities.size(); ++local_index)
-                    {
-                        // Get this entity's node indices.
-                        const auto& entity_node_indices = GetSubArray<Dimension + 1>(node_indices, local_index);
-                        // Look them up in the list of sets of entity node-indices of the requested dimension: binary search is definitely successful!
-                        const auto it = std::lower_bound(entity_node_index_list.begin(), entity_node_index_list.end(), entity_node_indices);
-                        // Get the (global) index.
-                        entities[local_index] = std::distance(entity_node_index_list.begin(), it);
-                    }
+                    std::copy(row, row + NumEntities, entities.begin());
 
                     return entities;
                 }
@@ -258,6 +252,9 @@ namespace HPM::entity
                 auto& mesh_entity_incidence_list = BaseTopology::MeshMemberAccess(mesh).EntityIncidenceList();
                 auto& mesh_entity_boundary_list = BaseTopology::MeshMemberAccess(mesh).EntityBoundaryList();
                 auto& mesh_entity_neighbor_list = BaseTopology::MeshMemberAccess(mesh).EntityNeighborList();
+                auto& mesh_entity_sub_entity_index_list = BaseTopology::MeshMemberAccess(mesh).EntitySubEntityIndexList();
+                auto& mesh_entity_containing_cell_offsets = BaseTopology::MeshMemberAccess(mesh).EntityContainingCellOffsets();
+                auto& mesh_entity_containing_cell_list = BaseTopology::MeshMemberAccess(mesh).EntityContainingCellList();
 
                 // (SUB-)ENTITIES within a cell:
                 //
@@ -269,40 +266,42 @@ namespace HPM::entity
                 //   - sub-entity 'I' corresponds to any of the combinations of the cell's node indices
                 //
                 //   - for each cell determine the node indices of sub-entity 'I' and sort them
-                //   - insert the node indices of all sub-entities with dimension 'D' into the list 'mesh.entity_node_index_list[D]'
+                //   - collect the node indices of all sub-entities with dimension 'D' in the list 'mesh.entity_node_index_list[D]',
+                //     then sort the list and remove duplicates (inserting into a sorted list one by one is quadratic in the number of cells)
                 //
                 //  Result: a set of sorted lists of node indices of sub-entities with dimension 0..(CellDimension-1).
-                for (std::size_t cell_index = 0; cell_index < mesh.GetNumEntities(); ++cell_index)
-                {
-                    // Node indices of this cell.
-                    const auto& cell_node_indices = std::get<CellDimension>(mesh_entity_node_index_list)[cell_index];
-
-                    // Construct all entities within this cell from the cell's node indices.
-                    // Loop bounds: [1, CellDimension].
-                    ConstexprFor<1, CellDimension + 1>([&cell_node_indices, &mesh_entity_node_index_list](const auto D) {
-                        // Dimension of this (sub-)entity: (CellDimension - 1)..0.
-                        constexpr std::size_t Dimension = CellDimension - D.value;
-                        // Reference to the list of all (sub-)entities' node indices.
-                        auto& entity_node_index_list = std::get<Dimension>(mesh_entity_node_index_list);
-                        // The number of (sub-)entities with dimension 'Dimension' in this cell.
-                        constexpr std::size_t NumEntities = GetNumEntitiesImplementation<Dimension, CellDimension>();
+                //
+                // Construct all entities within the cells from the cells' node indices.
+                // Loop bounds: [1, CellDimension].
+                ConstexprFor<1, CellDimension + 1>([&mesh, &mesh_entity_node_index_list](const auto D) {
+                    // Dimension of this (sub-)entity: (CellDimension - 1)..0.
+                    constexpr std::size_t Dimension = CellDimension - D.value;
+                    // Reference to the list of all (sub-)entities' node indices.
+                    auto& entity_node_index_list = std::get<Dimension>(mesh_entity_node_index_list);
+                    // The number of (sub-)entities with dimension 'Dimension' in a cell.
+                    constexpr std::size_t NumEntities = GetNumEntitiesImplementation<Dimension, CellDimension>();
+                    const std::size_t num_cells = mesh.GetNumEntities();
+                    const std::size_t offset = entity_node_index_list.size();
+
+                    entity_node_index_list.resize(offset + num_cells * NumEntities);
+
+#pragma omp parallel for schedule(static)
+                    for (std::size_t cell_index = 0; cell_index < num_cells; ++cell_index)
+                    {
+                        // Node indices of this cell.
+                        const auto& cell_node_indices = std::get<CellDimension>(mesh_entity_node_index_list)[cell_index];
 
-                        // Iterate over all (sub-)entities.
+                        // Iterate over all (sub-)entities: get their node indices.
                         for (std::size_t entity_local_index = 0; entity_local_index < NumEntities; ++entity_local_index)
                         {
-                            // Get this (sub-)entity's node indices.
-                            const auto& entity_node_indices = GetSubArray<Dimension + 1>(cell_node_indices, entity_local_index);
-                            // Look it up in the list of all (sub-)entities' node indices with the same dimension.
-                            const auto it = std::lower_bound(entity_node_index_list.begin(), entity_node_index_list.end(), entity_node_indices);
-
-                            if (it == entity_node_index_list.end() || (*it) != entity_node_indices)
-                            {
-                                // If the (sub-)entity cannot be found, add it: the resulting list is sorted.
-                                entity_node_index_list.insert(it, entity_node_indices);
-                            }
+                            entity_node_index_list[offset + cell_index * NumEntities + entity_local_index] = GetSubArray<Dimension + 1>(cell_node_indices, entity_local_index);
                         }
-                    });
-                }
+                    }
+
+                    // The resulting list is sorted and each (sub-)entity is contained once.
+                    std::sort(entity_node_index_list.begin(), entity_node_index_list.end());
+                    entity_node_index_list.erase(std::unique(entity_node_index_list.begin(), entity_node_index_list.end()), entity_node_index_list.end());
+                });
 
                 // Resize some fields / lists.
                 ConstexprFor<CellDimension + 1>([&mesh, &mesh_entity_index_list, &mesh_entity_incidence_list, &mesh_entity_neighbor_list](const auto D) {
@@ -357,6 +356,93 @@ namespace HPM::entity
                     });
                 }
 
+                // SUB-ENTITIES of non-cell entities:
+                //
+                // For each entity with dimension 'D' (2..(CellDimension-1)) precompute the indices of its sub-entities with dimension 'd' (1..(D-1)).
+                // Sub-entities with dimension 0 are the entity's node indices, and those with dimension 'D' are the entity itself: no table needed.
+                //
+                //   - for each entity with dimension 'D' create the node indices of sub-entity 'I' (same combinations as for the cells), look them up
+                //     in 'mesh.entity_node_index_list[d]' and deduce the corresponding 'index'
+                //   - store the index at position 'mesh.entity_sub_entity_index_list[D][d][entity_index * NumSubEntities + I]'
+                //
+                // Result: a table with fixed row length (CSR without offsets) for each pair of dimensions 'D' and 'd'
+                if constexpr (CellDimension > 2)
+                {
+                    // Loop bounds: [0, CellDimension-3].
+                    ConstexprFor<CellDimension - 2>([&mesh_entity_node_index_list, &mesh_entity_sub_entity_index_list](const auto I) {
+                        // Dimension of this entity: 2..(CellDimension-1).
+                        constexpr std::size_t Dimension = I + 2;
+                        // Reference to the list of all node indices of entities with dimension 'Dimension'.
+                        const auto& entity_node_index_list = std::get<Dimension>(mesh_entity_node_index_list);
+
+                        // Loop bounds: [0, Dimension-2].
+                        ConstexprFor<Dimension - 1>([&entity_node_index_list, &mesh_entity_node_index_list, &mesh_entity_sub_entity_index_list](const auto J) {
+                            // Dimension of the sub-entities: 1..(Dimension-1).
+                            constexpr std::size_t SubDimension = J + 1;
+                            // The number of sub-entities with dimension 'SubDimension' relative to an entity with dimension 'Dimension'.
+                            constexpr std::size_t NumSubEntities = GetNumEntitiesImplementation<SubDimension, Dimension>();
+                            // Reference to the list of all node indices of entities with dimension 'SubDimension'.
+                            const auto& sub_entity_node_index_list = std::get<SubDimension>(mesh_entity_node_index_list);
+                            auto& sub_entity_index_list = mesh_entity_sub_entity_index_list[Dimension][SubDimension];
+
+                            sub_entity_index_list.resize(entity_node_index_list.size() * NumSubEntities);
+
+                            for (std::size_t entity_index = 0; entity_index < entity_node_index_list.size(); ++entity_index)
+                            {
+                                for (std::size_t sub_entity_local_index = 0; sub_entity_local_index < NumSubEntities; ++sub_entity_local_index)
+                                {
+                                    // Get this sub-entity's node indices.
+                                    const auto& sub_entity_node_indices = GetSubArray<SubDimension + 1>(entity_node_index_list[entity_index], sub_entity_local_index);
+                                    // Look them up in the list of all (sub-)entities' node indices with the same dimension: use binary search!
+                                    const auto it = std::lower_bound(sub_entity_node_index_list.begin(), sub_entity_node_index_list.end(), sub_entity_node_indices);
+
+                                    sub_entity_index_list[entity_index * NumSubEntities + sub_entity_local_index] = std::distance(sub_entity_node_index_list.begin(), it);
+                                }
+                            }
+                        });
+                    });
+                }
+
+                // CONTAINING cells:
+                //
+                // For each entity with dimension 'D' (0..CellDimension) precompute the indices of all cells that contain it (CSR format).
+                //
+                //   - count the number of containing cells per entity using 'mesh.entity_index_list[D]' and accumulate the counts into offsets
+                //   - iterate over all cells in ascending order and add the cell index to the rows of all its sub-entities
+                //   - a cell contains each of its sub-entities just once
+                //
+                // Result: a sorted list of containing cells for each entity in 'mesh.entity_containing_cell_list[D]', with row 'i' starting at
+                //         'mesh.entity_containing_cell_offsets[D][i]'
+                ConstexprFor<CellDimension + 1>([&mesh, &mesh_entity_index_list, &mesh_entity_containing_cell_offsets, &mesh_entity_containing_cell_list](const auto D) {
+                    const auto& entity_indices = std::get<D>(mesh_entity_index_list);
+                    auto& offsets = mesh_entity_containing_cell_offsets[D];
+                    auto& containing_cells = mesh_entity_containing_cell_list[D];
+                    const std::size_t num_cells = mesh.GetNumEntities();
+
+                    offsets.assign(mesh.template GetNumEntities<D>() + 1, 0);
+
+                    for (std::size_t cell_index = 0; cell_index < num_cells; ++cell_index)
+                    {
+                        for (const std::size_t entity_index : entity_indices[cell_index])
+                        {
+                            ++offsets[entity_index + 1];
+                        }
+                    }
+
+                    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                    std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+                    containing_cells.resize(offsets.back());
+
+                    for (std::size_t cell_index = 0; cell_index < num_cells; ++cell_index)
+                    {
+                        for (const std::size_t entity_index : entity_indices[cell_index])
+                        {
+                            containing_cells[position[entity_index]++] = cell_index;
+                        }
+                    }
+                });
+
                 // INCIDENT entities:
                 //
                 // For each entity with dimension 'D' (1..CellDimension) add the entity's index to
@@ -599,6 +685,7 @@ namespace HPM::entity
 
             // Deduced types.
             using ScalarT = typename CoordinateT::ValueT;
+            using JacobianElementsT = std::array<std::array<ScalarT, EntityDimension>, EntityDimension>;
             static constexpr bool IsCell = Simplex::Topology::IsCell;
             static constexpr bool CreatedByCell = Simplex::Topology::CreatedByCell;
             static constexpr bool IsFace = Simplex::Topology::IsFace;
@@ -767,53 +854,172 @@ namespace HPM::entity
             }
 
             //!
-            //! \brief Get the inverse of the jacobian matrix for this entity.
+            //! \brief Compute the determinant and the inverse of a square jacobian matrix.
             //!
-            //! This implementation works for entities with dimension 2 and 3.
+            //! The determinant is calculated according to the Leibniz formula (as `Matrix::Determinant`), the inverse by the adjoint matrix
+            //! (as the former `GetInverseJacobianImplementation`).
+            //! This function is used for single entities and (lane-wise) by the batched setup of the mesh's geometry cache.
+            //! Multiply-adds are fused explicitly (`std::fma`): the compiler cannot contract or reassociate them differently in the
+            //! vectorized loop (e.g., with `-ffast-math`), so cached and on-the-fly values are bitwise equal.
+            //! If the determinant is zero, the inverse contains non-finite values.
             //!
-            //! \return the inverse of the jacobian matrix for this entity
+            //! \param J the elements of the jacobian matrix
+            //! \param determinant the determinant of the jacobian matrix (output)
+            //! \param inverse the elements of the inverse of the jacobian matrix (output)
             //!
-            inline auto GetInverseJacobianImplementation() const -> Matrix<ScalarT, EntityDimension, WorldDimension>
+            static inline auto InvertJacobian(const JacobianElementsT& J, ScalarT& determinant, JacobianElementsT& inverse) -> void
             {
-                const auto& J = GetJacobianImplementation();
-                // TODO: Error message if det(J) = 0 -> matrix is singular -> no inverse exists
-                const ScalarT J_determinant = 1.0 / J.Determinant();
+                static_assert((EntityDimension == 3 && WorldDimension == 3) || (EntityDimension == 2 && WorldDimension == 2), "error: implementation not available");
 
-                if constexpr (EntityDimension == 3 && WorldDimension == 3)
+                // a * b - c * d
+                const auto difference_of_products = [](const ScalarT a, const ScalarT b, const ScalarT c, const ScalarT d) { return std::fma(a, b, -(c * d)); };
+
+                // Leibniz' rule: the sign is +-1, so the order of the multiplications within a product does not matter.
+                determinant = 0;
+
+                for (std::size_t s = 0; s < Factorial(EntityDimension); ++s)
                 {
-                    const ScalarT drdx = (J.yy * J.zz - J.zy * J.yz) * J_determinant;
-                    const ScalarT dsdx = -(J.xy * J.zz - J.zy * J.xz) * J_determinant;
-                    const ScalarT dtdx = (J.xy * J.yz - J.yy * J.xz) * J_determinant;
-                    const ScalarT drdy = -(J.yx * J.zz - J.zx * J.yz) * J_determinant;
-                    const ScalarT dsdy = (J.xx * J.zz - J.zx * J.xz) * J_determinant;
-                    const ScalarT dtdy = -(J.xx * J.yz - J.yx * J.xz) * J_determinant;
-                    const ScalarT drdz = (J.yx * J.zy - J.zx * J.yy) * J_determinant;
-                    const ScalarT dsdz = -(J.xx * J.zy - J.zx * J.xy) * J_determinant;
-                    const ScalarT dtdz = (J.xx * J.yy - J.yx * J.xy) * J_determinant;
+                    const std::array<std::size_t, EntityDimension>& permutation = ::HPM::math::GetPermutation<EntityDimension>(s);
+                    ScalarT product = ::HPM::math::GetSignOfPermutation<EntityDimension>(s);
+
+                    for (std::size_t i = 0; i < (EntityDimension - 1); ++i)
+                    {
+                        product *= J[i][permutation[i]];
+                    }
 
-                    return {drdx, dsdx, dtdx, drdy, dsdy, dtdy, drdz, dsdz, dtdz};
+                    determinant = std::fma(product, J[EntityDimension - 1][permutation[EntityDimension - 1]], determinant);
                 }
-                else if constexpr (EntityDimension == 2 && WorldDimension == 2)
+
+                const ScalarT J_determinant = 1.0 / determinant;
+
+                if constexpr (EntityDimension == 3)
+                {
+                    inverse[0][0] = difference_of_products(J[1][1], J[2][2], J[2][1], J[1][2]) * J_determinant;
+                    inverse[0][1] = -difference_of_products(J[0][1], J[2][2], J[2][1], J[0][2]) * J_determinant;
+                    inverse[0][2] = difference_of_products(J[0][1], J[1][2], J[1][1], J[0][2]) * J_determinant;
+                    inverse[1][0] = -difference_of_products(J[1][0], J[2][2], J[2][0], J[1][2]) * J_determinant;
+                    inverse[1][1] = difference_of_products(J[0][0], J[2][2], J[2][0], J[0][2]) * J_determinant;
+                    inverse[1][2] = -difference_of_products(J[0][0], J[1][2], J[1][0], J[0][2]) * J_determinant;
+                    inverse[2][0] = difference_of_products(J[1][0], J[2][1], J[2][0], J[1][1]) * J_determinant;
+                    inverse[2][1] = -difference_of_products(J[0][0], J[2][1], J[2][0], J[0][1]) * J_determinant;
+                    inverse[2][2] = difference_of_products(J[0][0], J[1][1], J[1][0], J[0][1]) * J_determinant;
+                }
+                else
+                {
+                    inverse[0][0] = (J[1][1]) * J_determinant;
+                    inverse[0][1] = -(J[0][1]) * J_determinant;
+                    inverse[1][0] = -(J[1][0]) * J_determinant;
+                    inverse[1][1] = (J[0][0]) * J_determinant;
+                }
+            }
+
+            //!
+            //! \brief Compute the determinant and the inverse of the jacobian matrix for this entity.
+            //!
+            //! \param determinant the determinant of the jacobian matrix (output)
+            //! \param inverse the elements of the inverse of the jacobian matrix (output)
+            //!
+            inline auto InvertJacobian(ScalarT& determinant, JacobianElementsT& inverse) const -> void
+            {
+                const auto& jacobian = GetJacobianImplementation();
+                JacobianElementsT J;
+
+                for (std::size_t r = 0; r < EntityDimension; ++r)
+                {
+                    for (std::size_t c = 0; c < EntityDimension; ++c)
+                    {
+                        J[r][c] = jacobian[r][c];
+                    }
+                }
+
+                InvertJacobian(J, determinant, inverse);
+            }
+
+            //!
+            //! \brief Get the absolute value of the determinant of the jacobian matrix for this entity.
+            //!
+            //! \return the absolute value of the determinant of the jacobian matrix for this entity
+            //!
+            inline auto GetAbsJacobianDeterminantImplementation() const -> ScalarT
+            {
+                if constexpr ((EntityDimension == 3 && WorldDimension == 3) || (EntityDimension == 2 && WorldDimension == 2))
                 {
-                    const ScalarT drdx =  (J.yy) * J_determinant;
-                    const ScalarT dsdx = -(J.xy) * J_determinant;
-                    const ScalarT drdy = -(J.yx) * J_determinant;
-                    const ScalarT dsdy =  (J.xx) * J_determinant;
+                    ScalarT determinant;
+                    JacobianElementsT inverse;
+
+                    InvertJacobian(determinant, inverse);
 
-                    return {drdx, dsdx, drdy, dsdy};
+                    return std::abs(determinant);
                 }
                 else
                 {
-                    static_assert((EntityDimension == 3 && WorldDimension == 3)||(EntityDimension == 2 && WorldDimension == 2), "error: implementation not available");
+                    return std::abs(GetJacobianImplementation().Determinant());
                 }
             }
 
+            //!
+            //! \brief Get the inverse of the jacobian matrix for this entity.
+            //!
+            //! This implementation works for entities with dimension 2 and 3.
+            //!
+            //! \return the inverse of the jacobian matrix for this entity
+            //!
+            inline auto GetInverseJacobianImplementation() const -> Matrix<ScalarT, EntityDimension, WorldDimension>
+            {
+                static_assert((EntityDimension == 3 && WorldDimension == 3) || (EntityDimension == 2 && WorldDimension == 2), "error: implementation not available");
+
+                ScalarT determinant;
+                JacobianElementsT inverse;
+                Matrix<ScalarT, EntityDimension, WorldDimension> inverse_jacobian;
+
+                // TODO: Error message if det(J) = 0 -> matrix is singular -> no inverse exists
+                InvertJacobian(determinant, inverse);
+
+                for (std::size_t r = 0; r < EntityDimension; ++r)
+                {
+                    for (std::size_t c = 0; c < EntityDimension; ++c)
+                    {
+                        inverse_jacobian[r][c] = inverse[r][c];
+                    }
+                }
+
+                return inverse_jacobian;
+            }
+
+            //!
+            //! \brief Get the outward normals (not normalized) of the faces of a tetrahedron.
+            //!
+            //! The face order corresponds to the local face indices of the cell.
+            //! The normal orientation is stored separately: the normals returned by this function are as is.
+            //!
+            //! \param nodes the (global) node coordinates of the mesh
+            //! \param cell_node_indices the node indices of the cell
+            //! \return the face normals of the cell
+            //!
+            static inline auto GetFaceNormalsOfCell(const std::vector<CoordinateT>& nodes, const std::array<std::size_t, 4>& cell_node_indices) -> std::array<CoordinateT, 4>
+            {
+                const CoordinateT& n_0 = nodes[cell_node_indices[0]];
+                const CoordinateT& n_1 = nodes[cell_node_indices[1]];
+                const CoordinateT& n_2 = nodes[cell_node_indices[2]];
+                const CoordinateT& n_3 = nodes[cell_node_indices[3]];
+                const CoordinateT v[5] = {n_1 - n_0, n_2 - n_0, n_3 - n_0, n_2 - n_1, n_3 - n_1};
+
+                return {CrossProduct(v[0], v[1]), CrossProduct(v[0], v[2]), CrossProduct(v[3], v[4]), CrossProduct(v[1], v[2])};
+            }
+
             //!
             //! \brief Setup data structures in the mesh that hold geometry information.
             //!
+            //! Cells (and faces) are processed independently of each other, and the loops are distributed among OpenMP threads.
+            //! Each face normal is taken from the containing cell with the lowest index, so the result does not depend on the number of threads.
+            //!
+            //! If a list of cells is given, only the normals of their faces and their normal orientations are recomputed,
+            //! e.g., after their nodes have been moved (see `Mesh::UpdateNodes`).
+            //!
             //! \param mesh a reference to the mesh
+            //! \param cells the (global) indices of the cells to be set up, or `nullptr` for all cells
             //!
-            static auto SetupGeometryImplementation(MeshT& mesh)
+            static auto SetupGeometryImplementation(MeshT& mesh, const std::vector<std::size_t>* cells = nullptr)
             {
                 static_assert(EntityDimension == CellDimension, "error: this entity is not a cell");
 
@@ -824,6 +1030,10 @@ namespace HPM::entity
                 //   - cell has dimension 2: entity normals (no orientation)
                 if constexpr (WorldDimension == 3 && (EntityDimension == 2 || EntityDimension == 3))
                 {
+                    const auto& nodes = BaseGeometry::MeshMemberAccess(mesh).Nodes();
+                    const auto& cell_node_index_list = std::get<CellDimension>(BaseGeometry::MeshMemberAccess(mesh).EntityNodeIndexList());
+                    const std::int64_t num_cells = (cells ? cells->size() : mesh.GetNumEntities());
+                    auto get_cell_index = [cells](const std::size_t i) { return (cells ? (*cells)[i] : i); };
                     // Reference to the list of normals vectors.
                     auto& normals = std::get<2>(BaseGeometry::MeshMemberAccess(mesh).Normals());
 
@@ -835,37 +1045,61 @@ namespace HPM::entity
                     // Iterator over all cells and calculate the face normals.
                     if constexpr (EntityDimension == 2)
                     {
-                        for (const auto& cell : mesh.GetEntities())
+                        #pragma omp parallel for schedule(static)
+                        for (std::int64_t i = 0; i < num_cells; ++i)
                         {
-                            const std::size_t cell_index = cell.GetTopology().GetIndex();
-                            const auto& cell_nodes = cell.GetTopology().GetNodes();
+                            const std::size_t cell_index = get_cell_index(i);
+                            const auto& cell_node_indices = cell_node_index_list[cell_index];
+                            const CoordinateT& n_0 = nodes[cell_node_indices[0]];
 
-                            normals[cell_index] = CrossProduct(cell_nodes[1] - cell_nodes[0], cell_nodes[2] - cell_nodes[0]);
+                            normals[cell_index] = CrossProduct(nodes[cell_node_indices[1]] - n_0, nodes[cell_node_indices[2]] - n_0);
                         }
                     }
                     else
                     {
-                        for (const auto& cell : mesh.GetEntities())
+                        const auto& face_index_list = std::get<2>(BaseGeometry::MeshMemberAccess(mesh).EntityIndexList());
+                        const auto& containing_cell_offsets = BaseGeometry::MeshMemberAccess(mesh).EntityContainingCellOffsets()[2];
+                        const auto& containing_cell_list = BaseGeometry::MeshMemberAccess(mesh).EntityContainingCellList()[2];
+                        // The faces of the given cells: each face once, as faces are shared between cells.
+                        std::vector<std::size_t> faces;
+
+                        if (cells)
                         {
-                            const std::size_t cell_index = cell.GetTopology().GetIndex();
-                            const auto& cell_nodes = cell.GetTopology().GetNodes();
-                            const CoordinateT v[5] = {cell_nodes[1] - cell_nodes[0], cell_nodes[2] - cell_nodes[0], cell_nodes[3] - cell_nodes[0], cell_nodes[2] - cell_nodes[1], cell_nodes[3] - cell_nodes[1]};
-                            const CoordinateT face_normal[4] = {CrossProduct(v[0], v[1]), CrossProduct(v[0], v[2]), CrossProduct(v[3], v[4]), CrossProduct(v[1], v[2])};
-                            const auto& face_indices = std::get<2>(BaseGeometry::MeshMemberAccess(mesh).EntityIndexList())[cell_index];
+                            faces.reserve(cells->size() * 4);
 
-                            for (std::size_t face_local_index = 0; face_local_index < 4; ++face_local_index)
+                            for (const std::size_t cell_index : *cells)
                             {
-                                if (normals[face_indices[face_local_index]] == CoordinateT{})
-                                {
-                                    normals[face_indices[face_local_index]] = face_normal[face_local_index];
-                                }
+                                faces.insert(faces.end(), face_index_list[cell_index].begin(), face_index_list[cell_index].end());
                             }
+
+                            std::sort(faces.begin(), faces.end());
+                            faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
                         }
-                    }
 
-                    // Determine face-normal orientations: works only for faces that are embedded into a cell.
-                    if constexpr (EntityDimension == 3)
-                    {
+                        const std::int64_t num_faces = (cells ? faces.size() : mesh.template GetNumEntities<2>());
+
+                        // Iterate over all faces and assign the normal of the first containing cell that provides a non-zero normal.
+                        // Existing normals are overwritten, so the geometry can be set up again after the nodes have been moved.
+                        #pragma omp parallel for schedule(static)
+                        for (std::int64_t f = 0; f < num_faces; ++f)
+                        {
+                            const std::size_t face_index = (cells ? faces[f] : f);
+                            CoordinateT normal{};
+
+                            for (std::size_t i = containing_cell_offsets[face_index]; i < containing_cell_offsets[face_index + 1] && normal == CoordinateT{}; ++i)
+                            {
+                                const std::size_t cell_index = containing_cell_list[i];
+                                const auto& face_indices = face_index_list[cell_index];
+                                const std::size_t face_local_index = std::distance(face_indices.begin(), std::find(face_indices.begin(), face_indices.end(), face_index));
+
+                                normal = GetFaceNormalsOfCell(nodes, cell_node_index_list[cell_index])[face_local_index];
+                            }
+
+                            normals[face_index] = normal;
+                        }
+
+                        // Determine face-normal orientations: works only for faces that are embedded into a cell.
+                        const auto& face_node_index_list = std::get<2>(BaseGeometry::MeshMemberAccess(mesh).EntityNodeIndexList());
                         // Reference to the list of normal orientations.
                         auto& normal_orientations = std::get<2>(BaseGeometry::MeshMemberAccess(mesh).NormalOrientations());
 
@@ -874,34 +1108,139 @@ namespace HPM::entity
                             normal_orientations.resize(mesh.GetNumEntities());
                         }
 
-                        for (const auto& cell : mesh.GetEntities())
+                        #pragma omp parallel for schedule(static)
+                        for (std::int64_t i = 0; i < num_cells; ++i)
                         {
-                            for (const auto& face : cell.GetTopology().GetSubEntities())
+                            const std::size_t cell_index = get_cell_index(i);
+                            const auto& cell_node_indices = cell_node_index_list[cell_index];
+
+                            for (std::size_t face_local_index = 0; face_local_index < 4; ++face_local_index)
                             {
+                                const std::size_t face_index = face_index_list[cell_index][face_local_index];
+                                const auto& face_node_indices = face_node_index_list[face_index];
                                 // Find the cell-node that is not contained in the face (there is only one such node).
-                                const std::size_t node_index = [&cell, &face]() {
-                                    for (const std::size_t cell_node_index : cell.GetTopology().GetNodeIndices())
+                                const std::size_t node_index = [&cell_node_indices, &face_node_indices]() {
+                                    for (const std::size_t cell_node_index : cell_node_indices)
                                     {
-                                        bool contained = false;
-                                        for (const std::size_t face_node_index : face.GetTopology().GetNodeIndices())
+                                        if (std::find(face_node_indices.begin(), face_node_indices.end(), cell_node_index) == face_node_indices.end())
                                         {
-                                            contained |= (cell_node_index == face_node_index);
-                                        }
-
-                                        if (!contained)
                                             return cell_node_index;
+                                        }
                                     }
 
                                     return MeshT::InvalidIndex;
                                 }();
 
                                 // Get the vector from any face node to the node not contained in the face.
-                                const auto& node = (BaseGeometry::MeshMemberAccess(mesh).Nodes())[node_index];
-                                const auto& v = node - face.GetTopology().GetNodes()[0];
+                                const auto& v = nodes[node_index] - nodes[face_node_indices[0]];
                                 // If the scalar product of the face normal and 'v' is negative, the face normal points outwards.
-                                const ScalarT orientation = ((normals[face.GetTopology().GetIndex()] * v) <= 0 ? 1 : -1);
+                                const ScalarT orientation = ((normals[face_index] * v) <= 0 ? 1 : -1);
 
-                                normal_orientations[cell.GetTopology().GetIndex()][face.GetTopology().GetLocalIndex()] = orientation;
+                                normal_orientations[cell_index][face_local_index] = orientation;
+                            }
+                        }
+                    }
+                }
+            }
+
+            //!
+            //! \brief Compute the absolute Jacobian determinants and the inverse Jacobians of all cells.
+            //!
+            //! Cells are processed in blocks of `BlockSize` cells that are distributed among OpenMP threads.
+            //! The Jacobians of a block are set up from the node coordinates in a structure-of-arrays layout,
+            //! and determinants and inverses are computed lane-wise in vectorizable loops.
+            //! Determinants and inverses are calculated by `InvertJacobian`, as for single cells:
+            //! the results are bitwise equal to those calculated by `GetAbsJacobianDeterminantImplementation` and `GetInverseJacobianImplementation`.
+            //!
+            //! \tparam AbsJacobianDeterminantT the storage type of the absolute Jacobian determinants
+            //! \tparam InverseJacobianT the storage type of the inverse Jacobians
+            //! \param mesh a reference to the mesh
+            //! \param abs_jacobian_determinant a pointer to the output (one element per cell), or `nullptr`
+            //! \param inverse_jacobian a pointer to the output (one element per cell), or `nullptr`
+            //! \param cells the (global) indices of the cells to be set up, or `nullptr` for all cells
+            //!
+            template <typename AbsJacobianDeterminantT, typename InverseJacobianT>
+            static auto SetupJacobiansImplementation(MeshT& mesh, AbsJacobianDeterminantT* abs_jacobian_determinant, InverseJacobianT* inverse_jacobian,
+                                                     const std::vector<std::size_t>* cells = nullptr)
+            {
+                static_assert(IsCell, "error: this entity is not a cell");
+                static_assert(EntityDimension == WorldDimension && (EntityDimension == 2 || EntityDimension == 3), "error: implementation not available");
+
+                constexpr std::size_t D = EntityDimension;
+                constexpr std::size_t BlockSize = 16;
+
+                const auto& nodes = BaseGeometry::MeshMemberAccess(mesh).Nodes();
+                const auto& cell_node_index_list = std::get<CellDimension>(BaseGeometry::MeshMemberAccess(mesh).EntityNodeIndexList());
+                const std::size_t num_cells = (cells ? cells->size() : mesh.GetNumEntities());
+                const std::int64_t num_blocks = (num_cells + BlockSize - 1) / BlockSize;
+                auto get_cell_index = [cells](const std::size_t i) { return (cells ? (*cells)[i] : i); };
+
+                #pragma omp parallel for schedule(static)
+                for (std::int64_t block = 0; block < num_blocks; ++block)
+                {
+                    const std::size_t begin = block * BlockSize;
+                    const std::size_t size = std::min(BlockSize, num_cells - begin);
+                    alignas(64) ScalarT J[D][D][BlockSize];
+                    alignas(64) ScalarT determinant[BlockSize];
+                    alignas(64) ScalarT inverse[D][D][BlockSize];
+
+                    // Jacobians: column 'c' is the position vector of node 'c+1' relative to node 0 (see `GetJacobianImplementation`).
+                    // Lanes beyond the last cell are filled with the identity.
+                    for (std::size_t l = 0; l < BlockSize; ++l)
+                    {
+                        for (std::size_t r = 0; r < D; ++r)
+                        {
+                            for (std::size_t c = 0; c < D; ++c)
+                            {
+                                J[r][c][l] = (l < size ? (nodes[cell_node_index_list[get_cell_index(begin + l)][c + 1]][r] - nodes[cell_node_index_list[get_cell_index(begin + l)][0]][r]) : (r == c ? 1 : 0));
+                            }
+                        }
+                    }
+
+                    // Determinants and inverses: lane-wise, using the same function as for single cells.
+                    #pragma omp simd
+                    for (std::size_t l = 0; l < BlockSize; ++l)
+                    {
+                        JacobianElementsT J_l;
+                        JacobianElementsT inverse_l;
+
+                        for (std::size_t r = 0; r < D; ++r)
+                        {
+                            for (std::size_t c = 0; c < D; ++c)
+                            {
+                                J_l[r][c] = J[r][c][l];
+                            }
+                        }
+
+                        InvertJacobian(J_l, determinant[l], inverse_l);
+
+                        for (std::size_t r = 0; r < D; ++r)
+                        {
+                            for (std::size_t c = 0; c < D; ++c)
+                            {
+                                inverse[r][c][l] = inverse_l[r][c];
+                            }
+                        }
+                    }
+
+                    // Write back the results (structure-of-arrays to array-of-structures).
+                    for (std::size_t l = 0; l < size; ++l)
+                    {
+                        const std::size_t cell_index = get_cell_index(begin + l);
+
+                        if (abs_jacobian_determinant)
+                        {
+                            abs_jacobian_determinant[cell_index] = std::abs(determinant[l]);
+                        }
+
+                        if (inverse_jacobian)
+                        {
+                            for (std::size_t r = 0; r < D; ++r)
+                            {
+                                for (std::size_t c = 0; c < D; ++c)
+                                {
+                                    inverse_jacobian[cell_index][r][c] = inverse[r][c][l];
+                                }
                             }
                         }
                     }
@@ -7,12 +7,12 @@
 #define DSL_ENTITIES_TOPOLOGY_HPP
 
 #include <array>
-#include <set>
 #include <vector>
 
 #include <HighPerMeshes/auxiliary/ConstexprIfElse.hpp>
 #include <HighPerMeshes/auxiliary/ArrayOperations.hpp>
 #include <HighPerMeshes/common/Iterator.hpp>
+#include <HighPerMeshes/dsl/meshes/GeometryCachePolicy.hpp>
 
 namespace HPM::entity
 {
@@ -50,8 +50,8 @@ namespace HPM::entity
         using EntityT = std::conditional_t<(Dimension > EntityDimension), typename MeshT::template EntityT<Dimension>,                               // has `MeshT::NullT` as the parent type
                                                             std::conditional_t<(Dimension == EntityDimension), ThisEntityT,                              // take the type of this entity
                                                                                 EntityTypeName<MeshT, CoordinateT, Dimension, ThisEntityT>>>;             // has this type as the parent type
-        template <typename ThisEntityT>
-        using IndexedEntityRange = ::HPM::iterator::IndexedEntityRange<ThisEntityT, MeshT>;
+        template <typename ThisEntityT, typename IndexSetT = ::HPM::iterator::IndexSpan>
+        using IndexedEntityRange = ::HPM::iterator::IndexedEntityRange<ThisEntityT, MeshT, false, IndexSetT>;
         using Topology = typename ThisEntityT::Topology;
         static constexpr bool IsCell = (EntityDimension == CellDimension);
         static constexpr bool ParentEntityIsCell = (HasParentEntity && ParentEntityDimension == CellDimension);
@@ -170,39 +170,17 @@ namespace HPM::entity
         //!
         //! \brief Get the indices of all cells that contain this entity.
         //!
-        //! If this entity is a cell, return a vector with the (global) index of this entity as its content.
-        //! Otherwise, start from this entity's (global) index and iterate over all higher dimensional entities that are incident to it
-        //! until the cell dimension is reached.
-        //! The output of each iteration becomes the input of the next iteration.
-        //! In order to count incident entities just once, this implementation uses an `std::set` data structure to hold the indices.
-        //! At the end of the iteration, the content of the set is copied to a vector container which then is returned by this function.
+        //! If this entity is a cell, the result contains the (global) index of this entity only.
+        //! The indices of the containing cells of all entities are precomputed during the mesh setup and stored in CSR format.
+        //! This function returns a view into that storage: the indices are sorted in ascending order.
         //!
-        //! \return a vector container holding the indices of all cells that contain this entity
+        //! \return a view to the indices of all cells that contain this entity
         //!
-        inline auto GetIndicesOfAllContainingCells() const -> std::vector<std::size_t>
+        inline auto GetIndicesOfAllContainingCells() const -> ::HPM::iterator::IndexSpan
         {
-            std::set<std::size_t> indices;
-            indices.insert(index);
+            const auto& offsets = mesh.entity_containing_cell_offsets[EntityDimension];
 
-            if constexpr (!IsCell)
-            {
-                for (std::size_t d = EntityDimension; d < CellDimension; ++d)
-                {
-                    const auto& entity_incidence_list = mesh.entity_incidence_list[d];
-                    std::set<std::size_t> tmp;
-
-                    for (std::size_t index : indices)
-                    {
-                        const auto& incident_entities = entity_incidence_list[index];
-
-                        tmp.insert(incident_entities.begin(), incident_entities.end());
-                    }
-
-                    indices.swap(tmp);
-                }
-            }
-
-            return {indices.begin(), indices.end()};
+            return {mesh.entity_containing_cell_list[EntityDimension].data() + offsets[index], offsets[index + 1] - offsets[index]};
         }
 
         //!
@@ -222,23 +200,27 @@ namespace HPM::entity
 
             const std::size_t cell_index = GetIndexOfContainingCell();
         
-#if defined(MESH_VALUE_LOOKUP)
-            const std::size_t face_index = local_index;
-            return mesh.lookup_face_neighboring_cell_mapping[cell_index][face_index];
-#else
-            // Iterate over all incident cells and return the index of the cell that is not the containing cell.
-            for (const auto& incident_cell : GetIncidentEntities())
+            if constexpr (MeshT::template CachesGeometry<::HPM::mesh::GeometryQuantity::FaceNeighbors>())
             {
-                const std::size_t incident_cell_index = incident_cell.GetTopology().GetIndex();
+                const std::size_t face_index = local_index;
 
-                if (incident_cell_index != cell_index)
+                return mesh.lookup_face_neighboring_cell_mapping[cell_index][face_index];
+            }
+            else
+            {
+                // Iterate over all incident cells and return the index of the cell that is not the containing cell.
+                for (const auto& incident_cell : GetIncidentEntities())
                 {
-                    return incident_cell_index;
+                    const std::size_t incident_cell_index = incident_cell.GetTopology().GetIndex();
+
+                    if (incident_cell_index != cell_index)
+                    {
+                        return incident_cell_index;
+                    }
                 }
-            }
 
-            return cell_index;
-#endif
+                return cell_index;
+            }
         }
 
         //!
@@ -266,24 +248,27 @@ namespace HPM::entity
             const std::size_t cell_index = GetIndexOfContainingCell();
             const std::size_t face_index = local_index;
 
-#if defined(MESH_VALUE_LOOKUP)
-            return mesh.lookup_face_neighboring_face_mapping[cell_index][face_index];
-#else
-            const auto& neighboring_cell = GetNeighboringCell();
-
-            if (neighboring_cell.GetTopology().GetIndex() != cell_index)
+            if constexpr (MeshT::template CachesGeometry<::HPM::mesh::GeometryQuantity::FaceNeighbors>())
+            {
+                return mesh.lookup_face_neighboring_face_mapping[cell_index][face_index];
+            }
+            else
             {
-                for (const auto& neighboring_face : neighboring_cell.GetTopology().GetSubEntities())
+                const auto& neighboring_cell = GetNeighboringCell();
+
+                if (neighboring_cell.GetTopology().GetIndex() != cell_index)
                 {
-                    if ((*this) == neighboring_face)
+                    for (const auto& neighboring_face : neighboring_cell.GetTopology().GetSubEntities())
                     {
-                        return neighboring_face.GetTopology().GetLocalIndex();
+                        if ((*this) == neighboring_face)
+                        {
+                            return neighboring_face.GetTopology().GetLocalIndex();
+                        }
                     }
                 }
-            }
 
-            return face_index;
-#endif
+                return face_index;
+            }
         }
 
         //!
@@ -404,18 +389,19 @@ namespace HPM::entity
         //! \brief Get an iterator range over all entities with a specified dimension that are contained in this entity.
         //!
         //! All entities with a lower dimension inherit the index of the containing cell from this entity.
+        //! The indices are held by the range in a fixed-size array: no heap allocation happens.
         //!
         //! \tparam Dimension the dimension of the requested entities
         //! \return an iterator range over the requested entities
         //!
         template <std::size_t Dimension>
-        inline auto GetEntities() const -> IndexedEntityRange<EntityT<Dimension>>
+        inline auto GetEntities() const
         {
             static_assert(Dimension <= EntityDimension, "error: dimension must be lower or equal to the entity dimension");
 
-            const auto& element_indices = GetIndicesOfEntitiesWithDimension<Dimension>();
+            using IndexSetT = std::decay_t<decltype(GetIndicesOfEntitiesWithDimension<Dimension>())>;
 
-            return {mesh, {element_indices.begin(), element_indices.end()}, index_of_containing_cell};
+            return IndexedEntityRange<EntityT<Dimension>, IndexSetT>{mesh, GetIndicesOfEntitiesWithDimension<Dimension>(), index_of_containing_cell};
         }
 
         //!
@@ -531,14 +517,17 @@ namespace HPM::entity
             static_assert(IsFace, "error: this is not a face entity");
             static_assert(ParentEntityIsCell, "error: this entity does not have a cell as a parent");
 
-#if defined(MESH_VALUE_LOOKUP)
-            const std::size_t cell_index = GetIndexOfContainingCell();
-            const std::size_t face_index = local_index;
+            if constexpr (MeshT::template CachesGeometry<::HPM::mesh::GeometryQuantity::FaceNeighbors>())
+            {
+                const std::size_t cell_index = GetIndexOfContainingCell();
+                const std::size_t face_index = local_index;
 
-            return (mesh.lookup_face_neighboring_cell_mapping[cell_index][face_index] != cell_index);
-#else
-            return (GetNumIncidentEntities() > 1);
-#endif
+                return (mesh.lookup_face_neighboring_cell_mapping[cell_index][face_index] != cell_index);
+            }
+            else
+            {
+                return (GetNumIncidentEntities() > 1);
+            }
         }
 
         //!
@@ -610,59 +599,60 @@ namespace HPM::entity
             // Setup data structures in the mesh.
             Topology::SetupTopologyImplementation(mesh);
 
-#if defined(MESH_VALUE_LOOKUP)
-            // Pre-calculate some geometry information.
-            auto& lookup_face_neighboring_cell_mapping = mesh.lookup_face_neighboring_cell_mapping;
-            auto& lookup_face_neighboring_face_mapping = mesh.lookup_face_neighboring_face_mapping;
-            const std::size_t num_cells = mesh.GetNumEntities();
-
-            if (lookup_face_neighboring_cell_mapping.empty())
-            {
-                lookup_face_neighboring_cell_mapping.resize(num_cells);
-            }
-
-            if (lookup_face_neighboring_face_mapping.empty())
+            // Pre-calculate the face neighbor mappings if selected by the mesh's geometry cache policy.
+            if constexpr (MeshT::template CachesGeometry<::HPM::mesh::GeometryQuantity::FaceNeighbors>())
             {
-                lookup_face_neighboring_face_mapping.resize(num_cells);
-            }
+                auto& lookup_face_neighboring_cell_mapping = mesh.lookup_face_neighboring_cell_mapping;
+                auto& lookup_face_neighboring_face_mapping = mesh.lookup_face_neighboring_face_mapping;
+                const std::size_t num_cells = mesh.GetNumEntities();
 
-            for (const auto& cell : mesh.GetEntities())
-            {
-                const std::size_t cell_index = cell.GetTopology().GetIndex();
+                if (lookup_face_neighboring_cell_mapping.empty())
+                {
+                    lookup_face_neighboring_cell_mapping.resize(num_cells);
+                }
 
-                for (const auto& face : cell.GetTopology().GetSubEntities())
+                if (lookup_face_neighboring_face_mapping.empty())
                 {
-                    const std::size_t face_index = face.GetTopology().GetLocalIndex();
+                    lookup_face_neighboring_face_mapping.resize(num_cells);
+                }
 
-                    // Default assignment: the containing cell itself.
-                    lookup_face_neighboring_cell_mapping[cell_index][face_index] = cell_index;
-                    lookup_face_neighboring_face_mapping[cell_index][face_index] = face_index;
+                for (const auto& cell : mesh.GetEntities())
+                {
+                    const std::size_t cell_index = cell.GetTopology().GetIndex();
 
-                    // At most 2 incident cells: the containing cell and optionally a neighboring cell.
-                    for (const auto& incident_cell : face.GetTopology().GetIncidentEntities())
+                    for (const auto& face : cell.GetTopology().GetSubEntities())
                     {
-                        const std::size_t incident_cell_index = incident_cell.GetTopology().GetIndex();
+                        const std::size_t face_index = face.GetTopology().GetLocalIndex();
+
+                        // Default assignment: the containing cell itself.
+                        lookup_face_neighboring_cell_mapping[cell_index][face_index] = cell_index;
+                        lookup_face_neighboring_face_mapping[cell_index][face_index] = face_index;
 
-                        if (incident_cell_index != cell_index)
+                        // At most 2 incident cells: the containing cell and optionally a neighboring cell.
+                        for (const auto& incident_cell : face.GetTopology().GetIncidentEntities())
                         {
-                            lookup_face_neighboring_cell_mapping[cell_index][face_index] = incident_cell_index;
+                            const std::size_t incident_cell_index = incident_cell.GetTopology().GetIndex();
 
-                            for (const auto& neighboring_face : incident_cell.GetTopology().GetSubEntities())
+                            if (incident_cell_index != cell_index)
                             {
-                                if (neighboring_face == face)
+                                lookup_face_neighboring_cell_mapping[cell_index][face_index] = incident_cell_index;
+
+                                for (const auto& neighboring_face : incident_cell.GetTopology().GetSubEntities())
                                 {
-                                    lookup_face_neighboring_face_mapping[cell_index][face_index] = neighboring_face.GetTopology().GetLocalIndex();
+                                    if (neighboring_face == face)
+                                    {
+                                        lookup_face_neighboring_face_mapping[cell_index][face_index] = neighboring_face.GetTopology().GetLocalIndex();
 
-                                    break;
+                                        break;
+                                    }
                                 }
-                            }
 
-                            break;
+                                break;
+                            }
                         }
                     }
                 }
             }
-#endif
         }
 
         protected:
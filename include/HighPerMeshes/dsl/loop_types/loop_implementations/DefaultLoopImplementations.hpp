@@ -72,19 +72,22 @@ namespace HPM::internal
 
             for (std::size_t i = 0; i < i_max; i += ChunkSize)
             {
-                auto&& local_vectors{LocalView::CreateMultiple(access_definitions, it, std::make_index_sequence<ChunkSize>{})};
+                // Local views are set up using entity handles: the entities are created for the loop body only.
+                const auto& handles = it.template GetHandles<ChunkSize>();
+                auto&& local_vectors{LocalView::CreateMultiple(access_definitions, handles, std::make_index_sequence<ChunkSize>{})};
 
                 for (std::size_t ii = 0; ii < ChunkSize; ++ii, ++it)
                 {
-                    loop_body(*it, local_vectors[ii]);
+                    loop_body(handles[ii].Materialize(), local_vectors[ii]);
                 }
             }
 
             for (std::size_t i = i_max; i < entities.GetRangeSize(); ++i, ++it)
             {
-                auto&& localVector{LocalView::Create(access_definitions, *it)};
+                const auto& handle = it.GetHandle();
+                auto&& localVector{LocalView::Create(access_definitions, handle)};
 
-                loop_body(*it, localVector);
+                loop_body(handle.Materialize(), localVector);
             }
         }
     };
@@ -96,14 +99,17 @@ namespace HPM::internal
     //! Dimension_ specifies the dimension of requested entities to iterate over
     //!
     //! \tparam
-    //! SubDimension specifies the dimension of requested sub-entities to iterate over
-    template <std::size_t Dimension_, std::size_t SubDimension>
+    //! SubDimension_ specifies the dimension of requested sub-entities to iterate over
+    template <std::size_t Dimension_, std::size_t SubDimension_>
     struct ForEachIncidence
     {
 
         //! Is used to infer the dimension of entities in operator() by the run time system.
         static constexpr std::size_t Dimension = Dimension_;
 
+        //! The dimension of the sub-entities the loop body is invoked for.
+        static constexpr std::size_t SubDimension = SubDimension_;
+
         //! \brief Iterates over all given `entities` and its sub-entities of a given SubDimension and invokes `loop_body` for each sub-entity.
         //!
         //! For example, given a vector of edges `e` and the SubDimension for nodes, operator()(e, [](auto node) {}) iterates over all child-nodes of each edge in `e` and invokes `loop_body` for each of the nodes.
@@ -146,15 +152,17 @@ namespace HPM::internal
         {
             constexpr std::size_t NumSubEntities = EntityRange::EntityT::Topology::template GetNumEntities<SubDimension>();
 
-            for (auto const& entity : std::forward<EntityRange>(entities))
-            {   
-                const auto sub_entities { entity.GetTopology().template GetEntities<SubDimension>() }; 
-                auto it = sub_entities.begin();
-                auto&& local_vectors{LocalView::CreateMultiple(access_definitions, it, std::make_index_sequence<NumSubEntities>{})};
+            auto it = entities.begin();
+
+            for (std::size_t i = 0; i < entities.GetRangeSize(); ++i, ++it)
+            {
+                // Local views are set up using entity handles: the sub-entities are created for the loop body only.
+                const auto& sub_entities = it.GetHandle().template GetEntities<SubDimension>();
+                auto&& local_vectors{LocalView::CreateMultiple(access_definitions, sub_entities, std::make_index_sequence<NumSubEntities>{})};
 
-                for (std::size_t i = 0; i < NumSubEntities; ++i, ++it)
+                for (std::size_t ii = 0; ii < NumSubEntities; ++ii)
                 {
-                    loop_body(*it, local_vectors[i]);
+                    loop_body(sub_entities[ii].Materialize(), local_vectors[ii]);
                 }
             }
         }
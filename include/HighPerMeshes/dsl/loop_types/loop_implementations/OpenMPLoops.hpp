@@ -13,6 +13,7 @@
 #include <sys/sysinfo.h>
 
 #include <HighPerMeshes/dsl/data_access/LocalView.hpp>
+#include <HighPerMeshes/dsl/dispatchers/Instrumentation.hpp>
 
 //!
 //! \name
@@ -68,6 +69,16 @@ struct OpenMP_ForEachEntity
     //! AccessDefinition.hpp
     template <typename EntityRange, typename AccessDefinitions, typename LoopBody>
     auto operator()(EntityRange entities, AccessDefinitions &access_definitions, LoopBody loop_body) const
+    {
+        operator()(entities, access_definitions, loop_body, NoInstrumentation::Scope{});
+    }
+
+    //! \brief Same as above, but each thread measures its share of the `entities` within the given scope.
+    //!
+    //! \see
+    //! Instrumentation.hpp
+    template <typename EntityRange, typename AccessDefinitions, typename LoopBody, typename ScopeT>
+    auto operator()(EntityRange entities, AccessDefinitions &access_definitions, LoopBody loop_body, const ScopeT &scope) const
     {
         constexpr std::size_t ChunkSize = 4;
         const std::size_t i_max = (entities.GetRangeSize() / ChunkSize) * ChunkSize;
@@ -91,31 +102,34 @@ struct OpenMP_ForEachEntity
 
 #pragma omp parallel
         {
-
+            scope.Measure([&]() {
 #pragma omp for nowait
-            for (std::size_t i = 0; i < i_max; i += ChunkSize)
-            {
-                auto it = entities.begin();
-                it += i;
+                for (std::size_t i = 0; i < i_max; i += ChunkSize)
+                {
+                    auto it = entities.begin();
+                    it += i;
 
-                auto &&local_vectors{LocalView::CreateMultiple(access_definitions, it, std::make_index_sequence<ChunkSize>{})};
+                    const auto &handles = it.template GetHandles<ChunkSize>();
+                    auto &&local_vectors{LocalView::CreateMultiple(access_definitions, handles, std::make_index_sequence<ChunkSize>{})};
 
-                for (std::size_t ii = 0; ii < ChunkSize; ++ii, ++it)
-                {
-                    loop_body(*it, local_vectors[ii]);
+                    for (std::size_t ii = 0; ii < ChunkSize; ++ii)
+                    {
+                        loop_body(handles[ii].Materialize(), local_vectors[ii]);
+                    }
                 }
-            }
 
-#pragma omp for
-            for (std::size_t i = i_max; i < entities.GetRangeSize(); ++i)
-            {
-                auto it = entities.begin();
-                it += i;
+#pragma omp for nowait
+                for (std::size_t i = i_max; i < entities.GetRangeSize(); ++i)
+                {
+                    auto it = entities.begin();
+                    it += i;
 
-                auto &&localVector{LocalView::Create(access_definitions, *it)};
+                    const auto &handle = it.GetHandle();
+                    auto &&localVector{LocalView::Create(access_definitions, handle)};
 
-                loop_body(*it, localVector);
-            }
+                    loop_body(handle.Materialize(), localVector);
+                }
+            });
         }
     }
 };
@@ -127,14 +141,17 @@ struct OpenMP_ForEachEntity
 //! Dimension_ specifies the dimension of requested entities to iterate over
 //!
 //! \tparam
-//! SubDimension specifies the dimension of requested sub-entities to iterate over
-template <std::size_t Dimension_, std::size_t SubDimension>
+//! SubDimension_ specifies the dimension of requested sub-entities to iterate over
+template <std::size_t Dimension_, std::size_t SubDimension_>
 struct OpenMP_ForEachIncidence
 {
 
     //! Is used to infer the dimension of entities in operator() by the run time system.
     static constexpr std::size_t Dimension = Dimension_;
 
+    //! The dimension of the sub-entities the loop body is invoked for.
+    static constexpr std::size_t SubDimension = SubDimension_;
+
     //! \brief Iterates over all given `entities` and its sub-entities of a given SubDimension and invokes `loop_body` for each sub-entity.
     //!
     //! For example, given a vector of edges `e` and the SubDimension for nodes, operator()(e, [](auto node) {}) iterates over all child-nodes of each edge in `e` and invokes `loop_body` for each of the nodes.
@@ -174,6 +191,16 @@ struct OpenMP_ForEachIncidence
     //! AccessDefinition.hpp
     template <typename EntityRange, typename AccessDefinitions, typename LoopBody>
     auto operator()(EntityRange entities, AccessDefinitions &access_definitions, LoopBody loop_body) const
+    {
+        operator()(entities, access_definitions, loop_body, NoInstrumentation::Scope{});
+    }
+
+    //! \brief Same as above, but each thread measures its share of the `entities` within the given scope.
+    //!
+    //! \see
+    //! Instrumentation.hpp
+    template <typename EntityRange, typename AccessDefinitions, typename LoopBody, typename ScopeT>
+    auto operator()(EntityRange entities, AccessDefinitions &access_definitions, LoopBody loop_body, const ScopeT &scope) const
     {
         constexpr std::size_t NumSubEntities = EntityRange::EntityT::Topology::template GetNumEntities<SubDimension>();
         static bool fix_pinning = true;
@@ -194,22 +221,24 @@ struct OpenMP_ForEachIncidence
             fix_pinning = false;
         }
 
-#pragma omp parallel for
-        for (
-            size_t offset = 0;
-            offset < entities.GetRangeSize();
-            ++offset)
+#pragma omp parallel
         {
-            auto entity_iter = entities.begin();
-            entity_iter += offset;
+            scope.Measure([&]() {
+#pragma omp for nowait
+                for (std::size_t offset = 0; offset < entities.GetRangeSize(); ++offset)
+                {
+                    auto entity_iter = entities.begin();
+                    entity_iter += offset;
 
-            auto it = (*entity_iter).GetTopology().template GetEntities<SubDimension>().begin();
-            auto &&local_vectors{LocalView::CreateMultiple(access_definitions, it, std::make_index_sequence<NumSubEntities>{})};
+                    const auto &sub_entities = entity_iter.GetHandle().template GetEntities<SubDimension>();
+                    auto &&local_vectors{LocalView::CreateMultiple(access_definitions, sub_entities, std::make_index_sequence<NumSubEntities>{})};
 
-            for (std::size_t i = 0; i < NumSubEntities; ++i, ++it)
-            {
-                loop_body(*it, local_vectors[i]);
-            }
+                    for (std::size_t i = 0; i < NumSubEntities; ++i)
+                    {
+                        loop_body(sub_entities[i].Materialize(), local_vectors[i]);
+                    }
+                }
+            });
         }
     }
 };
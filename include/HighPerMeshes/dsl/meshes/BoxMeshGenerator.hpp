@@ -0,0 +1,437 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_MESHES_BOXMESHGENERATOR_HPP
+#define DSL_MESHES_BOXMESHGENERATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/common/Vec.hpp>
+#include <HighPerMeshes/dsl/meshes/Partitioner.hpp>
+
+namespace HPM::mesh
+{
+    //!
+    //! \brief Generator for tetrahedral meshes of a box.
+    //!
+    //! The box is divided into `num_cubes[0] x num_cubes[1] x num_cubes[2]` hexahedra, each of which is split into 6 tetrahedra
+    //! that share the diagonal from its lowest to its highest corner (Kuhn / Freudenthal triangulation).
+    //! All hexahedra are split the same way, so the mesh is conforming: neighboring cells share complete faces.
+    //!
+    //! Nodes are numbered x-fastest, cells hexahedron by hexahedron in the same order (6 consecutive cells per hexahedron).
+    //! The node indices of each cell are sorted, and the cells are sorted by their node indices.
+    //! Nodes and cells are created in parallel (OpenMP) and the results do not depend on the number of threads.
+    //!
+    //! Optionally, the node spacing can be graded geometrically per dimension, and interior nodes can be perturbed randomly.
+    //!
+    //! Usage:
+    //! \code{.cpp}
+    //! BoxMeshGenerator generator{{100, 100, 100}};
+    //! generator.SetDomain({0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}).SetPerturbation(0.1, 42);
+    //! const auto mesh = generator.CreateMesh<Mesh<dataType::Vec<double, 3>, entity::Simplex>>();
+    //! const auto partitioned_mesh = generator.CreatePartitionedMesh<PartitionedMesh<dataType::Vec<double, 3>, entity::Simplex>>({1, 4}, 0);
+    //! \endcode
+    //!
+    //! \tparam CoordinateT the coordinate type used for the node representation (three-dimensional)
+    //!
+    template <typename CoordinateT = ::HPM::dataType::Vec<double, 3>>
+    class BoxMeshGenerator
+    {
+        static_assert(CoordinateT::Dimension == 3, "error: box meshes are three-dimensional");
+
+        using ScalarT = typename CoordinateT::ValueT;
+
+        public:
+        static constexpr std::size_t NumCellsPerCube = 6;
+
+        using CellT = std::array<std::size_t, 4>;
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! The default domain is [0, num_cubes[0]] x [0, num_cubes[1]] x [0, num_cubes[2]]: unit spacing.
+        //!
+        //! \param num_cubes the number of hexahedra per dimension
+        //!
+        BoxMeshGenerator(const std::array<std::size_t, 3>& num_cubes) : num_cubes(num_cubes)
+        {
+            for (std::size_t dimension = 0; dimension < 3; ++dimension)
+            {
+                if (num_cubes[dimension] == 0)
+                {
+                    throw std::runtime_error("error: the number of cubes must be larger than zero in each dimension");
+                }
+
+                lower[dimension] = 0;
+                upper[dimension] = num_cubes[dimension];
+                grading[dimension] = 1;
+            }
+        }
+
+        //!
+        //! \brief Set the extent of the box.
+        //!
+        //! \param lower_corner the lower corner of the box
+        //! \param upper_corner the upper corner of the box
+        //! \return a reference to this generator
+        //!
+        auto SetDomain(const CoordinateT& lower_corner, const CoordinateT& upper_corner) -> BoxMeshGenerator&
+        {
+            for (std::size_t dimension = 0; dimension < 3; ++dimension)
+            {
+                if (!(lower_corner[dimension] < upper_corner[dimension]))
+                {
+                    throw std::runtime_error("error: the lower corner of the box must be lower than the upper corner");
+                }
+            }
+
+            lower = lower_corner;
+            upper = upper_corner;
+
+            return *this;
+        }
+
+        //!
+        //! \brief Set a geometric grading of the node spacing.
+        //!
+        //! \param ratio the ratio of the last to the first spacing per dimension (1: uniform spacing)
+        //! \return a reference to this generator
+        //!
+        auto SetGrading(const CoordinateT& ratio) -> BoxMeshGenerator&
+        {
+            for (std::size_t dimension = 0; dimension < 3; ++dimension)
+            {
+                if (!(ratio[dimension] > 0))
+                {
+                    throw std::runtime_error("error: the grading ratio must be positive");
+                }
+            }
+
+            grading = ratio;
+
+            return *this;
+        }
+
+        //!
+        //! \brief Perturb the interior nodes randomly.
+        //!
+        //! Each coordinate of a node is shifted by up to `amplitude` times the smaller adjacent spacing in that dimension.
+        //! Coordinates on the boundary of the box are not shifted, so the box keeps its shape.
+        //! Small amplitudes (about 0.2 and below) keep all cells valid: this is not checked.
+        //!
+        //! \param amplitude the relative amplitude of the perturbation in [0, 0.5)
+        //! \param seed the seed of the random numbers: the same seed gives the same nodes
+        //! \return a reference to this generator
+        //!
+        auto SetPerturbation(const double amplitude, const std::uint64_t seed = 0) -> BoxMeshGenerator&
+        {
+            if (amplitude < 0.0 || amplitude >= 0.5)
+            {
+                throw std::runtime_error("error: the perturbation amplitude must be in [0, 0.5)");
+            }
+
+            perturbation = amplitude;
+            perturbation_seed = seed;
+
+            return *this;
+        }
+
+        //!
+        //! \brief Get the number of hexahedra per dimension.
+        //!
+        auto GetNumCubes() const -> const std::array<std::size_t, 3>& { return num_cubes; }
+
+        //!
+        //! \brief Get the number of nodes.
+        //!
+        auto GetNumNodes() const -> std::size_t { return (num_cubes[0] + 1) * (num_cubes[1] + 1) * (num_cubes[2] + 1); }
+
+        //!
+        //! \brief Get the number of cells.
+        //!
+        auto GetNumCells() const -> std::size_t { return NumCellsPerCube * num_cubes[0] * num_cubes[1] * num_cubes[2]; }
+
+        //!
+        //! \brief Create the nodes of the mesh (in parallel).
+        //!
+        //! \return the node coordinates
+        //!
+        auto CreateNodes() const -> std::vector<CoordinateT>
+        {
+            const std::array<std::vector<ScalarT>, 3> coordinates{GetCoordinates(0), GetCoordinates(1), GetCoordinates(2)};
+            const std::int64_t num_nodes_x = num_cubes[0] + 1;
+            const std::int64_t num_nodes_y = num_cubes[1] + 1;
+            const std::int64_t num_nodes_z = num_cubes[2] + 1;
+            std::vector<CoordinateT> nodes(GetNumNodes());
+
+#pragma omp parallel for collapse(2) schedule(static)
+            for (std::int64_t z = 0; z < num_nodes_z; ++z)
+            {
+                for (std::int64_t y = 0; y < num_nodes_y; ++y)
+                {
+                    std::size_t node_index = (z * num_nodes_y + y) * num_nodes_x;
+
+                    for (std::int64_t x = 0; x < num_nodes_x; ++x, ++node_index)
+                    {
+                        CoordinateT& node = nodes[node_index];
+
+                        node[0] = coordinates[0][x];
+                        node[1] = coordinates[1][y];
+                        node[2] = coordinates[2][z];
+
+                        if (perturbation > 0.0)
+                        {
+                            const std::array<std::int64_t, 3> node_position{x, y, z};
+
+                            for (std::size_t dimension = 0; dimension < 3; ++dimension)
+                            {
+                                const std::int64_t i = node_position[dimension];
+
+                                // Only interior coordinates are shifted.
+                                if (i > 0 && i < static_cast<std::int64_t>(num_cubes[dimension]))
+                                {
+                                    const ScalarT spacing = std::min(coordinates[dimension][i] - coordinates[dimension][i - 1], coordinates[dimension][i + 1] - coordinates[dimension][i]);
+
+                                    node[dimension] += perturbation * spacing * (2.0 * GetRandomNumber(node_index, dimension) - 1.0);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            return nodes;
+        }
+
+        //!
+        //! \brief Create the cells of the mesh (in parallel).
+        //!
+        //! \return the node indices of the cells: sorted per cell, and the cells sorted by their node indices
+        //!
+        auto CreateCells() const -> std::vector<CellT>
+        {
+            const std::size_t num_nodes_x = num_cubes[0] + 1;
+            const std::size_t num_nodes_y = num_cubes[1] + 1;
+            const std::int64_t num_cube_rows = num_cubes[1] * num_cubes[2];
+            const std::array<std::size_t, 3> offset{1, num_nodes_x, num_nodes_x * num_nodes_y};
+            std::vector<CellT> cells(GetNumCells());
+
+            // Each tetrahedron is a path from the lowest to the highest corner along the 3 axes in some order.
+            // The node indices increase along the path, and the permutations are ordered such that the cells of a hexahedron are sorted.
+            constexpr std::array<std::array<std::size_t, 3>, NumCellsPerCube> Permutations{{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+            std::array<CellT, NumCellsPerCube> local_cells;
+
+            for (std::size_t i = 0; i < NumCellsPerCube; ++i)
+            {
+                local_cells[i][0] = 0;
+
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    local_cells[i][j + 1] = local_cells[i][j] + offset[Permutations[i][j]];
+                }
+            }
+
+            std::sort(local_cells.begin(), local_cells.end());
+
+#pragma omp parallel for schedule(static)
+            for (std::int64_t row = 0; row < num_cube_rows; ++row)
+            {
+                const std::size_t y = row % num_cubes[1];
+                const std::size_t z = row / num_cubes[1];
+                std::size_t cell_index = NumCellsPerCube * row * num_cubes[0];
+
+                for (std::size_t x = 0; x < num_cubes[0]; ++x)
+                {
+                    const std::size_t origin = (z * num_nodes_y + y) * num_nodes_x + x;
+
+                    for (const auto& local_cell : local_cells)
+                    {
+                        cells[cell_index++] = {origin + local_cell[0], origin + local_cell[1], origin + local_cell[2], origin + local_cell[3]};
+                    }
+                }
+            }
+
+            return cells;
+        }
+
+        //!
+        //! \brief Create a mesh: the nodes and cells are moved into the mesh.
+        //!
+        //! \tparam MeshT the mesh type
+        //! \return the mesh
+        //!
+        template <typename MeshT>
+        auto CreateMesh() const -> MeshT
+        {
+            return MeshT{CreateNodes(), CreateCells()};
+        }
+
+        //!
+        //! \brief A partitioner that divides the box into slabs along the z-axis.
+        //!
+        //! The nodes and cells of a box mesh are already ordered by their slab: the partitioning needs no reordering and no graph partitioner.
+        //! It can be used as the partitioner of a `PartitionedMesh` for nodes and cells created by the same generator.
+        //!
+        class SlabPartitioner
+        {
+            public:
+            SlabPartitioner(const std::array<std::size_t, 3>& num_cubes) : num_cubes(num_cubes) {}
+
+            //!
+            //! \brief Create the level-1 (L1) and level-2 (L2) partitioning: the interface of `Partitioner::CreatePartitions`.
+            //!
+            //! L2 partition `p` consists of the hexahedra in the slab `[p * n_z / P, (p + 1) * n_z / P)` where `P` is the total number of L2 partitions.
+            //! Each node belongs to the L2 partition of the slab above it (the top layer of nodes to the last partition).
+            //! The L2 partitions of a partition of any coarser level of the hierarchy are adjacent slabs.
+            //!
+            //! \tparam NumCommonNodes unused
+            //! \param nodes the nodes created by the generator
+            //! \param cells the cells created by the generator
+            //! \param num_partitions the number of partitions on each level, e.g., the number of L1 and L2 partitions
+            //! \return the same tuple as `Partitioner::CreatePartitions`
+            //!
+            template <std::size_t NumCommonNodes, typename NodeT>
+            auto CreatePartitions(std::vector<NodeT>&& nodes, std::vector<CellT>&& cells, const PartitionHierarchy& num_partitions) const
+            {
+                const std::size_t num_L2_partitions = num_partitions.GetTotalNumPartitions(num_partitions.GetNumLevels() - 1);
+                const std::size_t num_nodes_per_layer = (num_cubes[0] + 1) * (num_cubes[1] + 1);
+                const std::size_t num_cells_per_layer = NumCellsPerCube * num_cubes[0] * num_cubes[1];
+
+                if (nodes.size() != num_nodes_per_layer * (num_cubes[2] + 1) || cells.size() != num_cells_per_layer * num_cubes[2])
+                {
+                    throw std::runtime_error("error: the nodes and cells were not created by the box mesh generator");
+                }
+
+                if (num_L2_partitions == 0 || num_L2_partitions > num_cubes[2])
+                {
+                    throw std::runtime_error("error: the number of partitions must be in [1, number of cubes in z-direction]");
+                }
+
+                std::vector<std::size_t> L2P_to_cell_offset(num_L2_partitions + 1);
+                std::vector<std::size_t> L2P_to_node_offset(num_L2_partitions + 1);
+
+                for (std::size_t i_L2 = 0; i_L2 <= num_L2_partitions; ++i_L2)
+                {
+                    const std::size_t layer = (i_L2 * num_cubes[2]) / num_L2_partitions;
+
+                    L2P_to_cell_offset[i_L2] = layer * num_cells_per_layer;
+                    L2P_to_node_offset[i_L2] = layer * num_nodes_per_layer;
+                }
+
+                // The top layer of nodes.
+                L2P_to_node_offset[num_L2_partitions] = nodes.size();
+
+                std::vector<std::size_t> cell_to_L2P(cells.size());
+                std::vector<std::size_t> node_to_L2P(nodes.size());
+
+#pragma omp parallel for schedule(static)
+                for (std::int64_t i_L2 = 0; i_L2 < static_cast<std::int64_t>(num_L2_partitions); ++i_L2)
+                {
+                    std::fill(cell_to_L2P.begin() + L2P_to_cell_offset[i_L2], cell_to_L2P.begin() + L2P_to_cell_offset[i_L2 + 1], i_L2);
+                    std::fill(node_to_L2P.begin() + L2P_to_node_offset[i_L2], node_to_L2P.begin() + L2P_to_node_offset[i_L2 + 1], i_L2);
+                }
+
+                return std::make_tuple(std::move(nodes), std::move(cells), std::move(cell_to_L2P), std::move(node_to_L2P), std::move(L2P_to_cell_offset), std::move(L2P_to_node_offset));
+            }
+
+            private:
+            const std::array<std::size_t, 3> num_cubes;
+        };
+
+        //!
+        //! \brief Get a partitioner for the nodes and cells of this generator.
+        //!
+        //! \return a slab partitioner
+        //!
+        auto GetPartitioner() const -> SlabPartitioner { return {num_cubes}; }
+
+        //!
+        //! \brief Create a partitioned mesh: the nodes and cells are moved into the mesh.
+        //!
+        //! \tparam PartitionedMeshT the partitioned mesh type
+        //! \tparam PartitionerT the partitioner type
+        //! \param num_partitions the number of partitions on each level, e.g., the number of level-1 (L1) and level-2 (L2) partitions
+        //! \param my_L1_partition the L1 partition of this process
+        //! \param partitioner the partitioner (default: the pre-partitioned slab layout, see `SlabPartitioner`)
+        //! \return the partitioned mesh
+        //!
+        template <typename PartitionedMeshT, typename PartitionerT>
+        auto CreatePartitionedMesh(const PartitionHierarchy& num_partitions, const std::size_t my_L1_partition, PartitionerT partitioner) const -> PartitionedMeshT
+        {
+            return PartitionedMeshT{CreateNodes(), CreateCells(), num_partitions, my_L1_partition, partitioner};
+        }
+
+        //!
+        //! \brief Create a partitioned mesh with the pre-partitioned slab layout (see `SlabPartitioner`).
+        //!
+        template <typename PartitionedMeshT>
+        auto CreatePartitionedMesh(const PartitionHierarchy& num_partitions, const std::size_t my_L1_partition) const -> PartitionedMeshT
+        {
+            return CreatePartitionedMesh<PartitionedMeshT>(num_partitions, my_L1_partition, GetPartitioner());
+        }
+
+        private:
+        //!
+        //! \brief Get the node coordinates along one dimension.
+        //!
+        //! \param dimension the dimension
+        //! \return `num_cubes[dimension] + 1` coordinates from the lower to the upper corner of the box
+        //!
+        auto GetCoordinates(const std::size_t dimension) const -> std::vector<ScalarT>
+        {
+            const std::size_t n = num_cubes[dimension];
+            const ScalarT length = upper[dimension] - lower[dimension];
+            std::vector<ScalarT> coordinates(n + 1);
+
+            // Spacings h_i = h_0 * q^i with h_{n-1} / h_0 = ratio.
+            const double q = (n > 1 ? std::pow(static_cast<double>(grading[dimension]), 1.0 / (n - 1)) : 1.0);
+
+            for (std::size_t i = 0; i <= n; ++i)
+            {
+                const double t = (std::abs(q - 1.0) < 1.0E-12 ? static_cast<double>(i) / n : (std::pow(q, static_cast<double>(i)) - 1.0) / (std::pow(q, static_cast<double>(n)) - 1.0));
+
+                coordinates[i] = lower[dimension] + length * t;
+            }
+
+            coordinates[n] = upper[dimension];
+
+            return coordinates;
+        }
+
+        //!
+        //! \brief Get a random number for a node coordinate (SplitMix64 hash of the seed, the node index and the dimension).
+        //!
+        //! \param node_index the index of the node
+        //! \param dimension the dimension
+        //! \return a random number in [0, 1)
+        //!
+        auto GetRandomNumber(const std::size_t node_index, const std::size_t dimension) const -> double
+        {
+            std::uint64_t x = perturbation_seed + 0x9E3779B97F4A7C15ULL * (3 * node_index + dimension + 1);
+
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            x = x ^ (x >> 31);
+
+            return (x >> 11) * (1.0 / (1ULL << 53));
+        }
+
+        const std::array<std::size_t, 3> num_cubes;
+        CoordinateT lower;
+        CoordinateT upper;
+        CoordinateT grading;
+        double perturbation = 0.0;
+        std::uint64_t perturbation_seed = 0;
+    };
+} // namespace HPM::mesh
+
+#endif
@@ -0,0 +1,413 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_MESHES_GEOMETRICPARTITIONER_HPP
+#define DSL_MESHES_GEOMETRICPARTITIONER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/dsl/meshes/Partitioner.hpp>
+
+namespace HPM::mesh
+{
+    namespace internal
+    {
+        //!
+        //! \brief Get the centroids of a set of elements (in parallel).
+        //!
+        //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
+        //! \tparam NumNodesPerElement the number of nodes per element
+        //! \param nodes the coordinates of all nodes
+        //! \param elements a set of elements
+        //! \return the centroid of each element
+        //!
+        template <typename CoordinateT, std::size_t NumNodesPerElement>
+        auto GetCentroids(const std::vector<CoordinateT>& nodes, const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements)
+        {
+            constexpr std::size_t Dimension = CoordinateT::Dimension;
+            const std::size_t num_elements = elements.size();
+            std::vector<std::array<double, Dimension>> centroids(num_elements);
+
+#pragma omp parallel for schedule(static)
+            for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
+            {
+                std::array<double, Dimension> centroid{};
+
+                for (std::size_t node_index = 0; node_index < NumNodesPerElement; ++node_index)
+                {
+                    for (std::size_t dimension = 0; dimension < Dimension; ++dimension)
+                    {
+                        centroid[dimension] += nodes[elements[element_index][node_index]][dimension];
+                    }
+                }
+
+                for (std::size_t dimension = 0; dimension < Dimension; ++dimension)
+                {
+                    centroid[dimension] /= NumNodesPerElement;
+                }
+
+                centroids[element_index] = centroid;
+            }
+
+            return centroids;
+        }
+
+        //!
+        //! \brief Get the bounding box of a set of points.
+        //!
+        //! \param points the points
+        //! \param begin the first index (into `points`) to be considered
+        //! \param end the index (into `points`) after the last one to be considered
+        //! \return the lower and upper corner of the bounding box
+        //!
+        template <std::size_t Dimension, typename IteratorT>
+        auto GetBoundingBox(const std::vector<std::array<double, Dimension>>& points, IteratorT begin, IteratorT end)
+        {
+            std::array<double, Dimension> lower, upper;
+
+            lower.fill(std::numeric_limits<double>::max());
+            upper.fill(std::numeric_limits<double>::lowest());
+
+            for (auto it = begin; it != end; ++it)
+            {
+                for (std::size_t dimension = 0; dimension < Dimension; ++dimension)
+                {
+                    lower[dimension] = std::min(lower[dimension], points[*it][dimension]);
+                    upper[dimension] = std::max(upper[dimension], points[*it][dimension]);
+                }
+            }
+
+            return std::make_pair(lower, upper);
+        }
+
+        //!
+        //! \brief Assign each node to the partition of one of its elements (the one with the smallest partition index).
+        //!
+        //! Nodes that do not belong to any of the elements are assigned to partition 0.
+        //!
+        template <std::size_t NumNodesPerElement>
+        auto GetNodeToPartition(const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::vector<std::size_t>& element_to_partition, const std::size_t num_nodes)
+        {
+            constexpr std::size_t Unassigned = std::numeric_limits<std::size_t>::max();
+            std::vector<std::size_t> node_to_partition(num_nodes, Unassigned);
+
+            for (std::size_t element_index = 0; element_index < elements.size(); ++element_index)
+            {
+                for (const std::size_t node_index : elements[element_index])
+                {
+                    node_to_partition[node_index] = std::min(node_to_partition[node_index], element_to_partition[element_index]);
+                }
+            }
+
+            std::replace(node_to_partition.begin(), node_to_partition.end(), Unassigned, std::size_t{0});
+
+            return node_to_partition;
+        }
+    } // namespace internal
+
+    //!
+    //! \brief A partitioner type using recursive coordinate bisection (RCB).
+    //!
+    //! The element centroids are split recursively at the median of the longest extent of their bounding box.
+    //! For a non-power-of-2 number of partitions, the split is proportional to the number of partitions on either side.
+    //! With element weights, the split balances the sum of the weights instead of the number of elements.
+    //! With fewer elements than partitions, some partitions are empty.
+    //! Recursive bisections are independent and executed as OpenMP tasks.
+    //!
+    //! This partitioner works without METIS: it is selected by passing it to the `PartitionedMesh` constructor or `PartitionedMesh::CreateFromFile`.
+    //!
+    class RcbPartitioner : public Partitioner<RcbPartitioner>
+    {
+        friend class Partitioner<RcbPartitioner>;
+
+        // Ranges smaller than this are bisected by the calling task.
+        static constexpr std::size_t MinTaskSize = 4096;
+
+        //!
+        //! \brief Create a partitioning of the elements.
+        //!
+        //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common (not used)
+        //! \tparam NumNodesPerElement the number of nodes per element
+        //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
+        //! \param nodes the coordinates of all nodes
+        //! \param elements a set of elements to be partitioned
+        //! \param num_partitions the number of partitions to be created
+        //! \param element_weights the weight of each element, or none
+        //! \return a tuple consisting of vector containers holding the mapping of elements to partitions and nodes to partitions
+        //!
+        template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement, typename CoordinateT>
+        auto CreatePartitionImplementation(const std::vector<CoordinateT>& nodes, const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::size_t num_partitions,
+                                           const std::vector<double>& element_weights) const
+        {
+            const auto& centroids = internal::GetCentroids(nodes, elements);
+            std::vector<std::size_t> element_indices(elements.size());
+            std::vector<std::size_t> element_to_partition(elements.size(), 0);
+
+            std::iota(element_indices.begin(), element_indices.end(), 0);
+
+#pragma omp parallel
+#pragma omp single
+            Bisect(centroids, element_weights, element_indices.begin(), element_indices.end(), 0, std::max(num_partitions, std::size_t{1}), element_to_partition);
+
+            auto&& node_to_partition = internal::GetNodeToPartition(elements, element_to_partition, nodes.size());
+
+            return std::make_tuple(std::move(element_to_partition), std::move(node_to_partition));
+        }
+
+        //!
+        //! \brief Assign the elements in [begin, end) to the partitions [first_partition, first_partition + num_partitions).
+        //!
+        template <std::size_t Dimension, typename IteratorT>
+        static auto Bisect(const std::vector<std::array<double, Dimension>>& centroids, const std::vector<double>& element_weights, IteratorT begin, IteratorT end, const std::size_t first_partition,
+                           const std::size_t num_partitions, std::vector<std::size_t>& element_to_partition) -> void
+        {
+            if (num_partitions == 1)
+            {
+                for (auto it = begin; it != end; ++it)
+                {
+                    element_to_partition[*it] = first_partition;
+                }
+
+                return;
+            }
+
+            // Split along the longest extent of the bounding box.
+            const auto& bounding_box = internal::GetBoundingBox(centroids, begin, end);
+            const auto& lower = bounding_box.first;
+            const auto& upper = bounding_box.second;
+            std::size_t axis = 0;
+
+            for (std::size_t dimension = 1; dimension < Dimension; ++dimension)
+            {
+                if ((upper[dimension] - lower[dimension]) > (upper[axis] - lower[axis]))
+                {
+                    axis = dimension;
+                }
+            }
+
+            const std::size_t num_left_partitions = num_partitions / 2;
+            const std::size_t num_elements = end - begin;
+            const auto compare = [&centroids, axis](const std::size_t lhs, const std::size_t rhs) { return centroids[lhs][axis] < centroids[rhs][axis]; };
+            IteratorT middle = begin + (num_elements * num_left_partitions) / num_partitions;
+
+            if (element_weights.empty())
+            {
+                std::nth_element(begin, middle, end, compare);
+            }
+            else
+            {
+                // Weighted median: the first element at which the sum of the weights exceeds the share of the left partitions.
+                std::sort(begin, end, compare);
+
+                double total_weight = 0.0;
+
+                for (auto it = begin; it != end; ++it)
+                {
+                    total_weight += element_weights[*it];
+                }
+
+                if (total_weight > 0.0)
+                {
+                    const double left_weight = total_weight * num_left_partitions / num_partitions;
+                    double weight = 0.0;
+
+                    for (middle = begin; middle != end && (weight + 0.5 * element_weights[*middle]) < left_weight; ++middle)
+                    {
+                        weight += element_weights[*middle];
+                    }
+
+                    // Each partition gets at least one element (if possible).
+                    // With fewer elements than partitions, the bounds would be swapped: they are reordered, and some partitions stay empty.
+                    const std::size_t min_left_elements = std::min(num_left_partitions, num_elements);
+                    const std::size_t max_left_elements = num_elements - std::min(num_partitions - num_left_partitions, num_elements);
+                    const std::size_t num_left_elements = std::clamp(static_cast<std::size_t>(middle - begin), std::min(min_left_elements, max_left_elements), std::max(min_left_elements, max_left_elements));
+
+                    middle = begin + num_left_elements;
+                }
+            }
+
+#pragma omp task default(shared) if ((middle - begin) >= static_cast<std::ptrdiff_t>(MinTaskSize))
+            Bisect(centroids, element_weights, begin, middle, first_partition, num_left_partitions, element_to_partition);
+
+            Bisect(centroids, element_weights, middle, end, first_partition + num_left_partitions, num_partitions - num_left_partitions, element_to_partition);
+
+#pragma omp taskwait
+        }
+    };
+
+    //!
+    //! \brief A partitioner type using a space-filling (Hilbert) curve.
+    //!
+    //! The element centroids are mapped onto a Hilbert curve through their bounding box,
+    //! and the elements are split into contiguous chunks of equal size (or equal sum of the element weights) along the curve.
+    //! The Hilbert indices are computed in parallel.
+    //!
+    //! This partitioner works without METIS: it is selected by passing it to the `PartitionedMesh` constructor or `PartitionedMesh::CreateFromFile`.
+    //!
+    class HilbertPartitioner : public Partitioner<HilbertPartitioner>
+    {
+        friend class Partitioner<HilbertPartitioner>;
+
+        //!
+        //! \brief Create a partitioning of the elements.
+        //!
+        //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common (not used)
+        //! \tparam NumNodesPerElement the number of nodes per element
+        //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
+        //! \param nodes the coordinates of all nodes
+        //! \param elements a set of elements to be partitioned
+        //! \param num_partitions the number of partitions to be created
+        //! \param element_weights the weight of each element, or none
+        //! \return a tuple consisting of vector containers holding the mapping of elements to partitions and nodes to partitions
+        //!
+        template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement, typename CoordinateT>
+        auto CreatePartitionImplementation(const std::vector<CoordinateT>& nodes, const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::size_t num_partitions,
+                                           const std::vector<double>& element_weights) const
+        {
+            constexpr std::size_t Dimension = CoordinateT::Dimension;
+            constexpr std::size_t NumBits = std::min(std::size_t{21}, 64 / Dimension);
+
+            static_assert(Dimension > 0, "error: the coordinate dimension must be larger than 0");
+
+            const std::size_t num_elements = elements.size();
+            const auto& centroids = internal::GetCentroids(nodes, elements);
+            std::vector<std::size_t> element_indices(num_elements);
+
+            std::iota(element_indices.begin(), element_indices.end(), 0);
+
+            const auto& bounding_box = internal::GetBoundingBox(centroids, element_indices.begin(), element_indices.end());
+            const auto& lower = bounding_box.first;
+            const auto& upper = bounding_box.second;
+            std::vector<std::pair<std::uint64_t, std::size_t>> keys(num_elements);
+
+#pragma omp parallel for schedule(static)
+            for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
+            {
+                std::array<std::uint64_t, Dimension> position;
+
+                for (std::size_t dimension = 0; dimension < Dimension; ++dimension)
+                {
+                    const double extent = upper[dimension] - lower[dimension];
+                    const double scaled = (extent > 0.0 ? (centroids[element_index][dimension] - lower[dimension]) / extent : 0.0);
+
+                    position[dimension] = std::min(static_cast<std::uint64_t>(scaled * (1UL << NumBits)), (1UL << NumBits) - 1);
+                }
+
+                keys[element_index] = {GetHilbertIndex<NumBits>(position), element_index};
+            }
+
+            std::sort(keys.begin(), keys.end());
+
+            std::vector<std::size_t> element_to_partition(num_elements);
+            const std::size_t num_chunks = std::max(num_partitions, std::size_t{1});
+            const double total_weight = std::accumulate(element_weights.begin(), element_weights.end(), 0.0);
+
+            if (total_weight > 0.0)
+            {
+                // Each element goes to the chunk that contains the midpoint of its weight interval along the curve.
+                double weight = 0.0;
+
+                for (std::size_t i = 0; i < num_elements; ++i)
+                {
+                    const double element_weight = element_weights[keys[i].second];
+
+                    element_to_partition[keys[i].second] = std::min(static_cast<std::size_t>((weight + 0.5 * element_weight) * num_chunks / total_weight), num_chunks - 1);
+                    weight += element_weight;
+                }
+            }
+            else
+            {
+#pragma omp parallel for schedule(static)
+                for (std::size_t i = 0; i < num_elements; ++i)
+                {
+                    element_to_partition[keys[i].second] = (i * num_chunks) / num_elements;
+                }
+            }
+
+            auto&& node_to_partition = internal::GetNodeToPartition(elements, element_to_partition, nodes.size());
+
+            return std::make_tuple(std::move(element_to_partition), std::move(node_to_partition));
+        }
+
+        //!
+        //! \brief Get the index of a point along the Hilbert curve.
+        //!
+        //! This is Skilling's algorithm ("Programming the Hilbert curve", AIP Conf. Proc. 707, 2004):
+        //! the coordinates are transformed into the transposed Hilbert index, whose bits are interleaved afterwards.
+        //!
+        //! \tparam NumBits the number of bits per coordinate
+        //! \param position the integer coordinates of the point, each in [0, 2^NumBits)
+        //! \return the Hilbert index
+        //!
+        template <std::size_t NumBits, std::size_t Dimension>
+        static auto GetHilbertIndex(std::array<std::uint64_t, Dimension> position) -> std::uint64_t
+        {
+            // Inverse undo.
+            for (std::uint64_t q = (1UL << (NumBits - 1)); q > 1; q >>= 1)
+            {
+                const std::uint64_t p = q - 1;
+
+                for (std::size_t i = 0; i < Dimension; ++i)
+                {
+                    if (position[i] & q)
+                    {
+                        position[0] ^= p;
+                    }
+                    else
+                    {
+                        const std::uint64_t t = (position[0] ^ position[i]) & p;
+
+                        position[0] ^= t;
+                        position[i] ^= t;
+                    }
+                }
+            }
+
+            // Gray encode.
+            for (std::size_t i = 1; i < Dimension; ++i)
+            {
+                position[i] ^= position[i - 1];
+            }
+
+            std::uint64_t t = 0;
+
+            for (std::uint64_t q = (1UL << (NumBits - 1)); q > 1; q >>= 1)
+            {
+                if (position[Dimension - 1] & q)
+                {
+                    t ^= q - 1;
+                }
+            }
+
+            for (std::size_t i = 0; i < Dimension; ++i)
+            {
+                position[i] ^= t;
+            }
+
+            // Interleave the bits of the transposed index: most significant bits first.
+            std::uint64_t index = 0;
+
+            for (std::size_t bit = NumBits; bit-- > 0;)
+            {
+                for (std::size_t i = 0; i < Dimension; ++i)
+                {
+                    index = (index << 1) | ((position[i] >> bit) & 1);
+                }
+            }
+
+            return index;
+        }
+    };
+} // namespace HPM::mesh
+
+#endif
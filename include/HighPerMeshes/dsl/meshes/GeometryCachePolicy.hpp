@@ -0,0 +1,135 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_MESHES_GEOMETRYCACHEPOLICY_HPP
+#define DSL_MESHES_GEOMETRYCACHEPOLICY_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+#include <HighPerMeshes/common/Matrix.hpp>
+#include <HighPerMeshes/common/Vec.hpp>
+
+namespace HPM::mesh
+{
+    //!
+    //! \brief Quantities the mesh can precompute during its setup.
+    //!
+    //! Values can be combined using the `|` operator.
+    //!
+    enum class GeometryQuantity : unsigned
+    {
+        None = 0x00,
+        AbsJacobianDeterminant = 0x01, // per cell
+        InverseJacobian = 0x02,        // per cell
+        Normal = 0x04,                 // per face of a cell
+        UnitNormal = 0x08,             // per face of a cell
+        NormalLength = 0x10,           // per face of a cell
+        FaceNeighbors = 0x20,          // per face of a cell: neighboring cell and its local face index
+        All = 0x3F
+    };
+
+    //!
+    //! \brief Combine geometry quantities.
+    //!
+    //! \param a a (combination of) geometry quantities
+    //! \param b another (combination of) geometry quantities
+    //! \return the union of both
+    //!
+    constexpr auto operator|(const GeometryQuantity a, const GeometryQuantity b) -> GeometryQuantity { return static_cast<GeometryQuantity>(static_cast<unsigned>(a) | static_cast<unsigned>(b)); }
+
+    //!
+    //! \brief Geometry cache policy of the mesh.
+    //!
+    //! The policy selects which quantities the mesh precomputes during its setup, and the scalar type used to store them.
+    //! All other quantities are computed on the fly from the node coordinates whenever they are requested.
+    //! Precomputed values are converted to the mesh's scalar type when they are read, so the choice of the policy does not change the interface of the entities.
+    //!
+    //! Storing everything is the fastest option for compute-bound kernels.
+    //! Storing in `float` halves the cache footprint, and storing nothing minimizes it for memory-bound kernels.
+    //!
+    //! \tparam Quantities_ the quantities to be precomputed
+    //! \tparam ValueT_ the scalar type used for the storage (`void` means the scalar type of the mesh)
+    //!
+    template <GeometryQuantity Quantities_, typename ValueT_ = void>
+    struct GeometryCachePolicy
+    {
+        static_assert(std::is_void_v<ValueT_> || std::is_floating_point_v<ValueT_>, "error: the storage type must be a floating point type");
+
+        // Template arguments.
+        static constexpr GeometryQuantity Quantities = Quantities_;
+        using ValueT = ValueT_;
+
+        // Deduced types and constants.
+        template <typename ScalarT>
+        using StorageT = std::conditional_t<std::is_void_v<ValueT>, ScalarT, ValueT>;
+
+        //!
+        //! \brief Check whether a quantity is selected by this policy.
+        //!
+        //! \tparam Quantity the geometry quantity
+        //! \return `true` if the quantity is selected, otherwise `false`
+        //!
+        template <GeometryQuantity Quantity>
+        static constexpr auto Caches() -> bool
+        {
+            return (static_cast<unsigned>(Quantities) & static_cast<unsigned>(Quantity)) == static_cast<unsigned>(Quantity);
+        }
+    };
+
+    // Predefined policies.
+    using CacheAllGeometry = GeometryCachePolicy<GeometryQuantity::All>;
+    using CacheAllGeometryAsFloat = GeometryCachePolicy<GeometryQuantity::All, float>;
+    using ComputeGeometryOnTheFly = GeometryCachePolicy<GeometryQuantity::None>;
+
+    namespace internal
+    {
+        //!
+        //! \brief Convert a cached value to the requested type.
+        //!
+        //! If the types match, the value is returned unchanged.
+        //! Otherwise, scalars, vectors and matrices are converted element-wise.
+        //!
+        //! \tparam T the requested type
+        //! \tparam CachedT the type of the cached value
+        //! \param value the cached value
+        //! \return the value converted to type `T`
+        //!
+        template <typename T, typename CachedT>
+        inline auto ConvertCachedValue(const CachedT& value) -> T
+        {
+            if constexpr (std::is_same_v<T, CachedT> || std::is_arithmetic_v<CachedT>)
+            {
+                return static_cast<T>(value);
+            }
+            else
+            {
+                T result;
+
+                if constexpr (::HPM::dataType::internal::ProvidesMetaData<CachedT>::value)
+                {
+                    for (std::size_t i = 0; i < CachedT::Dimension; ++i)
+                    {
+                        result[i] = value[i];
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < CachedT::M; ++i)
+                    {
+                        for (std::size_t j = 0; j < CachedT::N; ++j)
+                        {
+                            result[i][j] = value[i][j];
+                        }
+                    }
+                }
+
+                return result;
+            }
+        }
+    } // namespace internal
+} // namespace HPM::mesh
+
+#endif
@@ -6,19 +6,21 @@
 #ifndef DSL_MESHES_MESH_HPP
 #define DSL_MESHES_MESH_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <set>
+#include <stdexcept>
 #include <tuple>
 #include <utility>
 #include <vector>
 
-#define MESH_VALUE_LOOKUP
-
 #include <HighPerMeshes/common/IndexSequence.hpp>
 #include <HighPerMeshes/common/Iterator.hpp>
+#include <HighPerMeshes/dsl/entities/EntityHandle.hpp>
 #include <HighPerMeshes/dsl/entities/Geometry.hpp>
 #include <HighPerMeshes/dsl/entities/Topology.hpp>
+#include <HighPerMeshes/dsl/meshes/GeometryCachePolicy.hpp>
 #include <HighPerMeshes/dsl/meshes/Range.hpp>
 
 namespace HPM::mesh
@@ -39,8 +41,10 @@ namespace HPM::mesh
     //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
     //! \tparam EntityTypeName the class type of the mesh entities
     //! \tparam CellDimension the dimensionality of the mesh entity type 'cell' (can be lower than the coordinate dimension)
+    //! \tparam GeometryCachePolicy_ the selection of geometry quantities (and their storage type) that are precomputed during the mesh setup
     //!
-    template <typename CoordinateT, template <typename, typename, std::size_t, typename> typename EntityTypeName, std::size_t CellDimension_ = CoordinateT::Dimension>
+    template <typename CoordinateT, template <typename, typename, std::size_t, typename> typename EntityTypeName, std::size_t CellDimension_ = CoordinateT::Dimension,
+              typename GeometryCachePolicy_ = CacheAllGeometry>
     class Mesh
     {
         static_assert(::HPM::dataType::internal::ProvidesMetaData<CoordinateT>::value, "error: ScalarT and Dimension meta data is required");
@@ -52,6 +56,7 @@ namespace HPM::mesh
         public:
         // Template arguments.
         static constexpr std::size_t CellDimension = CellDimension_;
+        using GeometryCachePolicyT = GeometryCachePolicy_;
 
         // Deduced types and constants.
         using ScalarT = typename CoordinateT::ValueT;
@@ -65,6 +70,34 @@ namespace HPM::mesh
 
         static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
 
+        //!
+        //! \brief Check whether a geometry quantity is precomputed by this mesh.
+        //!
+        //! A quantity is precomputed if the geometry cache policy selects it and if it is available for the cell and world dimension of the mesh:
+        //! Jacobians require the cell dimension to match the world dimension (2 or 3), normals require both to be 3.
+        //!
+        //! \tparam Quantity a single geometry quantity
+        //! \return `true` if the quantity is precomputed, otherwise `false`
+        //!
+        template <GeometryQuantity Quantity>
+        static constexpr auto CachesGeometry() -> bool
+        {
+            constexpr bool Selected = GeometryCachePolicyT::template Caches<Quantity>();
+
+            if constexpr (Quantity == GeometryQuantity::AbsJacobianDeterminant || Quantity == GeometryQuantity::InverseJacobian)
+            {
+                return Selected && CellDimension == WorldDimension && (CellDimension == 2 || CellDimension == 3);
+            }
+            else if constexpr (Quantity == GeometryQuantity::Normal || Quantity == GeometryQuantity::UnitNormal || Quantity == GeometryQuantity::NormalLength)
+            {
+                return Selected && CellDimension == 3 && WorldDimension == 3;
+            }
+            else
+            {
+                return Selected;
+            }
+        }
+
         protected:
         // Deduced types and constants.
         template <std::size_t Dimension>
@@ -72,8 +105,8 @@ namespace HPM::mesh
         // The last template paramter is set to 'true' which results in the local index of an entity equals its (global) index.
         // This is needed because entities of any dimension and with no embedding can be created by the mesh.
         // The equality of the local index and the index of an entity is enforced internally only for cells.
-        template <std::size_t Dimension>
-        using IndexedEntityRange = ::HPM::iterator::IndexedEntityRange<EntityT<Dimension>, Mesh, true>;
+        template <std::size_t Dimension, typename IndexSetT = ::HPM::iterator::IndexSpan>
+        using IndexedEntityRange = ::HPM::iterator::IndexedEntityRange<EntityT<Dimension>, Mesh, true, IndexSetT>;
 
         //!
         //! \brief A data type to request the number of nodes of an entity.
@@ -147,6 +180,8 @@ namespace HPM::mesh
         friend class ::HPM::entity::EntityTopology;
         template <typename, typename, typename, std::size_t>
         friend class ::HPM::entity::EntityGeometry;
+        template <typename>
+        friend class ::HPM::entity::EntityHandle;
 
         public:
         //!
@@ -166,6 +201,23 @@ namespace HPM::mesh
             CellT::Geometry::SetupGeometry(*this);
         }
 
+        //!
+        //! \brief Constructor.
+        //!
+        //! Create a mesh from a node set and a cell to node mapping that are moved into the mesh.
+        //!
+        //! \param nodes a set of nodes
+        //! \param cell_node_index_list the mapping of the cells to the nodes
+        //!
+        Mesh(std::vector<CoordinateT>&& nodes, std::vector<std::array<std::size_t, NumNodesPerCell>>&& cell_node_index_list) : nodes(std::move(nodes))
+        {
+            std::get<CellDimension>(entity_node_index_list) = std::move(cell_node_index_list);
+
+            // Set up internal data members according to the entity type: the cell type must be used!
+            CellT::Topology::SetupTopology(*this);
+            CellT::Geometry::SetupGeometry(*this);
+        }
+
         //!
         //! \brief Create a mesh from a mesh file.
         //!
@@ -186,6 +238,70 @@ namespace HPM::mesh
             return {std::get<0>(fields), std::get<1>(fields)};
         }
 
+        //!
+        //! \brief Move the nodes of the mesh.
+        //!
+        //! The node coordinates are replaced, and the geometry information (normals, normal orientations and the
+        //! quantities selected by the geometry cache policy) is recomputed in place and in parallel, but only for
+        //! the cells that contain at least one moved node.
+        //! The topology is not touched: the connectivity must be the same as before.
+        //! Hence, all entity ranges, index lists and buffers created for this mesh remain valid.
+        //!
+        //! Data structures that are derived from the node coordinates outside of the mesh (e.g., `DG::DgNodesMap`)
+        //! must be refreshed as well: pass them as additional arguments, and their `Update()` member function
+        //! is called once the mesh has been updated.
+        //!
+        //! \code
+        //! DG::DgNodesMap<DgInfo, Mesh> dg_nodes_map(mesh);
+        //! ...
+        //! mesh.UpdateNodes(new_nodes, dg_nodes_map);
+        //! \endcode
+        //!
+        //! \tparam DerivedT the types of the data structures derived from the node coordinates
+        //! \param new_nodes the new node coordinates: one per node of the mesh
+        //! \param derived the data structures derived from the node coordinates (each must provide `Update()`)
+        //!
+        template <typename... DerivedT>
+        auto UpdateNodes(const std::vector<CoordinateT>& new_nodes, DerivedT&... derived) -> void
+        {
+            if (new_nodes.size() != nodes.size())
+            {
+                throw std::runtime_error("error: the number of nodes does not match the number of nodes of the mesh");
+            }
+
+            // Determine the cells with at least one moved node: only their geometry information depends on the update.
+            const auto& cell_node_index_list = std::get<CellDimension>(entity_node_index_list);
+            const std::int64_t num_cells = cell_node_index_list.size();
+            std::vector<char> is_moved(num_cells);
+
+            #pragma omp parallel for schedule(static)
+            for (std::int64_t cell_index = 0; cell_index < num_cells; ++cell_index)
+            {
+                is_moved[cell_index] = std::any_of(cell_node_index_list[cell_index].begin(), cell_node_index_list[cell_index].end(),
+                                                   [this, &new_nodes](const std::size_t node_index) { return !(new_nodes[node_index] == nodes[node_index]); });
+            }
+
+            std::vector<std::size_t> moved_cells;
+
+            for (std::int64_t cell_index = 0; cell_index < num_cells; ++cell_index)
+            {
+                if (is_moved[cell_index])
+                {
+                    moved_cells.push_back(cell_index);
+                }
+            }
+
+            // Copy without reallocation: references to the node coordinates remain valid.
+            std::copy(new_nodes.begin(), new_nodes.end(), nodes.begin());
+
+            if (!moved_cells.empty())
+            {
+                CellT::Geometry::UpdateGeometry(*this, moved_cells);
+            }
+
+            (derived.Update(), ...);
+        }
+
         //!
         //! \brief Get the number of entities with a given dimension.
         //!
@@ -222,6 +338,8 @@ namespace HPM::mesh
         //!
         //! \brief Get an iterator over entities with a given dimension and (global) indices.
         //!
+        //! The returned range does not copy the indices: the index vector must outlive the range.
+        //!
         //! \tparam Dimension the entity dimension
         //! \param indices the (global) indices of the entities
         //! \return an iterator over all entities with a given dimension
@@ -232,6 +350,21 @@ namespace HPM::mesh
             return {*this, indices};
         }
 
+        //!
+        //! \brief Get an iterator over entities with a given dimension and (global) indices.
+        //!
+        //! The returned range takes ownership of the (temporary) index vector.
+        //!
+        //! \tparam Dimension the entity dimension
+        //! \param indices the (global) indices of the entities
+        //! \return an iterator over all entities with a given dimension
+        //!
+        template <std::size_t Dimension = CellDimension>
+        inline auto GetEntities(std::vector<std::size_t>&& indices) const -> IndexedEntityRange<Dimension, std::vector<std::size_t>>
+        {
+            return {*this, std::move(indices)};
+        }
+
         //!
         //! \brief Get all entities of a given dimension.
         //!
@@ -352,6 +485,19 @@ namespace HPM::mesh
             return GetEntityRange<Dimension>([](const auto&) { return true; }, begin, end);
         }
 
+        //!
+        //! \brief Get the memory footprint of the precomputed geometry quantities.
+        //!
+        //! \return the number of bytes used for the geometry cache
+        //!
+        inline auto GetGeometryCacheSize() const -> std::size_t
+        {
+            const auto size = [](const auto& list) { return list.size() * sizeof(typename std::decay_t<decltype(list)>::value_type); };
+
+            return size(lookup_abs_jacobian_determinant) + size(lookup_inverse_jacobian) + size(lookup_normals) + size(lookup_unit_normals) + size(lookup_normal_lengths) +
+                   size(lookup_face_neighboring_cell_mapping) + size(lookup_face_neighboring_face_mapping);
+        }
+
         protected:
         //!
         //! \brief Accessor data structure.
@@ -425,6 +571,27 @@ namespace HPM::mesh
             //!
             inline auto& EntityNeighborList() const { return mesh.entity_neighbor_list; }
 
+            //!
+            //! \brief Get access to the `entity_sub_entity_index_list` member.
+            //!
+            //! \return a (const) reference to the `entity_sub_entity_index_list` member
+            //!
+            inline auto& EntitySubEntityIndexList() const { return mesh.entity_sub_entity_index_list; }
+
+            //!
+            //! \brief Get access to the `entity_containing_cell_offsets` member.
+            //!
+            //! \return a (const) reference to the `entity_containing_cell_offsets` member
+            //!
+            inline auto& EntityContainingCellOffsets() const { return mesh.entity_containing_cell_offsets; }
+
+            //!
+            //! \brief Get access to the `entity_containing_cell_list` member.
+            //!
+            //! \return a (const) reference to the `entity_containing_cell_list` member
+            //!
+            inline auto& EntityContainingCellList() const { return mesh.entity_containing_cell_list; }
+
             //!
             //! \brief Get access to the `normals` member.
             //!
@@ -475,21 +642,23 @@ namespace HPM::mesh
         std::array<std::vector<std::vector<std::size_t>>, CellDimension + 1> entity_incidence_list;   // array<vector<vector<size_t>>, CellDimension+1>
         std::array<std::vector<std::size_t>, CellDimension + 1> entity_boundary_list;                 // array<vector<size_t>, CellDimension+1>
         std::array<std::vector<std::vector<std::size_t>>, CellDimension + 1> entity_neighbor_list;    // array<vector<vector<size_t>>, CellDimension+1>
+        std::array<std::array<std::vector<std::size_t>, CellDimension + 1>, CellDimension + 1> entity_sub_entity_index_list; // array<array<vector<size_t>, CellDimension+1>, CellDimension+1>
+        std::array<std::vector<std::size_t>, CellDimension + 1> entity_containing_cell_offsets;       // array<vector<size_t>, CellDimension+1>: CSR row offsets
+        std::array<std::vector<std::size_t>, CellDimension + 1> entity_containing_cell_list;          // array<vector<size_t>, CellDimension+1>: CSR column indices
         std::array<std::vector<CoordinateT>, CellDimension + 1> normals;                              // array<vector<CoordinateT>, CellDimension+1>
         EntityIndexListT<ScalarT> normal_orientations;                                                // tuple<vector<array<ScalarT, NumSubEntitiesOfCell<0>>,..,array<ScalarT, 1>>>
 
-#if defined(MESH_VALUE_LOOKUP)
-        template <typename T, std::size_t M, std::size_t N>
-        using MatrixT = ::HPM::dataType::Matrix<ScalarT, M, N>;
-
-        std::vector<ScalarT> lookup_abs_jacobian_determinant;
-        std::vector<MatrixT<ScalarT, WorldDimension, WorldDimension>> lookup_inverse_jacobian;
-        EntityIndexListT<CoordinateT> lookup_normals;
-        EntityIndexListT<CoordinateT> lookup_unit_normals;
-        EntityIndexListT<ScalarT> lookup_normal_lengths;
-        std::vector<std::array<std::size_t, NumFacesPerCell>> lookup_face_neighboring_cell_mapping;
-        std::vector<std::array<std::size_t, NumFacesPerCell>> lookup_face_neighboring_face_mapping;
-#endif
+        // Geometry cache: the storage type is selected by the geometry cache policy (see `CachesGeometry` for which lists are filled).
+        using CachedScalarT = typename GeometryCachePolicyT::template StorageT<ScalarT>;
+        using CachedCoordinateT = std::conditional_t<std::is_same_v<CachedScalarT, ScalarT>, CoordinateT, ::HPM::dataType::Vec<CachedScalarT, WorldDimension>>;
+
+        std::vector<CachedScalarT> lookup_abs_jacobian_determinant;                                                   // vector<CachedScalarT>
+        std::vector<::HPM::dataType::Matrix<CachedScalarT, WorldDimension, WorldDimension>> lookup_inverse_jacobian; // vector<Matrix<CachedScalarT, WorldDimension, WorldDimension>>
+        std::vector<std::array<CachedCoordinateT, NumFacesPerCell>> lookup_normals;                                   // vector<array<CachedCoordinateT, NumFacesPerCell>>
+        std::vector<std::array<CachedCoordinateT, NumFacesPerCell>> lookup_unit_normals;                              // vector<array<CachedCoordinateT, NumFacesPerCell>>
+        std::vector<std::array<CachedScalarT, NumFacesPerCell>> lookup_normal_lengths;                                // vector<array<CachedScalarT, NumFacesPerCell>>
+        std::vector<std::array<std::size_t, NumFacesPerCell>> lookup_face_neighboring_cell_mapping;                  // vector<array<size_t, NumFacesPerCell>>
+        std::vector<std::array<std::size_t, NumFacesPerCell>> lookup_face_neighboring_face_mapping;                  // vector<array<size_t, NumFacesPerCell>>
     };
 } // namespace HPM::mesh
 
@@ -6,8 +6,10 @@
 #ifndef DSL_MESHES_PARTITIONEDMESH_HPP
 #define DSL_MESHES_PARTITIONEDMESH_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <numeric>
 #include <set>
 #include <tuple>
 #include <vector>
@@ -26,12 +28,14 @@ namespace HPM::mesh
     //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
     //! \tparam EntityTypeName the class type of the mesh entities
     //! \tparam CellDimension the dimensionality of the mesh entity type 'cell' (can be lower than the coordinate dimension)
+    //! \tparam GeometryCachePolicy the selection of geometry quantities (and their storage type) that are precomputed during the mesh setup
     //!
-    template <typename CoordinateT, template <typename, typename, std::size_t, typename> typename EntityTypeName, std::size_t CellDimension = CoordinateT::Dimension>
-    class PartitionedMesh : public Mesh<CoordinateT, EntityTypeName, CellDimension>
+    template <typename CoordinateT, template <typename, typename, std::size_t, typename> typename EntityTypeName, std::size_t CellDimension = CoordinateT::Dimension,
+              typename GeometryCachePolicy = CacheAllGeometry>
+    class PartitionedMesh : public Mesh<CoordinateT, EntityTypeName, CellDimension, GeometryCachePolicy>
     {
-        using Self = PartitionedMesh<CoordinateT, EntityTypeName, CellDimension>;
-        using MeshBase = Mesh<CoordinateT, EntityTypeName, CellDimension>;
+        using Self = PartitionedMesh<CoordinateT, EntityTypeName, CellDimension, GeometryCachePolicy>;
+        using MeshBase = Mesh<CoordinateT, EntityTypeName, CellDimension, GeometryCachePolicy>;
 
         template <std::size_t Dimension>
         using EntityRange = typename MeshBase::template EntityRange<Dimension>;
@@ -47,7 +51,7 @@ namespace HPM::mesh
         //! \brief Private Constructor
         //!
         template <typename Partitioner = SimplePartitioner>
-        PartitionedMesh(std::vector<CoordinateT>&& nodes, std::vector<std::array<std::size_t, NumNodesPerCell>>&& cell_node_index_list, const std::pair<std::size_t, std::size_t> num_partitions = {1, 1}, std::size_t myL1Partition = 0,
+        PartitionedMesh(std::vector<CoordinateT>&& nodes, std::vector<std::array<std::size_t, NumNodesPerCell>>&& cell_node_index_list, const PartitionHierarchy& num_partitions = {1, 1}, std::size_t myL1Partition = 0,
                         Partitioner partitioner = Partitioner{})
             : PartitionedMesh(partitioner.template CreatePartitions<NumNodesPerFace>(std::move(nodes), std::move(cell_node_index_list), num_partitions), num_partitions, myL1Partition)
         {
@@ -62,74 +66,64 @@ namespace HPM::mesh
         //! as well as the mapping between L2 partitions and entities of any dimension up to the cell dimension.
         //!
         //! \param tuple input data provided by the partitioner
-        //! \param num_partitions the number of level-1 (L1) and L2 partitions to be created
+        //! \param num_partitions the number of partitions on each level, e.g., the number of level-1 (L1) and L2 partitions to be created
         //!
         template <typename TupleT>
-        PartitionedMesh(TupleT&& tuple, const std::pair<std::size_t, std::size_t>& num_partitions, std::size_t myL1Partition)
+        PartitionedMesh(TupleT&& tuple, const PartitionHierarchy& num_partitions, std::size_t myL1Partition)
             : MeshBase(std::move(std::get<0>(tuple)), std::move(std::get<1>(tuple))), cell_to_L2P(std::move(std::get<2>(tuple))), node_to_L2P(std::move(std::get<3>(tuple))),
                 L2P_to_cell_offset(std::move(std::get<4>(tuple))), L2P_to_node_offset(std::move(std::get<5>(tuple))), num_partitions(num_partitions), MyL1Partition(myL1Partition)
         {
             // Determine all L2 partitions assigned to this process.
             const std::size_t proc_id = MyL1Partition;
-            const std::size_t num_procs = num_partitions.first;
+            const std::size_t num_procs = GetNumL1Partitions();
             const std::size_t num_L2_partitions = GetNumL2Partitions();
             const std::size_t num_L2_partitions_per_proc = num_L2_partitions / num_procs;
             const std::size_t L2_begin = proc_id * num_L2_partitions_per_proc;
             const std::size_t L2_end = L2_begin + num_L2_partitions_per_proc;
 
-            // Loop bounds: [0, CellDimension].
+            // Loop bounds: [0, CellDimension).
             ::HPM::auxiliary::ConstexprFor<CellDimension>([num_L2_partitions, L2_begin, L2_end, this](const auto Dimension) {
-                // Resize to the total number of L2 partitions: we do not use index remapping, and thus need the whole index range.
-                std::get<Dimension>(L2P_to_entity).resize(num_L2_partitions);
+                const std::size_t num_entities = std::get<Dimension>(MeshBase::entity_node_index_list).size();
+                const auto& containing_cell_offsets = MeshBase::entity_containing_cell_offsets[Dimension];
+                const auto& containing_cell_list = MeshBase::entity_containing_cell_list[Dimension];
+                auto& list = std::get<Dimension>(entity_to_L2P);
 
-                // Iterate over all L2 partitions assigned to this process.
-                for (std::size_t i_L2 = L2_begin; i_L2 < L2_end; ++i_L2)
-                {
-                    auto& list = std::get<Dimension>(L2P_to_entity)[i_L2];
+                // Entity to L2 partition mapping: each entity belongs to the containing cell with the lowest (global) index.
+                // The indices of the containing cells are sorted in ascending order (CSR).
+                list.resize(num_entities);
 
-                    // Iterate over all elements in this partition.
-                    for (const auto& cell : L2PToEntity(i_L2))
-                    {
-                        const std::size_t cell_index = cell.GetTopology().GetIndex();
-
-                        for (const auto& entity : cell.GetTopology().template GetEntities<Dimension>())
-                        {
-                            const std::size_t entity_index = entity.GetTopology().GetIndex();
-                            const auto& it = std::lower_bound(list.begin(), list.end(), entity_index);
-
-                            if (it == list.end() || (*it) != entity_index)
-                            {
-                                // Get indices of all cells that contain this entity.
-                                std::vector<std::size_t> containing_cell_indices = entity.GetTopology().GetIndicesOfAllContainingCells();
-
-                                // Remove all cells that do not have a lower index than the current cell.
-                                containing_cell_indices.erase(std::remove_if(containing_cell_indices.begin(), containing_cell_indices.end(), [cell_index](const std::size_t& index) { return index >= cell_index; }),
-                                                                containing_cell_indices.end());
-
-                                // If the list is empty, this cell is the one with the lowest index and the entity belongs to its L2 partition.
-                                if (containing_cell_indices.empty())
-                                {
-                                    list.insert(it, entity_index);
-                                }
-                            }
-                        }
-                    }
+#pragma omp parallel for schedule(static)
+                for (std::size_t entity_index = 0; entity_index < num_entities; ++entity_index)
+                {
+                    list[entity_index] = cell_to_L2P[containing_cell_list[containing_cell_offsets[entity_index]]];
                 }
 
-                // Entity to L2 partition mapping.
-                const std::size_t num_entities = std::get<Dimension>(MeshBase::entity_node_index_list).size();
-                auto& list = std::get<Dimension>(entity_to_L2P);
+                // L2 partition to entity mapping (counting sort): resize to the total number of L2 partitions, as we do not use index remapping,
+                // and fill in the entities of the L2 partitions assigned to this process only, in ascending order.
+                auto& L2P_to_entities = std::get<Dimension>(L2P_to_entity);
+                std::vector<std::size_t> num_entities_in_L2P(num_L2_partitions, 0);
 
-                list.resize(num_entities);
+                L2P_to_entities.resize(num_L2_partitions);
 
-                for (const auto& entity : MeshBase::template GetEntities<Dimension>(0, num_entities))
+                for (std::size_t entity_index = 0; entity_index < num_entities; ++entity_index)
                 {
-                    // This entity belongs to the cell with the lowest (global) index: the requested indices are sorted already.
-                    std::vector<std::size_t> containing_cell_indices = entity.GetTopology().GetIndicesOfAllContainingCells();
-                    const std::size_t cell_index = containing_cell_indices.at(0);
+                    ++num_entities_in_L2P[list[entity_index]];
+                }
 
-                    // Get the L2 partition of this cell and store it.
-                    list.at(entity.GetTopology().GetIndex()) = CellToL2P(cell_index);
+                for (std::size_t i_L2 = L2_begin; i_L2 < L2_end; ++i_L2)
+                {
+                    L2P_to_entities[i_L2].clear();
+                    L2P_to_entities[i_L2].reserve(num_entities_in_L2P[i_L2]);
+                }
+
+                for (std::size_t entity_index = 0; entity_index < num_entities; ++entity_index)
+                {
+                    const std::size_t i_L2 = list[entity_index];
+
+                    if (i_L2 >= L2_begin && i_L2 < L2_end)
+                    {
+                        L2P_to_entities[i_L2].push_back(entity_index);
+                    }
                 }
             });
         }
@@ -144,11 +138,13 @@ namespace HPM::mesh
         //! \tparam Reader the class type of the mesh file reader
         //! \tparam Partitioner the type of the partitioner
         //! \param filename the name of the mesh file
-        //! \param num_partitions the number of level-1 (L1) and level-2 (L2) partitions to be created
+        //! \param num_partitions the number of partitions on each level, e.g., the number of level-1 (L1) and level-2 (L2) partitions to be created
+        //! \param myL1Partition the L1 partition of this process
+        //! \param partitioner the partitioner, e.g. `MetisPartitioner`, `RcbPartitioner` or `HilbertPartitioner` (`SimplePartitioner` supports 1 partition only)
         //! \return a partitioned mesh object
         //!
         template <template <typename, typename> class Reader, typename Partitioner = SimplePartitioner>
-        static PartitionedMesh CreateFromFile(const std::string& filename, const std::pair<std::size_t, std::size_t> num_partitions, std::size_t myL1Partition, Partitioner partitioner = Partitioner{})
+        static PartitionedMesh CreateFromFile(const std::string& filename, const PartitionHierarchy& num_partitions, std::size_t myL1Partition, Partitioner partitioner = Partitioner{})
         {
             Reader<CoordinateT, std::array<std::size_t, NumNodesPerCell>> reader;
             
@@ -156,19 +152,45 @@ namespace HPM::mesh
         }
         
         template <template <typename, typename> class Reader, typename Partitioner = SimplePartitioner>
-        static PartitionedMesh CreateFromFile(const std::string& filename, Reader<CoordinateT, std::array<std::size_t, NumNodesPerCell>> reader, const std::pair<std::size_t, std::size_t> num_partitions, std::size_t myL1Partition, Partitioner partitioner = Partitioner{})
+        static PartitionedMesh CreateFromFile(const std::string& filename, Reader<CoordinateT, std::array<std::size_t, NumNodesPerCell>> reader, const PartitionHierarchy& num_partitions, std::size_t myL1Partition, Partitioner partitioner = Partitioner{})
         {
             auto&& data = reader.ReadNodesAndElements(filename);
 
             return PartitionedMesh(std::move(std::get<0>(data)), std::move(std::get<1>(data)), num_partitions, myL1Partition, partitioner);
         }
 
+        //!
+        //! \brief Create a new partitioning of this mesh.
+        //!
+        //! The new mesh is created from the nodes and cells of this mesh in their current order:
+        //! element weights set for the partitioner refer to the cell indices of this mesh, e.g., those measured by a `CostProfiler`.
+        //!
+        //! \tparam Partitioner the type of the partitioner
+        //! \param num_partitions the number of partitions on each level, e.g., the number of level-1 (L1) and level-2 (L2) partitions to be created
+        //! \param myL1Partition the L1 partition of this process
+        //! \param partitioner the partitioner
+        //! \return the re-partitioned mesh
+        //!
+        template <typename Partitioner>
+        auto Repartition(const PartitionHierarchy& num_partitions, std::size_t myL1Partition, Partitioner partitioner) const -> PartitionedMesh
+        {
+            return PartitionedMesh(std::vector<CoordinateT>(MeshBase::nodes), std::vector<std::array<std::size_t, NumNodesPerCell>>(std::get<CellDimension>(MeshBase::entity_node_index_list)), num_partitions,
+                                   myL1Partition, partitioner);
+        }
+
         //!
         //! \brief Get the number of level-1 partitions.
         //!
         //! \return the number of level-1 partitions
         //!
-        inline auto GetNumL1Partitions() const -> std::size_t { return std::get<0>(num_partitions); }
+        inline auto GetNumL1Partitions() const -> std::size_t { return num_partitions.GetNumPartitions(0); }
+
+        //!
+        //! \brief Get the level-1 (L1) partition assigned to this process.
+        //!
+        //! \return the index of the L1 partition of this process
+        //!
+        inline auto GetMyL1Partition() const -> std::size_t { return MyL1Partition; }
 
         //!
         //! \brief Get the number of level-2 (L2) partitions.
@@ -178,7 +200,7 @@ namespace HPM::mesh
         //!
         //! \return the number of L2 partitions
         //!
-        inline auto GetNumL2Partitions() const -> std::size_t { return std::get<0>(num_partitions) * std::get<1>(num_partitions); }
+        inline auto GetNumL2Partitions() const -> std::size_t { return num_partitions.GetTotalNumPartitions(num_partitions.GetNumLevels() - 1); }
 
         //!
         //! \brief Get the containing level-1 (L1) partition of a level-2 (L2) partition.
@@ -186,7 +208,7 @@ namespace HPM::mesh
         //! \param L2_index the index of the L2 partition
         //! \return the containing L1 partition
         //!
-        inline auto L2PToL1P(const std::size_t L2_index) const { return (L2_index / std::get<1>(num_partitions)); }
+        inline auto L2PToL1P(const std::size_t L2_index) const { return (L2_index / GetNumL2PartitionsPerL1()); }
 
         //!
         //! \brief Get all level-1 (L1) partitions of a level-2 (L2) partition
@@ -194,7 +216,78 @@ namespace HPM::mesh
         //! \param L1_index the index of the L1 partition
         //! \return an iterator over all L2 partitions belonging to the specified L1 partition
         //!
-        inline auto L1PToL2P(const std::size_t L1_index) const -> Iterator { return {L1_index * std::get<1>(num_partitions), (L1_index + 1) * std::get<1>(num_partitions)}; }
+        inline auto L1PToL2P(const std::size_t L1_index) const -> Iterator { return {L1_index * GetNumL2PartitionsPerL1(), (L1_index + 1) * GetNumL2PartitionsPerL1()}; }
+
+        //!
+        //! \brief Get the number of levels of the partition hierarchy.
+        //!
+        //! Level 0 is the level-1 (L1) partitioning, the last level is the level-2 (L2) partitioning.
+        //!
+        //! \return the number of levels
+        //!
+        inline auto GetNumLevels() const -> std::size_t { return num_partitions.GetNumLevels(); }
+
+        //!
+        //! \brief Get the partition hierarchy.
+        //!
+        //! \return the number of partitions on each level
+        //!
+        inline auto GetPartitionHierarchy() const -> const PartitionHierarchy& { return num_partitions; }
+
+        //!
+        //! \brief Get the total number of partitions of a level of the partition hierarchy.
+        //!
+        //! \param level the level
+        //! \return the number of partitions of this level
+        //!
+        inline auto GetNumLxPartitions(const std::size_t level) const -> std::size_t { return num_partitions.GetTotalNumPartitions(level); }
+
+        //!
+        //! \brief Get the partitions of level `Ly` that correspond to a partition of level `Lx`.
+        //!
+        //! If `Ly` is a coarser level than `Lx`, this is the containing partition, otherwise these are the contained partitions,
+        //! e.g., `LxPToLyP(2, 1, i)` is the NUMA-level partition of the L2 partition `i` of a mesh with the hierarchy `{nodes, NUMA domains, blocks}`,
+        //! and `LxPToLyP(1, 2, j)` are the L2 partitions of the NUMA-level partition `j`.
+        //!
+        //! \param Lx the level of the partition
+        //! \param Ly the requested level
+        //! \param index the index of the partition of level `Lx`
+        //! \return an iterator over all partitions of level `Ly` that contain or are contained in the specified partition
+        //!
+        inline auto LxPToLyP(const std::size_t Lx, const std::size_t Ly, const std::size_t index) const -> Iterator
+        {
+            if (Ly <= Lx)
+            {
+                const std::size_t index_y = index / num_partitions.GetNumSubPartitions(Ly, Lx);
+
+                return {index_y, index_y + 1};
+            }
+
+            const std::size_t num_sub_partitions = num_partitions.GetNumSubPartitions(Lx, Ly);
+
+            return {index * num_sub_partitions, (index + 1) * num_sub_partitions};
+        }
+
+        //!
+        //! \brief Get the partition of a level of the partition hierarchy for each level-2 (L2) partition.
+        //!
+        //! This is the input for the grouping of the partitions in parallel dispatchers, e.g., `OpenMPDispatcher::SetPartitionDomains`.
+        //!
+        //! \param level the level
+        //! \return the partition of this level, indexed by the L2 partition
+        //!
+        inline auto GetL2PToLxP(const std::size_t level) const -> std::vector<std::size_t>
+        {
+            const std::size_t num_L2_partitions_per_LxP = num_partitions.GetNumSubPartitions(level, GetNumLevels() - 1);
+            std::vector<std::size_t> L2P_to_LxP(GetNumL2Partitions());
+
+            for (std::size_t i_L2 = 0; i_L2 < L2P_to_LxP.size(); ++i_L2)
+            {
+                L2P_to_LxP[i_L2] = i_L2 / num_L2_partitions_per_LxP;
+            }
+
+            return L2P_to_LxP;
+        }
 
         //!
         //! \brief Get the level-2 (L2) partition of an entity.
@@ -252,6 +345,27 @@ namespace HPM::mesh
             return EntityToL2P(cell);
         }
 
+        //!
+        //! \brief Get the level-2 (L2) partition of each cell.
+        //!
+        //! \return the L2 partition of each cell, indexed by the cell index
+        //!
+        inline auto GetCellToL2P() const -> const std::vector<std::size_t>& { return cell_to_L2P; }
+
+        //!
+        //! \brief Get the offsets of the level-2 (L2) partitions within the cells: L2 partition `i` holds the cells [offsets[i], offsets[i + 1]).
+        //!
+        //! \return the offsets (one more than the number of L2 partitions)
+        //!
+        inline auto GetL2PToCellOffsets() const -> const std::vector<std::size_t>& { return L2P_to_cell_offset; }
+
+        //!
+        //! \brief Get the offsets of the level-2 (L2) partitions within the nodes: L2 partition `i` holds the nodes [offsets[i], offsets[i + 1]).
+        //!
+        //! \return the offsets (one more than the number of L2 partitions)
+        //!
+        inline auto GetL2PToNodeOffsets() const -> const std::vector<std::size_t>& { return L2P_to_node_offset; }
+
         //!
         //! \brief Get all entities of a given dimension within a level-2 (L2) partition.
         //!
@@ -306,6 +420,12 @@ namespace HPM::mesh
             return MeshBase::template GetEntities<Dimension>(indices);
         }
 
+        template <std::size_t Dimension = CellDimension>
+        inline auto GetEntities(std::vector<std::size_t>&& indices) const
+        {
+            return MeshBase::template GetEntities<Dimension>(std::move(indices));
+        }
+
         template <std::size_t Dimension = CellDimension>
         inline auto GetEntities(const std::size_t L2_index) const
         {
@@ -430,17 +550,17 @@ namespace HPM::mesh
         }
 
         private:
+        inline auto GetNumL2PartitionsPerL1() const -> std::size_t { return num_partitions.GetNumSubPartitions(0, GetNumLevels() - 1); }
+
         std::vector<std::size_t> cell_to_L2P;
         std::vector<std::size_t> node_to_L2P;
         std::vector<std::size_t> L2P_to_cell_offset;
         std::vector<std::size_t> L2P_to_node_offset;
         std::array<std::vector<std::vector<std::size_t>>, CellDimension> L2P_to_entity;
         std::array<std::vector<std::size_t>, CellDimension> entity_to_L2P;
-        const std::pair<std::size_t, std::size_t> num_partitions;
+        const PartitionHierarchy num_partitions;
         const size_t MyL1Partition;
     };
 } // namespace HPM::mesh
 
-#include <HighPerMeshes/drts/data_flow/DataDependencyMaps.hpp>
-
 #endif
\ No newline at end of file
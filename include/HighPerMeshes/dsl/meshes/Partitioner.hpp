@@ -9,34 +9,124 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
-#include <set>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace HPM::mesh
 {
+    //!
+    //! \brief The number of partitions on each level of a partition hierarchy.
+    //!
+    //! Level 0 is the level-1 (L1) partitioning among the processes, the last level is the level-2 (L2) partitioning into the work units of the threads.
+    //! Each partition of a level is split into the same number of partitions on the next level, e.g., `{num_nodes, num_NUMA_domains, num_blocks}`
+    //! creates one L1 partition per node, one partition per NUMA domain within each L1 partition, and the L2 partitions within each NUMA domain.
+    //! Partitions are numbered consecutively on each level: the partitions contained in a partition of a coarser level have contiguous indices.
+    //! A pair `{L1, L2}` is a hierarchy with two levels.
+    //!
+    class PartitionHierarchy
+    {
+        public:
+        PartitionHierarchy(std::initializer_list<std::size_t> num_partitions) : PartitionHierarchy(std::vector<std::size_t>(num_partitions)) {}
+
+        template <typename IntegerT>
+        PartitionHierarchy(const std::pair<IntegerT, IntegerT>& num_partitions) : PartitionHierarchy({static_cast<std::size_t>(num_partitions.first), static_cast<std::size_t>(num_partitions.second)})
+        {
+        }
+
+        //!
+        //! \brief Constructor.
+        //!
+        //! \param num_partitions the number of partitions on each level within each partition of the previous level
+        //!
+        PartitionHierarchy(std::vector<std::size_t> num_partitions) : num_partitions(std::move(num_partitions))
+        {
+            if (this->num_partitions.empty() || std::find(this->num_partitions.begin(), this->num_partitions.end(), 0) != this->num_partitions.end())
+            {
+                throw std::runtime_error("error: a partition hierarchy needs at least one level and at least one partition per level");
+            }
+        }
+
+        //!
+        //! \brief Get the number of levels.
+        //!
+        //! \return the number of levels
+        //!
+        auto GetNumLevels() const -> std::size_t { return num_partitions.size(); }
+
+        //!
+        //! \brief Get the number of partitions of a level within each partition of the previous level.
+        //!
+        //! \param level the level
+        //! \return the number of partitions per partition of the previous level
+        //!
+        auto GetNumPartitions(const std::size_t level) const -> std::size_t { return num_partitions.at(level); }
+
+        //!
+        //! \brief Get the total number of partitions of a level.
+        //!
+        //! \param level the level
+        //! \return the number of partitions of this level
+        //!
+        auto GetTotalNumPartitions(const std::size_t level) const -> std::size_t { return num_partitions.at(0) * GetNumSubPartitions(0, level); }
+
+        //!
+        //! \brief Get the number of partitions of a finer level within each partition of a coarser level.
+        //!
+        //! \param coarse_level the coarser level
+        //! \param fine_level the finer level (not lower than `coarse_level`)
+        //! \return the number of partitions of the finer level per partition of the coarser level
+        //!
+        auto GetNumSubPartitions(const std::size_t coarse_level, const std::size_t fine_level) const -> std::size_t
+        {
+            if (coarse_level > fine_level || fine_level >= num_partitions.size())
+            {
+                throw std::runtime_error("error: invalid levels of the partition hierarchy");
+            }
+
+            return std::accumulate(num_partitions.begin() + coarse_level + 1, num_partitions.begin() + fine_level + 1, std::size_t{1}, std::multiplies<std::size_t>{});
+        }
+
+        //!
+        //! \brief Get the number of partitions on each level.
+        //!
+        //! \return the number of partitions on each level within each partition of the previous level
+        //!
+        auto GetNumPartitions() const -> const std::vector<std::size_t>& { return num_partitions; }
+
+        private:
+        std::vector<std::size_t> num_partitions;
+    };
+
     //!
     //! \brief A partitioner type.
     //!
-    //! This type provides a 2-level partitioning.
+    //! This type provides a multi-level partitioning (see `PartitionHierarchy`).
     //! Implementing (derived) classes must provide a `CreatePartitionImplementation`  member function that implements the partitioning
     //! of the elements using a specific number of nodes common to neighboring elements.
+    //! Optionally, it uses the node coordinates and element weights (see `CreatePartition`).
     //!
     //! \tparam Implementation the type of the implementing (derived) class (CRTP)
     //!
     template <typename Implementation>
     class Partitioner
     {
-        protected:
+        public:
         //!
-        //! \brief Protected Constructor.
+        //! \brief Constructor.
         //!
-        //! Only derived classes can instantiate this type.
+        //! This constructor is public, so that implementations without constructors can be created by `Implementation{}` (aggregate initialization of this base).
         //!
         Partitioner() = default;
 
+        protected:
+
         //!
         //! \brief Create a partitioning of the elements.
         //!
@@ -53,12 +143,104 @@ namespace HPM::mesh
             return static_cast<const Implementation&>(*this).template CreatePartitionImplementation<NumCommonNodes>(elements, num_nodes, num_partitions);
         }
 
+        //!
+        //! \brief Create a (weighted) partitioning of the elements using the node coordinates.
+        //!
+        //! The implementation is called with the first of the following argument lists it provides a `CreatePartitionImplementation` member function for:
+        //!     `(nodes, elements, num_partitions, element_weights)`,
+        //!     `(nodes, elements, num_partitions)` (geometric partitioners),
+        //!     `(elements, num_nodes, num_partitions, element_weights)`,
+        //!     `(elements, num_nodes, num_partitions)`.
+        //! Implementations accepting element weights must handle empty weights (all elements have the same weight).
+        //!
+        //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common
+        //! \tparam NumNodesPerElement the number of nodes per element
+        //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
+        //! \param nodes the coordinates of all nodes
+        //! \param elements a set of elements to be partitioned
+        //! \param num_partitions the number of partitions to be created
+        //! \param element_weights the weight of each element, or none
+        //! \return a tuple consisting of vector containers holding the mapping of elements to partitions and nodes to partitions
+        //!
+        template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement, typename CoordinateT>
+        auto CreatePartition(const std::vector<CoordinateT>& nodes, const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::size_t num_partitions,
+                             const std::vector<double>& element_weights = {}) const
+        {
+            const auto& implementation = static_cast<const Implementation&>(*this);
+
+            if constexpr (decltype(IsImplemented<NumCommonNodes>(0, nodes, elements, num_partitions, element_weights))::value)
+            {
+                return implementation.template CreatePartitionImplementation<NumCommonNodes>(nodes, elements, num_partitions, element_weights);
+            }
+            else if constexpr (decltype(IsImplemented<NumCommonNodes>(0, nodes, elements, num_partitions))::value)
+            {
+                RequireNoWeights(element_weights);
+
+                return implementation.template CreatePartitionImplementation<NumCommonNodes>(nodes, elements, num_partitions);
+            }
+            else if constexpr (decltype(IsImplemented<NumCommonNodes>(0, elements, nodes.size(), num_partitions, element_weights))::value)
+            {
+                return implementation.template CreatePartitionImplementation<NumCommonNodes>(elements, nodes.size(), num_partitions, element_weights);
+            }
+            else
+            {
+                RequireNoWeights(element_weights);
+
+                return CreatePartition<NumCommonNodes>(elements, nodes.size(), num_partitions);
+            }
+        }
+
+        private:
+        // Check if the implementation provides a `CreatePartitionImplementation` member function for the arguments: std::true_type or std::false_type.
+        template <std::size_t NumCommonNodes, typename... Arguments>
+        static auto IsImplemented(int, const Arguments&... arguments) -> decltype(std::declval<const Implementation&>().template CreatePartitionImplementation<NumCommonNodes>(arguments...), std::true_type{});
+
+        template <std::size_t NumCommonNodes, typename... Arguments>
+        static auto IsImplemented(long, const Arguments&...) -> std::false_type;
+
+        static auto RequireNoWeights(const std::vector<double>& element_weights) -> void
+        {
+            if (!element_weights.empty())
+            {
+                throw std::runtime_error("error: this partitioner does not support element weights");
+            }
+        }
+
         public:
+        //!
+        //! \brief Set the weights of the elements, e.g., their measured execution times (see `CostProfiler`).
+        //!
+        //! The partitions are balanced with respect to the sum of the weights of their elements.
+        //! The weights refer to the elements passed to `CreatePartitions`: one weight per element, in the same order.
+        //!
+        //! \param weights the weight of each element (non-negative), or none to give all elements the same weight
+        //! \return a reference to the implementing partitioner
+        //!
+        auto SetElementWeights(std::vector<double> weights) -> Implementation&
+        {
+            if (std::any_of(weights.begin(), weights.end(), [](const double weight) { return !(weight >= 0.0); }))
+            {
+                throw std::runtime_error("error: element weights must be non-negative");
+            }
+
+            element_weights = std::move(weights);
+
+            return static_cast<Implementation&>(*this);
+        }
+
+        //!
+        //! \brief Get the weights of the elements.
+        //!
+        //! \return the weight of each element, or none if all elements have the same weight
+        //!
+        auto GetElementWeights() const -> const std::vector<double>& { return element_weights; }
+
         //!
         //! \brief Create a partitioning of elements.
         //!
-        //! This function implements a two-level partitioning of the elements.
-        //! Furthermore, nodes and elements are ordered by their level-2 partiton.
+        //! This function implements a hierarchical partitioning of the elements: the elements are partitioned into the partitions of the first level,
+        //! and the elements of each partition are partitioned into the partitions of the next level (see `PartitionHierarchy`).
+        //! Furthermore, nodes and elements are ordered by their level-2 partiton, that is, the partition of the last level.
         //! A mapping between the original node indices and the reordered ones is created.
         //!
         //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common
@@ -66,155 +248,141 @@ namespace HPM::mesh
         //! \tparam CoordinateT the coordinate type used for the node (vertex) representation
         //! \param elements a set of elements to be partitioned
         //! \param num_nodes the total number of nodes among all elements
-        //! \param num_partitions the number of level-1 (L1) and level-2 (L2) partitions to be created
+        //! \param num_partitions the number of partitions on each level, e.g., the number of level-1 (L1) and level-2 (L2) partitions
         //! \return a tuple consisting of vector containers holding
         //!     the ordered nodes and elements,
         //!     the mapping of nodes and elements to level-2 partitions
         //!     offsets (prefix sums) for the number nodes and elements in level-2 partitions
         //!
         template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement, typename CoordinateT>
-        auto CreatePartitions(std::vector<CoordinateT>&& nodes, std::vector<std::array<std::size_t, NumNodesPerElement>>&& elements, const std::pair<std::size_t, std::size_t>& num_partitions)
+        auto CreatePartitions(std::vector<CoordinateT>&& nodes, std::vector<std::array<std::size_t, NumNodesPerElement>>&& elements, const PartitionHierarchy& num_partitions)
         {
             const std::size_t num_nodes = nodes.size();
             const std::size_t num_elements = elements.size();
-            const std::size_t num_L2_partitions(std::get<0>(num_partitions) * std::get<1>(num_partitions));
-            std::vector<std::size_t> element_to_L2P(num_elements);
+            const std::size_t num_levels = num_partitions.GetNumLevels();
+            const std::size_t num_L2_partitions = num_partitions.GetTotalNumPartitions(num_levels - 1);
+
+            if (!element_weights.empty() && element_weights.size() != num_elements)
+            {
+                throw std::runtime_error("error: the number of element weights does not match the number of elements");
+            }
+
+            std::vector<std::size_t> element_to_L2P;
             std::vector<std::size_t> num_elements_in_L2P_offset(num_L2_partitions + 1);
-            std::vector<std::size_t> node_to_L2P(num_nodes);
+            std::vector<std::size_t> node_to_L2P;
             std::vector<std::size_t> num_nodes_in_L2P_offset(num_L2_partitions + 1);
 
             // Do the first level (L1) partitioning.
-            std::vector<std::size_t> element_to_L1P;
-            std::vector<std::size_t> node_to_L1P;
-            std::tie(element_to_L1P, node_to_L1P) = CreatePartition<NumCommonNodes>(elements, num_nodes, std::get<0>(num_partitions));
-
-            // Order elements by their L1 partition: ordering within any L1 partition is implicit.
-            std::vector<std::vector<std::size_t>> L1P_to_element(std::get<0>(num_partitions));
+            std::tie(element_to_L2P, node_to_L2P) = CreatePartition<NumCommonNodes>(nodes, elements, num_partitions.GetNumPartitions(0), element_weights);
 
-            for (std::size_t element_index = 0; element_index < element_to_L1P.size(); ++element_index)
+            // Partition the partitions of each level: the mappings hold the partitions of the previous level.
+            for (std::size_t level = 1; level < num_levels; ++level)
             {
-                L1P_to_element[element_to_L1P[element_index]].push_back(element_index);
-            }
+                const std::size_t num_parent_partitions = num_partitions.GetTotalNumPartitions(level - 1);
+                const std::size_t num_sub_partitions = num_partitions.GetNumPartitions(level);
+                std::vector<std::size_t> element_to_LxP(num_elements);
+                std::vector<std::size_t> node_to_LxP(num_nodes);
 
-            // Do the second level (L2) partitioning: iterate over all L1 partitions.
-            for (std::size_t i_L1 = 0; i_L1 < std::get<0>(num_partitions); ++i_L1)
-            {
-                const std::size_t num_elements_in_L1P = L1P_to_element[i_L1].size();
+                // Order elements by their parent partition (counting sort): ordering within any parent partition is implicit.
+                std::vector<std::size_t> parent_to_element_offset;
+                const std::vector<std::size_t>& parent_to_element = GetSortedIndices(element_to_L2P, num_parent_partitions, parent_to_element_offset);
 
-                // Collect all elements in this L1 partition.
-                std::vector<std::array<std::size_t, NumNodesPerElement>> elements_in_L1P(num_elements_in_L1P);
-                for (std::size_t element_index = 0; element_index < num_elements_in_L1P; ++element_index)
+                // Iterate over all parent partitions.
+                for (std::size_t parent = 0; parent < num_parent_partitions; ++parent)
                 {
-                    elements_in_L1P[element_index] = elements[L1P_to_element[i_L1][element_index]];
-                }
+                    const std::size_t* elements_of_parent = parent_to_element.data() + parent_to_element_offset[parent];
+                    const std::size_t num_elements_in_parent = parent_to_element_offset[parent + 1] - parent_to_element_offset[parent];
 
-                // Now do the partitioning of this L1 partition: use only elements in this L1 partition and the whole set of nodes.
-                std::vector<std::size_t> element_to_partition;
-                std::vector<std::size_t> node_to_partition;
-                std::tie(element_to_partition, node_to_partition) = CreatePartition<NumCommonNodes>(elements_in_L1P, num_nodes, std::get<1>(num_partitions));
+                    // Collect all elements in this parent partition.
+                    std::vector<std::array<std::size_t, NumNodesPerElement>> elements_in_parent(num_elements_in_parent);
+                    std::vector<double> element_weights_in_parent(element_weights.empty() ? 0 : num_elements_in_parent);
+                    for (std::size_t element_index = 0; element_index < num_elements_in_parent; ++element_index)
+                    {
+                        elements_in_parent[element_index] = elements[elements_of_parent[element_index]];
+                    }
 
-                // Iterate over all the nodes..
-                for (std::size_t node_index = 0; node_index < node_to_partition.size(); ++node_index)
-                {
-                    // ..and consider only those in this L1 partition.
-                    if (node_to_L1P[node_index] == i_L1)
+                    for (std::size_t element_index = 0; element_index < element_weights_in_parent.size(); ++element_index)
                     {
-                        // Translate the local partition index into the L2 partition index: i_L1 * num_L1_partitions + local_partition_index.
-                        node_to_L2P[node_index] = i_L1 * std::get<1>(num_partitions) + node_to_partition[node_index];
+                        element_weights_in_parent[element_index] = element_weights[elements_of_parent[element_index]];
                     }
-                }
 
-                // For each element in this L1 partition translate its local partition index into the L2 partition index (similar to the node case).
-                for (std::size_t element_index = 0; element_index < elements_in_L1P.size(); ++element_index)
-                {
-                    element_to_L2P[L1P_to_element[i_L1][element_index]] = i_L1 * std::get<1>(num_partitions) + element_to_partition[element_index];
+                    // Now do the partitioning of this parent partition: use only elements in this partition and the whole set of nodes.
+                    std::vector<std::size_t> element_to_partition;
+                    std::vector<std::size_t> node_to_partition;
+                    std::tie(element_to_partition, node_to_partition) = CreatePartition<NumCommonNodes>(nodes, elements_in_parent, num_sub_partitions, element_weights_in_parent);
+
+                    // Iterate over all the nodes..
+                    for (std::size_t node_index = 0; node_index < node_to_partition.size(); ++node_index)
+                    {
+                        // ..and consider only those in this parent partition.
+                        if (node_to_L2P[node_index] == parent)
+                        {
+                            // Translate the local partition index into the partition index of this level: parent * num_sub_partitions + local_partition_index.
+                            node_to_LxP[node_index] = parent * num_sub_partitions + node_to_partition[node_index];
+                        }
+                    }
+
+                    // For each element in this parent partition translate its local partition index into the partition index of this level (similar to the node case).
+                    for (std::size_t element_index = 0; element_index < num_elements_in_parent; ++element_index)
+                    {
+                        element_to_LxP[elements_of_parent[element_index]] = parent * num_sub_partitions + element_to_partition[element_index];
+                    }
                 }
+
+                element_to_L2P.swap(element_to_LxP);
+                node_to_L2P.swap(node_to_LxP);
             }
 
             // At this point, we have the mapping of nodes and elements to their L2 partitions.
 
-            // Order the nodes by their L2 partition and store the index remapping.
+            // Order the nodes by their L2 partition (counting sort: ascending original index within each L2 partition) and store the index remapping.
             std::vector<std::size_t> node_index_remapping(num_nodes);
             {
-                std::vector<std::set<std::size_t>> L2P_to_node(num_L2_partitions);
-
-                // Insert node indices into L2 partitions: ordered.
-                for (std::size_t node_index = 0; node_index < num_nodes; ++node_index)
-                {
-                    L2P_to_node[node_to_L2P[node_index]].insert(node_index);
-                }
-
+                const std::vector<std::size_t>& L2P_to_node = GetSortedIndices(node_to_L2P, num_L2_partitions, num_nodes_in_L2P_offset);
                 std::vector<CoordinateT> remapped_nodes(num_nodes);
-                std::size_t i_L2 = 0;
-                std::size_t remapped_node_index = 0;
 
-                // For each L2 partition consider its node indices.
-                num_nodes_in_L2P_offset[0] = 0;
-                for (const auto& nodes_in_L2P : L2P_to_node)
+#pragma omp parallel for schedule(static)
+                for (std::size_t remapped_node_index = 0; remapped_node_index < num_nodes; ++remapped_node_index)
                 {
-                    // For each node index in this L2 partition..
-                    for (const auto& node_index : nodes_in_L2P)
-                    {
-                        // ..insert the node into the per-partition node list,
-                        remapped_nodes[remapped_node_index] = nodes[node_index];
-                        // ..note the partition this node belongs to,
-                        node_to_L2P[remapped_node_index] = i_L2;
-                        // ..and note the translation between the original and the remapped index.
-                        node_index_remapping[node_index] = remapped_node_index;
-                        // Go to the next node.
-                        ++remapped_node_index;
-                    }
+                    const std::size_t node_index = L2P_to_node[remapped_node_index];
 
-                    // Go to the next partition and note the number of nodes in the L2 partitions already considered.
-                    num_nodes_in_L2P_offset[++i_L2] = remapped_node_index;
+                    remapped_nodes[remapped_node_index] = nodes[node_index];
+                    node_index_remapping[node_index] = remapped_node_index;
                 }
 
+                // Note the partition each node belongs to.
+                SetPartitionOfSortedIndices(num_nodes_in_L2P_offset, node_to_L2P);
+
                 // Replace the unordered node incides by the those ordered by their L2 partitions.
                 nodes.swap(remapped_nodes);
             }
 
-            // Order the elements by their L2 partition.
+            // Order the elements by their L2 partition (counting sort).
             {
-                std::vector<std::set<std::size_t>> L2P_to_element(num_L2_partitions);
-
-                // Insert element indices into L2 partitions: ordered.
-                for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
-                {
-                    L2P_to_element[element_to_L2P[element_index]].insert(element_index);
-                }
-
+                const std::vector<std::size_t>& L2P_to_element = GetSortedIndices(element_to_L2P, num_L2_partitions, num_elements_in_L2P_offset);
                 std::vector<std::array<std::size_t, NumNodesPerElement>> remapped_elements(num_elements);
-                std::size_t i_L2 = 0;
-                std::size_t remapped_element_index = 0;
 
-                // For each L2 partition consider its element indices.
-                num_elements_in_L2P_offset[0] = 0;
-                for (const auto& elements_in_L2P : L2P_to_element)
+                // Translate the node indices of each element using the remapped indexing.
+#pragma omp parallel for schedule(static)
+                for (std::size_t remapped_element_index = 0; remapped_element_index < num_elements; ++remapped_element_index)
                 {
-                    // For each element index in this L2 partition..
-                    for (const auto& element_index : elements_in_L2P)
-                    {
-                        // ..translate its node indices using the remapped indexing,
-                        for (std::size_t node_index = 0; node_index < NumNodesPerElement; ++node_index)
-                        {
-                            remapped_elements[remapped_element_index][node_index] = node_index_remapping[elements[element_index][node_index]];
-                        }
+                    const auto& element = elements[L2P_to_element[remapped_element_index]];
 
-                        // ..and note the partition this element belongs to.
-                        element_to_L2P[remapped_element_index] = i_L2;
-                        // Go to the next element.
-                        ++remapped_element_index;
+                    for (std::size_t node_index = 0; node_index < NumNodesPerElement; ++node_index)
+                    {
+                        remapped_elements[remapped_element_index][node_index] = node_index_remapping[element[node_index]];
                     }
+                }
 
-                    // Note the number of elements in the L2 partitions already considered.
-                    num_elements_in_L2P_offset[i_L2 + 1] = remapped_element_index;
+                // Note the partition each element belongs to.
+                SetPartitionOfSortedIndices(num_elements_in_L2P_offset, element_to_L2P);
 
-                    // Sort all elements in this L2 partition: mappings of elements into and from the L2 partions intact!
-                    // Why sorting? Enable binary search for a specific element, given its node indices.
+                // Sort all elements in each L2 partition: mappings of elements into and from the L2 partions intact!
+                // Why sorting? Enable binary search for a specific element, given its node indices.
+#pragma omp parallel for schedule(dynamic)
+                for (std::size_t i_L2 = 0; i_L2 < num_L2_partitions; ++i_L2)
+                {
                     std::sort(remapped_elements.begin() + num_elements_in_L2P_offset[i_L2], remapped_elements.begin() + num_elements_in_L2P_offset[i_L2 + 1]);
-
-                    // Go to the next partition.
-                    ++i_L2;
                 }
 
                 // Replace the unordered elements by the those ordered by their L2 partitions.
@@ -223,6 +391,57 @@ namespace HPM::mesh
 
             return std::make_tuple(std::move(nodes), std::move(elements), std::move(element_to_L2P), std::move(node_to_L2P), std::move(num_elements_in_L2P_offset), std::move(num_nodes_in_L2P_offset));
         }
+
+        private:
+        //!
+        //! \brief Sort indices by their partition (counting sort).
+        //!
+        //! \param index_to_partition the partition of each index
+        //! \param num_partitions the number of partitions
+        //! \param offsets the offsets (prefix sums) of the partitions within the sorted indices: `num_partitions + 1` entries
+        //! \return the indices ordered by their partition, and in ascending order within each partition
+        //!
+        static auto GetSortedIndices(const std::vector<std::size_t>& index_to_partition, const std::size_t num_partitions, std::vector<std::size_t>& offsets) -> std::vector<std::size_t>
+        {
+            std::vector<std::size_t> sorted_indices(index_to_partition.size());
+
+            offsets.assign(num_partitions + 1, 0);
+
+            for (const std::size_t partition : index_to_partition)
+            {
+                ++offsets[partition + 1];
+            }
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+
+            for (std::size_t index = 0; index < index_to_partition.size(); ++index)
+            {
+                sorted_indices[position[index_to_partition[index]]++] = index;
+            }
+
+            return sorted_indices;
+        }
+
+        //!
+        //! \brief Set the partition of each sorted index from the offsets of the partitions.
+        //!
+        //! \param offsets the offsets (prefix sums) of the partitions
+        //! \param index_to_partition the partition of each sorted index (output)
+        //!
+        static auto SetPartitionOfSortedIndices(const std::vector<std::size_t>& offsets, std::vector<std::size_t>& index_to_partition) -> void
+        {
+            const std::size_t num_partitions = offsets.size() - 1;
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t partition = 0; partition < num_partitions; ++partition)
+            {
+                std::fill(index_to_partition.begin() + offsets[partition], index_to_partition.begin() + offsets[partition + 1], partition);
+            }
+        }
+
+        std::vector<double> element_weights;
     };
 
     //!
@@ -270,6 +489,125 @@ namespace HPM::mesh
             return std::make_tuple(std::move(element_to_partition), std::move(node_to_partition));
         }
     };
+
+    //!
+    //! \brief Quality measures of a partitioning of elements.
+    //!
+    struct PartitionQuality
+    {
+        //! the number of neighboring element pairs in different partitions
+        std::size_t edge_cut;
+        //! the number of ghost elements summed over all partitions: elements neighboring a partition they do not belong to
+        std::size_t halo_size;
+        //! the size of the largest partition relative to the average partition size
+        double imbalance;
+    };
+
+    //!
+    //! \brief Get the quality of a partitioning of elements.
+    //!
+    //! Two elements are neighbors if they have at least `NumCommonNodes` nodes in common (the dual graph used by METIS).
+    //!
+    //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common
+    //! \tparam NumNodesPerElement the number of nodes per element
+    //! \param elements a set of elements
+    //! \param element_to_partition the mapping of elements to partitions
+    //! \param num_partitions the number of partitions
+    //! \return the edge-cut, the halo size and the imbalance of the partitioning
+    //!
+    template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement>
+    auto GetPartitionQuality(const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::vector<std::size_t>& element_to_partition, const std::size_t num_partitions)
+        -> PartitionQuality
+    {
+        const std::size_t num_elements = elements.size();
+        std::size_t num_nodes = 0;
+
+        for (const auto& element : elements)
+        {
+            num_nodes = std::max(num_nodes, *std::max_element(element.begin(), element.end()) + 1);
+        }
+
+        // Node to element mapping (compressed).
+        std::vector<std::size_t> node_to_element_offset(num_nodes + 1, 0);
+        std::vector<std::size_t> node_to_element(num_elements * NumNodesPerElement);
+
+        for (const auto& element : elements)
+        {
+            for (const std::size_t node_index : element)
+            {
+                ++node_to_element_offset[node_index + 1];
+            }
+        }
+
+        std::partial_sum(node_to_element_offset.begin(), node_to_element_offset.end(), node_to_element_offset.begin());
+
+        {
+            std::vector<std::size_t> position(node_to_element_offset.begin(), node_to_element_offset.end() - 1);
+
+            for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
+            {
+                for (const std::size_t node_index : elements[element_index])
+                {
+                    node_to_element[position[node_index]++] = element_index;
+                }
+            }
+        }
+
+        std::size_t edge_cut = 0;
+        std::size_t halo_size = 0;
+
+#pragma omp parallel reduction(+ : edge_cut, halo_size)
+        {
+            std::vector<std::size_t> candidates;
+            std::vector<std::size_t> foreign_partitions;
+
+#pragma omp for schedule(static)
+            for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
+            {
+                candidates.clear();
+                foreign_partitions.clear();
+
+                for (const std::size_t node_index : elements[element_index])
+                {
+                    candidates.insert(candidates.end(), node_to_element.begin() + node_to_element_offset[node_index], node_to_element.begin() + node_to_element_offset[node_index + 1]);
+                }
+
+                std::sort(candidates.begin(), candidates.end());
+
+                // Each run of equal candidates is the number of nodes in common.
+                for (auto it = candidates.begin(); it != candidates.end();)
+                {
+                    const auto run_end = std::upper_bound(it, candidates.end(), *it);
+                    const std::size_t neighbor_index = *it;
+
+                    if (neighbor_index != element_index && static_cast<std::size_t>(run_end - it) >= NumCommonNodes &&
+                        element_to_partition[neighbor_index] != element_to_partition[element_index])
+                    {
+                        edge_cut += (neighbor_index > element_index ? 1 : 0);
+                        foreign_partitions.push_back(element_to_partition[neighbor_index]);
+                    }
+
+                    it = run_end;
+                }
+
+                // This element is a ghost element of each neighboring partition.
+                std::sort(foreign_partitions.begin(), foreign_partitions.end());
+                halo_size += std::distance(foreign_partitions.begin(), std::unique(foreign_partitions.begin(), foreign_partitions.end()));
+            }
+        }
+
+        std::vector<std::size_t> num_elements_in_partition(num_partitions, 0);
+
+        for (const std::size_t partition : element_to_partition)
+        {
+            ++num_elements_in_partition[partition];
+        }
+
+        const std::size_t max_num_elements = (num_partitions > 0 ? *std::max_element(num_elements_in_partition.begin(), num_elements_in_partition.end()) : 0);
+        const double imbalance = (num_elements > 0 ? static_cast<double>(max_num_elements) * num_partitions / num_elements : 1.0);
+
+        return {edge_cut, halo_size, imbalance};
+    }
 } // namespace HPM::mesh
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef DSL_MESHES_PARTITIONINGREPORT_HPP
+#define DSL_MESHES_PARTITIONINGREPORT_HPP
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace HPM::mesh
+{
+    //!
+    //! \brief Size and communication volume of one level-1 (L1) or level-2 (L2) partition.
+    //!
+    //! Ghost entities are entities owned by other partitions (of the same level) that this partition accesses.
+    //!
+    struct PartitionStatistics
+    {
+        std::size_t num_cells = 0;
+        std::size_t num_nodes = 0;
+        std::size_t num_neighbors = 0;               //!< the number of partitions this partition accesses
+        double imbalance = 0.0;                      //!< the number of cells relative to the average number of cells
+        std::vector<std::size_t> num_ghost_entities; //!< the number of ghost entities, indexed by the dimension
+        std::vector<std::size_t> halo_bytes;         //!< the estimated size of the halo, indexed by the buffer
+
+        //!
+        //! \return the estimated size of the halo summed up over all buffers
+        //!
+        auto GetHaloBytes() const -> std::size_t { return std::accumulate(halo_bytes.begin(), halo_bytes.end(), std::size_t{0}); }
+    };
+
+    //!
+    //! \brief Quality and communication volume of the partitioning of a `PartitionedMesh` (see `drts::data_flow::AnalyzePartitioning`).
+    //!
+    //! The report can be written as text or as JSON, e.g., to compare different numbers of partitions without running the simulation.
+    //!
+    struct PartitioningReport
+    {
+        std::size_t num_L1_partitions = 0;
+        std::size_t num_L2_partitions_per_L1 = 0;
+        std::vector<PartitionStatistics> L1_partitions;
+        std::vector<PartitionStatistics> L2_partitions;
+
+        //!
+        //! \brief Get the largest imbalance of a set of partitions.
+        //!
+        //! \param partitions the statistics of the partitions
+        //! \return the largest number of cells relative to the average number of cells
+        //!
+        static auto GetMaxImbalance(const std::vector<PartitionStatistics>& partitions) -> double
+        {
+            double max_imbalance = 0.0;
+
+            for (const auto& partition : partitions)
+            {
+                max_imbalance = std::max(max_imbalance, partition.imbalance);
+            }
+
+            return max_imbalance;
+        }
+
+        //!
+        //! \brief Get the total estimated halo size of a set of partitions.
+        //!
+        //! \param partitions the statistics of the partitions
+        //! \return the sum of the halo sizes over all partitions and buffers
+        //!
+        static auto GetTotalHaloBytes(const std::vector<PartitionStatistics>& partitions) -> std::size_t
+        {
+            std::size_t bytes = 0;
+
+            for (const auto& partition : partitions)
+            {
+                bytes += partition.GetHaloBytes();
+            }
+
+            return bytes;
+        }
+
+        //!
+        //! \brief Write the report as text tables: one table for the L1 partitions and one for the L2 partitions.
+        //!
+        //! \param stream the output stream
+        //!
+        auto WriteText(std::ostream& stream) const -> void
+        {
+            const auto flags = stream.flags();
+            const auto precision = stream.precision();
+
+            stream << "partitions: " << num_L1_partitions << " x " << num_L2_partitions_per_L1 << std::endl;
+
+            WriteTable(stream, "L1", L1_partitions);
+            WriteTable(stream, "L2", L2_partitions);
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        //!
+        //! \brief Write the report as a JSON object.
+        //!
+        //! \param stream the output stream
+        //!
+        auto WriteJson(std::ostream& stream) const -> void
+        {
+            stream << "{\"num_partitions\":[" << num_L1_partitions << "," << num_L2_partitions_per_L1 << "],";
+            stream << "\"max_imbalance\":{\"L1\":" << GetMaxImbalance(L1_partitions) << ",\"L2\":" << GetMaxImbalance(L2_partitions) << "},";
+            stream << "\"halo_bytes\":{\"L1\":" << GetTotalHaloBytes(L1_partitions) << ",\"L2\":" << GetTotalHaloBytes(L2_partitions) << "},";
+            stream << "\"L1\":";
+            WriteJsonArray(stream, L1_partitions);
+            stream << ",\"L2\":";
+            WriteJsonArray(stream, L2_partitions);
+            stream << "}" << std::endl;
+        }
+
+        private:
+        static auto WriteTable(std::ostream& stream, const std::string& level, const std::vector<PartitionStatistics>& partitions) -> void
+        {
+            const std::size_t num_dimensions = (partitions.empty() ? 0 : partitions.front().num_ghost_entities.size());
+            const std::size_t num_buffers = (partitions.empty() ? 0 : partitions.front().halo_bytes.size());
+
+            stream << level << ": max imbalance " << std::fixed << std::setprecision(3) << GetMaxImbalance(partitions) << ", halo " << GetTotalHaloBytes(partitions) << " bytes" << std::endl;
+            stream << std::setw(10) << level << std::setw(12) << "cells" << std::setw(12) << "nodes" << std::setw(12) << "imbalance" << std::setw(12) << "neighbors";
+
+            for (std::size_t dimension = 0; dimension < num_dimensions; ++dimension)
+            {
+                stream << std::setw(12) << ("ghosts " + std::to_string(dimension));
+            }
+
+            for (std::size_t buffer = 0; buffer < num_buffers; ++buffer)
+            {
+                stream << std::setw(12) << ("bytes " + std::to_string(buffer));
+            }
+
+            stream << std::endl;
+
+            for (std::size_t index = 0; index < partitions.size(); ++index)
+            {
+                const auto& partition = partitions[index];
+
+                stream << std::setw(10) << index << std::setw(12) << partition.num_cells << std::setw(12) << partition.num_nodes << std::setw(12) << partition.imbalance << std::setw(12)
+                       << partition.num_neighbors;
+
+                for (const std::size_t num_ghost_entities : partition.num_ghost_entities)
+                {
+                    stream << std::setw(12) << num_ghost_entities;
+                }
+
+                for (const std::size_t bytes : partition.halo_bytes)
+                {
+                    stream << std::setw(12) << bytes;
+                }
+
+                stream << std::endl;
+            }
+        }
+
+        static auto WriteJsonArray(std::ostream& stream, const std::vector<std::size_t>& values) -> void
+        {
+            stream << "[";
+
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                stream << (i == 0 ? "" : ",") << values[i];
+            }
+
+            stream << "]";
+        }
+
+        static auto WriteJsonArray(std::ostream& stream, const std::vector<PartitionStatistics>& partitions) -> void
+        {
+            stream << "[";
+
+            for (std::size_t index = 0; index < partitions.size(); ++index)
+            {
+                const auto& partition = partitions[index];
+
+                stream << (index == 0 ? "" : ",") << "\n{\"partition\":" << index << ",\"cells\":" << partition.num_cells << ",\"nodes\":" << partition.num_nodes
+                       << ",\"imbalance\":" << partition.imbalance << ",\"neighbors\":" << partition.num_neighbors << ",\"ghost_entities\":";
+                WriteJsonArray(stream, partition.num_ghost_entities);
+                stream << ",\"halo_bytes\":";
+                WriteJsonArray(stream, partition.halo_bytes);
+                stream << "}";
+            }
+
+            stream << "]";
+        }
+    };
+} // namespace HPM::mesh
+
+#endif
@@ -38,9 +38,9 @@ namespace HPM::mesh
     class Range
     {
         // Only the `PartitionedMesh` and the `Mesh` can instantiate this type: the index vector is always valid!
-        template <typename, template <typename, typename, std::size_t, typename> typename, std::size_t>
+        template <typename, template <typename, typename, std::size_t, typename> typename, std::size_t, typename>
         friend class PartitionedMesh;
-        template <typename, template <typename, typename, std::size_t, typename> typename, std::size_t>
+        template <typename, template <typename, typename, std::size_t, typename> typename, std::size_t, typename>
         friend class Mesh;
         friend auto MakeRange<EntityDimension, MeshT, std::set<std::size_t>>(const MeshT&, const std::set<std::size_t>&&);
         friend auto MakeRange<EntityDimension, MeshT, std::vector<std::size_t>>(const MeshT&, const std::vector<std::size_t>&&);
@@ -63,6 +63,13 @@ namespace HPM::mesh
         //!
         inline const auto& GetMesh() const { return mesh; }
 
+        //!
+        //! \brief Get the number of partitions.
+        //!
+        //! \return the number of index vectors: 1 for a `Mesh`, the number of L2 partitions for a `PartitionedMesh`
+        //!
+        inline auto GetNumPartitions() const { return indices.size(); }
+
         //!
         //! \brief Get the index vector of a specific partition.
         //!
@@ -74,14 +81,29 @@ namespace HPM::mesh
         //!
         //! \brief Get entities within a partition.
         //!
+        //! The returned range refers to the index vector of this range: no copy is made.
+        //!
         //! \param partition the index of the partition
         //! \return an iterable set of entities specified by the given `mesh`, `indices` and `EntityDimension`  
         //!
-        inline auto GetEntities(const std::size_t partition = 0) const 
+        inline auto GetEntities(const std::size_t partition = 0) const& 
         {
             return mesh.template GetEntities<EntityDimension>(GetIndices(partition));
         }
 
+        //!
+        //! \brief Get entities within a partition.
+        //!
+        //! This range is a temporary: the returned range holds a copy of the index vector.
+        //!
+        //! \param partition the index of the partition
+        //! \return an iterable set of entities specified by the given `mesh`, `indices` and `EntityDimension`  
+        //!
+        inline auto GetEntities(const std::size_t partition = 0) &&
+        {
+            return mesh.template GetEntities<EntityDimension>(std::vector<std::size_t>(GetIndices(partition)));
+        }
+
         private:
         const MeshT& mesh;
         const std::vector<std::vector<std::size_t>> indices;
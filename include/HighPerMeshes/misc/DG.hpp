@@ -6,6 +6,10 @@
 #ifndef MISC_DG_HPP
 #define MISC_DG_HPP
 
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
 #include <HighPerMeshes/dsl/meshes/Mesh.hpp>
 
 namespace HPM::DG
@@ -75,16 +79,48 @@ namespace HPM::DG
         // \todo { What is the meaning behind this map for the last index? Map[element index][local face index][DOF of face][??] - Stefan G. 23.07.2019 }
         using Map = std::vector<std::array<SurfaceMap<DgInfo::NumSurfaceNodes>, 4>>;
 
-        DgNodesMap(const MeshT& mesh) : mesh(mesh), map(mesh.GetNumEntities())
+        DgNodesMap(const MeshT& mesh) : mesh(mesh), map(mesh.GetNumEntities()) { Update(); }
+
+        //!
+        //! \brief Recompute the map from the current node coordinates of the mesh.
+        //!
+        //! Call this function after the nodes of the mesh have been moved (see `Mesh::UpdateNodes`).
+        //! The elements are processed in parallel.
+        //!
+        auto Update() -> void
         {
-            for (auto const& element : mesh.GetEntities())
+            const std::int64_t num_elements = mesh.GetNumEntities();
+            std::exception_ptr exception;
+
+            #pragma omp parallel for schedule(static)
+            for (std::int64_t element_index = 0; element_index < num_elements; ++element_index)
             {
-                const std::size_t element_index = element.GetTopology().GetIndex();
-                for (auto const& face : element.GetTopology().GetSubEntities())
+                try
                 {
-                    const std::size_t face_index = face.GetTopology().GetLocalIndex();
-                    map[element_index][face_index] = ComputeForOneFace<DgInfo>(element, face);
+                    const auto& element = *mesh.GetEntities(element_index, element_index + 1).begin();
+
+                    for (auto const& face : element.GetTopology().GetSubEntities())
+                    {
+                        const std::size_t face_index = face.GetTopology().GetLocalIndex();
+                        map[element_index][face_index] = ComputeForOneFace<DgInfo>(element, face);
+                    }
                 }
+                catch (...)
+                {
+                    // Exceptions must not leave the parallel region: rethrow the first one afterwards.
+                    #pragma omp critical
+                    {
+                        if (!exception)
+                        {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+            }
+
+            if (exception)
+            {
+                std::rethrow_exception(exception);
             }
         }
 
@@ -8,7 +8,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
+#include <limits>
+#include <numeric>
 #include <set>
 #include <stdexcept>
 #include <tuple>
@@ -45,15 +48,19 @@ namespace HPM::mesh
         //! Each element consists of a set of nodes.
         //! The number of nodes shared by two neighboring elements must be specified for the partitioning.
         //!
+        //! Element weights are scaled to integers for METIS: the largest weight becomes 1000 (at most), and each element has a weight of at least 1.
+        //!
         //! \tparam NumNodesPerElement the number of nodes per element
         //! \tparam NumCommonNodes the number of nodes two neighboring elements have in common
         //! \param elements a set of elements to be partitioned
         //! \param num_nodes the total number of nodes among all elements
         //! \param num_partitions the number of partitions to be created
+        //! \param element_weights the weight of each element, or none
         //! \return a tuple consisting of vector containers holding the mapping of elements to partitions and nodes to partitions
         //!
         template <std::size_t NumCommonNodes, std::size_t NumNodesPerElement>
-        auto CreatePartitionImplementation(const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::size_t num_nodes, const std::size_t num_partitions) const
+        auto CreatePartitionImplementation(const std::vector<std::array<std::size_t, NumNodesPerElement>>& elements, const std::size_t num_nodes, const std::size_t num_partitions,
+                                           const std::vector<double>& element_weights) const
         {
             const std::size_t num_elements = elements.size();
 
@@ -78,6 +85,21 @@ namespace HPM::mesh
                 }
             }
 
+            // Integer element weights: the sum of all weights must fit into the METIS index type.
+            std::vector<METISIndexType> element_weight_pointer(element_weights.size());
+
+            if (!element_weights.empty())
+            {
+                const double max_weight = *std::max_element(element_weights.begin(), element_weights.end());
+                const double sum_weights = std::accumulate(element_weights.begin(), element_weights.end(), 0.0);
+                const double scale = (max_weight > 0.0 ? std::min(1000.0 / max_weight, 0.25 * std::numeric_limits<METISIndexType>::max() / sum_weights) : 0.0);
+
+                for (std::size_t element_index = 0; element_index < num_elements; ++element_index)
+                {
+                    element_weight_pointer[element_index] = std::max(METISIndexType{1}, static_cast<METISIndexType>(std::llround(element_weights[element_index] * scale)));
+                }
+            }
+
             // Allocate memory for the result of the partitioning.
             //    - a container that holds for each element the index of the partition it belongs to
             //    - a container that holds for each node the index of the partition it belongs to
@@ -118,7 +140,7 @@ namespace HPM::mesh
                                             const_cast<METISIndexType*>(&n_nodes),        // numbr nodes to partition
                                             element_pointer.data(),                       // elm pointers array
                                             node_pointer.data(),                          // elm indices array
-                                            nullptr,                                      // == nullptr, array of FE-weights, equal weights
+                                            (element_weights.empty() ? nullptr : element_weight_pointer.data()), // array of FE-weights (nullptr: equal weights)
                                             nullptr,                                      // == nullptr, size of FE(s); equal for all FEs
                                             const_cast<METISIndexType*>(&n_common_nodes), // number of common vertices between FEs needed to "create" an edge between two FEs
                                             const_cast<METISIndexType*>(&n_partitions),   // number of partitions
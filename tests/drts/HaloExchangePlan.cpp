@@ -0,0 +1,225 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/drts/HaloExchangePlan.hpp>
+
+using namespace HPM;
+
+//! In these tests, the processes (L1 partitions) of a partitioned mesh are emulated within one process: each one has its own mesh and buffers,
+//! and the messages are copied in memory.
+class HaloExchangePlanTest : public ::testing::Test
+{
+    protected:
+    using CoordinateT = dataType::Vec<double, 3>;
+    using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+    // 1 dof per node and 2 per cell.
+    using DofH = dataType::ConstexprArray<std::size_t, 1, 0, 0, 2, 0>;
+    // 1 dof per cell.
+    using DofE = dataType::ConstexprArray<std::size_t, 0, 0, 0, 1, 0>;
+    using BufferH = DistributedBuffer<double, PartitionedBoxMesh, DofH>;
+    using BufferE = DistributedBuffer<CoordinateT, PartitionedBoxMesh, DofE>;
+
+    static constexpr std::size_t NumProcesses = 4;
+
+    struct Process
+    {
+        Process(const std::size_t rank)
+            : rank(rank), mesh(mesh::BoxMeshGenerator{{4, 4, 8}}.CreatePartitionedMesh<PartitionedBoxMesh>({NumProcesses, 2}, rank)), fieldH(rank, mesh), fieldE(rank, mesh)
+        {
+            // Initialize the dofs owned by this process.
+            for (const std::size_t L2 : mesh.L1PToL2P(rank))
+            {
+                for (const auto& node : mesh.L2PToEntity<0>(L2))
+                {
+                    for (const std::size_t dof : fieldH.GetDofIndices<0>(node.GetTopology().GetIndex()))
+                    {
+                        fieldH[dof] = GetValue(dof);
+                    }
+                }
+
+                for (const auto& cell : mesh.L2PToEntity<3>(L2))
+                {
+                    for (const std::size_t dof : fieldH.GetDofIndices<3>(cell.GetTopology().GetIndex()))
+                    {
+                        fieldH[dof] = GetValue(dof);
+                    }
+
+                    for (const std::size_t dof : fieldE.GetDofIndices<3>(cell.GetTopology().GetIndex()))
+                    {
+                        fieldE[dof] = {GetValue(dof), 2 * GetValue(dof), 3 * GetValue(dof)};
+                    }
+                }
+            }
+        }
+
+        template <typename... MeshLoops>
+        auto CreatePlan(const MeshLoops&... mesh_loops)
+        {
+            return drts::HaloExchangePlan{std::tie(fieldH, fieldE), mesh_loops...};
+        }
+
+        // The surface kernel of the Maxwell solver reads both fields of the neighboring cells.
+        auto GetSurfaceLoop()
+        {
+            return ForEachIncidence<2>(mesh.GetEntityRange<3>(), std::tuple(Read(NeighboringMeshElementOrSelf(fieldH)), Read(NeighboringMeshElementOrSelf(fieldE)), Write(ContainingMeshElement(fieldH))),
+                                       [](const auto&, const auto&, const auto&, auto&) {});
+        }
+
+        auto GetVolumeLoop()
+        {
+            return ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Read(Node(fieldH)), ReadWrite(Cell(fieldE))), [](const auto&, const auto&, auto&) {});
+        }
+
+        static auto GetValue(const std::size_t dof) -> double { return dof + 1.0; }
+
+        const std::size_t rank;
+        const PartitionedBoxMesh mesh;
+        BufferH fieldH;
+        BufferE fieldE;
+    };
+
+    HaloExchangePlanTest()
+    {
+        for (std::size_t rank = 0; rank < NumProcesses; ++rank)
+        {
+            processes.push_back(std::make_unique<Process>(rank));
+        }
+    }
+
+    //! Exchange the messages of all processes in memory.
+    template <typename PlanT>
+    static auto Exchange(std::vector<PlanT>& plans) -> void
+    {
+        for (auto& plan : plans)
+        {
+            plan.Pack();
+        }
+
+        for (std::size_t rank = 0; rank < plans.size(); ++rank)
+        {
+            for (std::size_t neighbor = 0; neighbor < plans[rank].GetNumNeighbors(); ++neighbor)
+            {
+                auto& other_plan = plans[plans[rank].GetNeighbors()[neighbor]];
+                const auto& other_neighbors = other_plan.GetNeighbors();
+                const std::size_t index = std::find(other_neighbors.begin(), other_neighbors.end(), rank) - other_neighbors.begin();
+
+                ASSERT_LT(index, other_neighbors.size());
+                ASSERT_EQ(plans[rank].GetSendMessageSize(neighbor), other_plan.GetReceiveMessageSize(index));
+
+                std::memcpy(other_plan.GetReceiveMessage(index), plans[rank].GetSendMessage(neighbor), plans[rank].GetSendMessageSize(neighbor));
+            }
+        }
+
+        for (auto& plan : plans)
+        {
+            plan.Unpack();
+        }
+    }
+
+    std::vector<std::unique_ptr<Process>> processes;
+};
+
+TEST_F(HaloExchangePlanTest, OneMessagePerNeighbor)
+{
+    auto& process = *processes[1];
+    const auto& surface_loop = process.GetSurfaceLoop();
+    const auto& plan = process.CreatePlan(surface_loop);
+
+    // The L1 partitions are slabs along the z-axis: the inner ones have two neighbors.
+    ASSERT_EQ(plan.GetNeighbors(), (std::vector<std::size_t>{0, 2}));
+
+    for (std::size_t neighbor = 0; neighbor < plan.GetNumNeighbors(); ++neighbor)
+    {
+        // Both fields are exchanged within one message: the cells of the halo are the same for both fields.
+        EXPECT_GT(plan.GetSendPositions(neighbor, 0).size(), 0);
+        EXPECT_EQ(plan.GetSendPositions(neighbor, 0).size(), 2 * plan.GetSendPositions(neighbor, 1).size());
+        EXPECT_EQ(plan.GetReceivePositions(neighbor, 0).size(), 2 * plan.GetReceivePositions(neighbor, 1).size());
+        EXPECT_GE(plan.GetSendMessageSize(neighbor), plan.GetSendPositions(neighbor, 0).size() * sizeof(double) + plan.GetSendPositions(neighbor, 1).size() * sizeof(CoordinateT));
+        EXPECT_GE(plan.GetReceiveMessageSize(neighbor), plan.GetReceivePositions(neighbor, 0).size() * sizeof(double) + plan.GetReceivePositions(neighbor, 1).size() * sizeof(CoordinateT));
+    }
+}
+
+TEST_F(HaloExchangePlanTest, Exchange)
+{
+    using PlanT = decltype(processes[0]->CreatePlan(processes[0]->GetSurfaceLoop(), processes[0]->GetVolumeLoop()));
+
+    std::vector<PlanT> plans;
+
+    for (auto& process : processes)
+    {
+        plans.push_back(process->CreatePlan(process->GetSurfaceLoop(), process->GetVolumeLoop()));
+    }
+
+    auto check_halos = [this]() {
+        for (auto& process : processes)
+        {
+            const auto& mesh = process->mesh;
+
+            for (const std::size_t L2 : mesh.L1PToL2P(process->rank))
+            {
+                for (const auto& cell : mesh.L2PToEntity<3>(L2))
+                {
+                    // The nodes of the owned cells.
+                    for (const std::size_t node_index : cell.GetTopology().GetIndicesOfEntitiesWithDimension<0>())
+                    {
+                        for (const std::size_t dof : process->fieldH.GetDofIndices<0>(node_index))
+                        {
+                            EXPECT_EQ(process->fieldH[dof], Process::GetValue(dof));
+                        }
+                    }
+
+                    // The neighboring cells.
+                    for (const std::size_t neighbor_index : cell.GetTopology().GetIndicesOfNeighboringEntities())
+                    {
+                        for (const std::size_t dof : process->fieldH.GetDofIndices<3>(neighbor_index))
+                        {
+                            EXPECT_EQ(process->fieldH[dof], Process::GetValue(dof));
+                        }
+
+                        for (const std::size_t dof : process->fieldE.GetDofIndices<3>(neighbor_index))
+                        {
+                            EXPECT_EQ(process->fieldE[dof][2], 3 * Process::GetValue(dof));
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    Exchange(plans);
+    check_halos();
+
+    // The plans are persistent: overwrite the halos and exchange again.
+    for (std::size_t rank = 0; rank < NumProcesses; ++rank)
+    {
+        for (std::size_t neighbor = 0; neighbor < plans[rank].GetNumNeighbors(); ++neighbor)
+        {
+            for (const std::size_t position : plans[rank].GetReceivePositions(neighbor, 0))
+            {
+                processes[rank]->fieldH.GetData()[position] = -1.0;
+            }
+        }
+    }
+
+    Exchange(plans);
+    check_halos();
+}
+
+TEST_F(HaloExchangePlanTest, UnsupportedLoop)
+{
+    auto& process = *processes[0];
+    const auto& face_loop = ForEachEntity(process.mesh.GetEntityRange<2>(), std::tuple(Read(Cell(process.fieldE))), [](const auto&, const auto&, auto&) {});
+
+    EXPECT_THROW(process.CreatePlan(face_loop), std::runtime_error);
+}
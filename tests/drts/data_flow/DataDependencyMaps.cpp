@@ -6,12 +6,16 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <stdexcept>
 
 #include <HighPerMeshes/auxiliary/ConstexprFor.hpp>
 
 #include <HighPerMeshes/drts/data_flow/DataDependencyMaps.hpp>
 #include <HighPerMeshes/dsl/data_access/AccessPatterns.hpp>
 #include <HighPerMeshes/dsl/loop_types/loop_implementations/DefaultLoopImplementations.hpp>
+#include <HighPerMeshes/dsl/meshes/BoxMeshGenerator.hpp>
+#include <HighPerMeshes/dsl/meshes/GeometricPartitioner.hpp>
 
 #include "../../util/UnitCube.hpp"
 
@@ -89,8 +93,8 @@ class DataDependencyMapsTest : public testing::Test
     }
 
     //! return if collection lhs and rhs are equal
-    template <typename Collection>
-    auto equals(Collection&& lhs, Collection&& rhs) const
+    template <typename LhsCollection, typename RhsCollection>
+    auto equals(LhsCollection&& lhs, RhsCollection&& rhs) const
     {
         return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
@@ -323,3 +327,59 @@ TEST_F(DataDependencyMapsTest, AddMaps)
         }
     }
 }
+
+//! In this test we check that a DataDependencyMap of a partitioned mesh survives a save and load, that a file is rejected for a different mesh
+//! partitioning, access pattern or loop implementation, and that merging is idempotent.
+TEST(DataDependencyMapPersistenceTest, SaveAndLoad)
+{
+    using CoordinateT = dataType::Vec<double, 3>;
+    using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+    using Map = drts::data_flow::DataDependencyMap<3>;
+
+    const auto& neighbors = AccessPatterns::NeighboringMeshElementOrSelfPattern;
+    const auto& self = AccessPatterns::SimplePattern;
+    const ::HPM::internal::ForEachIncidence<3, 2> face_loop;
+    const ::HPM::internal::ForEachEntity<3> cell_loop;
+
+    const mesh::BoxMeshGenerator generator{{4, 4, 8}};
+    const auto& mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 4}, 0);
+    // Same entities and number of L2 partitions, but a different cell partitioning.
+    const auto& repartitioned_mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 4}, 0, mesh::RcbPartitioner{});
+    const auto& other_mesh = mesh::BoxMeshGenerator{{2, 2, 8}}.CreatePartitionedMesh<PartitionedBoxMesh>({2, 4}, 0);
+    const Map map{mesh, neighbors, face_loop};
+
+    ASSERT_EQ(map.GetNumL2Partitions(), 8);
+    ASSERT_EQ(repartitioned_mesh.GetNumEntities(), mesh.GetNumEntities());
+
+    map.Save("ddm_test.ddm", mesh);
+
+    EXPECT_TRUE(Map::Load("ddm_test.ddm", mesh, neighbors, face_loop) == map);
+    EXPECT_THROW(Map::Load("ddm_test.ddm", other_mesh, neighbors, face_loop), std::runtime_error);
+    EXPECT_THROW(Map::Load("ddm_test.ddm", repartitioned_mesh, neighbors, face_loop), std::runtime_error);
+    EXPECT_THROW(Map::Load("ddm_test.ddm", mesh, self, cell_loop), std::runtime_error);
+    EXPECT_THROW(Map::Load("ddm_test.ddm", mesh, neighbors, ::HPM::internal::ForEachIncidence<3, 1>{}), std::runtime_error);
+    EXPECT_THROW(Map::Load("ddm_test_missing.ddm", mesh, neighbors, face_loop), std::runtime_error);
+
+    // The file belongs to another access pattern and loop: the map is computed and the file is replaced.
+    const Map self_map{mesh, self, cell_loop};
+
+    ASSERT_TRUE(self_map != map);
+    EXPECT_TRUE(Map::LoadOrCreate("ddm_test.ddm", mesh, self, cell_loop) == self_map);
+    EXPECT_TRUE(Map::Load("ddm_test.ddm", mesh, self, cell_loop) == self_map);
+    EXPECT_THROW(Map::Load("ddm_test.ddm", mesh, neighbors, face_loop), std::runtime_error);
+
+    // The file belongs to another mesh: the map is computed and the file is replaced.
+    const Map other_map{other_mesh, neighbors, face_loop};
+
+    EXPECT_TRUE(Map::LoadOrCreate("ddm_test.ddm", other_mesh, neighbors, face_loop) == other_map);
+    EXPECT_TRUE(Map::Load("ddm_test.ddm", other_mesh, neighbors, face_loop) == other_map);
+
+    std::remove("ddm_test.ddm");
+
+    Map merged;
+
+    merged += map;
+    EXPECT_TRUE(merged == map);
+    merged += map;
+    EXPECT_TRUE(merged == map);
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <HighPerMeshes/drts/data_flow/GraphAnalysis.hpp>
+
+using namespace HPM;
+using namespace HPM::drts::data_flow;
+
+//!
+//! \brief A diamond-shaped step with a loop-carried dependency: A -> {B, C} -> D -> A (next step).
+//!
+class GraphAnalysisTest : public ::testing::Test
+{
+    protected:
+    Graph<std::string> graph;
+    std::size_t A, B, C, D;
+    const std::vector<double> durations{0.0, 1.0, 2.0, 1.0, 1.0};
+
+    void SetUp() override
+    {
+        A = graph.AddVertex();
+        graph.AddDependency(A, "w", AccessMode::Read);
+        graph.AddDependency(A, "x", AccessMode::Write);
+
+        B = graph.AddVertex();
+        graph.AddDependency(B, "x", AccessMode::Read);
+        graph.AddDependency(B, "y", AccessMode::Write);
+
+        C = graph.AddVertex();
+        graph.AddDependency(C, "x", AccessMode::Read);
+        graph.AddDependency(C, "z", AccessMode::Write);
+
+        D = graph.AddVertex();
+        graph.AddDependency(D, "y", AccessMode::Read);
+        graph.AddDependency(D, "z", AccessMode::Read);
+        graph.AddDependency(D, "w", AccessMode::Write);
+
+        graph.Finalize();
+    }
+};
+
+TEST_F(GraphAnalysisTest, CriticalPath)
+{
+    const auto& analysis = AnalyzeSchedule(graph, durations);
+    const std::vector<std::pair<std::size_t, std::size_t>> critical_path{{0, A}, {0, B}, {0, D}};
+
+    EXPECT_DOUBLE_EQ(analysis.total_work, 5.0);
+    EXPECT_DOUBLE_EQ(analysis.critical_path_length, 4.0);
+    EXPECT_DOUBLE_EQ(analysis.GetAverageParallelism(), 1.25);
+    EXPECT_EQ(analysis.critical_path, critical_path);
+    EXPECT_EQ(analysis.parallelism, (std::vector<std::size_t>{1, 2, 1}));
+    EXPECT_TRUE(analysis.IsCritical(B));
+    EXPECT_FALSE(analysis.IsCritical(C));
+
+    // Without durations, each task takes one unit of time.
+    EXPECT_DOUBLE_EQ(AnalyzeSchedule(graph).critical_path_length, 3.0);
+}
+
+TEST_F(GraphAnalysisTest, LoopCarriedDependencies)
+{
+    const auto& analysis = AnalyzeSchedule(graph, durations, 1, 2);
+    const std::vector<std::pair<std::size_t, std::size_t>> critical_path{{0, A}, {0, B}, {0, D}, {1, A}, {1, B}, {1, D}};
+
+    EXPECT_DOUBLE_EQ(analysis.total_work, 10.0);
+    EXPECT_DOUBLE_EQ(analysis.critical_path_length, 8.0);
+    EXPECT_EQ(analysis.critical_path, critical_path);
+    EXPECT_EQ(analysis.parallelism, (std::vector<std::size_t>{1, 2, 1, 1, 2, 1}));
+}
+
+TEST_F(GraphAnalysisTest, IdleTime)
+{
+    const auto& sequential = AnalyzeSchedule(graph, durations, 1);
+
+    EXPECT_DOUBLE_EQ(sequential.makespan, 5.0);
+    EXPECT_DOUBLE_EQ(sequential.idle_time, 0.0);
+
+    // A, then B and C concurrently, then D: the second worker is idle while A, D and the rest of B run.
+    const auto& parallel = AnalyzeSchedule(graph, durations, 2);
+
+    EXPECT_DOUBLE_EQ(parallel.makespan, 4.0);
+    EXPECT_DOUBLE_EQ(parallel.idle_time, 3.0);
+    EXPECT_DOUBLE_EQ(parallel.GetEfficiency(), 5.0 / 8.0);
+
+    EXPECT_THROW(AnalyzeSchedule(graph, durations, 0), std::runtime_error);
+}
+
+TEST_F(GraphAnalysisTest, TaskDurations)
+{
+    // Loop 1 (vertex B) runs with two threads in step 0, and with one thread in step 1.
+    const std::vector<LoopEvent> events{{0, 1, 0, 0, 0, 0, 1000}, {0, 1, 0, 0, 1, 500, 2000}, {0, 1, 1, 0, 0, 5000, 9000}, {0, 7, 0, 0, 0, 0, 1000}};
+    const auto& task_durations = GetTaskDurations(events, 5, [](const LoopEvent& event) { return event.loop + 1; });
+
+    ASSERT_EQ(task_durations.size(), 5);
+    EXPECT_DOUBLE_EQ(task_durations[B], 3.0E-6);
+    EXPECT_DOUBLE_EQ(task_durations[A], 0.0);
+}
+
+TEST_F(GraphAnalysisTest, Output)
+{
+    const auto& analysis = AnalyzeSchedule(graph, durations, 2, 2);
+    std::ostringstream dot;
+    std::ostringstream json;
+
+    analysis.WriteDot(dot, graph);
+    analysis.WriteJson(json);
+
+    EXPECT_NE(dot.str().find("1 -> 2 [color=red, penwidth=2];"), std::string::npos);
+    EXPECT_NE(dot.str().find("1 -> 3;"), std::string::npos);
+    EXPECT_NE(dot.str().find("4 -> 1 [color=red, penwidth=2, style=dashed];"), std::string::npos);
+    EXPECT_NE(json.str().find("\"critical_path_length\":8,"), std::string::npos);
+    EXPECT_NE(json.str().find("\"parallelism\":[1,2,1,1,2,1]"), std::string::npos);
+}
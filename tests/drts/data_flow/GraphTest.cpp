@@ -371,3 +371,87 @@ TEST_F(GraphTest, AddTwice)
     EXPECT_EQ(countDependencies(), 1);
     EXPECT_EQ(countDependencies(B), 1);
 }
+
+TEST_F(GraphTest, Adjacency)
+{
+    // A -> B -> C, A -> C
+    auto A = graph.AddVertex();
+    graph.AddDependency(A, field, AccessMode::Write);
+
+    auto B = graph.AddVertex();
+    graph.AddDependency(B, field, AccessMode::Read);
+    graph.AddDependency(B, "field2", AccessMode::Write);
+
+    auto C = graph.AddVertex();
+    graph.AddDependency(C, field, AccessMode::Read);
+    graph.AddDependency(C, "field2", AccessMode::Read);
+
+    graph.Finalize();
+
+    auto to_vector = [](const auto& span) { return std::vector<std::size_t>(span.begin(), span.end()); };
+
+    EXPECT_EQ(countDependencies(), 3);
+    EXPECT_EQ(to_vector(graph.GetPredecessors(A)), std::vector<std::size_t>{});
+    EXPECT_EQ(to_vector(graph.GetPredecessors(C)), (std::vector<std::size_t>{A, B}));
+    EXPECT_EQ(to_vector(graph.GetSuccessors(A)), (std::vector<std::size_t>{B, C}));
+
+    // A -> C is implied by A -> B -> C.
+    EXPECT_EQ(graph.ReduceTransitively(), 1);
+    EXPECT_EQ(countDependencies(), 2);
+    EXPECT_EQ(to_vector(graph.GetPredecessors(C)), (std::vector<std::size_t>{B}));
+    EXPECT_EQ(firstDependency(C).producer, B);
+    EXPECT_EQ(firstDependency(C).edge, "field2");
+}
+
+TEST_F(GraphTest, TransitiveReductionAcrossSteps)
+{
+    // A -> B -> C within a step, C -> A and B -> A into the next step.
+    auto A = graph.AddVertex();
+    graph.AddDependency(A, field, AccessMode::Write);
+    graph.AddDependency(A, "field2", AccessMode::Read);
+    graph.AddDependency(A, "field3", AccessMode::Read);
+
+    auto B = graph.AddVertex();
+    graph.AddDependency(B, field, AccessMode::ReadWrite);
+    graph.AddDependency(B, "field3", AccessMode::Write);
+
+    auto C = graph.AddVertex();
+    graph.AddDependency(C, field, AccessMode::Read);
+    graph.AddDependency(C, "field2", AccessMode::Write);
+
+    graph.Finalize();
+
+    EXPECT_EQ(countDependencies(), 4);
+
+    // B -> A (next step) is implied by B -> C -> A (next step).
+    EXPECT_EQ(graph.ReduceTransitively(), 1);
+    EXPECT_EQ(countDependencies(), 3);
+    EXPECT_EQ(countDependencies(A), 1);
+    EXPECT_EQ(firstDependency(A).producer, C);
+    EXPECT_EQ(firstDependency(B).producer, A);
+    EXPECT_EQ(firstDependency(C).producer, B);
+}
+
+TEST_F(GraphTest, TransitiveReductionKeepsCycles)
+{
+    // A <-> B <-> C: no edge is implied by the others, parallel edges are.
+    auto A = graph.AddVertex();
+    graph.AddDependency(A, field, AccessMode::ReadWrite);
+    graph.AddDependency(A, "field2", AccessMode::ReadWrite);
+
+    auto B = graph.AddVertex();
+    graph.AddDependency(B, field, AccessMode::ReadWrite);
+    graph.AddDependency(B, "field2", AccessMode::ReadWrite);
+
+    auto C = graph.AddVertex();
+    graph.AddDependency(C, field, AccessMode::ReadWrite);
+    graph.AddDependency(C, "field2", AccessMode::ReadWrite);
+
+    graph.Finalize();
+
+    EXPECT_EQ(countDependencies(), 6);
+    EXPECT_EQ(graph.ReduceTransitively(), 3);
+    EXPECT_EQ(firstDependency(A).producer, C);
+    EXPECT_EQ(firstDependency(B).producer, A);
+    EXPECT_EQ(firstDependency(C).producer, B);
+}
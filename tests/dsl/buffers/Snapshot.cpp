@@ -0,0 +1,104 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using BoxMesh = mesh::Mesh<CoordinateT, entity::Simplex>;
+
+class SnapshotTest : public ::testing::Test
+{
+    protected:
+    using CellDofT = dataType::ConstexprArray<std::size_t, 0, 0, 0, 4, 0>;
+    using NodeDofT = dataType::ConstexprArray<std::size_t, 1, 0, 0, 0, 2>;
+
+    BoxMesh mesh{mesh::BoxMeshGenerator{{4, 4, 4}}.CreateMesh<BoxMesh>()};
+    Buffer<CoordinateT, BoxMesh, CellDofT> field_e{mesh};
+    Buffer<float, BoxMesh, NodeDofT> field_h{mesh};
+
+    void Fill(const double value)
+    {
+        for (std::size_t i = 0; i < field_e.GetSize(); ++i)
+        {
+            field_e[i] = CoordinateT{value, 2 * value, 1.0 * i};
+        }
+
+        for (std::size_t i = 0; i < field_h.GetSize(); ++i)
+        {
+            field_h[i] = value + i;
+        }
+    }
+
+    void Check(const double value)
+    {
+        for (std::size_t i = 0; i < field_e.GetSize(); ++i)
+        {
+            EXPECT_EQ(field_e[i][0], value);
+            EXPECT_EQ(field_e[i][1], 2 * value);
+            EXPECT_EQ(field_e[i][2], 1.0 * i);
+        }
+
+        for (std::size_t i = 0; i < field_h.GetSize(); ++i)
+        {
+            EXPECT_EQ(field_h[i], static_cast<float>(value + i));
+        }
+    }
+};
+
+TEST_F(SnapshotTest, WriteAndLoad)
+{
+    SnapshotWriter snapshots;
+
+    Fill(1.0);
+    snapshots.Write("snapshot_test_1.hpm", 10, field_e, field_h);
+
+    // The buffers can be modified while the snapshot is written.
+    Fill(2.0);
+    snapshots.Write("snapshot_test_2.hpm", 20, field_e, field_h);
+    Fill(3.0);
+    snapshots.Wait();
+
+    const auto& report = snapshots.GetReport();
+
+    EXPECT_EQ(report.num_snapshots, 2);
+    EXPECT_GT(report.bytes, 2 * (field_e.GetSize() * sizeof(CoordinateT) + field_h.GetSize() * sizeof(float)));
+    EXPECT_GE(report.write_time, 0.0);
+    EXPECT_LE(report.GetHiddenTime(), report.write_time);
+    EXPECT_GE(report.GetHiddenFraction(), 0.0);
+    EXPECT_LE(report.GetHiddenFraction(), 1.0);
+
+    EXPECT_EQ(LoadSnapshot("snapshot_test_1.hpm", field_e, field_h), 10);
+    Check(1.0);
+    EXPECT_EQ(LoadSnapshot("snapshot_test_2.hpm", field_e, field_h), 20);
+    Check(2.0);
+
+    // Mismatches: number of buffers, order of the buffers, mesh.
+    BoxMesh other_mesh{mesh::BoxMeshGenerator{{4, 4, 3}}.CreateMesh<BoxMesh>()};
+    Buffer<float, BoxMesh, NodeDofT> other_field_h{other_mesh};
+
+    EXPECT_THROW(LoadSnapshot("snapshot_test_1.hpm", field_e), std::runtime_error);
+    EXPECT_THROW(LoadSnapshot("snapshot_test_1.hpm", field_h, field_e), std::runtime_error);
+    EXPECT_THROW(LoadSnapshot("snapshot_test_1.hpm", field_e, other_field_h), std::runtime_error);
+    EXPECT_THROW(LoadSnapshot("snapshot_test_3.hpm", field_e, field_h), std::runtime_error);
+
+    std::remove("snapshot_test_1.hpm");
+    std::remove("snapshot_test_2.hpm");
+}
+
+TEST_F(SnapshotTest, BackgroundError)
+{
+    SnapshotWriter snapshots;
+
+    snapshots.Write("no_such_directory/snapshot.hpm", 0, field_h);
+
+    EXPECT_THROW(snapshots.Wait(), std::runtime_error);
+}
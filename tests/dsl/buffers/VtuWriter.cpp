@@ -0,0 +1,240 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#if defined(HPM_ENABLE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include <HighPerMeshes.hpp>
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+
+//!
+//! \brief Read a file.
+//!
+static auto ReadFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file)
+    {
+        throw std::runtime_error("error: could not open file: " + filename);
+    }
+
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//!
+//! \brief Get all (decoded) data arrays of a `.vtu` file by name: the points are named "Points".
+//!
+static auto ReadArrays(const std::string& filename, const bool compressed)
+{
+    const std::string content = ReadFile(filename);
+    const std::size_t appended_data = content.find('_', content.find("<AppendedData")) + 1;
+    const std::regex data_array{"<DataArray type=\"\\w+\"(?: Name=\"(\\w+)\")? NumberOfComponents=\"\\d+\" format=\"appended\" offset=\"(\\d+)\"/>"};
+    std::map<std::string, std::string> arrays;
+
+    for (auto it = std::sregex_iterator(content.begin(), content.begin() + appended_data, data_array); it != std::sregex_iterator(); ++it)
+    {
+        const std::string name = ((*it)[1].matched ? (*it)[1].str() : "Points");
+        const char* data = content.data() + appended_data + std::stoul((*it)[2].str());
+        std::uint64_t size;
+
+        if (!compressed)
+        {
+            std::memcpy(&size, data, sizeof(size));
+            arrays[name] = std::string(data + sizeof(size), size);
+
+            continue;
+        }
+
+#if defined(HPM_ENABLE_ZLIB)
+        std::uint64_t header[3];
+
+        std::memcpy(header, data, sizeof(header));
+
+        std::vector<std::uint64_t> compressed_sizes(header[0]);
+        const char* block = data + sizeof(header) + header[0] * sizeof(std::uint64_t);
+        std::string& array = arrays[name];
+
+        std::memcpy(compressed_sizes.data(), data + sizeof(header), compressed_sizes.size() * sizeof(std::uint64_t));
+
+        for (std::size_t i = 0; i < header[0]; ++i)
+        {
+            uLongf block_size = (i + 1 == header[0] ? header[2] : header[1]);
+            const std::size_t position = array.size();
+
+            array.resize(position + block_size);
+            EXPECT_EQ(uncompress(reinterpret_cast<Bytef*>(&array[position]), &block_size, reinterpret_cast<const Bytef*>(block), compressed_sizes[i]), Z_OK);
+            block += compressed_sizes[i];
+        }
+#endif
+    }
+
+    return arrays;
+}
+
+template <typename T>
+static auto GetValues(const std::string& data)
+{
+    std::vector<T> values(data.size() / sizeof(T));
+
+    std::memcpy(values.data(), data.data(), data.size());
+
+    return values;
+}
+
+class VtuWriterTest : public ::testing::Test
+{
+    protected:
+    VtuWriterTest() : mesh(mesh::BoxMeshGenerator{{2, 2, 4}}.CreatePartitionedMesh<PartitionedBoxMesh>({1, 2}, 0))
+    {
+        for (const auto& cell : mesh.GetEntities())
+        {
+            const std::size_t index = cell.GetTopology().GetIndex();
+
+            cell_buffer[2 * index] = index;
+            cell_buffer[2 * index + 1] = -1.0 * index;
+        }
+
+        for (const auto& node : mesh.GetEntities<0>())
+        {
+            const auto coordinates = node.GetTopology().GetNodes()[0];
+
+            node_buffer[node.GetTopology().GetIndex()] = {static_cast<float>(coordinates[0]), static_cast<float>(coordinates[1]), static_cast<float>(coordinates[2])};
+        }
+    }
+
+    //!
+    //! \brief Check the pieces written for `basename`.
+    //!
+    void Check(const std::string& basename, const bool compressed)
+    {
+        const std::string index = ReadFile(basename + ".pvtu");
+
+        EXPECT_NE(index.find("<Piece Source=\"vtu_writer_test_1.vtu\"/>"), std::string::npos);
+        EXPECT_NE(index.find("<PDataArray type=\"Float64\" Name=\"cell\" NumberOfComponents=\"2\"/>"), std::string::npos);
+
+        for (std::size_t piece = 0; piece < 2; ++piece)
+        {
+            auto arrays = ReadArrays(basename + "_" + std::to_string(piece) + ".vtu", compressed);
+            const auto& points = GetValues<double>(arrays["Points"]);
+            const auto& connectivity = GetValues<std::int64_t>(arrays["connectivity"]);
+            const auto& offsets = GetValues<std::int64_t>(arrays["offsets"]);
+            const auto& cell = GetValues<double>(arrays["cell"]);
+            const auto& node = GetValues<float>(arrays["node"]);
+            const auto& average = GetValues<double>(arrays["average"]);
+            const auto& cells = mesh.L2PToEntity(piece);
+            std::size_t i = 0;
+
+            ASSERT_EQ(connectivity.size(), 4 * offsets.size());
+            ASSERT_EQ(cell.size(), 2 * offsets.size());
+            ASSERT_EQ(arrays["types"], std::string(offsets.size(), 10));
+            ASSERT_EQ(node.size(), points.size());
+            ASSERT_EQ(average.size(), points.size() / 3);
+
+            for (const auto& mesh_cell : cells)
+            {
+                const std::size_t index = mesh_cell.GetTopology().GetIndex();
+                const auto& nodes = mesh_cell.GetTopology().GetNodes();
+
+                EXPECT_EQ(cell[2 * i], index);
+                EXPECT_EQ(cell[2 * i + 1], -1.0 * index);
+                EXPECT_EQ(offsets[i], 4 * (i + 1));
+
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    const std::size_t local_node = connectivity[4 * i + j];
+
+                    for (std::size_t dimension = 0; dimension < 3; ++dimension)
+                    {
+                        EXPECT_EQ(points[3 * local_node + dimension], nodes[j][dimension]);
+                        EXPECT_EQ(node[3 * local_node + dimension], static_cast<float>(nodes[j][dimension]));
+                    }
+                }
+
+                ++i;
+            }
+
+            EXPECT_EQ(i, offsets.size());
+
+            // The nodes of a piece are sorted by their (global) index.
+            std::vector<std::size_t> node_indices;
+
+            for (const auto& mesh_cell : cells)
+            {
+                const auto& indices = mesh_cell.GetTopology().GetNodeIndices();
+
+                node_indices.insert(node_indices.end(), indices.begin(), indices.end());
+            }
+
+            std::sort(node_indices.begin(), node_indices.end());
+            node_indices.erase(std::unique(node_indices.begin(), node_indices.end()), node_indices.end());
+
+            ASSERT_EQ(node_indices.size(), average.size());
+
+            // The average over all containing cells: the same in all pieces.
+            std::size_t j = 0;
+
+            for (const auto& mesh_node : mesh.GetEntities<0>(node_indices))
+            {
+                double sum = 0.0;
+
+                for (const std::size_t cell_index : mesh_node.GetTopology().GetIndicesOfAllContainingCells())
+                {
+                    sum += cell_index;
+                }
+
+                EXPECT_DOUBLE_EQ(average[j++], sum / mesh_node.GetTopology().GetNumContainingCells());
+            }
+        }
+    }
+
+    PartitionedBoxMesh mesh;
+    Buffer<double, PartitionedBoxMesh, dataType::ConstexprArray<std::size_t, 0, 0, 0, 2, 0>> cell_buffer{mesh};
+    Buffer<dataType::Vec<float, 3>, PartitionedBoxMesh, dataType::ConstexprArray<std::size_t, 1, 0, 0, 0, 0>> node_buffer{mesh};
+};
+
+TEST_F(VtuWriterTest, Pieces)
+{
+    VtuWriter writer{mesh};
+
+    writer.AddCellData("cell", cell_buffer).AddPointData("node", node_buffer).AddPointData("average", cell_buffer, [](const auto&, const double* dofs, std::size_t) { return dofs[0]; });
+
+    EXPECT_EQ(writer.Write("vtu_writer_test"), 2);
+
+    Check("vtu_writer_test", false);
+
+    EXPECT_THROW(VtuWriter(mesh).AddPointData("cell", cell_buffer), std::runtime_error);
+    EXPECT_THROW(VtuWriter(mesh).AddCellData("node", node_buffer), std::runtime_error);
+}
+
+#if defined(HPM_ENABLE_ZLIB)
+TEST_F(VtuWriterTest, Compressed)
+{
+    VtuWriter writer{mesh, true};
+
+    writer.AddCellData("cell", cell_buffer).AddPointData("node", node_buffer).AddPointData("average", cell_buffer, [](const auto&, const double* dofs, std::size_t) { return dofs[0]; });
+    writer.Write("vtu_writer_test");
+
+    Check("vtu_writer_test", true);
+}
+#endif
@@ -0,0 +1,180 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/third_party/metis/Partitioner.hpp>
+
+#include "../../util/ExpensiveCells.hpp"
+
+using namespace HPM;
+using ::HPM::test::IsExpensive;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+
+//!
+//! \brief Get the sum of the cell weights within each L2 partition.
+//!
+template <typename WeightFuncT>
+static auto GetPartitionWeights(const PartitionedBoxMesh& mesh, WeightFuncT weight)
+{
+    std::vector<double> partition_weights(mesh.GetNumL2Partitions(), 0.0);
+
+    for (std::size_t i_L2 = 0; i_L2 < mesh.GetNumL2Partitions(); ++i_L2)
+    {
+        for (const auto& cell : mesh.L2PToEntity(i_L2))
+        {
+            partition_weights[i_L2] += weight(cell);
+        }
+    }
+
+    return partition_weights;
+}
+
+//!
+//! \brief Get the ratio of the largest and the smallest partition.
+//!
+static auto GetRatio(const std::vector<double>& partition_weights)
+{
+    return *std::max_element(partition_weights.begin(), partition_weights.end()) / *std::min_element(partition_weights.begin(), partition_weights.end());
+}
+
+template <typename PartitionerT>
+class WeightedPartitionerTest : public ::testing::Test
+{
+};
+
+using Partitioners = ::testing::Types<mesh::RcbPartitioner, mesh::HilbertPartitioner>;
+TYPED_TEST_SUITE(WeightedPartitionerTest, Partitioners);
+
+TYPED_TEST(WeightedPartitionerTest, BalancesWeights)
+{
+    const auto& mesh = test::CreateUnitCubeMesh<PartitionedBoxMesh>({8, 8, 8}, {1, 4});
+    auto weight = [](const auto& cell) { return (IsExpensive(cell) ? 10.0 : 1.0); };
+    std::vector<double> weights(mesh.GetNumEntities());
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        weights[cell.GetTopology().GetIndex()] = weight(cell);
+    }
+
+    // The slab layout (along the z-axis) is balanced by the number of cells, but not by the weights.
+    ASSERT_GT(GetRatio(GetPartitionWeights(mesh, weight)), 5.0);
+
+    const auto& weighted_mesh = mesh.Repartition({2, 2}, 0, TypeParam{}.SetElementWeights(weights));
+
+    EXPECT_LT(GetRatio(GetPartitionWeights(weighted_mesh, weight)), 1.1);
+
+    EXPECT_THROW(mesh.Repartition({1, 4}, 0, TypeParam{}.SetElementWeights(std::vector<double>(weights.size() - 1, 1.0))), std::runtime_error);
+}
+
+TEST(WeightedPartitioner, Metis)
+{
+    const auto& mesh = test::CreateUnitCubeMesh<PartitionedBoxMesh>({4, 4, 4}, {1, 2});
+    std::vector<double> weights(mesh.GetNumEntities(), 1.0);
+
+    weights[0] = 1.0e6;
+
+    const auto& weighted_mesh = mesh.Repartition({1, 2}, 0, mesh::MetisPartitioner{}.SetElementWeights(weights));
+
+    EXPECT_EQ(weighted_mesh.GetNumEntities(), mesh.GetNumEntities());
+}
+
+TEST(WeightedPartitioner, InvalidWeights)
+{
+    const auto& mesh = test::CreateUnitCubeMesh<PartitionedBoxMesh>({2, 2, 2}, {1, 1});
+
+    EXPECT_THROW(mesh::RcbPartitioner{}.SetElementWeights({1.0, -1.0}), std::runtime_error);
+    EXPECT_THROW(mesh.Repartition({1, 1}, 0, mesh::SimplePartitioner{}.SetElementWeights(std::vector<double>(mesh.GetNumEntities(), 1.0))), std::runtime_error);
+}
+
+//!
+//! \brief A loop body that spends (simulated) time on each cell: the expensive cells take 20 times as long as the others.
+//!
+static auto Work = [](const auto& cell, const auto&, auto&) { test::SpendTime(cell); };
+
+TEST(CostProfiler, CellCosts)
+{
+    const auto& mesh = test::CreateUnitCubeMesh<PartitionedBoxMesh>({4, 4, 4}, {1, 2});
+    SequentialDispatcher<CostProfiler<CostGranularity::Cell, test::ManualClock>> dispatcher;
+    auto& profiler = dispatcher.GetInstrumentation();
+
+    profiler.SetNumProfiledSteps(2);
+    dispatcher.Execute(iterator::Range{4}, ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(), Work));
+
+    EXPECT_EQ(profiler.GetNumProfiledSteps(), 2);
+    EXPECT_TRUE(profiler.IsComplete());
+
+    // Each expensive cell costs more than any cheap cell.
+    const auto& costs = profiler.GetCellCosts();
+    double min_expensive_cost = std::numeric_limits<double>::max();
+    double max_cheap_cost = 0.0;
+
+    ASSERT_EQ(costs.size(), mesh.GetNumEntities());
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const double cost = costs[cell.GetTopology().GetIndex()];
+
+        EXPECT_GT(cost, 0.0);
+
+        if (IsExpensive(cell))
+        {
+            min_expensive_cost = std::min(min_expensive_cost, cost);
+        }
+        else
+        {
+            max_cheap_cost = std::max(max_cheap_cost, cost);
+        }
+    }
+
+    EXPECT_GT(min_expensive_cost, 10.0 * max_cheap_cost);
+
+    // A re-partitioning with the measured costs: the slab layout puts all expensive cells into one partition, the balanced mesh distributes them evenly.
+    const auto& balanced_mesh = mesh.Repartition({1, 2}, 0, mesh::RcbPartitioner{}.SetElementWeights(profiler.GetCellWeights(mesh)));
+    const auto& num_expensive_cells = GetPartitionWeights(balanced_mesh, [](const auto& cell) { return (IsExpensive(cell) ? 1.0 : 0.0); });
+
+    EXPECT_LT(GetRatio(num_expensive_cells), 1.25);
+    EXPECT_LT(GetRatio(GetPartitionWeights(balanced_mesh, [](const auto& cell) { return (IsExpensive(cell) ? 20.0 : 1.0); })), 1.1);
+}
+
+TEST(CostProfiler, PartitionCosts)
+{
+    const auto& mesh = test::CreateUnitCubeMesh<PartitionedBoxMesh>({4, 4, 4}, {1, 2});
+    SequentialDispatcher<CostProfiler<CostGranularity::Partition, test::ManualClock>> dispatcher;
+    auto& profiler = dispatcher.GetInstrumentation();
+
+    profiler.SetNumProfiledSteps(1);
+    dispatcher.Execute(iterator::Range{2}, ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(), Work));
+
+    // The slab partition that contains the expensive cells (z < 0.25) is the expensive one.
+    const auto& costs = profiler.GetPartitionCosts();
+    const auto& num_expensive_cells = GetPartitionWeights(mesh, [](const auto& cell) { return (IsExpensive(cell) ? 1.0 : 0.0); });
+    const std::size_t expensive_partition = (num_expensive_cells[0] > num_expensive_cells[1] ? 0 : 1);
+
+    ASSERT_EQ(costs.size(), 2);
+    EXPECT_GT(costs[expensive_partition], 2.0 * costs[1 - expensive_partition]);
+
+    // All cells of a partition get the same weight.
+    const auto& weights = profiler.GetCellWeights(mesh);
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        EXPECT_DOUBLE_EQ(weights[cell.GetTopology().GetIndex()], costs[mesh.CellToL2P(cell.GetTopology().GetIndex())] / (mesh.GetNumEntities() / 2));
+    }
+
+    profiler.Reset();
+
+    EXPECT_EQ(profiler.GetNumProfiledSteps(), 0);
+    EXPECT_EQ(profiler.GetPartitionCosts()[expensive_partition], 0.0);
+}
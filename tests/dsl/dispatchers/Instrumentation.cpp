@@ -0,0 +1,142 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/dsl/meshes/PartitionedMesh.hpp>
+#include <HighPerMeshes/third_party/metis/Partitioner.hpp>
+
+#include "../../util/Grid.hpp"
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+static constexpr std::size_t NumSteps = 3;
+
+TEST(InstrumentationTest, NoInstrumentationIsEmpty)
+{
+    EXPECT_TRUE(std::is_empty_v<NoInstrumentation>);
+    EXPECT_TRUE(std::is_empty_v<NoInstrumentation::Scope>);
+}
+
+TEST(InstrumentationTest, DefaultLoops)
+{
+    UnitCube cube;
+    SequentialDispatcher<LoopTimer> dispatcher;
+    std::vector<std::size_t> visits(cube.mesh.GetNumEntities(), 0);
+
+    const auto& cells = cube.mesh.GetEntityRange<3>();
+    auto count = [&visits](const auto& cell, const auto&, auto&) { ++visits[cell.GetTopology().GetIndex()]; };
+
+    dispatcher.Execute(iterator::Range{NumSteps}, ForEachEntity(cells, std::tuple(), count), ForEachEntity(cells, std::tuple(), count));
+
+    const auto& timer = dispatcher.GetInstrumentation();
+    const auto& events = timer.GetEvents();
+
+    // One event per loop and step: the default loops are measured as a whole.
+    ASSERT_EQ(events.size(), 2 * NumSteps);
+    EXPECT_EQ(timer.GetNumExecutions(), 1);
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_EQ(events[i].execution, 0);
+        EXPECT_EQ(events[i].loop, i % 2);
+        EXPECT_EQ(events[i].step, i / 2);
+        EXPECT_EQ(events[i].partition, 0);
+        EXPECT_LE(events[i].begin, events[i].end);
+    }
+
+    EXPECT_GT(timer.GetWallTime(0, 0).count(), 0);
+    EXPECT_EQ(timer.GetWallTime(1, 0).count(), 0);
+
+    for (const std::size_t num_visits : visits)
+    {
+        EXPECT_EQ(num_visits, 2 * NumSteps);
+    }
+}
+
+TEST(InstrumentationTest, OpenMPLoops)
+{
+    UnitCube cube;
+    SequentialDispatcher<LoopTimer> dispatcher;
+
+    dispatcher.Execute(iterator::Range{NumSteps},
+                       ForEachEntity(cube.mesh.GetEntityRange<3>(), std::tuple(), [](const auto&, const auto&, auto&) {}, internal::OpenMP_ForEachEntity<3>{}),
+                       ForEachIncidence<2>(cube.mesh.GetEntityRange<3>(), std::tuple(), [](const auto&, const auto&, const auto&, auto&) {}, internal::OpenMP_ForEachIncidence<3, 2>{}));
+
+    const auto& events = dispatcher.GetInstrumentation().GetEvents();
+
+    // At least one event per loop and step: one for each thread.
+    for (std::size_t loop = 0; loop < 2; ++loop)
+    {
+        for (std::size_t step = 0; step < NumSteps; ++step)
+        {
+            EXPECT_GE(std::count_if(events.begin(), events.end(), [&](const auto& event) { return event.loop == loop && event.step == step; }), 1);
+        }
+    }
+}
+
+TEST(InstrumentationTest, Partitions)
+{
+    using PartitionedMesh = mesh::PartitionedMesh<typename Grid<2>::CoordinateT, entity::Simplex>;
+
+    Grid<2> grid{6, 6};
+    const PartitionedMesh mesh{std::move(grid.nodes), std::move(grid.simplices), std::pair{1, 2}, 0, mesh::MetisPartitioner{}};
+    SequentialDispatcher<LoopTimer> dispatcher;
+    std::vector<std::size_t> visits(mesh.GetNumEntities(), 0);
+
+    dispatcher.Execute(iterator::Range{1}, ForEachEntity(mesh.GetEntityRange<2>(), std::tuple(), [&visits](const auto& cell, const auto&, auto&) { ++visits[cell.GetTopology().GetIndex()]; }));
+
+    const auto& events = dispatcher.GetInstrumentation().GetEvents();
+
+    // All L2 partitions are executed: each cell is visited exactly once.
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_NE(events[0].partition, events[1].partition);
+
+    for (const std::size_t num_visits : visits)
+    {
+        EXPECT_EQ(num_visits, 1);
+    }
+}
+
+TEST(InstrumentationTest, ChromeTrace)
+{
+    UnitCube cube;
+    SequentialDispatcher<LoopTimer> dispatcher;
+
+    dispatcher.Execute(iterator::Range{NumSteps}, ForEachEntity(cube.mesh.GetEntityRange<3>(), std::tuple(), [](const auto&, const auto&, auto&) {}));
+    dispatcher.GetInstrumentation().SetLoopName(0, 0, "cell \"kernel\"");
+
+    const std::string filename = "instrumentation_test_trace.json";
+
+    dispatcher.GetInstrumentation().WriteChromeTrace(filename);
+
+    std::ifstream file(filename);
+    const std::string trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    std::remove(filename.c_str());
+
+    std::size_t num_events = 0;
+
+    for (std::size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
+    {
+        ++num_events;
+    }
+
+    EXPECT_EQ(num_events, NumSteps);
+    EXPECT_NE(trace.find("\"name\":\"cell \\\"kernel\\\"\""), std::string::npos);
+    EXPECT_NE(trace.find("\"traceEvents\":["), std::string::npos);
+
+    EXPECT_THROW(dispatcher.GetInstrumentation().WriteChromeTrace("/nonexistent/trace.json"), std::runtime_error);
+}
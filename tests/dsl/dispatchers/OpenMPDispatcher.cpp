@@ -0,0 +1,182 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/ExpensiveCells.hpp"
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+using CellBuffer = Buffer<double, PartitionedBoxMesh, dataType::ConstexprArray<std::size_t, 0, 0, 0, 1, 0>, std::allocator<double>>;
+
+static constexpr std::size_t NumSteps = 6;
+
+//!
+//! \brief Create a mesh of the unit cube with 8 slab partitions along the z-axis: the two lowest slabs are expensive.
+//!
+static auto CreateMesh() { return test::CreateUnitCubeMesh<PartitionedBoxMesh>({4, 4, 8}, {1, 8}); }
+
+//!
+//! \brief Execute two dependent mesh loops on the cells and count the visits of each cell.
+//!
+template <typename DispatcherT>
+static auto Execute(DispatcherT& dispatcher, const PartitionedBoxMesh& mesh, std::vector<std::size_t>& visits)
+{
+    CellBuffer a{mesh, {}, {}};
+    CellBuffer b{mesh, {}, {}};
+
+    dispatcher.Execute(iterator::Range{NumSteps},
+                       ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Write(Cell(a))),
+                                     [&visits](const auto& cell, const auto& step, auto& local_view) {
+                                         const std::size_t index = cell.GetTopology().GetIndex();
+
+                                         test::SpendTime(cell);
+                                         std::get<0>(local_view)[0] = static_cast<double>(step + index);
+                                         ++visits[index];
+                                     }),
+                       ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Read(Cell(a)), ReadWrite(Cell(b))),
+                                     [](const auto&, const auto&, auto& local_view) { std::get<1>(local_view)[0] += std::get<0>(local_view)[0]; }));
+
+    return std::vector<double>(b.begin(), b.end());
+}
+
+TEST(OpenMPDispatcherTest, SameResultsAsSequential)
+{
+    const auto& mesh = CreateMesh();
+    std::vector<std::size_t> sequential_visits(mesh.GetNumEntities(), 0);
+    std::vector<std::size_t> visits(mesh.GetNumEntities(), 0);
+    SequentialDispatcher sequential_dispatcher;
+    OpenMPDispatcher dispatcher{2};
+
+    const auto& expected = Execute(sequential_dispatcher, mesh, sequential_visits);
+    const auto& result = Execute(dispatcher, mesh, visits);
+
+    EXPECT_EQ(result, expected);
+
+    // Each cell is visited exactly once per step, also after moving partitions.
+    for (const std::size_t num_visits : visits)
+    {
+        EXPECT_EQ(num_visits, NumSteps);
+    }
+
+    EXPECT_EQ(dispatcher.GetOwners().size(), mesh.GetNumL2Partitions());
+}
+
+TEST(OpenMPDispatcherTest, Rebalancing)
+{
+#if defined(_OPENMP)
+    const int max_num_threads = omp_get_max_threads();
+
+    omp_set_num_threads(2);
+#endif
+    const auto& mesh = CreateMesh();
+    std::vector<std::size_t> visits(mesh.GetNumEntities(), 0);
+    // The partition times are measured with the simulated cell costs: the rebalancing is deterministic.
+    OpenMPDispatcher<LoopTimer, test::ManualClock> dispatcher{2};
+
+    Execute(dispatcher, mesh, visits);
+
+#if defined(_OPENMP)
+    omp_set_num_threads(max_num_threads);
+#endif
+
+    const auto& owners = dispatcher.GetOwners();
+    const auto& times = dispatcher.GetPartitionTimes();
+    const std::size_t num_threads = *std::max_element(owners.begin(), owners.end()) + 1;
+
+    ASSERT_EQ(owners.size(), 8);
+
+    // The two lowest slabs are the expensive ones: 20 times the cost of the others.
+    for (std::size_t partition = 0; partition < 8; ++partition)
+    {
+        EXPECT_DOUBLE_EQ(times[partition], (partition < 2 ? 20.0 : 1.0) * times[2]);
+    }
+
+    if (num_threads > 1)
+    {
+        // Initially, thread 0 owns partitions 0-3 (load 42 vs. 4): moving partition 0 to thread 1 balances the loads (22 vs. 24) within the tolerance.
+        EXPECT_EQ(dispatcher.GetNumRebalancings(), 1);
+        EXPECT_EQ(dispatcher.GetNumMovedPartitions(), 1);
+        EXPECT_EQ(owners, (std::vector<std::size_t>{1, 0, 0, 0, 1, 1, 1, 1}));
+    }
+
+    // All loop executions are recorded, by the owning threads.
+    EXPECT_EQ(dispatcher.GetInstrumentation().GetEvents().size(), 2 * 8 * NumSteps);
+}
+
+TEST(OpenMPDispatcherTest, PartitionDomains)
+{
+#if defined(_OPENMP)
+    const int max_num_threads = omp_get_max_threads();
+
+    omp_set_num_threads(2);
+#endif
+    // Two NUMA-level partitions with 4 L2 partitions each.
+    mesh::BoxMeshGenerator generator{{4, 4, 8}};
+    const auto& mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({1, 2, 4}, 0);
+    std::vector<std::size_t> visits(mesh.GetNumEntities(), 0);
+    OpenMPDispatcher dispatcher;
+
+    // Interleaved domains: each group of threads owns every other partition.
+    dispatcher.SetPartitionDomains({0, 1, 0, 1, 0, 1, 0, 1});
+    Execute(dispatcher, mesh, visits);
+
+    const std::size_t num_threads = *std::max_element(dispatcher.GetOwners().begin(), dispatcher.GetOwners().end()) + 1;
+
+    for (std::size_t partition = 0; partition < 8; ++partition)
+    {
+        EXPECT_EQ(dispatcher.GetOwners()[partition], (num_threads > 1 ? partition % 2 : 0));
+    }
+
+    // The NUMA-level partitions of the mesh: contiguous blocks of partitions.
+    dispatcher.SetPartitionDomains(mesh.GetL2PToLxP(1));
+    Execute(dispatcher, mesh, visits);
+
+#if defined(_OPENMP)
+    omp_set_num_threads(max_num_threads);
+#endif
+
+    for (std::size_t partition = 0; partition < 8; ++partition)
+    {
+        EXPECT_EQ(dispatcher.GetOwners()[partition], (num_threads > 1 ? partition / 4 : 0));
+    }
+
+    for (const std::size_t num_visits : visits)
+    {
+        EXPECT_EQ(num_visits, 2 * NumSteps);
+    }
+}
+
+TEST(OpenMPDispatcherTest, AccessedPages)
+{
+    const auto& mesh = CreateMesh();
+    CellBuffer buffer{mesh, {}, {}};
+    const auto& cells = mesh.GetEntityRange<3>();
+    const auto& loop = ForEachEntity(cells, std::tuple(Read(Cell(buffer))), [](const auto&, const auto&, auto&) {});
+    std::vector<void*> pages;
+
+    internal::GetAccessedPages(loop, 0, 4096, pages);
+
+    ASSERT_FALSE(pages.empty());
+
+    for (const auto* page : pages)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(page) % 4096, 0);
+        EXPECT_GE(static_cast<const char*>(page) + 4096, reinterpret_cast<const char*>(buffer.GetData()));
+        EXPECT_LE(static_cast<const char*>(page), reinterpret_cast<const char*>(buffer.GetData() + buffer.GetSize()));
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+TEST(PerfCountersTest, Difference)
+{
+    internal::PerfEventGroup::Sample begin, end;
+
+    begin.values[0] = 10;
+    end.time_enabled = 200;
+    end.time_running = 200;
+    end.values[0] = 110;
+
+    EXPECT_EQ(internal::PerfEventGroup::GetDifference(begin, end)[0], 100);
+
+    // Multiplexed counters are extrapolated to the time enabled.
+    end.time_running = 100;
+
+    EXPECT_EQ(internal::PerfEventGroup::GetDifference(begin, end)[0], 200);
+}
+
+TEST(PerfCountersTest, Loops)
+{
+    constexpr std::size_t NumSteps = 3;
+    UnitCube cube;
+    SequentialDispatcher<PerfCounterTimer> dispatcher;
+    double sum = 0.0;
+
+    dispatcher.Execute(iterator::Range{NumSteps},
+                       ForEachEntity(cube.mesh.GetEntityRange<3>(), std::tuple(), [&sum](const auto& cell, const auto&, auto&) { sum += cell.GetGeometry().GetAbsJacobianDeterminant(); }),
+                       ForEachEntity(cube.mesh.GetEntityRange<3>(), std::tuple(), [](const auto&, const auto&, auto&) {}, internal::OpenMP_ForEachEntity<3>{}));
+
+    auto& counters = dispatcher.GetInstrumentation();
+    const auto& events = counters.GetPerfCounterEvents();
+
+    // The jacobian determinant of a tetrahedron is 6 times its volume.
+    EXPECT_DOUBLE_EQ(sum, NumSteps * 6.0);
+    // The times are recorded in any case.
+    EXPECT_EQ(counters.GetEvents().size(), events.size());
+    EXPECT_GE(events.size(), 2 * NumSteps);
+
+    const auto& counts = counters.GetCounts(0, 0);
+
+    for (std::size_t counter = 0; counter < NumPerfCounters; ++counter)
+    {
+        // Unavailable counters (e.g., in containers) are 0.
+        if (!counters.IsAvailable(static_cast<PerfCounter>(counter)))
+        {
+            EXPECT_EQ(counts[counter], 0);
+        }
+    }
+
+    if (counters.IsAvailable(PerfCounter::Instructions))
+    {
+        EXPECT_GT(counts[static_cast<std::size_t>(PerfCounter::Instructions)], 0);
+    }
+
+    counters.SetLoopName(0, 0, "volume");
+
+    std::ostringstream report;
+
+    counters.WritePerfCounterReport(report);
+
+    EXPECT_NE(report.str().find("volume"), std::string::npos);
+    EXPECT_EQ(report.str().find("n/a") == std::string::npos, counters.IsAvailable(PerfCounter::Cycles) && counters.IsAvailable(PerfCounter::Instructions) && counters.IsAvailable(PerfCounter::CacheReferences) && counters.IsAvailable(PerfCounter::CacheMisses) && counters.IsAvailable(PerfCounter::BranchMisses) && counters.IsAvailable(PerfCounter::L1DReadMisses));
+
+    counters.Clear();
+
+    EXPECT_TRUE(counters.GetPerfCounterEvents().empty());
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+class RooflineTest : public ::testing::Test, public UnitCube
+{
+    protected:
+    // 2 dofs per cell, 1 per face, 3 per node and 3 global dofs.
+    using DofT = dataType::ConstexprArray<std::size_t, 3, 0, 1, 2, 3>;
+
+    Buffer<double, CubeMesh, DofT> buffer{mesh};
+    Buffer<float, CubeMesh, DofT> float_buffer{mesh};
+
+    static constexpr std::size_t NumNodes = 8;
+    // The central cell shares its faces with the 4 corner cells.
+    static constexpr std::size_t NumFaces = 4 * NumCells - 4;
+};
+
+TEST_F(RooflineTest, EntityLoop)
+{
+    const auto& traffic = GetDataTraffic(ForEachEntity(
+        mesh.GetEntityRange<3>(), std::tuple(Read(Cell(buffer)), Write(Cell(float_buffer)), Read(Node(buffer)), ReadWrite(Face(buffer)), Read(Global(buffer))),
+        [](const auto&, const auto&, auto&) {}));
+
+    EXPECT_EQ(traffic.num_iterations, NumCells);
+    EXPECT_EQ(traffic.bytes_read, NumCells * 2 * sizeof(double) + NumNodes * 3 * sizeof(double) + NumFaces * sizeof(double) + 3 * sizeof(double));
+    EXPECT_EQ(traffic.bytes_written, NumCells * 2 * sizeof(float) + NumFaces * sizeof(double));
+    EXPECT_EQ(traffic.GetBytes(), traffic.bytes_read + traffic.bytes_written);
+}
+
+TEST_F(RooflineTest, IncidenceLoop)
+{
+    const auto& traffic = GetDataTraffic(ForEachIncidence<2>(
+        mesh.GetEntityRange<3>(), std::tuple(Read(NeighboringMeshElementOrSelf(buffer)), Write(ContainingMeshElement(float_buffer)), Read(Face(buffer))),
+        [](const auto&, const auto&, const auto&, auto&) {}));
+
+    // Each cell is accessed by several faces, but counted only once.
+    EXPECT_EQ(traffic.num_iterations, 4 * NumCells);
+    EXPECT_EQ(traffic.bytes_read, NumCells * 2 * sizeof(double) + NumFaces * sizeof(double));
+    EXPECT_EQ(traffic.bytes_written, NumCells * 2 * sizeof(float));
+}
+
+TEST_F(RooflineTest, RooflineTimer)
+{
+    constexpr std::size_t NumSteps = 4;
+    SequentialDispatcher<RooflineTimer> dispatcher;
+
+    dispatcher.Execute(iterator::Range{NumSteps}, ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Read(Cell(buffer)), Write(Cell(float_buffer))), [](const auto& cell, const auto&, auto& lvs) {
+                           auto& output = std::get<1>(lvs);
+                           output[0] = std::get<0>(lvs)[1] * cell.GetGeometry().GetAbsJacobianDeterminant();
+                       }));
+
+    auto& timer = dispatcher.GetInstrumentation();
+
+    timer.SetLoopName(0, 0, "scale");
+    timer.SetFlopsPerIteration(0, 0, 10.0);
+
+    const double peak_bandwidth = MeasureStreamBandwidth(1UL << 16, 2);
+    const auto& metrics = timer.GetRoofline(0, 0, peak_bandwidth);
+    const std::size_t bytes_per_step = NumCells * 2 * (sizeof(double) + sizeof(float));
+
+    EXPECT_GT(peak_bandwidth, 0.0);
+    EXPECT_EQ(timer.GetDataTraffic(0, 0).GetBytes(), bytes_per_step);
+    EXPECT_EQ(metrics.bytes, NumSteps * bytes_per_step);
+    EXPECT_DOUBLE_EQ(metrics.flops, 10.0 * NumCells * NumSteps);
+    EXPECT_DOUBLE_EQ(metrics.arithmetic_intensity, metrics.flops / metrics.bytes);
+    EXPECT_GT(metrics.bandwidth, 0.0);
+    EXPECT_DOUBLE_EQ(metrics.fraction_of_peak, metrics.bandwidth / peak_bandwidth);
+
+    // The data traffic of the same loop is taken from the cache in subsequent `Execute` calls.
+    dispatcher.Execute(iterator::Range{NumSteps}, ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Read(Cell(buffer)), Write(Cell(float_buffer))), [](const auto&, const auto&, auto&) {}),
+                       ForEachEntity(mesh.GetEntityRange<3>(), std::tuple(Read(Cell(buffer))), [](const auto&, const auto&, auto&) {}));
+
+    EXPECT_EQ(timer.GetDataTraffic(1, 0).GetBytes(), bytes_per_step);
+    EXPECT_EQ(timer.GetDataTraffic(1, 0).num_iterations, NumCells);
+    EXPECT_EQ(timer.GetDataTraffic(1, 1).GetBytes(), NumCells * 2 * sizeof(double));
+
+    std::ostringstream report;
+
+    timer.WriteRooflineReport(report, peak_bandwidth);
+
+    EXPECT_NE(report.str().find("scale"), std::string::npos);
+
+    timer.Clear();
+
+    EXPECT_EQ(timer.GetNumExecutions(), 0);
+    EXPECT_THROW(timer.GetDataTraffic(0, 0), std::out_of_range);
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+class EntityHandleTest : public ::testing::Test, public UnitCube
+{
+};
+
+using CellHandle = entity::EntityHandle<CubeMesh::CellT>;
+
+// An entity type that counts its constructions: handles to it must not construct it unless they are materialized.
+template <typename EntityT>
+struct CountingEntity : public EntityT
+{
+    CountingEntity(const typename EntityT::MeshT& mesh, const std::size_t local_index, const std::size_t index, const std::size_t index_of_containing_cell)
+        : EntityT(mesh, local_index, index, index_of_containing_cell)
+    {
+        ++num_constructions;
+    }
+
+    static inline std::size_t num_constructions = 0;
+};
+
+TEST_F(EntityHandleTest, TriviallyCopyable)
+{
+    EXPECT_TRUE(std::is_trivially_copyable_v<CellHandle>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<CellHandle::CellHandleT>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<entity::EntityHandle<CellHandle::SubEntityT<2>>>);
+}
+
+TEST_F(EntityHandleTest, Materialize)
+{
+    auto it = mesh.GetEntities().begin();
+
+    for (std::size_t i = 0; i < NumCells; ++i, ++it)
+    {
+        const auto& handle = it.GetHandle();
+        const auto& cell = handle.Materialize();
+
+        EXPECT_EQ(handle.GetIndex(), (*it).GetTopology().GetIndex());
+        EXPECT_EQ(cell.GetTopology().GetIndex(), (*it).GetTopology().GetIndex());
+        EXPECT_EQ(cell.GetTopology().GetLocalIndex(), (*it).GetTopology().GetLocalIndex());
+    }
+}
+
+TEST_F(EntityHandleTest, SubEntities)
+{
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const CellHandle handle{mesh, cell.GetTopology().GetIndex()};
+        const auto& faces = handle.GetEntities<2>();
+        std::size_t i = 0;
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            ASSERT_LT(i, faces.size());
+            EXPECT_EQ(faces[i].GetIndex(), face.GetTopology().GetIndex());
+            EXPECT_EQ(faces[i].GetLocalIndex(), face.GetTopology().GetLocalIndex());
+            EXPECT_EQ(faces[i].GetIndexOfContainingCell(), face.GetTopology().GetIndexOfContainingCell());
+            EXPECT_EQ(faces[i].GetIndicesOfEntitiesWithDimension<1>(), face.GetTopology().GetIndicesOfEntitiesWithDimension<1>());
+            EXPECT_EQ(faces[i].Materialize(), face);
+            ++i;
+        }
+
+        EXPECT_EQ(i, faces.size());
+    }
+}
+
+TEST_F(EntityHandleTest, AccessPatterns)
+{
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const CellHandle handle{mesh, cell.GetTopology().GetIndex()};
+        const auto& faces = handle.GetEntities<2>();
+        std::size_t i = 0;
+
+        EXPECT_EQ(AccessPatterns::SimplePattern(handle).GetIndex(), AccessPatterns::SimplePattern(cell).GetTopology().GetIndex());
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            const auto& containing_cell = AccessPatterns::ContainingMeshElementPattern(faces[i]);
+            const auto& neighboring_cell = AccessPatterns::NeighboringMeshElementOrSelfPattern(faces[i]);
+
+            static_assert(std::is_same_v<std::decay_t<decltype(containing_cell)>, CellHandle>);
+            static_assert(std::is_same_v<std::decay_t<decltype(neighboring_cell)>, CellHandle>);
+
+            EXPECT_EQ(containing_cell.GetIndex(), AccessPatterns::ContainingMeshElementPattern(face).GetTopology().GetIndex());
+            EXPECT_EQ(neighboring_cell.GetIndex(), AccessPatterns::NeighboringMeshElementOrSelfPattern(face).GetTopology().GetIndex());
+            ++i;
+        }
+    }
+}
+
+TEST_F(EntityHandleTest, NoEntityConstruction)
+{
+    using CountingCell = CountingEntity<CubeMesh::CellT>;
+    using CountingFace = CountingEntity<CellHandle::SubEntityT<2>>;
+
+    CountingCell::num_constructions = 0;
+    CountingFace::num_constructions = 0;
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const entity::EntityHandle<CountingCell> handle{mesh, cell.GetTopology().GetIndex()};
+
+        EXPECT_EQ(handle.GetIndicesOfEntitiesWithDimension<1>(), cell.GetTopology().GetIndicesOfEntitiesWithDimension<1>());
+        EXPECT_EQ(handle.GetIndicesOfEntitiesWithDimension<2>(), cell.GetTopology().GetIndicesOfEntitiesWithDimension<2>());
+        EXPECT_EQ(handle.GetContainingCell().GetIndex(), cell.GetTopology().GetIndex());
+        EXPECT_EQ(handle.GetEntities<2>().size(), 4U);
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            const auto& face_topology = face.GetTopology();
+            const entity::EntityHandle<CountingFace> face_handle{mesh, face_topology.GetLocalIndex(), face_topology.GetIndex(), face_topology.GetIndexOfContainingCell()};
+
+            EXPECT_EQ(face_handle.GetIndexOfContainingCell(), face_topology.GetIndexOfContainingCell());
+            EXPECT_EQ(face_handle.GetIndexOfNeighboringCell(), face_topology.GetIndexOfNeighboringCell());
+            EXPECT_EQ(face_handle.GetNeighboringCell().GetIndex(), face_topology.GetNeighboringCell().GetTopology().GetIndex());
+            EXPECT_EQ(face_handle.GetIndicesOfEntitiesWithDimension<0>(), face_topology.GetIndicesOfEntitiesWithDimension<0>());
+            EXPECT_EQ(face_handle.GetIndicesOfEntitiesWithDimension<1>(), face_topology.GetIndicesOfEntitiesWithDimension<1>());
+            EXPECT_EQ(face_handle.GetEntities<1>().size(), 3U);
+        }
+    }
+
+    EXPECT_EQ(CountingCell::num_constructions, 0U);
+    EXPECT_EQ(CountingFace::num_constructions, 0U);
+
+    // Only materialization constructs the entity.
+    entity::EntityHandle<CountingCell>{mesh, 0}.Materialize();
+
+    EXPECT_EQ(CountingCell::num_constructions, 1U);
+}
@@ -30,7 +30,7 @@ public:
 
     Buffer<int, std::decay_t<decltype(cube.mesh)>, dataType::ConstexprArray<std::size_t, 1, 1, 1, 1, 0>, std::allocator<int>> field{mesh, {}, {}};
 
-    SequentialDispatcher dispatcher;
+    SequentialDispatcher<> dispatcher;
 
     template <typename Op>
     auto for_each(std::size_t until, Op op)
@@ -0,0 +1,142 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+#include <omp.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/third_party/metis/Partitioner.hpp>
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using BoxMesh = mesh::Mesh<CoordinateT, entity::Simplex>;
+using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+
+//!
+//! \brief Get the volume of all cells and the smallest cell volume.
+//!
+template <typename MeshT>
+static auto GetVolumes(const MeshT& mesh)
+{
+    double volume = 0.0;
+    double min_volume = std::numeric_limits<double>::max();
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const double cell_volume = cell.GetGeometry().GetAbsJacobianDeterminant() / 6.0;
+
+        volume += cell_volume;
+        min_volume = std::min(min_volume, cell_volume);
+    }
+
+    return std::pair{volume, min_volume};
+}
+
+TEST(BoxMeshGenerator, Conforming)
+{
+    const std::array<std::size_t, 3> num_cubes{4, 3, 2};
+    const mesh::BoxMeshGenerator generator{num_cubes};
+    const auto mesh = generator.CreateMesh<BoxMesh>();
+
+    EXPECT_EQ(mesh.GetNumEntities<0>(), 5 * 4 * 3);
+    EXPECT_EQ(mesh.GetNumEntities(), 6 * 4 * 3 * 2);
+    EXPECT_EQ(generator.GetNumCells(), mesh.GetNumEntities());
+
+    // Neighboring cells share complete faces: only the faces on the box surface (2 triangles per square) are boundary faces.
+    std::size_t num_boundary_faces = 0;
+
+    for (const auto& face : mesh.GetEntities<2>())
+    {
+        num_boundary_faces += (face.GetTopology().GetNumContainingCells() == 1 ? 1 : 0);
+    }
+
+    EXPECT_EQ(num_boundary_faces, 2 * 2 * (4 * 3 + 3 * 2 + 4 * 2));
+
+    const auto [volume, min_volume] = GetVolumes(mesh);
+
+    EXPECT_NEAR(volume, 4.0 * 3.0 * 2.0, 1.0E-12);
+    EXPECT_NEAR(min_volume, 1.0 / 6.0, 1.0E-12);
+
+    // Cells are sorted by their (sorted) node indices.
+    const auto& cells = generator.CreateCells();
+
+    EXPECT_TRUE(std::is_sorted(cells.begin(), cells.end()));
+
+    for (const auto& cell : cells)
+    {
+        EXPECT_TRUE(std::is_sorted(cell.begin(), cell.end()));
+    }
+}
+
+TEST(BoxMeshGenerator, GradingAndPerturbation)
+{
+    mesh::BoxMeshGenerator generator{{6, 5, 4}};
+
+    generator.SetDomain({-1.0, 0.0, 0.0}, {1.0, 2.0, 0.5}).SetGrading({4.0, 1.0, 0.5}).SetPerturbation(0.2, 7);
+
+    const auto mesh = generator.CreateMesh<BoxMesh>();
+    const auto [volume, min_volume] = GetVolumes(mesh);
+
+    // The boundary of the box is not perturbed.
+    EXPECT_NEAR(volume, 2.0 * 2.0 * 0.5, 1.0E-12);
+    EXPECT_GT(min_volume, 0.0);
+
+    const auto& nodes = generator.CreateNodes();
+
+    // Grading: the last spacing in x-direction is 4 times the first one.
+    const auto& graded_nodes = mesh::BoxMeshGenerator{generator}.SetPerturbation(0.0).CreateNodes();
+
+    EXPECT_NEAR((graded_nodes[6][0] - graded_nodes[5][0]) / (graded_nodes[1][0] - graded_nodes[0][0]), 4.0, 1.0E-12);
+    EXPECT_DOUBLE_EQ(nodes.back()[0], 1.0);
+
+    // The nodes do not depend on the number of threads.
+    const int num_threads = omp_get_max_threads();
+
+    omp_set_num_threads(3);
+    const auto& nodes_3 = generator.CreateNodes();
+    omp_set_num_threads(num_threads);
+
+    EXPECT_EQ(nodes, nodes_3);
+
+    EXPECT_THROW(generator.SetPerturbation(0.5), std::runtime_error);
+    EXPECT_THROW(generator.SetDomain({0.0, 0.0, 0.0}, {1.0, 0.0, 1.0}), std::runtime_error);
+    EXPECT_THROW(mesh::BoxMeshGenerator({0, 1, 1}), std::runtime_error);
+}
+
+TEST(BoxMeshGenerator, PrePartitioned)
+{
+    const mesh::BoxMeshGenerator generator{{3, 3, 8}};
+    const auto mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 2}, 0);
+
+    ASSERT_EQ(mesh.GetNumL2Partitions(), 4);
+    EXPECT_EQ(mesh.GetNumEntities(), generator.GetNumCells());
+
+    // Each L2 partition is a slab of 2 layers of cubes.
+    for (std::size_t i_L2 = 0; i_L2 < 4; ++i_L2)
+    {
+        for (const auto& cell : mesh.L2PToEntity(i_L2))
+        {
+            const auto& nodes = cell.GetTopology().GetNodes();
+            const double z = (nodes[0][2] + nodes[1][2] + nodes[2][2] + nodes[3][2]) / 4.0;
+
+            EXPECT_EQ(static_cast<std::size_t>(z / 2.0), i_L2);
+        }
+    }
+
+    // The same mesh with a general partitioner.
+    const auto metis_mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 2}, 0, mesh::MetisPartitioner{});
+
+    EXPECT_EQ(metis_mesh.GetNumEntities(), mesh.GetNumEntities());
+    EXPECT_EQ(metis_mesh.GetNumEntities<0>(), mesh.GetNumEntities<0>());
+    EXPECT_EQ(metis_mesh.GetNumEntities<2>(), mesh.GetNumEntities<2>());
+
+    EXPECT_THROW(generator.CreatePartitionedMesh<PartitionedBoxMesh>({3, 3}, 0), std::runtime_error);
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/AllocationCounter.hpp"
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+using ::HPM::test::CountAllocations;
+
+class EntityRangesTest : public ::testing::Test, public UnitCube
+{
+};
+
+TEST_F(EntityRangesTest, IndexedRangeIsAllocationFree)
+{
+    const auto& range = mesh.GetEntityRange<2>();
+    std::size_t sum = 0;
+
+    const std::size_t allocations = CountAllocations([&]() {
+        for (const auto& face : range.GetEntities())
+        {
+            sum += face.GetTopology().GetIndex();
+        }
+
+        for (const auto& face : mesh.GetEntities<2>(range.GetIndices()))
+        {
+            sum += face.GetTopology().GetIndex();
+        }
+    });
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(sum, NumFaces * (NumFaces - 1));
+}
+
+TEST_F(EntityRangesTest, SubEntityIterationIsAllocationFree)
+{
+    std::size_t num_faces = 0;
+    std::size_t num_nodes = 0;
+    std::size_t num_incident_cells = 0;
+
+    const std::size_t allocations = CountAllocations([&]() {
+        for (const auto& cell : mesh.GetEntities())
+        {
+            for (const auto& face : cell.GetTopology().GetSubEntities())
+            {
+                ++num_faces;
+
+                for (const auto& node : face.GetTopology().template GetEntities<0>())
+                {
+                    num_nodes += (node.GetTopology().GetIndex() < NumNodes);
+                }
+
+                for (const auto& incident_cell : face.GetTopology().GetIncidentEntities())
+                {
+                    num_incident_cells += (incident_cell.GetTopology().GetIndex() < NumCells);
+                }
+            }
+        }
+    });
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(num_faces, 4 * NumCells);
+    EXPECT_EQ(num_nodes, 3 * num_faces);
+    // Each of the 4 inner faces has 2 incident cells and is visited from both of them.
+    EXPECT_EQ(num_incident_cells, 4 * NumCells + 4 * 2);
+}
+
+TEST_F(EntityRangesTest, ForEachIncidenceIsAllocationFree)
+{
+    std::size_t num_faces = 0;
+
+    const std::size_t allocations = CountAllocations([&]() {
+        internal::ForEachIncidence<3, 2>{}(mesh.GetEntities(), [&](const auto& face) { num_faces += (face.GetTopology().GetIndex() < NumFaces); });
+    });
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(num_faces, 4 * NumCells);
+}
+
+TEST_F(EntityRangesTest, TemporaryIndices)
+{
+    std::size_t sum = 0;
+
+    for (const auto& cell : mesh.GetEntities(std::vector<std::size_t>{1, 3}))
+    {
+        sum += cell.GetTopology().GetIndex();
+    }
+
+    for (const auto& cell : mesh.GetEntityRange<3>(std::vector<std::size_t>{2, 4}).GetEntities())
+    {
+        sum += cell.GetTopology().GetIndex();
+    }
+
+    EXPECT_EQ(sum, 10);
+}
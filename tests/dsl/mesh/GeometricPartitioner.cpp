@@ -0,0 +1,144 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+#include <HighPerMeshes/third_party/metis/Partitioner.hpp>
+
+using namespace HPM;
+
+using CoordinateT = dataType::Vec<double, 3>;
+using PartitionedBoxMesh = mesh::PartitionedMesh<CoordinateT, entity::Simplex>;
+
+//!
+//! \brief Partition a box mesh and check that all L2 partitions have (almost) the same size.
+//!
+//! \return the quality of the L2 partitioning
+//!
+template <typename PartitionerT>
+static auto Partition(PartitionerT partitioner, const std::pair<std::size_t, std::size_t>& num_partitions)
+{
+    const mesh::BoxMeshGenerator generator{{8, 8, 8}};
+    const std::size_t num_L2_partitions = num_partitions.first * num_partitions.second;
+    const auto& [nodes, cells, cell_to_L2P, node_to_L2P, num_cells_in_L2P_offset, num_nodes_in_L2P_offset] = partitioner.template CreatePartitions<3>(generator.CreateNodes(), generator.CreateCells(), num_partitions);
+
+    EXPECT_EQ(cells.size(), generator.GetNumCells());
+    EXPECT_EQ(num_cells_in_L2P_offset.back(), cells.size());
+    EXPECT_EQ(num_nodes_in_L2P_offset.back(), nodes.size());
+    EXPECT_TRUE(std::all_of(cell_to_L2P.begin(), cell_to_L2P.end(), [&](const std::size_t partition) { return partition < num_L2_partitions; }));
+
+    // Each node belongs to the L2 partition of one of its cells.
+    std::vector<bool> node_in_partition_cell(nodes.size(), false);
+
+    for (std::size_t cell_index = 0; cell_index < cells.size(); ++cell_index)
+    {
+        for (const std::size_t node_index : cells[cell_index])
+        {
+            node_in_partition_cell[node_index] = node_in_partition_cell[node_index] || (node_to_L2P[node_index] == cell_to_L2P[cell_index]);
+        }
+    }
+
+    EXPECT_TRUE(std::all_of(node_in_partition_cell.begin(), node_in_partition_cell.end(), [](const bool value) { return value; }));
+
+    return mesh::GetPartitionQuality<3>(cells, cell_to_L2P, num_L2_partitions);
+}
+
+TEST(GeometricPartitioner, Balanced)
+{
+    for (const auto& num_partitions : {std::pair<std::size_t, std::size_t>{1, 8}, {2, 4}, {3, 1}, {1, 5}})
+    {
+        // 6 * 8^3 cells: the partition sizes differ by at most 1 cell.
+        const double max_imbalance = static_cast<double>((6 * 8 * 8 * 8) / (num_partitions.first * num_partitions.second) + 1) * (num_partitions.first * num_partitions.second) / (6 * 8 * 8 * 8);
+
+        EXPECT_LE(Partition(mesh::RcbPartitioner{}, num_partitions).imbalance, max_imbalance);
+        EXPECT_LE(Partition(mesh::HilbertPartitioner{}, num_partitions).imbalance, max_imbalance);
+    }
+}
+
+TEST(GeometricPartitioner, MorePartitionsThanElements)
+{
+    // 6 cells, 8 partitions: each cell gets its own partition, and 2 partitions are empty.
+    const mesh::BoxMeshGenerator generator{{1, 1, 1}};
+
+    for (const bool weighted : {false, true})
+    {
+        mesh::RcbPartitioner partitioner;
+
+        if (weighted)
+        {
+            partitioner.SetElementWeights({1.0, 5.0, 1.0, 2.0, 1.0, 3.0});
+        }
+
+        const auto& [nodes, cells, cell_to_L2P, node_to_L2P, num_cells_in_L2P_offset, num_nodes_in_L2P_offset] = partitioner.template CreatePartitions<3>(generator.CreateNodes(), generator.CreateCells(), {1, 8});
+        std::vector<std::size_t> partitions = cell_to_L2P;
+
+        static_cast<void>(nodes);
+        static_cast<void>(node_to_L2P);
+        static_cast<void>(num_nodes_in_L2P_offset);
+
+        ASSERT_EQ(cells.size(), 6);
+        EXPECT_EQ(num_cells_in_L2P_offset.back(), 6);
+        EXPECT_TRUE(std::all_of(partitions.begin(), partitions.end(), [](const std::size_t partition) { return partition < 8; }));
+
+        std::sort(partitions.begin(), partitions.end());
+
+        EXPECT_EQ(std::adjacent_find(partitions.begin(), partitions.end()), partitions.end());
+    }
+}
+
+TEST(GeometricPartitioner, QualityComparedToMetis)
+{
+    const auto& metis = Partition(mesh::MetisPartitioner{}, {2, 4});
+    const auto& rcb = Partition(mesh::RcbPartitioner{}, {2, 4});
+    const auto& hilbert = Partition(mesh::HilbertPartitioner{}, {2, 4});
+
+    // RCB cuts the 8x8x8 cube into 8 4x4x4 cubes: 3 planes of 8x8 squares (2 triangles each).
+    EXPECT_EQ(rcb.edge_cut, 3 * 2 * 8 * 8);
+    EXPECT_LE(rcb.edge_cut, 2 * metis.edge_cut);
+    EXPECT_LE(hilbert.edge_cut, 2 * metis.edge_cut);
+    EXPECT_LE(rcb.halo_size, 2 * metis.halo_size);
+    EXPECT_LE(hilbert.halo_size, 2 * metis.halo_size);
+
+    for (const auto& [name, quality] : {std::pair{"metis", metis}, {"rcb", rcb}, {"hilbert", hilbert}})
+    {
+        RecordProperty(std::string(name) + "_edge_cut", static_cast<int>(quality.edge_cut));
+        RecordProperty(std::string(name) + "_halo_size", static_cast<int>(quality.halo_size));
+    }
+}
+
+TEST(GeometricPartitioner, PartitionedMesh)
+{
+    const mesh::BoxMeshGenerator generator{{4, 4, 4}};
+    const auto& rcb_mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 2}, 1, mesh::RcbPartitioner{});
+    const auto& hilbert_mesh = generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 2}, 1, mesh::HilbertPartitioner{});
+
+    for (const auto* mesh : {&rcb_mesh, &hilbert_mesh})
+    {
+        ASSERT_EQ(mesh->GetNumL2Partitions(), 4);
+        EXPECT_EQ(mesh->GetNumEntities(), generator.GetNumCells());
+
+        for (std::size_t i_L2 = 0; i_L2 < 4; ++i_L2)
+        {
+            std::size_t num_cells = 0;
+
+            for (const auto& cell : mesh->L2PToEntity(i_L2))
+            {
+                static_cast<void>(cell);
+                ++num_cells;
+            }
+
+            EXPECT_EQ(num_cells, generator.GetNumCells() / 4);
+        }
+    }
+
+    EXPECT_THROW(generator.CreatePartitionedMesh<PartitionedBoxMesh>({2, 2}, 0, mesh::SimplePartitioner{}), std::runtime_error);
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/Grid.hpp"
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+template <typename GeometryCachePolicy>
+using CubeMeshWithPolicy = mesh::Mesh<CubeCoordinates, entity::Simplex, 3, GeometryCachePolicy>;
+
+using SelectedGeometry = mesh::GeometryCachePolicy<mesh::GeometryQuantity::InverseJacobian | mesh::GeometryQuantity::FaceNeighbors>;
+
+class GeometryCacheTest : public ::testing::Test, public UnitCube
+{
+    protected:
+    CubeMeshWithPolicy<mesh::ComputeGeometryOnTheFly> on_the_fly_mesh{nodes, simplexes};
+    CubeMeshWithPolicy<mesh::CacheAllGeometryAsFloat> float_mesh{nodes, simplexes};
+    CubeMeshWithPolicy<SelectedGeometry> selected_mesh{nodes, simplexes};
+};
+
+TEST_F(GeometryCacheTest, Selection)
+{
+    EXPECT_TRUE(CubeMesh::CachesGeometry<mesh::GeometryQuantity::InverseJacobian>());
+    EXPECT_TRUE(CubeMesh::CachesGeometry<mesh::GeometryQuantity::Normal>());
+    EXPECT_FALSE(decltype(on_the_fly_mesh)::CachesGeometry<mesh::GeometryQuantity::InverseJacobian>());
+    EXPECT_TRUE(decltype(selected_mesh)::CachesGeometry<mesh::GeometryQuantity::InverseJacobian>());
+    EXPECT_FALSE(decltype(selected_mesh)::CachesGeometry<mesh::GeometryQuantity::AbsJacobianDeterminant>());
+    EXPECT_FALSE(decltype(selected_mesh)::CachesGeometry<mesh::GeometryQuantity::Normal>());
+
+    // Normals are not available for two-dimensional meshes.
+    EXPECT_FALSE(Grid<2>::GridMesh::CachesGeometry<mesh::GeometryQuantity::Normal>());
+    EXPECT_TRUE(Grid<2>::GridMesh::CachesGeometry<mesh::GeometryQuantity::AbsJacobianDeterminant>());
+}
+
+TEST_F(GeometryCacheTest, Footprint)
+{
+    EXPECT_EQ(on_the_fly_mesh.GetGeometryCacheSize(), 0);
+    EXPECT_GT(selected_mesh.GetGeometryCacheSize(), 0);
+    EXPECT_LT(selected_mesh.GetGeometryCacheSize(), mesh.GetGeometryCacheSize());
+    EXPECT_LT(float_mesh.GetGeometryCacheSize(), mesh.GetGeometryCacheSize());
+}
+
+TEST_F(GeometryCacheTest, CellQuantities)
+{
+    for (std::size_t cell_index = 0; cell_index < NumCells; ++cell_index)
+    {
+        const auto& cell = *mesh.GetEntities(cell_index, cell_index + 1).begin();
+        const auto& on_the_fly_cell = *on_the_fly_mesh.GetEntities(cell_index, cell_index + 1).begin();
+        const auto& float_cell = *float_mesh.GetEntities(cell_index, cell_index + 1).begin();
+        const auto& selected_cell = *selected_mesh.GetEntities(cell_index, cell_index + 1).begin();
+
+        // Cached values are computed the same way as values computed on the fly.
+        EXPECT_EQ(cell.GetGeometry().GetAbsJacobianDeterminant(), on_the_fly_cell.GetGeometry().GetAbsJacobianDeterminant());
+        EXPECT_EQ(cell.GetGeometry().GetInverseJacobian(), on_the_fly_cell.GetGeometry().GetInverseJacobian());
+        EXPECT_EQ(selected_cell.GetGeometry().GetInverseJacobian(), on_the_fly_cell.GetGeometry().GetInverseJacobian());
+
+        // Values cached in single precision are returned in double precision.
+        EXPECT_NEAR(float_cell.GetGeometry().GetAbsJacobianDeterminant(), cell.GetGeometry().GetAbsJacobianDeterminant(), 1.0E-6);
+
+        const auto& inverse_jacobian = cell.GetGeometry().GetInverseJacobian();
+        const auto& float_inverse_jacobian = float_cell.GetGeometry().GetInverseJacobian();
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_NEAR(float_inverse_jacobian[i][j], inverse_jacobian[i][j], 1.0E-6);
+            }
+        }
+    }
+}
+
+TEST_F(GeometryCacheTest, FaceQuantities)
+{
+    for (std::size_t cell_index = 0; cell_index < NumCells; ++cell_index)
+    {
+        const auto& cell = *mesh.GetEntities(cell_index, cell_index + 1).begin();
+        const auto& on_the_fly_cell = *on_the_fly_mesh.GetEntities(cell_index, cell_index + 1).begin();
+        const auto& faces = cell.GetTopology().GetSubEntities();
+        const auto& on_the_fly_faces = on_the_fly_cell.GetTopology().GetSubEntities();
+
+        auto it = on_the_fly_faces.begin();
+
+        for (const auto& face : faces)
+        {
+            const auto& on_the_fly_face = *it;
+
+            EXPECT_EQ(face.GetGeometry().GetNormal(), on_the_fly_face.GetGeometry().GetNormal());
+            EXPECT_EQ(face.GetGeometry().GetUnitNormal(), on_the_fly_face.GetGeometry().GetUnitNormal());
+            EXPECT_EQ(face.GetGeometry().GetNormalLength(), on_the_fly_face.GetGeometry().GetNormalLength());
+            EXPECT_EQ(face.GetTopology().GetIndexOfNeighboringCell(), on_the_fly_face.GetTopology().GetIndexOfNeighboringCell());
+            EXPECT_EQ(face.GetTopology().GetLocalIndexOfNeighboringFace(), on_the_fly_face.GetTopology().GetLocalIndexOfNeighboringFace());
+            EXPECT_EQ(face.GetTopology().HasNeighboringCell(), on_the_fly_face.GetTopology().HasNeighboringCell());
+
+            ++it;
+        }
+    }
+}
+
+TEST(GeometryCache2DTest, AbsJacobianDeterminant)
+{
+    Grid<2> grid{4, 4};
+
+    for (const auto& cell : grid.mesh.GetEntities())
+    {
+        EXPECT_EQ(cell.GetGeometry().GetAbsJacobianDeterminant(), std::abs(cell.GetGeometry().GetJacobian().Determinant()));
+    }
+}
+
+TEST(GeometryCacheSetupTest, BatchedSetupMatchesSingleCells)
+{
+    // Perturb the grid nodes to get cells with different shapes: the number of cells is not a multiple of the block size.
+    const Grid<3> grid{{7, 6, 5}};
+    std::vector<CubeCoordinates> nodes = grid.nodes;
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i] += CubeCoordinates{0.2 * std::sin(1.0 * i), 0.2 * std::cos(1.3 * i), 0.2 * std::sin(0.7 * i)};
+    }
+
+    const CubeMesh mesh{nodes, grid.simplices};
+    const CubeMeshWithPolicy<mesh::ComputeGeometryOnTheFly> on_the_fly_mesh{nodes, grid.simplices};
+
+    auto it = on_the_fly_mesh.GetEntities().begin();
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const auto& on_the_fly_cell = *it;
+
+        // Cached and on-the-fly values are bitwise equal.
+        EXPECT_EQ(cell.GetGeometry().GetAbsJacobianDeterminant(), on_the_fly_cell.GetGeometry().GetAbsJacobianDeterminant());
+        EXPECT_EQ(cell.GetGeometry().GetInverseJacobian(), on_the_fly_cell.GetGeometry().GetInverseJacobian());
+
+        const auto& cell_nodes = cell.GetTopology().GetNodes();
+        const CubeCoordinates cell_center = (cell_nodes[0] + cell_nodes[1] + cell_nodes[2] + cell_nodes[3]) * 0.25;
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            // Face normals point out of the cell.
+            EXPECT_LT(face.GetGeometry().GetNormal() * (cell_center - face.GetTopology().GetNodes()[0]), 0.0);
+        }
+
+        ++it;
+    }
+}
@@ -3,11 +3,20 @@
 // Distributed under the MIT Software License
 // (See accompanying file LICENSE)
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "../../util/Grid.hpp"
 #include "../../util/UnitCube.hpp"
 
+#include <HighPerMeshes.hpp>
 #include <HighPerMeshes/dsl/meshes/PartitionedMesh.hpp>
 #include <HighPerMeshes/third_party/metis/Partitioner.hpp>
 
@@ -210,3 +219,149 @@ TEST(PartitionedMesh, TwoL1_TwoL2)
     EntityToL2P(1, Dimension<PartitionedMesh::CellDimension - 1>{});
     EntityToL2P(1, Dimension<PartitionedMesh::CellDimension - 2>{});
 }
+
+TEST(PartitionedMesh, AnalyzePartitioning)
+{
+    using BoxMesh = HPM::mesh::PartitionedMesh<HPM::dataType::Vec<double, 3>, HPM::entity::Simplex>;
+    using CellBuffer = HPM::Buffer<double, BoxMesh, HPM::dataType::ConstexprArray<std::size_t, 0, 0, 0, 6, 0>, std::allocator<double>>;
+    using NodeBuffer = HPM::Buffer<float, BoxMesh, HPM::dataType::ConstexprArray<std::size_t, 1, 0, 0, 0, 0>, std::allocator<float>>;
+
+    // 4 slabs along the z-axis, one after another: the interface between two slabs consists of 4x4x2 faces and 5x5 nodes.
+    const HPM::mesh::BoxMeshGenerator generator{{4, 4, 4}};
+    const auto& mesh = generator.CreatePartitionedMesh<BoxMesh>({2, 2}, 0);
+    const CellBuffer cell_buffer{mesh, {}, {}};
+    const NodeBuffer node_buffer{mesh, {}, {}};
+
+    const auto& report = HPM::drts::data_flow::AnalyzePartitioning(mesh, HPM::AccessPatterns::NeighboringMeshElementOrSelfPattern, HPM::internal::ForEachIncidence<3, 2>{}, cell_buffer, node_buffer);
+
+    ASSERT_EQ(report.L1_partitions.size(), 2);
+    ASSERT_EQ(report.L2_partitions.size(), 4);
+
+    for (std::size_t i_L2 = 0; i_L2 < 4; ++i_L2)
+    {
+        const auto& partition = report.L2_partitions[i_L2];
+        const std::size_t num_interfaces = ((i_L2 == 0 || i_L2 == 3) ? 1 : 2);
+
+        EXPECT_EQ(partition.num_cells, 6 * 4 * 4);
+        EXPECT_DOUBLE_EQ(partition.imbalance, 1.0);
+        EXPECT_EQ(partition.num_neighbors, num_interfaces);
+        ASSERT_EQ(partition.num_ghost_entities.size(), 4);
+        EXPECT_EQ(partition.num_ghost_entities[3], num_interfaces * 32);
+        EXPECT_EQ(partition.num_ghost_entities[0], 0);
+        EXPECT_EQ(partition.halo_bytes, (std::vector<std::size_t>{num_interfaces * 32 * 6 * sizeof(double), 0}));
+    }
+
+    for (const auto& partition : report.L1_partitions)
+    {
+        EXPECT_EQ(partition.num_cells, 2 * 6 * 4 * 4);
+        EXPECT_EQ(partition.num_neighbors, 1);
+        EXPECT_EQ(partition.num_ghost_entities[3], 32);
+    }
+
+    EXPECT_EQ(report.L2_partitions[0].num_nodes + report.L2_partitions[1].num_nodes, report.L1_partitions[0].num_nodes);
+    EXPECT_EQ(report.L1_partitions[0].num_nodes + report.L1_partitions[1].num_nodes, mesh.GetNumEntities<0>());
+
+    // Node accesses: the interface nodes belong to the slab below (the cells with the lower indices).
+    const auto& node_report = HPM::drts::data_flow::AnalyzePartitioning(mesh, HPM::AccessPatterns::SimplePattern, HPM::internal::ForEachIncidence<3, 0>{}, node_buffer);
+
+    for (std::size_t i_L2 = 0; i_L2 < 4; ++i_L2)
+    {
+        EXPECT_EQ(node_report.L2_partitions[i_L2].num_ghost_entities[0], (i_L2 == 0 ? 0 : 25));
+        EXPECT_EQ(node_report.L2_partitions[i_L2].GetHaloBytes(), (i_L2 == 0 ? 0 : 25 * sizeof(float)));
+    }
+
+    std::ostringstream text;
+    std::ostringstream json;
+
+    report.WriteText(text);
+    report.WriteJson(json);
+
+    EXPECT_NE(text.str().find("partitions: 2 x 2"), std::string::npos);
+    EXPECT_EQ(json.str().find("{\"num_partitions\":[2,2],\"max_imbalance\":{\"L1\":1,\"L2\":1},\"halo_bytes\":{\"L1\":3072,\"L2\":9216}"), 0);
+}
+
+TEST(PartitionedMesh, PartitionHierarchy)
+{
+    using BoxMesh = HPM::mesh::PartitionedMesh<HPM::dataType::Vec<double, 3>, HPM::entity::Simplex>;
+
+    // Three levels: 2 L1 partitions, 2 NUMA-level partitions per L1 partition, and 3 L2 partitions per NUMA-level partition.
+    const HPM::mesh::BoxMeshGenerator generator{{4, 4, 4}};
+    const auto& mesh = generator.CreatePartitionedMesh<BoxMesh>({2, 2, 3}, 1, HPM::mesh::RcbPartitioner{});
+    // The first two levels of the hierarchy only.
+    const auto& two_level_mesh = generator.CreatePartitionedMesh<BoxMesh>({2, 2}, 1, HPM::mesh::RcbPartitioner{});
+
+    auto to_vector = [](const auto& range) { return std::vector<std::size_t>(range.begin(), range.end()); };
+
+    ASSERT_EQ(mesh.GetNumLevels(), 3);
+    EXPECT_EQ(mesh.GetNumL1Partitions(), 2);
+    EXPECT_EQ(mesh.GetNumLxPartitions(1), 4);
+    EXPECT_EQ(mesh.GetNumL2Partitions(), 12);
+
+    EXPECT_EQ(mesh.L2PToL1P(7), 1);
+    EXPECT_EQ(to_vector(mesh.L1PToL2P(1)), (std::vector<std::size_t>{6, 7, 8, 9, 10, 11}));
+    EXPECT_EQ(to_vector(mesh.LxPToLyP(2, 1, 7)), (std::vector<std::size_t>{2}));
+    EXPECT_EQ(to_vector(mesh.LxPToLyP(1, 0, 2)), (std::vector<std::size_t>{1}));
+    EXPECT_EQ(to_vector(mesh.LxPToLyP(1, 2, 2)), (std::vector<std::size_t>{6, 7, 8}));
+    EXPECT_EQ(to_vector(mesh.LxPToLyP(2, 2, 5)), (std::vector<std::size_t>{5}));
+    EXPECT_EQ(mesh.GetL2PToLxP(1), (std::vector<std::size_t>{0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3}));
+
+    // The L2 partitions of this process.
+    std::size_t num_cells = 0;
+
+    for (std::size_t i_L2 = 0; i_L2 < mesh.GetNumL2Partitions(); ++i_L2)
+    {
+        num_cells += mesh.GetEntityRange<3>().GetIndices(i_L2).size();
+        EXPECT_EQ(mesh.GetEntityRange<3>().GetIndices(i_L2).empty(), (i_L2 < 6));
+    }
+
+    EXPECT_EQ(num_cells, mesh.GetNumEntities() / 2);
+
+    // Each NUMA-level partition consists of the cells of an L2 partition of the two-level partitioning: the same centroids.
+    auto get_centroids = [](const auto& cells) {
+        std::vector<std::array<double, 3>> centroids;
+
+        for (const auto& cell : cells)
+        {
+            std::array<double, 3> centroid{};
+
+            for (const auto& node : cell.GetTopology().GetNodes())
+            {
+                for (std::size_t dimension = 0; dimension < 3; ++dimension)
+                {
+                    centroid[dimension] += node[dimension];
+                }
+            }
+
+            // Round off differences due to the order of the nodes.
+            for (auto& coordinate : centroid)
+            {
+                coordinate = std::round(coordinate * 1.0E6);
+            }
+
+            centroids.push_back(centroid);
+        }
+
+        std::sort(centroids.begin(), centroids.end());
+
+        return centroids;
+    };
+
+    for (std::size_t i_L1 = 0; i_L1 < mesh.GetNumLxPartitions(1); ++i_L1)
+    {
+        std::vector<std::array<double, 3>> centroids;
+
+        for (const std::size_t i_L2 : mesh.LxPToLyP(1, 2, i_L1))
+        {
+            const auto& partition_centroids = get_centroids(mesh.L2PToEntity(i_L2));
+
+            centroids.insert(centroids.end(), partition_centroids.begin(), partition_centroids.end());
+        }
+
+        std::sort(centroids.begin(), centroids.end());
+
+        EXPECT_EQ(centroids, get_centroids(two_level_mesh.L2PToEntity(i_L1)));
+    }
+
+    EXPECT_THROW((HPM::mesh::PartitionHierarchy{2, 0, 3}), std::runtime_error);
+    EXPECT_THROW(mesh.LxPToLyP(1, 3, 0), std::runtime_error);
+}
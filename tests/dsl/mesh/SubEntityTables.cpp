@@ -0,0 +1,93 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/UnitCube.hpp"
+
+using namespace HPM;
+
+class SubEntityTablesTest : public ::testing::Test, public UnitCube
+{
+};
+
+TEST_F(SubEntityTablesTest, FaceEdges)
+{
+    for (const auto& face : mesh.GetEntities<2>())
+    {
+        const auto& face_node_indices = face.GetTopology().GetNodeIndices();
+        const auto& edge_indices = face.GetTopology().GetIndicesOfEntitiesWithDimension<1>();
+
+        ASSERT_EQ(edge_indices.size(), 3);
+
+        // Each edge consists of two nodes of the face, and no edge appears twice.
+        std::set<std::size_t> unique_edge_indices(edge_indices.begin(), edge_indices.end());
+        EXPECT_EQ(unique_edge_indices.size(), 3);
+
+        for (const std::size_t edge_index : edge_indices)
+        {
+            const auto& edge = *mesh.GetEntities<1>(edge_index, edge_index + 1).begin();
+
+            for (const std::size_t node : edge.GetTopology().GetNodeIndices())
+            {
+                EXPECT_NE(std::find(face_node_indices.begin(), face_node_indices.end(), node), face_node_indices.end());
+            }
+        }
+    }
+}
+
+TEST_F(SubEntityTablesTest, CellAndFaceEdgesAgree)
+{
+    // Edges accessed through the faces of a cell must be edges of that cell.
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const auto& cell_edge_indices = cell.GetTopology().GetIndicesOfEntitiesWithDimension<1>();
+
+        for (const auto& face : cell.GetTopology().GetEntities<2>())
+        {
+            for (const std::size_t edge_index : face.GetTopology().GetIndicesOfEntitiesWithDimension<1>())
+            {
+                EXPECT_NE(std::find(cell_edge_indices.begin(), cell_edge_indices.end(), edge_index), cell_edge_indices.end());
+            }
+        }
+    }
+}
+
+TEST_F(SubEntityTablesTest, ContainingCells)
+{
+    // Reference: collect the containing cells by iterating over the sub-entities of all cells.
+    std::array<std::vector<std::vector<std::size_t>>, 4> reference;
+
+    auxiliary::ConstexprFor<4>([&](const auto D) { reference[D].resize(mesh.GetNumEntities<D>()); });
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const std::size_t cell_index = cell.GetTopology().GetIndex();
+
+        auxiliary::ConstexprFor<4>([&](const auto D) {
+            for (const std::size_t entity_index : cell.GetTopology().template GetIndicesOfEntitiesWithDimension<D>())
+            {
+                reference[D][entity_index].push_back(cell_index);
+            }
+        });
+    }
+
+    auxiliary::ConstexprFor<4>([&](const auto D) {
+        for (const auto& entity : mesh.GetEntities<D>())
+        {
+            const auto& containing_cells = entity.GetTopology().GetIndicesOfAllContainingCells();
+            const auto& expected = reference[D][entity.GetTopology().GetIndex()];
+
+            EXPECT_TRUE(std::equal(containing_cells.begin(), containing_cells.end(), expected.begin(), expected.end()));
+            EXPECT_EQ(entity.GetTopology().GetNumContainingCells(), expected.size());
+        }
+    });
+}
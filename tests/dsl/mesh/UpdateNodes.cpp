@@ -0,0 +1,154 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <HighPerMeshes.hpp>
+
+#include "../../util/Grid.hpp"
+
+using namespace HPM;
+
+class UpdateNodesTest : public ::testing::Test
+{
+    protected:
+    UpdateNodesTest() : grid{{5, 4, 6}}, moved_nodes(grid.nodes)
+    {
+        for (std::size_t i = 0; i < moved_nodes.size(); ++i)
+        {
+            moved_nodes[i] += Grid<3>::CoordinateT{0.15 * std::sin(1.0 * i), 0.15 * std::cos(1.3 * i), 0.15 * std::sin(0.7 * i)};
+        }
+    }
+
+    Grid<3> grid;
+    std::vector<Grid<3>::CoordinateT> moved_nodes;
+};
+
+// Compares the geometry of all cells and their faces with that of a mesh built from scratch.
+static auto ExpectSameGeometry(const Grid<3>::GridMesh& mesh, const Grid<3>::GridMesh& rebuilt_mesh)
+{
+    auto it = rebuilt_mesh.GetEntities().begin();
+
+    for (const auto& cell : mesh.GetEntities())
+    {
+        const auto& rebuilt_cell = *it;
+
+        EXPECT_EQ(cell.GetGeometry().GetAbsJacobianDeterminant(), rebuilt_cell.GetGeometry().GetAbsJacobianDeterminant());
+        EXPECT_EQ(cell.GetGeometry().GetInverseJacobian(), rebuilt_cell.GetGeometry().GetInverseJacobian());
+
+        auto face_it = rebuilt_cell.GetTopology().GetSubEntities().begin();
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            EXPECT_EQ(face.GetGeometry().GetNormal(), (*face_it).GetGeometry().GetNormal());
+            EXPECT_EQ(face.GetGeometry().GetUnitNormal(), (*face_it).GetGeometry().GetUnitNormal());
+            EXPECT_EQ(face.GetTopology().GetIndexOfNeighboringCell(), (*face_it).GetTopology().GetIndexOfNeighboringCell());
+
+            ++face_it;
+        }
+
+        ++it;
+    }
+}
+
+TEST_F(UpdateNodesTest, MatchesRebuiltMesh)
+{
+    const auto boundary_faces = grid.mesh.GetEntityRange<2>([](const auto& face) { return face.GetTopology().GetNumContainingCells() == 1; });
+    const std::vector<std::size_t> boundary_face_indices = boundary_faces.GetIndices();
+
+    grid.mesh.UpdateNodes(moved_nodes);
+
+    ExpectSameGeometry(grid.mesh, {moved_nodes, grid.simplices});
+
+    // Ranges created before the update remain valid.
+    EXPECT_EQ(boundary_faces.GetIndices(), boundary_face_indices);
+
+    for (const auto& face : boundary_faces.GetEntities())
+    {
+        EXPECT_EQ(face.GetTopology().GetNumContainingCells(), 1);
+    }
+}
+
+TEST_F(UpdateNodesTest, MovesSomeNodes)
+{
+    // Only the geometry of the cells around the moved nodes is recomputed.
+    std::vector<Grid<3>::CoordinateT> new_nodes = grid.nodes;
+
+    for (std::size_t i = 0; i < new_nodes.size(); i += 7)
+    {
+        new_nodes[i] = moved_nodes[i];
+    }
+
+    grid.mesh.UpdateNodes(new_nodes);
+
+    ExpectSameGeometry(grid.mesh, {new_nodes, grid.simplices});
+}
+
+TEST_F(UpdateNodesTest, UpdatesDerivedData)
+{
+    // Stands in for, e.g., `DG::DgNodesMap`: it must see the new node coordinates when updated.
+    struct DerivedData
+    {
+        auto Update() -> void
+        {
+            first_cell_nodes = (*mesh.GetEntities().begin()).GetTopology().GetNodes();
+            ++num_updates;
+        }
+
+        const Grid<3>::GridMesh& mesh;
+        std::array<Grid<3>::CoordinateT, 4> first_cell_nodes;
+        std::size_t num_updates;
+    };
+
+    DerivedData derived{grid.mesh, {}, 0};
+
+    grid.mesh.UpdateNodes(moved_nodes, derived);
+
+    EXPECT_EQ(derived.num_updates, 1);
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(derived.first_cell_nodes[i], moved_nodes[grid.simplices[0][i]]);
+    }
+}
+
+TEST_F(UpdateNodesTest, RestoresOriginalGeometry)
+{
+    const Grid<3>::GridMesh original_mesh{grid.nodes, grid.simplices};
+    const std::vector<Grid<3>::CoordinateT> original_nodes = grid.nodes;
+
+    grid.mesh.UpdateNodes(moved_nodes);
+    grid.mesh.UpdateNodes(original_nodes);
+
+    auto it = original_mesh.GetEntities().begin();
+
+    for (const auto& cell : grid.mesh.GetEntities())
+    {
+        EXPECT_EQ(cell.GetGeometry().GetInverseJacobian(), (*it).GetGeometry().GetInverseJacobian());
+
+        auto face_it = (*it).GetTopology().GetSubEntities().begin();
+
+        for (const auto& face : cell.GetTopology().GetSubEntities())
+        {
+            EXPECT_EQ(face.GetGeometry().GetNormal(), (*face_it).GetGeometry().GetNormal());
+
+            ++face_it;
+        }
+
+        ++it;
+    }
+}
+
+TEST_F(UpdateNodesTest, WrongNumberOfNodes)
+{
+    moved_nodes.pop_back();
+
+    EXPECT_THROW(grid.mesh.UpdateNodes(moved_nodes), std::runtime_error);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.hpp"
+
+namespace HPM::test
+{
+    std::atomic<bool> count_allocations{false};
+    std::atomic<std::size_t> num_allocations{0};
+} // namespace HPM::test
+
+namespace
+{
+    auto Allocate(const std::size_t size, const std::size_t alignment) noexcept -> void*
+    {
+        if (::HPM::test::count_allocations.load(std::memory_order_relaxed))
+        {
+            ::HPM::test::num_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (alignment <= alignof(std::max_align_t))
+        {
+            return std::malloc(size ? size : 1);
+        }
+
+        // The size passed to aligned_alloc must be a multiple of the alignment.
+        return std::aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) / alignment * alignment);
+    }
+
+    auto AllocateOrThrow(const std::size_t size, const std::size_t alignment) -> void*
+    {
+        if (void* ptr = Allocate(size, alignment))
+        {
+            return ptr;
+        }
+
+        throw std::bad_alloc{};
+    }
+} // namespace
+
+// The complete set of replaceable allocation and deallocation functions: all of them use malloc/free,
+// so that memory from any form of new can be released with any form of delete.
+void* operator new(std::size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
@@ -0,0 +1,60 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef TESTS_UTIL_ALLOCATIONCOUNTER_HPP
+#define TESTS_UTIL_ALLOCATIONCOUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+
+//!
+//! Global allocation counter: heap allocations are counted only while an `AllocationCounter` is alive.
+//!
+//! The replacements of the global allocation and deallocation functions are defined in AllocationCounter.cpp,
+//! which is linked into the `allocation_tests` executable only: all other tests use the default allocator.
+//!
+namespace HPM::test
+{
+    extern std::atomic<bool> count_allocations;
+    extern std::atomic<std::size_t> num_allocations;
+
+    //!
+    //! \brief RAII guard: counts all heap allocations during its lifetime.
+    //!
+    class AllocationCounter
+    {
+        public:
+        AllocationCounter()
+        {
+            num_allocations = 0;
+            count_allocations = true;
+        }
+
+        ~AllocationCounter() { count_allocations = false; }
+
+        AllocationCounter(const AllocationCounter&) = delete;
+        auto operator=(const AllocationCounter&) -> AllocationCounter& = delete;
+
+        //!
+        //! \return the number of heap allocations since the construction of this guard
+        //!
+        auto GetNumAllocations() const -> std::size_t { return num_allocations; }
+    };
+
+    //!
+    //! \return the number of heap allocations performed by `func`
+    //!
+    template <typename FuncT>
+    auto CountAllocations(FuncT&& func)
+    {
+        const AllocationCounter counter;
+
+        func();
+
+        return counter.GetNumAllocations();
+    }
+} // namespace HPM::test
+
+#endif
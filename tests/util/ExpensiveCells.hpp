@@ -0,0 +1,101 @@
+// Copyright (c) 2017-2020
+//
+// Distributed under the MIT Software License
+// (See accompanying file LICENSE)
+
+#ifndef TESTS_UTIL_EXPENSIVECELLS_HPP
+#define TESTS_UTIL_EXPENSIVECELLS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include <HighPerMeshes/dsl/meshes/BoxMeshGenerator.hpp>
+#include <HighPerMeshes/dsl/meshes/Partitioner.hpp>
+
+//!
+//! A cost model for load-balancing tests: a mesh of the unit cube whose lowest quarter (along the z-axis) is expensive.
+//!
+//! The loop bodies do not spend any real time: they advance a `ManualClock`, which the profiling dispatchers and
+//! instrumentations measure with. Hence, the measured costs are exact and do not depend on the load of the machine.
+//!
+namespace HPM::test
+{
+    //!
+    //! \brief A `std::chrono` clock that is advanced explicitly: each thread has its own time.
+    //!
+    class ManualClock
+    {
+        public:
+        using rep = std::chrono::nanoseconds::rep;
+        using period = std::chrono::nanoseconds::period;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<ManualClock>;
+
+        static constexpr bool is_steady = true;
+
+        static auto now() noexcept -> time_point { return current_time; }
+
+        //!
+        //! \brief Advance the time of the calling thread.
+        //!
+        //! \param time the time span
+        //!
+        static auto Advance(const duration time) noexcept -> void { current_time += time; }
+
+        private:
+        static inline thread_local time_point current_time{};
+    };
+
+    //!
+    //! \brief The cost of a cheap and an expensive cell: the time `SpendTime` advances the clock by.
+    //!
+    constexpr std::chrono::microseconds CheapCellCost{1};
+    constexpr std::chrono::microseconds ExpensiveCellCost{20};
+
+    //!
+    //! \brief Create a mesh of the unit cube.
+    //!
+    //! \tparam PartitionedMeshT the type of the partitioned mesh
+    //! \param num_cubes the number of cubes along each axis
+    //! \param num_partitions the partition hierarchy: the slab layout along the z-axis
+    //! \return the partitioned mesh
+    //!
+    template <typename PartitionedMeshT>
+    auto CreateUnitCubeMesh(const std::array<std::size_t, 3>& num_cubes, const ::HPM::mesh::PartitionHierarchy& num_partitions) -> PartitionedMeshT
+    {
+        ::HPM::mesh::BoxMeshGenerator generator{num_cubes};
+
+        generator.SetDomain({0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+
+        return generator.template CreatePartitionedMesh<PartitionedMeshT>(num_partitions, 0);
+    }
+
+    //!
+    //! \brief Test for an expensive cell: all cells with a centroid in the lower quarter of the unit cube along the z-axis.
+    //!
+    template <typename CellT>
+    auto IsExpensive(const CellT& cell)
+    {
+        const auto& nodes = cell.GetTopology().GetNodes();
+        double z = 0.0;
+
+        for (const auto& node : nodes)
+        {
+            z += node[2] / nodes.size();
+        }
+
+        return (z < 0.25);
+    }
+
+    //!
+    //! \brief Spend the (simulated) cost of a cell: advance the `ManualClock` of the calling thread.
+    //!
+    template <typename CellT>
+    auto SpendTime(const CellT& cell) -> void
+    {
+        ManualClock::Advance(IsExpensive(cell) ? ExpensiveCellCost : CheapCellCost);
+    }
+} // namespace HPM::test
+
+#endif
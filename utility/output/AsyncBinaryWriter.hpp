@@ -0,0 +1,262 @@
+#ifndef ASYNCBINARYWRITER_HPP
+#define ASYNCBINARYWRITER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <binary_record.hpp>
+
+namespace HPM {
+
+//! AsyncBinaryWriter writes binary records (see binary_record.hpp) to a file in the background.
+//!
+//! Each thread appends its records to its own staging block without any locking.
+//! Full blocks are handed over to a writer thread that writes them to the file with large sequential writes,
+//! so the calling threads continue computing while the output drains.
+//! The number of blocks is bounded: if the writer thread cannot keep up, the calling threads wait for free blocks.
+//!
+//! Threads are identified by their OpenMP thread number.
+//! Write() may be called concurrently by different threads; Flush() must not be called concurrently with Write().
+class AsyncBinaryWriter {
+
+    struct Block {
+        std::vector<char> data;
+        std::size_t size = 0;
+    };
+
+    // Align the staging blocks to cache lines to avoid false sharing between threads.
+    struct alignas(64) Staging {
+        Block block;
+    };
+
+  public:
+    //! Constructor.
+    //! \param filename the file to write to
+    //! \param block_size the size of the staging blocks in bytes
+    //! \param num_threads the maximum number of threads calling Write()
+    AsyncBinaryWriter(const std::string& filename, std::size_t block_size = (1UL << 22), std::size_t num_threads = GetMaxNumThreads())
+        : file(filename, std::ios::out | std::ios::binary | std::ios::trunc), block_size(block_size), max_num_blocks(4 * num_threads), staging(num_threads) {
+
+        if (!file) {
+            throw std::runtime_error("error: could not open file: " + filename);
+        }
+
+        if (block_size < sizeof(binary_record_header) || num_threads == 0) {
+            throw std::runtime_error("error: invalid block size or number of threads");
+        }
+
+        binary_file_header header{};
+        std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+        header.version = binary_version;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        num_bytes_written = sizeof(header);
+
+        writer = std::thread([this]() { Run(); });
+    }
+
+    AsyncBinaryWriter(const AsyncBinaryWriter&) = delete;
+    AsyncBinaryWriter& operator=(const AsyncBinaryWriter&) = delete;
+
+    //! Destructor: writes all remaining records and stops the writer thread.
+    ~AsyncBinaryWriter() {
+        try {
+            Flush();
+        } catch (...) {
+        }
+
+        {
+            std::lock_guard guard{mutex};
+            stop = true;
+        }
+
+        work_available.notify_one();
+        writer.join();
+    }
+
+    //! Append a record to the staging block of the calling thread.
+    //! \param index the index of the entity
+    //! \param time_step the time step
+    //! \param num_dofs the number of dofs
+    //! \param num_components the number of values per dof
+    //! \param values `num_dofs * num_components` values
+    void Write(std::uint64_t index, std::uint64_t time_step, std::uint32_t num_dofs, std::uint32_t num_components, const double* values) {
+        const std::size_t thread = GetThreadIndex();
+
+        if (thread >= staging.size()) {
+            throw std::runtime_error("error: the writer was created for less threads");
+        }
+
+        const binary_record_header header{index, time_step, num_dofs, num_components};
+        const std::size_t num_value_bytes = static_cast<std::size_t>(num_dofs) * num_components * sizeof(double);
+        const std::size_t record_size = sizeof(header) + num_value_bytes;
+        Block& block = staging[thread].block;
+
+        if (block.size + record_size > block.data.size()) {
+            if (block.size > 0) {
+                Submit(std::move(block));
+            }
+
+            block = GetFreeBlock();
+
+            // Records larger than the block size get a block of their own.
+            if (record_size > block.data.size()) {
+                block.data.resize(record_size);
+            }
+        }
+
+        std::memcpy(block.data.data() + block.size, &header, sizeof(header));
+        std::memcpy(block.data.data() + block.size + sizeof(header), values, num_value_bytes);
+        block.size += record_size;
+    }
+
+    //! Write all staged records to the file and wait until they are written.
+    void Flush() {
+        for (auto& thread_staging : staging) {
+            if (thread_staging.block.size > 0) {
+                Submit(std::move(thread_staging.block));
+                thread_staging.block = Block{};
+            }
+        }
+
+        std::unique_lock lock{mutex};
+        work_done.wait(lock, [this]() { return queue.empty() && !writing; });
+
+        file.flush();
+
+        if (!file) {
+            throw std::runtime_error("error: writing the binary output failed");
+        }
+    }
+
+    //! \return the number of bytes written to the file so far (including the file header)
+    auto GetNumBytesWritten() const {
+        std::lock_guard guard{mutex};
+        return num_bytes_written;
+    }
+
+    //! \return the time (in seconds) that calling threads waited for free staging blocks
+    auto GetWaitTime() const {
+        std::lock_guard guard{mutex};
+        return wait_time;
+    }
+
+  private:
+    static auto GetMaxNumThreads() -> std::size_t {
+#if defined(_OPENMP)
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    static auto GetThreadIndex() -> std::size_t {
+#if defined(_OPENMP)
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+    }
+
+    auto GetFreeBlock() -> Block {
+        std::unique_lock lock{mutex};
+
+        if (free_blocks.empty() && num_blocks >= max_num_blocks) {
+            const auto begin = std::chrono::high_resolution_clock::now();
+
+            block_available.wait(lock, [this]() { return !free_blocks.empty() || num_blocks < max_num_blocks; });
+
+            wait_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        }
+
+        if (free_blocks.empty()) {
+            ++num_blocks;
+            lock.unlock();
+
+            return Block{std::vector<char>(block_size), 0};
+        }
+
+        Block block = std::move(free_blocks.back());
+        free_blocks.pop_back();
+
+        return block;
+    }
+
+    void Submit(Block&& block) {
+        {
+            std::lock_guard guard{mutex};
+            queue.push_back(std::move(block));
+        }
+
+        work_available.notify_one();
+    }
+
+    void Run() {
+        std::unique_lock lock{mutex};
+
+        while (true) {
+            work_available.wait(lock, [this]() { return !queue.empty() || stop; });
+
+            if (queue.empty()) {
+                break;
+            }
+
+            Block block = std::move(queue.front());
+            queue.pop_front();
+            writing = true;
+
+            lock.unlock();
+            file.write(block.data.data(), block.size);
+            lock.lock();
+
+            num_bytes_written += block.size;
+            writing = false;
+
+            // Oversized blocks are not reused.
+            if (block.data.size() == block_size) {
+                block.size = 0;
+                free_blocks.push_back(std::move(block));
+            } else {
+                --num_blocks;
+            }
+
+            block_available.notify_one();
+            work_done.notify_all();
+        }
+    }
+
+    std::ofstream file;
+    const std::size_t block_size;
+    const std::size_t max_num_blocks;
+    std::vector<Staging> staging;
+
+    mutable std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::condition_variable block_available;
+    std::deque<Block> queue;
+    std::vector<Block> free_blocks;
+    std::size_t num_blocks = 0;
+    bool writing = false;
+    bool stop = false;
+    std::size_t num_bytes_written = 0;
+    double wait_time = 0.0;
+
+    std::thread writer;
+};
+
+}
+
+#endif /* ASYNCBINARYWRITER_HPP */
@@ -1,10 +1,13 @@
 #ifndef WRITELOOP_HPP
 #define WRITELOOP_HPP
 
+#include <array>
 #include <mutex>
 #include <fstream>
 #include <HighPerMeshes.hpp>
 
+#include "AsyncBinaryWriter.hpp"
+
 namespace HPM {
 
 //! prints values to a stream
@@ -26,6 +29,25 @@ template<typename Stream, typename T, size_t Dim> void print(Stream&& stream, HP
 }
 // \}
 
+//! number of double values per dof entry
+//! \{
+template<typename T> struct NumComponents { static constexpr std::size_t value = 1; };
+template<typename T, size_t Dim> struct NumComponents<HPM::dataType::Vec<T, Dim>> { static constexpr std::size_t value = Dim; };
+// \}
+
+//! copies a dof entry to double values
+//! \{
+template<typename T> void copy_values(double* values, const T& value) {
+    values[0] = static_cast<double>(value);
+}
+
+template<typename T, size_t Dim> void copy_values(double* values, const HPM::dataType::Vec<T, Dim>& value) {
+    for(size_t i = 0; i < Dim; ++i) {
+        values[i] = static_cast<double>(value[i]);
+    }
+}
+// \}
+
 //! pre-condition for printing. Always prints
 auto Always() { return [](const auto& /* not used */, const auto& /*time_step*/) { return true; }; }
 
@@ -75,6 +97,41 @@ auto WriteLoop(std::mutex& mutex, std::ofstream& file, HPM::mesh::Range<Dimensio
         });
 }
 
+//! WriteLoop provides a loop that writes the dof entries of a specific range to a binary file
+//! All dofs of an entity are copied into one record (see binary_record.hpp) in the staging block of the calling thread.
+//! The writer thread of `writer` writes the records in the background, i.e., no locks are taken within the loop.
+//! Call writer.Flush() after the execution to make sure all records are written.
+//! \param writer the writer that writes the records to a file
+//! \param range The range to iterate over
+//! \param buffer The entries of this buffer are written to file
+//! \param condition A condition that determines if the entry should be written to the file, i.e., entries are only written to the file if condition(entity, time_step) == true.
+//! \return A MeshLoop that is usable by the rts that writes result back to file
+template<size_t Dimension, typename Mesh, typename Buffer, typename Condition = decltype(Always())>
+auto WriteLoop(AsyncBinaryWriter& writer, HPM::mesh::Range<Dimension, Mesh>& range, Buffer& buffer, Condition condition = Always()) {
+
+    using namespace HPM;
+
+    constexpr size_t NumDofs = std::decay_t<Buffer>::DofT::Get()[Dimension];
+    constexpr size_t NumValues = NumComponents<typename std::decay_t<Buffer>::ValueT>::value;
+
+    return ForEachEntity(
+        range,
+        std::tuple( RequestDim<Dimension>(buffer) ),
+        [&writer, condition](const auto &entity, auto&& time_step, auto lvs) {
+            auto &field = std::get<0>(lvs);
+
+            if(!condition(entity, time_step)) return;
+
+            std::array<double, (NumDofs > 0 ? NumDofs * NumValues : 1)> values;
+
+            ForEach(NumDofs, [&](auto e) {
+                copy_values(&values[e * NumValues], field[e]);
+            });
+
+            writer.Write(entity.GetTopology().GetIndex(), time_step, NumDofs, NumValues, values.data());
+        });
+}
+
 }
 
 #endif /* WRITELOOP_HPP */
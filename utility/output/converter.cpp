@@ -0,0 +1,63 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <binary_record.hpp>
+#include <entry_parser.hpp>
+#include <read_paths.hpp>
+#include <to_trace_records.hpp>
+#include <trace_reader.hpp>
+#include <trace_store.hpp>
+
+//! Converts WriteLoop outputs (binary or text) into one indexed trace store.
+//! Usage: converter <trace store> <WriteLoop output>...
+int main(int argc, const char* argv[])
+{
+    using namespace std;
+
+    if(argc < 3) {
+        cerr << "usage: " << argv[0] << " <trace store> <WriteLoop output>..." << "\n";
+        return 1;
+    }
+
+    auto paths = read_paths(argc, argv);
+    const string output { paths.front() };
+    paths.erase(paths.begin());
+
+    vector<mapped_file> files;
+    vector<entry> text_entries;
+    vector<trace_record> records;
+
+    for(const auto& path : paths) {
+        try {
+            mapped_file file { string { path } };
+
+            if(file.size() >= sizeof(binary_magic) && memcmp(file.data(), binary_magic, sizeof(binary_magic)) == 0) {
+                read_binary_records(file.data(), file.data() + file.size(), records);
+                files.push_back(move(file));
+            } else {
+                entry_parser<const char*> parser;
+                const char* file_begin = file.data();
+                auto entries = parser.parse_entries(file_begin, file.data() + file.size());
+                move(entries.begin(), entries.end(), back_inserter(text_entries));
+            }
+        } catch(const exception& e) {
+            cerr << path << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    try {
+        vector<double> text_values;
+        const auto text_records = to_trace_records(text_entries, text_values);
+        records.insert(records.end(), text_records.begin(), text_records.end());
+
+        write_trace_store(output, records);
+    } catch(const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+
+    cout << "wrote " << records.size() << " records to " << output << "\n";
+}
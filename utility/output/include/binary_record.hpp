@@ -0,0 +1,28 @@
+#ifndef BINARY_RECORD_HPP
+#define BINARY_RECORD_HPP
+
+#include <cstdint>
+
+//! Binary output of the WriteLoop: a file header followed by a sequence of records.
+//! Each record is a record header followed by `num_dofs * num_components` values of type double.
+//! Records of different threads are interleaved in blocks, i.e., they are not ordered by time step or index.
+
+constexpr char binary_magic[8] = { 'H', 'P', 'M', 'W', 'L', 'O', 'O', 'P' };
+constexpr std::uint64_t binary_version = 1;
+
+struct binary_file_header {
+    char magic[8];
+    std::uint64_t version;
+};
+
+struct binary_record_header {
+    std::uint64_t index;
+    std::uint64_t time_step;
+    std::uint32_t num_dofs;
+    std::uint32_t num_components;
+};
+
+static_assert(sizeof(binary_file_header) == 16, "error: unexpected padding in binary_file_header");
+static_assert(sizeof(binary_record_header) == 24, "error: unexpected padding in binary_record_header");
+
+#endif /* BINARY_RECORD_HPP */
@@ -0,0 +1,59 @@
+#ifndef TO_TRACE_RECORDS_HPP
+#define TO_TRACE_RECORDS_HPP
+
+#include <entry.hpp>
+#include <trace_store.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+//! Merges the text entries (one per dof) into one record per index and time step.
+//! \param entries the parsed entries; they are sorted by time step, index and dof
+//! \param values the storage of the values the records refer to
+//! \return the records
+inline std::vector<trace_record> to_trace_records(std::vector<entry>& entries, std::vector<double>& values) {
+    using namespace std;
+
+    sort(begin(entries), end(entries), [](const entry& lhs, const entry& rhs) { return tie(lhs.time_step, lhs.index, lhs.Dof) < tie(rhs.time_step, rhs.index, rhs.Dof); });
+
+    size_t num_values = 0;
+    for(const auto& entry : entries) {
+        num_values += entry.values.size();
+    }
+
+    // The records point into values: no reallocation allowed.
+    values.clear();
+    values.reserve(num_values);
+
+    vector<trace_record> records;
+
+    for(auto first = entries.begin(); first != entries.end();) {
+        const auto last = find_if(first, entries.end(), [&](const entry& other) { return other.time_step != first->time_step || other.index != first->index; });
+        const auto num_components = first->values.size();
+        const auto offset = values.size();
+
+        for(auto dof = first; dof != last; ++dof) {
+            if(dof->Dof != static_cast<size_t>(dof - first) || dof->values.size() != num_components) {
+                throw invalid_argument("inconsistent dofs for index " + to_string(first->index) + " at time step " + to_string(first->time_step));
+            }
+            values.insert(values.end(), dof->values.begin(), dof->values.end());
+        }
+
+        records.push_back(trace_record {
+            first->time_step,
+            first->index,
+            static_cast<uint32_t>(last - first),
+            static_cast<uint32_t>(num_components),
+            reinterpret_cast<const char*>(values.data() + offset)
+        });
+
+        first = last;
+    }
+
+    return records;
+}
+
+#endif /* TO_TRACE_RECORDS_HPP */
@@ -0,0 +1,158 @@
+#ifndef TRACE_READER_HPP
+#define TRACE_READER_HPP
+
+#include <trace_store.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! A read-only memory mapping of a whole file.
+class mapped_file {
+  public:
+    explicit mapped_file(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::invalid_argument(std::string { "could not open file: " }.append(path));
+        }
+
+        struct stat status;
+
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throw std::invalid_argument(std::string { "could not stat file: " }.append(path));
+        }
+
+        length = status.st_size;
+
+        if (length > 0) {
+            void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error(std::string { "could not map file: " }.append(path));
+            }
+
+            memory = static_cast<const char*>(address);
+        }
+
+        ::close(fd);
+    }
+
+    mapped_file(mapped_file&& other) noexcept : memory(std::exchange(other.memory, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        std::swap(memory, other.memory);
+        std::swap(length, other.length);
+        return *this;
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+        if (memory) {
+            ::munmap(const_cast<char*>(memory), length);
+        }
+    }
+
+    const char* data() const { return memory; }
+    std::size_t size() const { return length; }
+
+  private:
+    const char* memory = nullptr;
+    std::size_t length = 0;
+};
+
+//! The values of one entity at one time step: num_dofs x num_components values (dof-major).
+struct trace_values {
+    const double* values = nullptr;
+    std::uint32_t num_dofs = 0;
+    std::uint32_t num_components = 0;
+
+    bool empty() const { return num_dofs == 0; }
+    std::size_t size() const { return static_cast<std::size_t>(num_dofs) * num_components; }
+    const double* begin() const { return values; }
+    const double* end() const { return values + size(); }
+    const double& operator[](std::size_t i) const { return values[i]; }
+    //! \return the component of a dof
+    const double& operator()(std::size_t dof, std::size_t component = 0) const { return values[dof * num_components + component]; }
+};
+
+//! The values of all entities at one time step.
+class trace_step_values {
+  public:
+    trace_step_values() = default;
+    trace_step_values(const char* file, const trace_step& step) : file(file), step(step) {}
+
+    std::uint64_t num_entities() const { return step.num_entities; }
+
+    //! \return the values of all entities, contiguous and ordered by entity index
+    const double* data() const { return reinterpret_cast<const double*>(file + step.data_offset); }
+    std::size_t size() const { return step.data_size / sizeof(double); }
+
+    //! \return the values of an entity, empty if the entity was not written at this time step
+    trace_values operator[](std::uint64_t index) const {
+        if (index >= step.num_entities) {
+            return {};
+        }
+
+        const auto& entity = reinterpret_cast<const trace_entity*>(file + step.entity_table_offset)[index];
+
+        return { reinterpret_cast<const double*>(file + entity.offset), entity.num_dofs, entity.num_components };
+    }
+
+  private:
+    const char* file = nullptr;
+    trace_step step {};
+};
+
+//! Memory-mapped reader for indexed trace stores (see trace_store.hpp).
+//! Lookups only access the index tables of the mapping: no parsing and no copies.
+class trace_reader {
+  public:
+    explicit trace_reader(const std::string& path) : file(path) {
+        if (file.size() < sizeof(trace_header) || std::memcmp(file.data(), trace_magic, sizeof(trace_magic)) != 0) {
+            throw std::invalid_argument(std::string { "not a trace store: " }.append(path));
+        }
+
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.version != trace_version) {
+            throw std::invalid_argument("unsupported trace store version: " + std::to_string(header.version));
+        }
+
+        if (header.step_table_offset + header.num_steps * sizeof(trace_step) > file.size()) {
+            throw std::invalid_argument(std::string { "truncated trace store: " }.append(path));
+        }
+    }
+
+    std::uint64_t first_step() const { return header.first_step; }
+    std::uint64_t num_steps() const { return header.num_steps; }
+
+    //! \return the values of all entities at a time step, empty if the time step was not written
+    trace_step_values at(std::uint64_t time_step) const {
+        if (time_step < header.first_step || time_step - header.first_step >= header.num_steps) {
+            return {};
+        }
+
+        return { file.data(), reinterpret_cast<const trace_step*>(file.data() + header.step_table_offset)[time_step - header.first_step] };
+    }
+
+    //! \return the values of an entity at a time step, empty if it was not written
+    trace_values at(std::uint64_t time_step, std::uint64_t index) const { return at(time_step)[index]; }
+
+  private:
+    mapped_file file;
+    trace_header header;
+};
+
+#endif /* TRACE_READER_HPP */
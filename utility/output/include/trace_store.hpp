@@ -0,0 +1,171 @@
+#ifndef TRACE_STORE_HPP
+#define TRACE_STORE_HPP
+
+#include <binary_record.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+//! Indexed binary trace store: the values of all entities at all time steps, with an index for direct access.
+//!
+//! Layout (all offsets in bytes from the beginning of the file, all sections aligned to 8 bytes):
+//! - trace_header
+//! - the values (double) of all records, ordered by time step and entity index:
+//!   the values of one time step are contiguous
+//! - per time step: a dense entity table with one trace_entity per entity index in [0, num_entities)
+//! - a dense step table with one trace_step per time step in [first_step, first_step + num_steps)
+//!
+//! Missing time steps have no entities, missing entities have no dofs.
+//! Hence, looking up the values of an entity at a time step takes two table accesses.
+
+constexpr char trace_magic[8] = { 'H', 'P', 'M', 'T', 'R', 'A', 'C', 'E' };
+constexpr std::uint64_t trace_version = 1;
+
+struct trace_header {
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t first_step;
+    std::uint64_t num_steps;
+    std::uint64_t step_table_offset;
+};
+
+struct trace_step {
+    std::uint64_t entity_table_offset;
+    std::uint64_t num_entities;
+    std::uint64_t data_offset;
+    std::uint64_t data_size;
+};
+
+struct trace_entity {
+    std::uint64_t offset;
+    std::uint32_t num_dofs;
+    std::uint32_t num_components;
+};
+
+static_assert(sizeof(trace_header) == 40, "error: unexpected padding in trace_header");
+static_assert(sizeof(trace_step) == 32, "error: unexpected padding in trace_step");
+static_assert(sizeof(trace_entity) == 16, "error: unexpected padding in trace_entity");
+
+//! A record that refers to its values, which are stored elsewhere.
+struct trace_record {
+    std::uint64_t time_step;
+    std::uint64_t index;
+    std::uint32_t num_dofs;
+    std::uint32_t num_components;
+    const char* values;
+
+    std::size_t size() const { return static_cast<std::size_t>(num_dofs) * num_components * sizeof(double); }
+};
+
+//! Collects the records of a binary WriteLoop output (see binary_record.hpp).
+//! The records refer to the values within [begin, end), which must outlive them.
+inline void read_binary_records(const char* begin, const char* end, std::vector<trace_record>& records) {
+    const std::size_t size = end - begin;
+
+    if (size < sizeof(binary_file_header) || std::memcmp(begin, binary_magic, sizeof(binary_magic)) != 0) {
+        throw std::invalid_argument("not a binary WriteLoop output");
+    }
+
+    binary_file_header file_header;
+    std::memcpy(&file_header, begin, sizeof(file_header));
+
+    if (file_header.version != binary_version) {
+        throw std::invalid_argument("unsupported binary WriteLoop version: " + std::to_string(file_header.version));
+    }
+
+    for (std::size_t offset = sizeof(file_header); offset < size;) {
+        if (size - offset < sizeof(binary_record_header)) {
+            throw std::invalid_argument("truncated binary WriteLoop output");
+        }
+
+        binary_record_header header;
+        std::memcpy(&header, begin + offset, sizeof(header));
+        offset += sizeof(header);
+
+        const trace_record record { header.time_step, header.index, header.num_dofs, header.num_components, begin + offset };
+
+        if (size - offset < record.size()) {
+            throw std::invalid_argument("truncated binary WriteLoop output");
+        }
+
+        offset += record.size();
+        records.push_back(record);
+    }
+}
+
+//! Writes an indexed trace store.
+//! \param path the file to write to
+//! \param records all records; they are sorted by time step and index. Each (time step, index) pair must be unique.
+inline void write_trace_store(const std::string& path, std::vector<trace_record>& records) {
+    std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return std::tie(lhs.time_step, lhs.index) < std::tie(rhs.time_step, rhs.index); });
+
+    const auto duplicate = std::adjacent_find(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.time_step == rhs.time_step && lhs.index == rhs.index; });
+
+    if (duplicate != records.end()) {
+        throw std::invalid_argument("duplicate record for index " + std::to_string(duplicate->index) + " at time step " + std::to_string(duplicate->time_step));
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+        throw std::invalid_argument(std::string { "could not open file: " }.append(path));
+    }
+
+    trace_header header {};
+    std::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+    header.version = trace_version;
+    header.first_step = (records.empty() ? 0 : records.front().time_step);
+    header.num_steps = (records.empty() ? 0 : records.back().time_step - header.first_step + 1);
+
+    std::vector<trace_step> steps(header.num_steps, trace_step {});
+    std::vector<std::vector<trace_entity>> entity_tables(header.num_steps);
+    std::uint64_t offset = sizeof(header);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Values, time step by time step.
+    for (auto record = records.begin(); record != records.end();) {
+        const std::uint64_t step = record->time_step - header.first_step;
+        const auto step_end = std::find_if(record, records.end(), [&](const auto& other) { return other.time_step != record->time_step; });
+        auto& entities = entity_tables[step];
+
+        entities.resize(std::prev(step_end)->index + 1, trace_entity {});
+        steps[step].num_entities = entities.size();
+        steps[step].data_offset = offset;
+
+        for (; record != step_end; ++record) {
+            entities[record->index] = trace_entity { offset, record->num_dofs, record->num_components };
+            out.write(record->values, record->size());
+            offset += record->size();
+        }
+
+        steps[step].data_size = offset - steps[step].data_offset;
+    }
+
+    // Entity tables.
+    for (std::uint64_t step = 0; step < header.num_steps; ++step) {
+        steps[step].entity_table_offset = offset;
+        out.write(reinterpret_cast<const char*>(entity_tables[step].data()), entity_tables[step].size() * sizeof(trace_entity));
+        offset += entity_tables[step].size() * sizeof(trace_entity);
+    }
+
+    // Step table.
+    header.step_table_offset = offset;
+    out.write(reinterpret_cast<const char*>(steps.data()), steps.size() * sizeof(trace_step));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!out) {
+        throw std::runtime_error(std::string { "could not write file: " }.append(path));
+    }
+}
+
+#endif /* TRACE_STORE_HPP */
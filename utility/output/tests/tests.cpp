@@ -1,15 +1,23 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include <catch2/catch.hpp>
 
+#include <AsyncBinaryWriter.hpp>
+#include <binary_record.hpp>
 #include <entry.hpp>
 #include <entry_parser.hpp>
 #include <read_files.hpp>
 #include <read_paths.hpp>
 #include <to_step_map.hpp>
+#include <to_trace_records.hpp>
+#include <trace_reader.hpp>
+#include <trace_store.hpp>
 #include <write_entries.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <sstream>
+#include <vector>
 
 std::string make_entry(const entry& e) {
   std::stringstream stream;
@@ -250,4 +258,141 @@ TEST_CASE("to_step_map works", "[to_step_map]") {
     mapped[2][0].index == 1
   );
 
-}
\ No newline at end of file
+}
+TEST_CASE("AsyncBinaryWriter works", "[i/o]") {
+
+  constexpr std::uint64_t num_records = 10000;
+  constexpr std::uint32_t num_dofs = 3;
+
+  {
+    // Small blocks to exercise the hand-over to the writer thread.
+    HPM::AsyncBinaryWriter writer { "test_data.bin", 1024, 4 };
+
+    #pragma omp parallel for num_threads(4)
+    for(std::uint64_t i = 0; i < num_records; ++i) {
+      const double values[num_dofs] = { 1.0 * i, 2.0 * i, 3.0 * i };
+      writer.Write(i, i % 7, num_dofs, 1, values);
+    }
+
+    writer.Flush();
+
+    REQUIRE(writer.GetNumBytesWritten() == sizeof(binary_file_header) + num_records * (sizeof(binary_record_header) + num_dofs * sizeof(double)));
+  }
+
+  std::ifstream in { "test_data.bin", std::ios::binary };
+  binary_file_header file_header;
+  in.read(reinterpret_cast<char*>(&file_header), sizeof(file_header));
+
+  REQUIRE(std::equal(std::begin(binary_magic), std::end(binary_magic), file_header.magic));
+  REQUIRE(file_header.version == binary_version);
+
+  std::vector<bool> found(num_records, false);
+  binary_record_header header;
+
+  while(in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    std::vector<double> values(header.num_dofs * header.num_components);
+    in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double));
+
+    REQUIRE(header.index < num_records);
+    REQUIRE(header.time_step == header.index % 7);
+    REQUIRE(values == std::vector<double> { 1.0 * header.index, 2.0 * header.index, 3.0 * header.index });
+    found[header.index] = true;
+  }
+
+  REQUIRE(std::all_of(found.begin(), found.end(), [](bool f) { return f; }));
+
+  SECTION("records larger than a block") {
+    HPM::AsyncBinaryWriter writer { "test_data.bin", 64, 1 };
+    std::vector<double> values(100, 1.0);
+
+    writer.Write(0, 0, 100, 1, values.data());
+    writer.Write(1, 0, 1, 1, values.data());
+    writer.Flush();
+
+    REQUIRE(writer.GetNumBytesWritten() == sizeof(binary_file_header) + 2 * sizeof(binary_record_header) + 101 * sizeof(double));
+  }
+
+}
+
+TEST_CASE("trace store works", "[i/o]") {
+
+  SECTION("from binary WriteLoop output") {
+    {
+      HPM::AsyncBinaryWriter writer { "test_data.bin", 256, 1 };
+
+      // Time steps 3 and 5, entity 1 is missing at time step 5.
+      for(std::uint64_t step : { 5, 3 }) {
+        for(std::uint64_t index : { 2, 0, 1 }) {
+          if(step == 5 && index == 1) continue;
+          const double values[4] = { 1.0 * step, 1.0 * index, 2.0, 3.0 };
+          writer.Write(index, step, 2, 2, values);
+        }
+      }
+    }
+
+    mapped_file file { "test_data.bin" };
+    std::vector<trace_record> records;
+    read_binary_records(file.data(), file.data() + file.size(), records);
+
+    REQUIRE(records.size() == 5);
+
+    write_trace_store("test_data.trace", records);
+    trace_reader reader { "test_data.trace" };
+
+    REQUIRE(reader.first_step() == 3);
+    REQUIRE(reader.num_steps() == 3);
+
+    const auto values = reader.at(5, 2);
+
+    REQUIRE(values.num_dofs == 2);
+    REQUIRE(values.num_components == 2);
+    REQUIRE(values(0, 0) == 5.0);
+    REQUIRE(values(0, 1) == 2.0);
+    REQUIRE(values(1, 1) == 3.0);
+
+    REQUIRE(reader.at(5, 1).empty());
+    REQUIRE(reader.at(5, 7).empty());
+    REQUIRE(reader.at(4).num_entities() == 0);
+    REQUIRE(reader.at(9).num_entities() == 0);
+
+    // All values of a time step are contiguous.
+    const auto step = reader.at(3);
+
+    REQUIRE(step.num_entities() == 3);
+    REQUIRE(step.size() == 12);
+    REQUIRE(std::vector<double>(step.data(), step.data() + 4) == std::vector<double> { 3.0, 0.0, 2.0, 3.0 });
+    REQUIRE(step[1].begin() == step.data() + 4);
+
+    records.push_back(records.front());
+    REQUIRE_THROWS(write_trace_store("test_data.trace", records));
+  }
+
+  SECTION("from text WriteLoop output") {
+    std::vector<entry> entries {
+      { 1, 0, 1, { 12.0 } },
+      { 0, 0, 0, { 1.0 } },
+      { 1, 0, 0, { 11.0 } },
+      { 0, 1, 0, { 2.0 } }
+    };
+
+    std::vector<double> values;
+    auto records = to_trace_records(entries, values);
+    write_trace_store("test_data.trace", records);
+    trace_reader reader { "test_data.trace" };
+
+    REQUIRE(reader.num_steps() == 2);
+    REQUIRE(std::vector<double>(reader.at(0, 1).begin(), reader.at(0, 1).end()) == std::vector<double> { 11.0, 12.0 });
+    REQUIRE(reader.at(1, 0)[0] == 2.0);
+    REQUIRE(reader.at(1, 1).empty());
+
+    entries.push_back({ 2, 0, 1, { 1.0 } });
+    REQUIRE_THROWS(to_trace_records(entries, values));
+  }
+
+  SECTION("throws for other files") {
+    std::ofstream { "test_data.trace" } << "wrong";
+    REQUIRE_THROWS(trace_reader { "test_data.trace" });
+    REQUIRE_THROWS(trace_reader { "wroooong" });
+  }
+
+}